@@ -0,0 +1,127 @@
+import numpy as np
+import pandas as pd
+
+# Reproducible synthetic datasets for the benchmarks. Each generator samples a random DAG over d variables (the
+# variables are named "X0", ..., "X{d-1}" in topological order) and then N instances from it. The same (N, d, seed)
+# always returns the same DataFrame and the same arcs, so the results of different commits can be compared.
+
+
+def random_dag(d, max_parents, rng):
+    arcs = []
+    for i in range(1, d):
+        num_parents = rng.integers(0, min(i, max_parents) + 1)
+        parents = rng.choice(i, size=num_parents, replace=False)
+        arcs.extend(("X" + str(p), "X" + str(i)) for p in sorted(parents))
+
+    return arcs
+
+
+def _parents(arcs, d):
+    parents = [[] for _ in range(d)]
+    for source, target in arcs:
+        parents[int(target[1:])].append(int(source[1:]))
+
+    return parents
+
+
+def gaussian_data(N, d, seed=0, max_parents=3):
+    """
+    Samples a Gaussian network: each variable is a linear combination of its parents plus Gaussian noise.
+
+    :returns: A tuple (DataFrame, arcs).
+    """
+    rng = np.random.default_rng(seed)
+    arcs = random_dag(d, max_parents, rng)
+    parents = _parents(arcs, d)
+
+    values = np.empty((N, d))
+    for i in range(d):
+        values[:, i] = rng.normal(0, 1, size=N) * rng.uniform(0.5, 2) + rng.uniform(-5, 5)
+        for p in parents[i]:
+            values[:, i] += rng.uniform(0.5, 2) * rng.choice([-1, 1]) * values[:, p]
+
+    return pd.DataFrame(values, columns=["X" + str(i) for i in range(d)]), arcs
+
+
+def clg_data(N, d, seed=0, max_parents=3, discrete_ratio=0.25, categories=3):
+    """
+    Samples a conditional linear Gaussian network. The first ``discrete_ratio * d`` variables are discrete, so the
+    discrete variables never have continuous parents. Each continuous variable has different linear coefficients for
+    each configuration of its discrete parents.
+
+    :returns: A tuple (DataFrame, arcs).
+    """
+    rng = np.random.default_rng(seed)
+    arcs = random_dag(d, max_parents, rng)
+    parents = _parents(arcs, d)
+    num_discrete = int(d * discrete_ratio)
+
+    columns = {}
+    codes = []
+    continuous = {}
+    for i in range(d):
+        name = "X" + str(i)
+        discrete_parents = [p for p in parents[i] if p < num_discrete]
+        continuous_parents = [p for p in parents[i] if p >= num_discrete]
+
+        config = np.zeros(N, dtype=int)
+        for p in discrete_parents:
+            config = config * categories + codes[p]
+        num_configs = categories ** len(discrete_parents)
+
+        if i < num_discrete:
+            probs = rng.dirichlet(np.ones(categories), size=num_configs)
+            cumulative = probs[config].cumsum(axis=1)
+            values = (rng.uniform(size=(N, 1)) > cumulative).sum(axis=1)
+            values = np.minimum(values, categories - 1)
+            codes.append(values)
+            columns[name] = pd.Categorical.from_codes(values, [name + "_" + str(c) for c in range(categories)])
+        else:
+            codes.append(None)
+            intercepts = rng.uniform(-5, 5, size=num_configs)
+            scales = rng.uniform(0.5, 2, size=num_configs)
+            values = intercepts[config] + rng.normal(0, 1, size=N) * scales[config]
+            for p in continuous_parents:
+                coefficients = rng.uniform(0.5, 2, size=num_configs) * rng.choice([-1, 1], size=num_configs)
+                values += coefficients[config] * continuous[p]
+
+            continuous[i] = values
+            columns[name] = values
+
+    return pd.DataFrame(columns), arcs
+
+
+_nonlinear_functions = [np.sin, np.cos, np.tanh, lambda x: 0.5 * x * x, np.abs]
+
+
+def nonlinear_data(N, d, seed=0, max_parents=3):
+    """
+    Samples a non-linear continuous network: each variable is a sum of non-linear functions (sin, cos, tanh, square
+    and absolute value) of its standardized parents plus Gaussian noise.
+
+    :returns: A tuple (DataFrame, arcs).
+    """
+    rng = np.random.default_rng(seed)
+    arcs = random_dag(d, max_parents, rng)
+    parents = _parents(arcs, d)
+
+    values = np.empty((N, d))
+    for i in range(d):
+        values[:, i] = rng.normal(0, rng.uniform(0.2, 1), size=N)
+        for p in parents[i]:
+            standardized = (values[:, p] - values[:, p].mean()) / values[:, p].std()
+            f = _nonlinear_functions[rng.integers(len(_nonlinear_functions))]
+            values[:, i] += rng.uniform(1, 3) * f(standardized)
+
+    return pd.DataFrame(values, columns=["X" + str(i) for i in range(d)]), arcs
+
+
+GENERATORS = {
+    "gaussian": gaussian_data,
+    "clg": clg_data,
+    "nonlinear": nonlinear_data,
+}
+
+
+def generate(kind, N, d, seed=0):
+    return GENERATORS[kind](N, d, seed)
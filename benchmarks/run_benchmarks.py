@@ -0,0 +1,189 @@
+"""
+Runs the benchmark suite of PyBNesian and saves the results in a JSON file that can be compared between commits:
+
+    python benchmarks/run_benchmarks.py --size medium --threads 1 2 4 --output baseline.json
+    (checkout another commit and rebuild)
+    python benchmarks/run_benchmarks.py --size medium --threads 1 2 4 --compare baseline.json
+
+For each benchmark and number of threads it reports the median, minimum and maximum wall time of the repetitions, the
+speedup with respect to the smallest number of threads, the memory allocated by Python (tracemalloc) and the growth of
+the peak resident set size of the process (which includes the allocations of the C++ code).
+"""
+import argparse
+import datetime
+import json
+import os
+import platform
+import re
+import resource
+import statistics
+import subprocess
+import sys
+import time
+import tracemalloc
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+
+import pybnesian as pbn
+import suite
+
+FORMAT_VERSION = 1
+
+
+def peak_rss():
+    rss = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+    # Linux reports kilobytes and macOS bytes.
+    return rss if sys.platform == "darwin" else rss * 1024
+
+
+def git_commit():
+    try:
+        return subprocess.run(["git", "rev-parse", "HEAD"],
+                              cwd=os.path.dirname(os.path.abspath(__file__)),
+                              capture_output=True,
+                              text=True,
+                              check=True).stdout.strip()
+    except (OSError, subprocess.CalledProcessError):
+        return None
+
+
+def measure(run, repetitions, warmup):
+    for _ in range(warmup):
+        run()
+
+    rss_before = peak_rss()
+    tracemalloc.start()
+
+    times = []
+    for _ in range(repetitions):
+        start = time.perf_counter()
+        run()
+        times.append(time.perf_counter() - start)
+
+    _, python_peak = tracemalloc.get_traced_memory()
+    tracemalloc.stop()
+
+    return {
+        "times": times,
+        "median": statistics.median(times),
+        "min": min(times),
+        "max": max(times),
+        "python_peak_bytes": python_peak,
+        "peak_rss_growth_bytes": peak_rss() - rss_before,
+    }
+
+
+def run_suite(names, N, d, threads, repetitions, warmup, verbose=True):
+    previous_threads = pbn.num_threads()
+    results = []
+
+    for name in names:
+        bN, bd = suite.problem_size(name, N, d)
+        run = suite.BENCHMARKS[name]["setup"](bN, bd)
+
+        base_time = None
+        for t in threads:
+            pbn.set_num_threads(t)
+            r = measure(run, repetitions, warmup)
+            if base_time is None:
+                base_time = r["median"]
+
+            r.update({
+                "name": name,
+                "dataset": suite.BENCHMARKS[name]["kind"],
+                "N": bN,
+                "d": bd,
+                "threads": t,
+                "speedup": base_time / r["median"] if r["median"] > 0 else None,
+            })
+            results.append(r)
+
+            if verbose:
+                print("{:<28} N={:<7} d={:<3} threads={:<3} median={:.6f}s min={:.6f}s speedup={:.2f}".format(
+                    name, bN, bd, t, r["median"], r["min"], r["speedup"]))
+
+    pbn.set_num_threads(previous_threads)
+    return results
+
+
+def compare(results, baseline, threshold):
+    """
+    Prints the ratio between the median times of results and baseline. Returns the number of regressions: the benchmarks
+    that are slower than the baseline by more than threshold (a fraction of the baseline time).
+    """
+    key = lambda r: (r["name"], r["N"], r["d"], r["threads"])
+    previous = {key(r): r for r in baseline["benchmarks"]}
+
+    regressions = 0
+    print()
+    print("Comparison with {} (commit {}):".format(baseline.get("date"), baseline.get("commit")))
+    for r in results:
+        old = previous.get(key(r))
+        if old is None:
+            continue
+
+        ratio = r["median"] / old["median"]
+        status = ""
+        if ratio > 1 + threshold:
+            status = "REGRESSION"
+            regressions += 1
+        elif ratio < 1 - threshold:
+            status = "improvement"
+
+        print("{:<28} threads={:<3} {:.6f}s -> {:.6f}s ({:+.1f}%) {}".format(
+            r["name"], r["threads"], old["median"], r["median"], 100 * (ratio - 1), status))
+
+    return regressions
+
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(description="PyBNesian benchmark suite.")
+    parser.add_argument("--size", choices=list(suite.SIZES.keys()), default="small")
+    parser.add_argument("-N", type=int, help="Number of instances. It overrides --size.")
+    parser.add_argument("-d", type=int, help="Number of variables. It overrides --size.")
+    parser.add_argument("--threads", type=int, nargs="+", default=[1, pbn.num_threads()])
+    parser.add_argument("--repetitions", type=int, default=5)
+    parser.add_argument("--warmup", type=int, default=1)
+    parser.add_argument("--filter", default=None, help="Regular expression to select the benchmarks.")
+    parser.add_argument("--output", default=None, help="JSON file where the results are saved.")
+    parser.add_argument("--compare", default=None, help="JSON baseline to compare with.")
+    parser.add_argument("--threshold",
+                        type=float,
+                        default=0.1,
+                        help="Relative slowdown with respect to the baseline reported as a regression.")
+    args = parser.parse_args(argv)
+
+    N = args.N if args.N is not None else suite.SIZES[args.size]["N"]
+    d = args.d if args.d is not None else suite.SIZES[args.size]["d"]
+    threads = sorted(set(args.threads))
+
+    names = [n for n in suite.BENCHMARKS if args.filter is None or re.search(args.filter, n)]
+    results = run_suite(names, N, d, threads, args.repetitions, args.warmup)
+
+    output = {
+        "format_version": FORMAT_VERSION,
+        "date": datetime.datetime.now().isoformat(),
+        "commit": git_commit(),
+        "pybnesian_version": getattr(pbn, "__version__", None),
+        "python": platform.python_version(),
+        "platform": platform.platform(),
+        "cpu_count": os.cpu_count(),
+        "benchmarks": results,
+    }
+
+    if args.output is not None:
+        with open(args.output, "w") as f:
+            json.dump(output, f, indent=2)
+
+    if args.compare is not None:
+        with open(args.compare) as f:
+            baseline = json.load(f)
+
+        if compare(results, baseline, args.threshold) > 0:
+            return 1
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
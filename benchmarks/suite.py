@@ -0,0 +1,203 @@
+import pybnesian as pbn
+
+import datasets
+
+# Benchmarks of the hot paths of PyBNesian. Each benchmark is a function that receives the problem size (N, d) and
+# returns a callable with the code to measure, so the setup (data generation, fitting, etc.) is not measured.
+#
+# The kernels of the KDE (Kernel<T>) and the k-d/VP trees are not exposed to Python. They are measured through
+# KDE.logl/CKDE.sample and KMutualInformation.pvalue, which spend most of their time in them.
+
+BENCHMARKS = {}
+
+# Problem sizes of each benchmark. "small" runs in a few seconds and is used by the pytest layer.
+SIZES = {
+    "small": {"N": 1000, "d": 6},
+    "medium": {"N": 10000, "d": 10},
+    "large": {"N": 100000, "d": 20},
+}
+
+
+def benchmark(name, kind, max_N=None, max_d=None):
+    """
+    Registers a benchmark. ``max_N`` and ``max_d`` limit the size of the quadratic (KDE) or very expensive (PC, MMHC)
+    benchmarks.
+    """
+
+    def register(f):
+        BENCHMARKS[name] = {"setup": f, "kind": kind, "max_N": max_N, "max_d": max_d}
+        return f
+
+    return register
+
+
+def problem_size(name, N, d):
+    b = BENCHMARKS[name]
+    if b["max_N"] is not None:
+        N = min(N, b["max_N"])
+    if b["max_d"] is not None:
+        d = min(d, b["max_d"])
+    return N, d
+
+
+def data(kind, N, d, seed=0):
+    return datasets.generate(kind, N, d, seed)
+
+
+# KDE
+
+
+@benchmark("kde_logl", "gaussian", max_N=20000)
+def kde_logl(N, d):
+    df, _ = data("gaussian", N, d)
+    kde = pbn.KDE(list(df.columns[:3]))
+    kde.fit(df)
+    return lambda: kde.logl(df)
+
+
+@benchmark("kde_logl_float", "gaussian", max_N=20000)
+def kde_logl_float(N, d):
+    df, _ = data("gaussian", N, d)
+    df = df.astype("float32")
+    kde = pbn.KDE(list(df.columns[:3]))
+    kde.fit(df)
+    return lambda: kde.logl(df)
+
+
+@benchmark("kde_logl_1d", "gaussian", max_N=20000)
+def kde_logl_1d(N, d):
+    df, _ = data("gaussian", N, d)
+    kde = pbn.KDE([df.columns[0]])
+    kde.fit(df)
+    return lambda: kde.logl(df)
+
+
+@benchmark("kde_logl_1d_sorted_window", "gaussian")
+def kde_logl_1d_sorted_window(N, d):
+    df, _ = data("gaussian", N, d)
+    kde = pbn.KDE([df.columns[0]])
+    kde.univariate_method = pbn.UnivariateKDEMethod.SortedWindow
+    kde.fit(df)
+    return lambda: kde.logl(df)
+
+
+@benchmark("kde_logl_1d_binned", "gaussian")
+def kde_logl_1d_binned(N, d):
+    df, _ = data("gaussian", N, d)
+    kde = pbn.KDE([df.columns[0]])
+    kde.univariate_method = pbn.UnivariateKDEMethod.Binned
+    kde.fit(df)
+    return lambda: kde.logl(df)
+
+
+@benchmark("productkde_logl", "gaussian", max_N=20000)
+def productkde_logl(N, d):
+    df, _ = data("gaussian", N, d)
+    kde = pbn.ProductKDE(list(df.columns[:3]))
+    kde.fit(df)
+    return lambda: kde.logl(df)
+
+
+@benchmark("ckde_sample", "gaussian", max_N=20000)
+def ckde_sample(N, d):
+    df, _ = data("gaussian", N, d)
+    cpd = pbn.CKDE(df.columns[2], list(df.columns[:2]))
+    cpd.fit(df)
+    evidence = df.iloc[:, :2]
+    return lambda: cpd.sample(N, evidence, 0)
+
+
+# Scores
+
+
+def _local_score_benchmark(score_class, kind, N, d, bn_type, **kwargs):
+    df, arcs = data(kind, N, d)
+    score = score_class(df, **kwargs)
+    model = bn_type(list(df.columns), arcs)
+    nodes = list(df.columns)
+
+    def run():
+        for n in nodes:
+            score.local_score(model, n)
+
+    return run
+
+
+@benchmark("bic_local_score", "gaussian")
+def bic_local_score(N, d):
+    return _local_score_benchmark(pbn.BIC, "gaussian", N, d, pbn.GaussianNetwork)
+
+
+@benchmark("bge_local_score", "gaussian")
+def bge_local_score(N, d):
+    return _local_score_benchmark(pbn.BGe, "gaussian", N, d, pbn.GaussianNetwork)
+
+
+@benchmark("cvlikelihood_local_score", "nonlinear", max_N=5000, max_d=8)
+def cvlikelihood_local_score(N, d):
+    df, arcs = data("nonlinear", N, d)
+    score = pbn.CVLikelihood(df, k=5, seed=0)
+    model = pbn.SemiparametricBN(list(df.columns), arcs, [(n, pbn.CKDEType()) for n in df.columns])
+    nodes = list(df.columns)
+
+    def run():
+        for n in nodes:
+            score.local_score(model, n)
+
+    return run
+
+
+# Independence tests
+
+
+def _pvalue_benchmark(test, nodes):
+    tests = [(nodes[0], nodes[1], []), (nodes[0], nodes[1], [nodes[2]]), (nodes[1], nodes[2], [nodes[0], nodes[3]])]
+
+    def run():
+        for x, y, z in tests:
+            test.pvalue(x, y, z)
+
+    return run
+
+
+@benchmark("linearcorrelation_pvalue", "gaussian")
+def linearcorrelation_pvalue(N, d):
+    df, _ = data("gaussian", N, d)
+    return _pvalue_benchmark(pbn.LinearCorrelation(df), list(df.columns))
+
+
+@benchmark("kmutualinformation_pvalue", "nonlinear", max_N=5000)
+def kmutualinformation_pvalue(N, d):
+    df, _ = data("nonlinear", N, d)
+    return _pvalue_benchmark(pbn.KMutualInformation(df, k=10, seed=0, samples=50), list(df.columns))
+
+
+# Structure learning
+
+
+@benchmark("hc_gaussian_bic", "gaussian")
+def hc_gaussian_bic(N, d):
+    df, _ = data("gaussian", N, d)
+    return lambda: pbn.hc(df, bn_type=pbn.GaussianNetworkType(), score="bic", seed=0)
+
+
+@benchmark("hc_clg_bic", "clg")
+def hc_clg_bic(N, d):
+    df, _ = data("clg", N, d)
+    return lambda: pbn.hc(df, bn_type=pbn.CLGNetworkType(), score="bic", seed=0)
+
+
+@benchmark("pc_gaussian", "gaussian", max_d=15)
+def pc_gaussian(N, d):
+    df, _ = data("gaussian", N, d)
+    test = pbn.LinearCorrelation(df)
+    return lambda: pbn.PC().estimate(test)
+
+
+@benchmark("mmhc_gaussian", "gaussian", max_d=15)
+def mmhc_gaussian(N, d):
+    df, _ = data("gaussian", N, d)
+    test = pbn.LinearCorrelation(df)
+    score = pbn.BIC(df)
+    operators = pbn.ArcOperatorSet()
+    return lambda: pbn.MMHC().estimate(test, operators, score)
@@ -0,0 +1,26 @@
+# pytest-benchmark layer of the benchmark suite. It runs each benchmark of suite.py with the "small" size:
+#
+#     pytest benchmarks --benchmark-json=baseline.json
+#     pytest benchmarks --benchmark-compare=<saved run> --benchmark-compare-fail=median:10%
+#
+# These benchmarks are not collected by the functional tests (pytest.ini only collects the tests directory).
+import os
+import sys
+
+import pytest
+
+pytest.importorskip("pytest_benchmark")
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+
+import suite
+
+
+@pytest.mark.parametrize("name", list(suite.BENCHMARKS.keys()))
+def test_benchmark(benchmark, name):
+    N, d = suite.problem_size(name, suite.SIZES["small"]["N"], suite.SIZES["small"]["d"])
+    run = suite.BENCHMARKS[name]["setup"](N, d)
+
+    benchmark.group = suite.BENCHMARKS[name]["kind"]
+    benchmark.extra_info.update({"N": N, "d": d})
+    benchmark(run)
@@ -418,54 +418,24 @@ def get_topological_sort_node_types():
 
     
     
-def build_operator_entry_score_and_search(idx, bn, delta_raw_df):
-    session_dict = session_objects[session.get('session_id')]
-
-    source_idx = idx % len(delta_raw_df)
-    target_idx = idx//len(delta_raw_df)
-
-    source = bn.collapsed_name(source_idx)
-    target = bn.collapsed_name(target_idx)
-
-    if bn.has_arc(source, target):
-        op = pbn.RemoveArc(
-            source, target, delta_raw_df.iloc[source_idx, target_idx])
-    elif bn.has_arc(target, source) and bn.can_flip_arc(target, source):
-        if session_dict['limited_indegree'] and bn.num_parents(target) >= session_dict['max_parents']:
-            return [np.nan] * 4
-        op = pbn.FlipArc(
-            target, source, delta_raw_df.iloc[source_idx, target_idx])
-    elif bn.can_add_arc(source, target):
-        if session_dict['limited_indegree'] and bn.num_parents(target) >= session_dict['max_parents']:
-            return [np.nan] * 4
-        op = pbn.AddArc(
-            source, target, delta_raw_df.iloc[source_idx, target_idx])
-    else:
-        return [np.nan] * 4
-
-    return [type(op).__name__, op.source(), op.target(), op.delta()]
+# Name of the FactorType class of each factor (as returned by FactorType.__str__).
+FACTOR_TYPE_CLASSES = {'CKDEFactor': 'CKDEType', 'LinearGaussianFactor': 'LinearGaussianCPDType'}
 
 def build_operator_df_score_and_search():
     session_dict = session_objects[session.get('session_id')]
     bn = session_dict['bn']
     op_set = session_dict['op_set']
-    delta_raw_df = pd.DataFrame(
-        op_set.get_op_sets()[0].get_delta(), columns=bn.nodes(), index=bn.nodes())
-    # Build the list of delta entries
-    delta_operations = [
-        build_operator_entry_score_and_search(idx, bn, delta_raw_df)
-        for idx in range(delta_raw_df.size)
-    ]
-
-    if session_dict['allow_kde']:
-        delta = op_set.get_op_sets()[1].get_delta()
-        type_changes_ops_idx = np.nonzero([len(x) for x in delta])[0]
-        type_changes_ops = [['ChangeNodeType', bn.nodes()[i], ('CKDEType' if str(bn.node_type(bn.nodes(
-        )[i])) == 'LinearGaussianFactor' else 'LinearGaussianCPDType'), delta[i][0]] for i in type_changes_ops_idx]
-        delta_operations += type_changes_ops
+    op_set.set_max_indegree(
+        session_dict['max_parents'] if session_dict['limited_indegree'] else 0)
+    # The legal operators are filtered in C++, and returned as a pyarrow.RecordBatch.
+    operators = op_set.legal_operators(bn).to_pandas()
 
-    operator_df = pd.DataFrame(
-        delta_operations, columns=session_dict['table_colnames'])
+    # The table shows the new node type of ChangeNodeType in the target column.
+    change_node_type = operators['type'] == 'ChangeNodeType'
+    operators.loc[change_node_type, 'target'] = operators.loc[change_node_type, 'node_type'].map(FACTOR_TYPE_CLASSES)
+
+    operator_df = operators[['type', 'source', 'target', 'delta']].set_axis(
+        session_dict['table_colnames'], axis=1)
     return operator_df
 
 def build_operator_df_constraint_based():
@@ -0,0 +1,175 @@
+#include <dataset/chunked_dataframe.hpp>
+#include <util/arrow_macros.hpp>
+
+using arrow::RecordBatch, arrow::Type;
+
+namespace dataset {
+
+WeightedMoments merge_moments(const WeightedMoments& a, const WeightedMoments& b) {
+    if (b.total_weight == 0) return a;
+    if (a.total_weight == 0) return b;
+
+    WeightedMoments res;
+    res.total_weight = a.total_weight + b.total_weight;
+
+    VectorXd delta = b.means - a.means;
+    res.means = a.means + delta * (b.total_weight / res.total_weight);
+    res.sse = a.sse + b.sse + delta * delta.transpose() * (a.total_weight * b.total_weight / res.total_weight);
+    return res;
+}
+
+namespace {
+
+void check_same_dictionaries(const std::vector<DataFrame>& chunks) {
+    const auto& first = chunks[0];
+
+    for (int i = 0; i < first->num_columns(); ++i) {
+        if (first.col(i)->type_id() != Type::DICTIONARY) continue;
+
+        auto dictionary = std::static_pointer_cast<arrow::DictionaryArray>(first.col(i))->dictionary();
+        for (size_t j = 1; j < chunks.size(); ++j) {
+            auto other = std::static_pointer_cast<arrow::DictionaryArray>(chunks[j].col(i))->dictionary();
+            if (!dictionary->Equals(other)) {
+                throw std::invalid_argument("Column \"" + first.name(i) + "\" has different categories in chunk " +
+                                            std::to_string(j) +
+                                            ". Unify the dictionaries (e.g. with pyarrow.Table.unify_dictionaries()).");
+            }
+        }
+    }
+}
+
+std::vector<DataFrame> table_chunks(const std::shared_ptr<arrow::Table>& table) {
+    arrow::TableBatchReader reader(*table);
+
+    std::vector<DataFrame> chunks;
+    while (true) {
+        std::shared_ptr<RecordBatch> batch;
+        RAISE_STATUS_ERROR(reader.ReadNext(&batch));
+        if (!batch) break;
+        chunks.push_back(DataFrame(batch));
+    }
+
+    if (chunks.empty()) {
+        std::shared_ptr<RecordBatch> empty;
+        RAISE_RESULT_ERROR(empty, RecordBatch::MakeEmpty(table->schema()))
+        chunks.push_back(DataFrame(empty));
+    }
+
+    return chunks;
+}
+
+template <typename T>
+WeightedMoments chunked_moments(const std::vector<DataFrame>& chunks, const std::vector<T>& columns) {
+    auto res = weighted_moments(chunks[0], columns);
+    for (size_t i = 1; i < chunks.size(); ++i) {
+        res = merge_moments(res, weighted_moments(chunks[i], columns));
+    }
+
+    return res;
+}
+
+Array_ptr take_indices(const std::vector<int64_t>::const_iterator& begin,
+                       const std::vector<int64_t>::const_iterator& end,
+                       int64_t offset) {
+    arrow::Int64Builder builder;
+    RAISE_STATUS_ERROR(builder.Reserve(std::distance(begin, end)));
+    for (auto it = begin; it != end; ++it) builder.UnsafeAppend(*it - offset);
+
+    Array_ptr out;
+    RAISE_STATUS_ERROR(builder.Finish(&out));
+    return out;
+}
+
+}  // namespace
+
+ChunkedDataFrame::ChunkedDataFrame(std::vector<DataFrame> chunks) : m_chunks(std::move(chunks)), m_num_rows(0) {
+    if (m_chunks.empty()) throw std::invalid_argument("ChunkedDataFrame must have at least one chunk.");
+
+    const auto& schema = m_chunks[0]->schema();
+    for (size_t i = 1; i < m_chunks.size(); ++i) {
+        if (!schema->Equals(*m_chunks[i]->schema(), true)) {
+            throw std::invalid_argument("Chunk " + std::to_string(i) + " has a different schema:\n" +
+                                        m_chunks[i]->schema()->ToString() + "\nExpected schema:\n" +
+                                        schema->ToString());
+        }
+    }
+
+    check_same_dictionaries(m_chunks);
+
+    for (const auto& chunk : m_chunks) m_num_rows += chunk->num_rows();
+
+    if (m_chunks.size() == 1)
+        m_schema_df = m_chunks[0];
+    else
+        m_schema_df = m_chunks[0].slice(0, 0);
+}
+
+ChunkedDataFrame::ChunkedDataFrame(const std::shared_ptr<arrow::Table>& table)
+    : ChunkedDataFrame(table_chunks(table)) {}
+
+WeightedMoments ChunkedDataFrame::moments(const std::vector<std::string>& columns) const {
+    return chunked_moments(m_chunks, columns);
+}
+
+WeightedMoments ChunkedDataFrame::moments(const std::vector<int>& columns) const {
+    return chunked_moments(m_chunks, columns);
+}
+
+MatrixXd ChunkedDataFrame::cov(const std::vector<std::string>& columns) const {
+    auto m = moments(columns);
+    return m.sse / (m.total_weight - 1);
+}
+
+DataFrame ChunkedDataFrame::take(const std::vector<int64_t>& indices) const {
+    std::vector<int64_t> offsets;
+    offsets.reserve(m_chunks.size() + 1);
+    offsets.push_back(0);
+    for (const auto& chunk : m_chunks) offsets.push_back(offsets.back() + chunk->num_rows());
+
+    for (auto index : indices) {
+        if (index < 0 || index >= m_num_rows)
+            throw std::invalid_argument("Index " + std::to_string(index) + " out of bounds for " +
+                                        std::to_string(m_num_rows) + " rows.");
+    }
+
+    if (m_chunks.size() == 1) return m_chunks[0].take(take_indices(indices.begin(), indices.end(), 0));
+    if (indices.empty()) return m_chunks[0].slice(0, 0);
+
+    // Each run of consecutive indices in the same chunk is taken from that chunk.
+    std::vector<std::shared_ptr<RecordBatch>> batches;
+    auto run_begin = indices.begin();
+    while (run_begin != indices.end()) {
+        auto chunk = std::upper_bound(offsets.begin(), offsets.end(), *run_begin) - offsets.begin() - 1;
+        auto run_end = std::find_if(run_begin, indices.end(), [&offsets, chunk](int64_t index) {
+            return index < offsets[chunk] || index >= offsets[chunk + 1];
+        });
+
+        auto taken = m_chunks[chunk].take(take_indices(run_begin, run_end, offsets[chunk]));
+        batches.push_back(taken.record_batch());
+        run_begin = run_end;
+    }
+
+    if (batches.size() == 1) return DataFrame(batches[0]);
+
+    std::shared_ptr<arrow::Table> table;
+    RAISE_RESULT_ERROR(table, arrow::Table::FromRecordBatches(batches))
+    return DataFrame(table_to_record_batch(table));
+}
+
+ChunkedDataFrame read_chunked_ipc(const std::string& path, const std::vector<std::string>& columns, bool memory_map) {
+    auto batches = read_ipc_batches(path, columns, memory_map);
+
+    std::vector<DataFrame> chunks;
+    chunks.reserve(batches.size());
+    for (const auto& batch : batches) {
+        // The included fields are read in the order of the file.
+        if (columns.empty())
+            chunks.push_back(DataFrame(batch));
+        else
+            chunks.push_back(DataFrame(batch).loc(columns));
+    }
+
+    return ChunkedDataFrame(std::move(chunks));
+}
+
+}  // namespace dataset
@@ -0,0 +1,99 @@
+#ifndef PYBNESIAN_DATASET_CHUNKED_DATAFRAME_HPP
+#define PYBNESIAN_DATASET_CHUNKED_DATAFRAME_HPP
+
+#include <dataset/dataset.hpp>
+
+namespace dataset {
+
+// Moments of the union of two disjoint sets of rows (pairwise update of Chan et al.).
+WeightedMoments merge_moments(const WeightedMoments& a, const WeightedMoments& b);
+
+// Data split in record batches with the same schema: the chunks of a pyarrow.Table or the record batches of an Arrow
+// IPC file. The chunks are never concatenated. The sufficient statistics (moments and counts) are computed on each
+// chunk and merged, so the extra memory does not depend on the number of rows. The categorical columns must have the
+// same dictionary in every chunk.
+class ChunkedDataFrame {
+public:
+    explicit ChunkedDataFrame(const DataFrame& df) : ChunkedDataFrame(std::vector<DataFrame>{df}) {}
+    explicit ChunkedDataFrame(std::vector<DataFrame> chunks);
+    // The record batches are slices of the chunks of the table, so the data is not copied.
+    explicit ChunkedDataFrame(const std::shared_ptr<arrow::Table>& table);
+
+    int num_chunks() const { return m_chunks.size(); }
+    const DataFrame& chunk(int i) const { return m_chunks[i]; }
+    const std::vector<DataFrame>& chunks() const { return m_chunks; }
+    int64_t num_rows() const { return m_num_rows; }
+
+    // Schema of the data, with the dictionaries of the categorical columns. With a single chunk, it is the chunk.
+    // Otherwise, it is an empty slice of the first chunk: it can be used to check the columns and their types, but
+    // not to compute statistics.
+    const DataFrame& schema_df() const { return m_schema_df; }
+    bool has_weights() const { return m_schema_df.has_weights(); }
+    // True if the statistics must be merged with moments() and the weighted counts, because the rows are weighted or
+    // split in several chunks.
+    bool requires_moments() const { return has_weights() || num_chunks() > 1; }
+
+    template <typename... Args>
+    int64_t null_count(const Args&... args) const {
+        int64_t res = 0;
+        for (const auto& chunk : m_chunks) res += chunk.null_count(args...);
+        return res;
+    }
+
+    template <typename... Args>
+    int64_t valid_rows(const Args&... args) const {
+        int64_t res = 0;
+        for (const auto& chunk : m_chunks) res += chunk.valid_rows(args...);
+        return res;
+    }
+
+    template <typename... Args>
+    double total_weight(const Args&... args) const {
+        double res = 0;
+        for (const auto& chunk : m_chunks) res += chunk.total_weight(args...);
+        return res;
+    }
+
+    WeightedMoments moments(const std::vector<std::string>& columns) const;
+    WeightedMoments moments(const std::vector<int>& columns) const;
+    VectorXd means(const std::vector<std::string>& columns) const { return moments(columns).means; }
+    // Sample covariance of the rows that are valid in all the columns.
+    MatrixXd cov(const std::vector<std::string>& columns) const;
+
+    // Matrix with the rows of every chunk that are valid in all the columns. The chunks are copied into the matrix one
+    // by one.
+    template <bool append_ones, typename ArrowType>
+    EigenMatrix<ArrowType> to_eigen(const std::vector<std::string>& columns) const;
+
+    // Rows at the positions indices (of the whole data) in a single DataFrame.
+    DataFrame take(const std::vector<int64_t>& indices) const;
+
+private:
+    std::vector<DataFrame> m_chunks;
+    DataFrame m_schema_df;
+    int64_t m_num_rows;
+};
+
+template <bool append_ones, typename ArrowType>
+EigenMatrix<ArrowType> ChunkedDataFrame::to_eigen(const std::vector<std::string>& columns) const {
+    using MatrixType = typename EigenMatrix<ArrowType>::element_type;
+
+    auto res = std::make_unique<MatrixType>(valid_rows(columns), columns.size() + append_ones);
+
+    int64_t offset = 0;
+    for (const auto& chunk : m_chunks) {
+        // Only one chunk is converted at a time.
+        auto m = chunk.template to_eigen<append_ones, ArrowType>(columns);
+        res->middleRows(offset, m->rows()) = *m;
+        offset += m->rows();
+    }
+
+    return res;
+}
+
+// Reads the record batches of an Arrow IPC file without concatenating them.
+ChunkedDataFrame read_chunked_ipc(const std::string& path, const std::vector<std::string>& columns, bool memory_map);
+
+}  // namespace dataset
+
+#endif  // PYBNESIAN_DATASET_CHUNKED_DATAFRAME_HPP
@@ -143,6 +143,10 @@ public:
     CrossValidation loc(const Args&... args) const {
         return CrossValidation(m_df.loc(args...), prop);
     }
+    // loc() of the columns that keeps the weights column (see DataFrame::loc_weighted()).
+    CrossValidation loc_weighted(const std::vector<std::string>& cols) const {
+        return CrossValidation(m_df.loc_weighted(cols), prop);
+    }
 
     class cv_iterator_indices {
     public:
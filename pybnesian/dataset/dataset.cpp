@@ -1,4 +1,12 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <random>
+#include <unordered_map>
 #include <arrow/api.h>
+#include <arrow/io/file.h>
+#include <arrow/ipc/reader.h>
 #include <arrow/util/align_util.h>
 #include <arrow/util/bitmap_ops.h>
 #include <arrow/python/pyarrow.h>
@@ -6,6 +14,8 @@
 #include <Eigen/Dense>
 #include <util/parameter_traits.hpp>
 #include <util/basic_eigen_ops.hpp>
+#include <util/hash_utils.hpp>
+#include <util/profiling.hpp>
 
 using Eigen::MatrixXd;
 
@@ -46,6 +56,30 @@ py::object pandas_to_pyarrow_array(py::handle pyobject) {
     return d;
 }
 
+std::shared_ptr<RecordBatch> table_to_record_batch(const std::shared_ptr<arrow::Table>& table) {
+    auto combined = table;
+    for (const auto& column : table->columns()) {
+        if (column->num_chunks() > 1) {
+            RAISE_RESULT_ERROR(combined, table->CombineChunks())
+            break;
+        }
+    }
+
+    Array_vector columns;
+    columns.reserve(combined->num_columns());
+    for (const auto& column : combined->columns()) {
+        if (column->num_chunks() == 0) {
+            Array_ptr empty;
+            RAISE_RESULT_ERROR(empty, arrow::MakeArrayOfNull(column->type(), 0))
+            columns.push_back(std::move(empty));
+        } else {
+            columns.push_back(column->chunk(0));
+        }
+    }
+
+    return RecordBatch::Make(combined->schema(), combined->num_rows(), columns);
+}
+
 std::shared_ptr<RecordBatch> to_record_batch(py::handle data) {
     PyObject* py_ptr = data.ptr();
 
@@ -56,6 +90,13 @@ std::shared_ptr<RecordBatch> to_record_batch(py::handle data) {
         } else {
             throw std::runtime_error("pyarrow's RecordBatch could not be converted.");
         }
+    } else if (pyarrow::is_table(py_ptr)) {
+        auto result = pyarrow::unwrap_table(py_ptr);
+        if (result.ok()) {
+            return table_to_record_batch(result.ValueOrDie());
+        } else {
+            throw std::runtime_error("pyarrow's Table could not be converted.");
+        }
     } else if (is_pandas_dataframe(data)) {
         auto a = pandas_to_pyarrow_record_batch(data);
         auto result = pyarrow::unwrap_batch(a.ptr());
@@ -66,7 +107,8 @@ std::shared_ptr<RecordBatch> to_record_batch(py::handle data) {
             throw std::runtime_error("pyarrow's RecordBatch could not be converted.");
         }
     } else {
-        throw std::invalid_argument("\'data\' parameter should be a pyarrow's RecordBatch or a pandas DataFrame. ");
+        throw std::invalid_argument(
+            "\'data\' parameter should be a pyarrow's RecordBatch, a pyarrow's Table or a pandas DataFrame. ");
     }
 
     return nullptr;
@@ -127,13 +169,422 @@ Array_ptr copy_array_dictionary(const Array_ptr& array) {
     return std::make_shared<arrow::DictionaryArray>(array->type(), new_indices, new_dictionary);
 }
 
+std::vector<std::shared_ptr<RecordBatch>> read_ipc_batches(const std::string& path,
+                                                           const std::vector<std::string>& columns,
+                                                           bool memory_map) {
+    std::shared_ptr<arrow::io::RandomAccessFile> file;
+    if (memory_map) {
+        RAISE_RESULT_ERROR(file, arrow::io::MemoryMappedFile::Open(path, arrow::io::FileMode::READ))
+    } else {
+        RAISE_RESULT_ERROR(file, arrow::io::ReadableFile::Open(path))
+    }
+
+    auto options = arrow::ipc::IpcReadOptions::Defaults();
+    if (!columns.empty()) {
+        // Only the footer is read to find the indices of the columns.
+        std::shared_ptr<arrow::ipc::RecordBatchFileReader> schema_reader;
+        RAISE_RESULT_ERROR(schema_reader, arrow::ipc::RecordBatchFileReader::Open(file))
+        auto schema = schema_reader->schema();
+
+        for (const auto& name : columns) {
+            auto index = schema->GetFieldIndex(name);
+            if (index == -1) throw std::invalid_argument("Column \"" + name + "\" not found in " + path + ".");
+            options.included_fields.push_back(index);
+        }
+    }
+
+    std::shared_ptr<arrow::ipc::RecordBatchFileReader> reader;
+    {
+        RAISE_RESULT_ERROR(reader, arrow::ipc::RecordBatchFileReader::Open(file, options))
+    }
+
+    std::vector<std::shared_ptr<RecordBatch>> batches;
+    batches.reserve(reader->num_record_batches());
+    for (int i = 0; i < reader->num_record_batches(); ++i) {
+        std::shared_ptr<RecordBatch> batch;
+        RAISE_RESULT_ERROR(batch, reader->ReadRecordBatch(i))
+        batches.push_back(std::move(batch));
+    }
+
+    if (batches.empty()) {
+        std::shared_ptr<RecordBatch> empty;
+        RAISE_RESULT_ERROR(empty, RecordBatch::MakeEmpty(reader->schema()))
+        batches.push_back(std::move(empty));
+    }
+
+    return batches;
+}
+
+DataFrame read_ipc(const std::string& path, const std::vector<std::string>& columns, bool memory_map) {
+    auto batches = read_ipc_batches(path, columns, memory_map);
+
+    DataFrame df = [&batches]() {
+        if (batches.size() == 1) return DataFrame(batches[0]);
+
+        std::shared_ptr<arrow::Table> table;
+        RAISE_RESULT_ERROR(table, arrow::Table::FromRecordBatches(batches))
+        return DataFrame(table_to_record_batch(table));
+    }();
+
+    // The included fields are read in the order of the file.
+    if (!columns.empty()) return df.loc(columns);
+    return df;
+}
+
+DataFrame bootstrap_sample(const DataFrame& df, unsigned int seed) {
+    auto num_rows = df->num_rows();
+    if (num_rows == 0) return df;
+
+    std::mt19937 rng{seed};
+    std::uniform_int_distribution<int64_t> row(0, num_rows - 1);
+
+    arrow::Int64Builder builder;
+    RAISE_STATUS_ERROR(builder.Reserve(num_rows));
+    for (int64_t i = 0; i < num_rows; ++i) {
+        builder.UnsafeAppend(row(rng));
+    }
+
+    Array_ptr indices;
+    RAISE_STATUS_ERROR(builder.Finish(&indices));
+    return df.take(indices);
+}
+
+DataFrame bootstrap_weights(const DataFrame& df, unsigned int seed) {
+    auto num_rows = df->num_rows();
+    std::mt19937 rng{seed};
+    std::vector<double> counts(num_rows, 0);
+
+    if (num_rows > 0) {
+        if (df.has_weights()) {
+            auto raw_weights = std::static_pointer_cast<arrow::DoubleArray>(df.weights())->raw_values();
+            auto num_draws = std::llround(std::accumulate(raw_weights, raw_weights + num_rows, 0.));
+
+            std::discrete_distribution<int64_t> row(raw_weights, raw_weights + num_rows);
+            for (int64_t i = 0; i < num_draws; ++i) {
+                ++counts[row(rng)];
+            }
+        } else {
+            // The same rows as bootstrap_sample() with the same seed.
+            std::uniform_int_distribution<int64_t> row(0, num_rows - 1);
+            for (int64_t i = 0; i < num_rows; ++i) {
+                ++counts[row(rng)];
+            }
+        }
+    }
+
+    arrow::DoubleBuilder builder;
+    RAISE_STATUS_ERROR(builder.AppendValues(counts));
+    Array_ptr weights;
+    RAISE_STATUS_ERROR(builder.Finish(&weights));
+
+    auto columns = df.columns();
+    if (df.has_weights()) {
+        columns[df.weights_index()] = weights;
+        return DataFrame(RecordBatch::Make(df->schema(), num_rows, columns));
+    }
+
+    // The weights column is appended, so the indices of the rest of the columns do not change.
+    std::string name = "bootstrap_weights";
+    while (df->schema()->GetFieldIndex(name) != -1) name = "_" + name;
+
+    auto schema = df->schema();
+    auto metadata = schema->metadata() ? schema->metadata()->Copy() : std::make_shared<arrow::KeyValueMetadata>();
+    RAISE_STATUS_ERROR(metadata->Set(weights_metadata_key, name));
+
+    auto fields = schema->fields();
+    fields.push_back(arrow::field(name, arrow::float64()));
+    columns.push_back(weights);
+
+    return DataFrame(RecordBatch::Make(arrow::schema(fields, metadata), num_rows, columns));
+}
+
+int DataFrame::find_weights(const std::shared_ptr<RecordBatch>& rb) {
+    auto metadata = rb->schema()->metadata();
+    if (!metadata) return -1;
+
+    auto key = metadata->FindKey(weights_metadata_key);
+    if (key == -1) return -1;
+
+    // The mark is ignored if the weights column is not in the DataFrame, e.g. if the column was not selected.
+    const auto& name = metadata->value(key);
+    auto index = rb->schema()->GetFieldIndex(name);
+    if (index == -1) return -1;
+
+    auto column = rb->column(index);
+    if (column->type_id() != Type::DOUBLE)
+        throw std::invalid_argument("The weights column \"" + name + "\" must be of type double.");
+    if (column->null_count() > 0)
+        throw std::invalid_argument("The weights column \"" + name + "\" contains null values.");
+
+    return index;
+}
+
+DataFrame DataFrame::loc_weighted(const std::vector<std::string>& columns) const {
+    if (!has_weights()) return loc(columns);
+
+    std::vector<std::string> weighted_columns(columns);
+    weighted_columns.push_back(name(m_weights));
+    auto selected = loc(weighted_columns);
+
+    auto metadata = arrow::key_value_metadata({weights_metadata_key}, {name(m_weights)});
+    return DataFrame(RecordBatch::Make(
+        selected->schema()->WithMetadata(metadata), selected->num_rows(), selected.columns()));
+}
+
+double DataFrame::sum_weights(const Buffer_ptr& bitmap) const {
+    auto raw_weights = std::static_pointer_cast<arrow::DoubleArray>(weights())->raw_values();
+    auto rows = num_rows();
+
+    double total = 0;
+    if (!bitmap) {
+        for (auto i = 0; i < rows; ++i) {
+            total += raw_weights[i];
+        }
+    } else {
+        auto bitmap_data = bitmap->data();
+        for (auto i = 0; i < rows; ++i) {
+            if (util::bit_util::GetBit(bitmap_data, i)) total += raw_weights[i];
+        }
+    }
+
+    return total;
+}
+
+VectorXd DataFrame::weights_vector(const Buffer_ptr& bitmap) const {
+    auto rows = num_rows();
+    auto valid_rows = bitmap ? util::bit_util::non_null_count(bitmap, rows) : rows;
+
+    if (!has_weights()) return VectorXd::Ones(valid_rows);
+
+    auto raw_weights = std::static_pointer_cast<arrow::DoubleArray>(weights())->raw_values();
+    if (!bitmap) return Map<const VectorXd>(raw_weights, rows);
+
+    VectorXd res(valid_rows);
+    auto bitmap_data = bitmap->data();
+    for (auto i = 0, j = 0; i < rows; ++i) {
+        if (util::bit_util::GetBit(bitmap_data, i)) res(j++) = raw_weights[i];
+    }
+
+    return res;
+}
+
+DataFrame with_weights(const DataFrame& df, const std::string& column) {
+    auto index = df.index(column);
+    if (index == -1) throw std::invalid_argument("Column \"" + column + "\" not found in DataFrame.");
+
+    auto weights = df.col(index);
+    if (!arrow::is_integer(weights->type_id()) && !arrow::is_floating(weights->type_id()))
+        throw std::invalid_argument("The weights column \"" + column + "\" must be numeric.");
+    if (weights->null_count() > 0)
+        throw std::invalid_argument("The weights column \"" + column + "\" contains null values.");
+
+    if (weights->type_id() != Type::DOUBLE) {
+        RAISE_RESULT_ERROR(weights, arrow::compute::Cast(*weights, arrow::float64()))
+    }
+
+    auto raw_weights = std::static_pointer_cast<arrow::DoubleArray>(weights)->raw_values();
+    for (int64_t i = 0; i < weights->length(); ++i) {
+        if (!(raw_weights[i] >= 0) || std::isinf(raw_weights[i]))
+            throw std::invalid_argument("The weights must be finite and non-negative.");
+    }
+
+    auto schema = df->schema();
+    auto metadata = schema->metadata() ? schema->metadata()->Copy() : std::make_shared<arrow::KeyValueMetadata>();
+    RAISE_STATUS_ERROR(metadata->Set(weights_metadata_key, column));
+
+    auto fields = schema->fields();
+    fields[index] = arrow::field(column, arrow::float64());
+    auto columns = df.columns();
+    columns[index] = weights;
+
+    return DataFrame(RecordBatch::Make(arrow::schema(fields, metadata), df->num_rows(), columns));
+}
+
+DataFrame without_weights(const DataFrame& df) {
+    auto schema = df->schema();
+    if (!schema->metadata() || schema->metadata()->FindKey(weights_metadata_key) == -1) return df;
+
+    auto metadata = schema->metadata()->Copy();
+    RAISE_STATUS_ERROR(metadata->Delete(weights_metadata_key));
+
+    return DataFrame(RecordBatch::Make(schema->WithMetadata(metadata), df->num_rows(), df.columns()));
+}
+
+DataFrame expand_weights(const DataFrame& df) {
+    if (!df.has_weights()) return df;
+
+    auto raw_weights = std::static_pointer_cast<arrow::DoubleArray>(df.weights())->raw_values();
+    auto num_rows = df->num_rows();
+
+    int64_t expanded_rows = 0;
+    for (int64_t i = 0; i < num_rows; ++i) {
+        if (raw_weights[i] != std::floor(raw_weights[i]))
+            throw std::invalid_argument("The weights must be integers to repeat the rows of the DataFrame.");
+        expanded_rows += static_cast<int64_t>(raw_weights[i]);
+    }
+
+    arrow::Int64Builder builder;
+    RAISE_STATUS_ERROR(builder.Reserve(expanded_rows));
+    for (int64_t i = 0; i < num_rows; ++i) {
+        for (int64_t j = 0, repetitions = static_cast<int64_t>(raw_weights[i]); j < repetitions; ++j) {
+            builder.UnsafeAppend(i);
+        }
+    }
+
+    Array_ptr indices;
+    RAISE_STATUS_ERROR(builder.Finish(&indices));
+    return without_weights(df).take(indices);
+}
+
+// Stores the dictionary codes of a column in codes[i * num_columns + column], or -1 if the row i is null.
+template <typename ArrowType>
+void fill_dictionary_codes(std::vector<int64_t>& codes, const Array_ptr& indices, int num_columns, int column) {
+    using ArrayType = typename arrow::TypeTraits<ArrowType>::ArrayType;
+    auto dwn_indices = std::static_pointer_cast<ArrayType>(indices);
+    auto raw_indices = dwn_indices->raw_values();
+
+    for (int64_t i = 0; i < dwn_indices->length(); ++i) {
+        codes[i * num_columns + column] = dwn_indices->IsValid(i) ? static_cast<int64_t>(raw_indices[i]) : -1;
+    }
+}
+
+DataFrame deduplicate(const DataFrame& df, const std::string& weights_name) {
+    std::vector<int> columns;
+    for (int i = 0; i < df->num_columns(); ++i) {
+        if (i == df.weights_index()) continue;
+
+        if (df.col(i)->type_id() != Type::DICTIONARY)
+            throw std::invalid_argument("deduplicate() needs discrete data, but column \"" + df.name(i) +
+                                        "\" is not discrete.");
+        if (df.name(i) == weights_name)
+            throw std::invalid_argument("Column \"" + weights_name + "\" already exists in DataFrame.");
+
+        columns.push_back(i);
+    }
+
+    int64_t num_rows = df->num_rows();
+    int num_columns = columns.size();
+
+    std::vector<int64_t> codes(num_rows * num_columns);
+    for (int c = 0; c < num_columns; ++c) {
+        auto indices = std::static_pointer_cast<arrow::DictionaryArray>(df.col(columns[c]))->indices();
+        switch (indices->type_id()) {
+            case Type::INT8:
+                fill_dictionary_codes<arrow::Int8Type>(codes, indices, num_columns, c);
+                break;
+            case Type::INT16:
+                fill_dictionary_codes<arrow::Int16Type>(codes, indices, num_columns, c);
+                break;
+            case Type::INT32:
+                fill_dictionary_codes<arrow::Int32Type>(codes, indices, num_columns, c);
+                break;
+            case Type::INT64:
+                fill_dictionary_codes<arrow::Int64Type>(codes, indices, num_columns, c);
+                break;
+            default:
+                throw std::invalid_argument("Wrong indices array type of DictionaryArray.");
+        }
+    }
+
+    // The rows are represented by the index of their first occurrence.
+    auto row_hash = [&codes, num_columns](int64_t row) {
+        std::size_t seed = num_columns;
+        for (int c = 0; c < num_columns; ++c) {
+            util::hash_combine(seed, codes[row * num_columns + c]);
+        }
+        return seed;
+    };
+    auto row_equal = [&codes, num_columns](int64_t a, int64_t b) {
+        auto begin_a = codes.begin() + a * num_columns;
+        return std::equal(begin_a, begin_a + num_columns, codes.begin() + b * num_columns);
+    };
+
+    std::unordered_map<int64_t, int64_t, decltype(row_hash), decltype(row_equal)> unique_rows(
+        num_rows, row_hash, row_equal);
+
+    auto weights = df.weights_vector(nullptr);
+    std::vector<int64_t> first_rows;
+    std::vector<double> counts;
+
+    for (int64_t i = 0; i < num_rows; ++i) {
+        auto [it, inserted] = unique_rows.insert({i, static_cast<int64_t>(first_rows.size())});
+        if (inserted) {
+            first_rows.push_back(i);
+            counts.push_back(0);
+        }
+
+        counts[it->second] += weights(i);
+    }
+
+    arrow::Int64Builder indices_builder;
+    RAISE_STATUS_ERROR(indices_builder.AppendValues(first_rows));
+    Array_ptr take_indices;
+    RAISE_STATUS_ERROR(indices_builder.Finish(&take_indices));
+
+    arrow::DoubleBuilder weights_builder;
+    RAISE_STATUS_ERROR(weights_builder.AppendValues(counts));
+    Array_ptr weights_array;
+    RAISE_STATUS_ERROR(weights_builder.Finish(&weights_array));
+
+    auto unique_df = df.loc(columns).take(take_indices);
+
+    auto fields = unique_df->schema()->fields();
+    fields.push_back(arrow::field(weights_name, arrow::float64()));
+    auto unique_columns = unique_df.columns();
+    unique_columns.push_back(weights_array);
+
+    auto metadata = arrow::key_value_metadata({weights_metadata_key}, {weights_name});
+    return DataFrame(
+        RecordBatch::Make(arrow::schema(fields, metadata), static_cast<int64_t>(first_rows.size()), unique_columns));
+}
+
+template <typename T>
+WeightedMoments weighted_moments_impl(const DataFrame& df, const std::vector<T>& columns) {
+    auto bitmap = df.combined_bitmap(columns);
+    auto w = df.weights_vector(bitmap);
+
+    WeightedMoments moments;
+    moments.total_weight = w.sum();
+
+    if (columns.empty()) {
+        moments.means = VectorXd(0);
+        moments.sse = MatrixXd(0, 0);
+        return moments;
+    }
+
+    MatrixXd X = [&df, &columns]() -> MatrixXd {
+        switch (df.same_type(columns)->id()) {
+            case Type::DOUBLE:
+                return *df.to_eigen<false, arrow::DoubleType>(columns);
+            case Type::FLOAT:
+                return df.to_eigen<false, arrow::FloatType>(columns)->template cast<double>();
+            default:
+                throw std::invalid_argument("Weighted moments can only be computed for continuous columns.");
+        }
+    }();
+
+    moments.means = X.transpose() * w / moments.total_weight;
+    X.rowwise() -= moments.means.transpose();
+    moments.sse = X.transpose() * w.asDiagonal() * X;
+
+    return moments;
+}
+
+WeightedMoments weighted_moments(const DataFrame& df, const std::vector<std::string>& columns) {
+    return weighted_moments_impl(df, columns);
+}
+
+WeightedMoments weighted_moments(const DataFrame& df, const std::vector<int>& columns) {
+    return weighted_moments_impl(df, columns);
+}
+
 std::vector<std::string> DataFrame::column_names() const {
     auto schema = m_batch->schema();
     std::vector<std::string> names;
     names.reserve(schema->num_fields());
 
     for (int i = 0, num_fields = schema->num_fields(); i < num_fields; ++i) {
-        names.push_back(schema->field(i)->name());
+        if (i != m_weights) names.push_back(schema->field(i)->name());
     }
 
     return names;
@@ -147,45 +598,123 @@ int64_t null_count(Array_iterator begin, Array_iterator end) {
     return r;
 }
 
-Buffer_ptr combined_bitmap(Array_iterator begin, Array_iterator end) {
-    if (null_count(begin, end) > 0) {
-        Array_iterator first_null_col = end;
+// Computes the AND of the validity bitmaps of the columns, which must have nulls.
+Validity combined_validity_with_null(const Array_vector& null_columns, int64_t length) {
+    if (null_columns.size() == 1 && null_columns[0]->offset() == 0) {
+        return Validity{null_columns[0]->null_bitmap(), length - null_columns[0]->null_count()};
+    }
 
-        for (auto it = begin; it < end; ++it) {
-            if ((*it)->null_count() != 0) {
-                first_null_col = it;
-                break;
-            }
+    // The bitmaps of sliced columns are copied, so all the bitmaps start at bit 0.
+    std::vector<Buffer_ptr> aligned;
+    std::vector<const uint8_t*> bitmaps;
+    bitmaps.reserve(null_columns.size());
+    for (const auto& col : null_columns) {
+        if (col->offset() == 0) {
+            bitmaps.push_back(col->null_bitmap_data());
+        } else {
+            Buffer_ptr copy;
+            RAISE_RESULT_ERROR(copy,
+                               arrow::internal::CopyBitmap(
+                                   arrow::default_memory_pool(), col->null_bitmap_data(), col->offset(), length))
+            bitmaps.push_back(copy->data());
+            aligned.push_back(std::move(copy));
+        }
+    }
+
+    std::shared_ptr<Buffer> bitmap;
+    {
+        RAISE_RESULT_ERROR(bitmap, arrow::AllocateBuffer((length + 7) / 8))
+    }
+    auto valid = util::bit_util::bitmap_and_count(bitmaps, length, bitmap->mutable_data());
+    return Validity{bitmap, valid};
+}
+
+Validity combined_validity(Array_iterator begin, Array_iterator end) {
+    if (std::distance(begin, end) == 0) {
+        return Validity{nullptr, 0};
+    }
+
+    auto length = (*begin)->length();
+
+    Array_vector null_columns;
+    for (auto it = begin; it != end; ++it) {
+        if ((*it)->null_count() > 0) null_columns.push_back(*it);
+    }
+
+    if (null_columns.empty()) return Validity{nullptr, length};
+
+    return combined_validity_with_null(null_columns, length);
+}
+
+Buffer_ptr combined_bitmap(Array_iterator begin, Array_iterator end) { return combined_validity(begin, end).bitmap; }
+
+int64_t valid_rows(Array_iterator begin, Array_iterator end) { return combined_validity(begin, end).valid_rows; }
+
+size_t ValidityCache::KeyHash::operator()(const std::vector<int>& key) const {
+    size_t seed = key.size();
+    for (auto index : key) {
+        util::hash_combine(seed, index);
+    }
+    return seed;
+}
+
+ValidityCache::ValidityCache(const std::shared_ptr<RecordBatch>& rb)
+    : m_null_columns(), m_mutex(), m_cache(), m_cached_bytes(0) {
+    for (int i = 0, num_columns = rb->num_columns(); i < num_columns; ++i) {
+        const auto& data = rb->column_data(i);
+        if (data->GetNullCount() > 0) m_null_columns.insert({data.get(), i});
+    }
+}
+
+Validity ValidityCache::combined_validity(const Array_vector& columns) const {
+    if (columns.empty()) return Validity{nullptr, 0};
+
+    auto length = columns[0]->length();
+
+    std::vector<int> key;
+    Array_vector null_columns;
+    bool cacheable = true;
+    for (const auto& col : columns) {
+        if (col->null_count() == 0) continue;
+
+        auto found = m_null_columns.find(col->data().get());
+        if (found != m_null_columns.end()) {
+            key.push_back(found->second);
+        } else {
+            cacheable = false;
         }
 
-        auto res = Buffer::Copy((*first_null_col)->null_bitmap(), arrow::default_cpu_memory_manager());
-        auto bitmap = std::move(res).ValueOrDie();
+        null_columns.push_back(col);
+    }
 
-        for (auto it = ++first_null_col; it < end; ++it) {
-            auto col = *it;
-            if (col->null_count()) {
-                auto other_bitmap = col->null_bitmap();
+    if (null_columns.empty()) return Validity{nullptr, length};
+    // A single column does not need to AND the bitmaps.
+    if (!cacheable || null_columns.size() == 1) return combined_validity_with_null(null_columns, length);
 
-                arrow::internal::BitmapAnd(
-                    bitmap->data(), 0, other_bitmap->data(), 0, (*first_null_col)->length(), 0, bitmap->mutable_data());
-            }
+    std::sort(key.begin(), key.end());
+    key.erase(std::unique(key.begin(), key.end()), key.end());
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto found = m_cache.find(key);
+        if (found != m_cache.end()) {
+            util::profiling::count("validity_cache/hits");
+            return found->second;
         }
-        return bitmap;
-    } else {
-        return nullptr;
     }
-}
 
-int64_t valid_rows(Array_iterator begin, Array_iterator end) {
-    if (std::distance(begin, end) == 0) {
-        return 0;
+    util::profiling::count("validity_cache/misses");
+    auto validity = combined_validity_with_null(null_columns, length);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto bytes = validity.bitmap->size();
+    if (m_cached_bytes + bytes > max_cached_bytes) {
+        m_cache.clear();
+        m_cached_bytes = 0;
     }
 
-    auto bitmap = combined_bitmap(begin, end);
-    if (bitmap)
-        return util::bit_util::non_null_count(bitmap, (*begin)->length());
-    else
-        return (*begin)->length();
+    if (m_cache.insert({std::move(key), validity}).second) m_cached_bytes += bytes;
+    return validity;
 }
 
 std::string index_to_string(int i) { return std::to_string(i); }
@@ -217,7 +746,7 @@ std::vector<int> DataFrame::discrete_columns() const {
 
     for (int i = 0; i < m_batch->num_columns(); ++i) {
         auto column = m_batch->column(i);
-        if (column->type_id() == Type::DICTIONARY) {
+        if (i != m_weights && column->type_id() == Type::DICTIONARY) {
             res.push_back(i);
         }
     }
@@ -230,6 +759,7 @@ std::vector<int> DataFrame::continuous_columns() const {
 
     arrow::Type::type dt = arrow::Type::NA;
     for (int i = 0; i < m_batch->num_columns() && dt == Type::NA; ++i) {
+        if (i == m_weights) continue;
         auto column = m_batch->column(i);
         switch (column->type_id()) {
             case Type::DOUBLE:
@@ -247,6 +777,7 @@ std::vector<int> DataFrame::continuous_columns() const {
     }
 
     for (int i = res[0] + 1; i < m_batch->num_columns(); ++i) {
+        if (i == m_weights) continue;
         auto column = m_batch->column(i);
 
         switch (column->type_id()) {
@@ -362,6 +893,10 @@ DataFrame DataFrame::normalize() const {
 
     for (auto i = 0; i < this->num_columns(); ++i) {
         auto column = col(i);
+        if (i == m_weights) {
+            columns.push_back(column);
+            continue;
+        }
 
         switch (column->type_id()) {
             case Type::DOUBLE: {
@@ -382,4 +917,202 @@ DataFrame DataFrame::normalize() const {
     return DataFrame(arrow::RecordBatch::Make(m_batch->schema(), this->num_rows(), columns));
 }
 
+namespace {
+
+// Visits the values of BOOL and binary-like (string) arrays as byte sequences: value(data, length) is called for each
+// valid element and null(i) for each null. The values are read from the buffers with the offset of the array, so the
+// result does not depend on how the buffers are sliced.
+template <typename Value, typename Null>
+void visit_variable_values(const Array_ptr& array, Value value, Null null) {
+    auto visit_binary = [&](const auto& binary_array) {
+        for (int64_t i = 0; i < binary_array.length(); ++i) {
+            if (binary_array.IsValid(i)) {
+                auto view = binary_array.GetView(i);
+                value(reinterpret_cast<const uint8_t*>(view.data()), static_cast<int64_t>(view.size()));
+            } else {
+                null(i);
+            }
+        }
+    };
+
+    switch (array->type_id()) {
+        case Type::BOOL: {
+            const auto& bool_array = static_cast<const arrow::BooleanArray&>(*array);
+            for (int64_t i = 0; i < bool_array.length(); ++i) {
+                if (bool_array.IsValid(i)) {
+                    uint8_t v = bool_array.Value(i);
+                    value(&v, 1);
+                } else {
+                    null(i);
+                }
+            }
+            break;
+        }
+        case Type::STRING:
+        case Type::BINARY:
+            visit_binary(static_cast<const arrow::BinaryArray&>(*array));
+            break;
+        case Type::LARGE_STRING:
+        case Type::LARGE_BINARY:
+            visit_binary(static_cast<const arrow::LargeBinaryArray&>(*array));
+            break;
+        default:
+            throw std::invalid_argument("Data type " + array->type()->ToString() + " cannot be hashed.");
+    }
+}
+
+// 64-bit FNV-1a.
+void fnv1a_hash(uint64_t& hash, const uint8_t* data, int64_t length) {
+    for (int64_t i = 0; i < length; ++i) {
+        hash ^= data[i];
+        hash *= 1099511628211ULL;
+    }
+}
+
+void fnv1a_hash(uint64_t& hash, const std::string& s) {
+    fnv1a_hash(hash, reinterpret_cast<const uint8_t*>(s.data()), s.size());
+}
+
+void fnv1a_hash(uint64_t& hash, int64_t v) { fnv1a_hash(hash, reinterpret_cast<const uint8_t*>(&v), sizeof(v)); }
+
+void fingerprint_array(uint64_t& hash, const Array_ptr& array) {
+    fnv1a_hash(hash, array->type()->ToString());
+    fnv1a_hash(hash, array->length());
+    fnv1a_hash(hash, array->null_count());
+
+    if (array->type_id() == Type::DICTIONARY) {
+        auto dict_array = std::static_pointer_cast<arrow::DictionaryArray>(array);
+        fingerprint_array(hash, dict_array->dictionary());
+        fingerprint_array(hash, dict_array->indices());
+        return;
+    }
+
+    auto fixed_width = dynamic_cast<const arrow::FixedWidthType*>(array->type().get());
+    if (fixed_width && array->type_id() != Type::BOOL) {
+        auto byte_width = fixed_width->bit_width() / 8;
+        // buffers[1] does not apply the offset of the array.
+        auto values = array->data()->buffers[1]->data() + array->offset() * byte_width;
+
+        if (array->null_count() == 0) {
+            fnv1a_hash(hash, values, array->length() * byte_width);
+        } else {
+            // The values under a null are undefined.
+            for (int64_t i = 0; i < array->length(); ++i) {
+                if (array->IsValid(i)) {
+                    fnv1a_hash(hash, values + i * byte_width, byte_width);
+                } else {
+                    fnv1a_hash(hash, i);
+                }
+            }
+        }
+    } else {
+        // The length of each value is hashed, so the boundaries between the strings change the fingerprint.
+        visit_variable_values(
+            array,
+            [&hash](const uint8_t* data, int64_t length) {
+                fnv1a_hash(hash, length);
+                fnv1a_hash(hash, data, length);
+            },
+            [&hash](int64_t i) { fnv1a_hash(hash, i); });
+    }
+}
+
+}  // namespace
+
+uint64_t DataFrame::fingerprint() const {
+    uint64_t hash = 14695981039346656037ULL;
+    fnv1a_hash(hash, m_batch->schema()->ToString());
+    fnv1a_hash(hash, m_batch->num_rows());
+    fnv1a_hash(hash, static_cast<int64_t>(m_weights));
+
+    for (const auto& column : m_batch->columns()) {
+        fingerprint_array(hash, column);
+    }
+
+    return hash;
+}
+
+constexpr uint64_t hash_prime1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t hash_prime2 = 0xC2B2AE3D27D4EB4FULL;
+
+inline uint64_t rotl64(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+
+inline uint64_t hash_round(uint64_t acc, uint64_t word) { return rotl64(acc + word * hash_prime2, 31) * hash_prime1; }
+
+inline uint64_t hash_finalize(uint64_t h) {
+    h ^= h >> 33;
+    h *= hash_prime2;
+    h ^= h >> 29;
+    h *= hash_prime1;
+    h ^= h >> 32;
+    return h;
+}
+
+// Hashes 8 bytes at a time with 4 independent accumulators, so the multiplications are pipelined. FNV-1a hashes one
+// byte per multiplication, which is an order of magnitude slower.
+uint64_t hash_bytes(uint64_t seed, const uint8_t* data, int64_t length) {
+    uint64_t acc[4] = {seed + hash_prime1, seed + hash_prime2, seed, seed - hash_prime1};
+
+    int64_t i = 0;
+    for (; i + 32 <= length; i += 32) {
+        for (int l = 0; l < 4; ++l) {
+            uint64_t word;
+            std::memcpy(&word, data + i + 8 * l, 8);
+            acc[l] = hash_round(acc[l], word);
+        }
+    }
+
+    uint64_t h = rotl64(acc[0], 1) + rotl64(acc[1], 7) + rotl64(acc[2], 12) + rotl64(acc[3], 18);
+    for (; i + 8 <= length; i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, 8);
+        h = hash_round(h, word);
+    }
+
+    for (; i < length; ++i) {
+        h = hash_round(h, data[i]);
+    }
+
+    return hash_finalize(h ^ static_cast<uint64_t>(length));
+}
+
+uint64_t array_hash(const Array_ptr& array) {
+    auto type_string = array->type()->ToString();
+    auto h = hash_bytes(static_cast<uint64_t>(array->length()),
+                        reinterpret_cast<const uint8_t*>(type_string.data()),
+                        type_string.size());
+
+    if (array->type_id() == Type::DICTIONARY) {
+        auto dict_array = std::static_pointer_cast<arrow::DictionaryArray>(array);
+        return hash_finalize(hash_round(array_hash(dict_array->dictionary()), array_hash(dict_array->indices())) ^ h);
+    }
+
+    auto fixed_width = dynamic_cast<const arrow::FixedWidthType*>(array->type().get());
+    if (fixed_width && array->type_id() != Type::BOOL) {
+        auto byte_width = fixed_width->bit_width() / 8;
+        // buffers[1] does not apply the offset of the array.
+        auto values = array->data()->buffers[1]->data() + array->offset() * byte_width;
+
+        if (array->null_count() == 0) return hash_bytes(h, values, array->length() * byte_width);
+
+        // The values under a null are undefined, so only the valid values and the positions of the nulls are hashed.
+        for (int64_t i = 0; i < array->length(); ++i) {
+            if (array->IsValid(i)) {
+                h = hash_bytes(h, values + i * byte_width, byte_width);
+            } else {
+                h = hash_round(h, static_cast<uint64_t>(i));
+            }
+        }
+
+        return hash_finalize(h);
+    }
+
+    // BOOL and string arrays: each valid value is hashed with its length, and each null with its position.
+    visit_variable_values(
+        array,
+        [&h](const uint8_t* data, int64_t length) { h = hash_bytes(h, data, length); },
+        [&h](int64_t i) { h = hash_round(h, static_cast<uint64_t>(i)); });
+    return hash_finalize(h);
+}
+
 }  // namespace dataset
@@ -1,6 +1,8 @@
 #ifndef PYBNESIAN_DATASET_DATASET_HPP
 #define PYBNESIAN_DATASET_DATASET_HPP
 
+#include <mutex>
+#include <unordered_map>
 #include <Eigen/Dense>
 #include <arrow/python/pyarrow.h>
 #include <arrow/python/platform.h>
@@ -30,6 +32,9 @@ namespace dataset {
 bool is_pandas_dataframe(py::handle pyobject);
 bool is_pandas_series(py::handle pyobject);
 
+// Converts a Table to a RecordBatch. If every column has at most one chunk, the RecordBatch shares the buffers of the
+// Table. Otherwise, the chunks are concatenated.
+std::shared_ptr<RecordBatch> table_to_record_batch(const std::shared_ptr<arrow::Table>& table);
 std::shared_ptr<RecordBatch> to_record_batch(py::handle pyobject);
 py::object pandas_to_pyarrow_record_batch(py::handle pyobject);
 py::object pandas_to_pyarrow_array(py::handle pyobject);
@@ -71,6 +76,47 @@ int64_t null_count(Array_iterator begin, Array_iterator end);
 Buffer_ptr combined_bitmap(Array_iterator begin, Array_iterator end);
 int64_t valid_rows(Array_iterator begin, Array_iterator end);
 
+// Combined validity bitmap of a set of columns (nullptr if no column has nulls) and its number of valid rows. The
+// bitmap always starts at bit 0, even if the columns are sliced.
+struct Validity {
+    Buffer_ptr bitmap;
+    int64_t valid_rows;
+};
+
+Validity combined_validity(Array_iterator begin, Array_iterator end);
+
+// Cache of the combined validity of the column sets of a RecordBatch, shared by all the copies of a DataFrame. The
+// columns without nulls do not change the combined bitmap, so the key is the sorted indices of the columns with
+// nulls. Columns that do not belong to the RecordBatch (e.g., copied columns) are not cached.
+class ValidityCache {
+public:
+    // Maximum total size of the cached bitmaps. The cache is cleared when it is full.
+    static constexpr int64_t max_cached_bytes = int64_t{64} << 20;
+
+    ValidityCache(const std::shared_ptr<RecordBatch>& rb);
+
+    // True if any column of the RecordBatch has nulls. It is computed when the cache is created.
+    bool has_nulls() const { return !m_null_columns.empty(); }
+
+    Validity combined_validity(const Array_vector& columns) const;
+
+private:
+    struct KeyHash {
+        size_t operator()(const std::vector<int>& key) const;
+    };
+
+    // Column index of the ArrayData of each column with nulls.
+    std::unordered_map<const arrow::ArrayData*, int> m_null_columns;
+    mutable std::mutex m_mutex;
+    mutable std::unordered_map<std::vector<int>, Validity, KeyHash> m_cache;
+    mutable int64_t m_cached_bytes;
+};
+
+// Hash of the type and the (valid) values of an array. It is much faster than DataFrame::fingerprint(), but it can
+// change between versions of the library, so it must not be saved. It is used to check that an in-memory cached result
+// was computed with the same data.
+uint64_t array_hash(const Array_ptr& array);
+
 template <bool append_ones, typename ArrowType>
 inline typename ArrowType::c_type* fill_ones(typename ArrowType::c_type* ptr, int rows [[maybe_unused]]) {
     if constexpr (append_ones) {
@@ -1033,18 +1079,24 @@ public:
     }
 
     ///////////////////////////// combined_bitmap /////////////////////////
+    // The combined_bitmap(), null_count() and valid_rows() functions return immediately if the DataFrame has no nulls.
+    // Otherwise, the combined bitmaps are read from the cache of the Derived class (see ValidityCache).
     Buffer_ptr combined_bitmap() const {
-        Array_vector cols = derived().columns();
-        return dataset::combined_bitmap(cols.begin(), cols.end());
+        if (!derived().has_nulls()) return nullptr;
+        return derived().columns_validity(derived().columns()).bitmap;
     }
     template <typename Index, enable_if_index_t<Index, int> = 0>
     Buffer_ptr combined_bitmap(const Index& index) const {
-        return derived().col(index)->null_bitmap();
+        auto col = derived().col(index);
+        // The bitmap of a sliced column is copied, so it starts at bit 0.
+        if (col->offset() == 0 || col->null_count() == 0) return col->null_bitmap();
+        return derived().columns_validity(Array_vector{col}).bitmap;
     }
     template <typename T, util::enable_if_index_container_t<T, int> = 0>
     Buffer_ptr combined_bitmap(const T& cols) const {
+        if (!derived().has_nulls()) return nullptr;
         Array_vector v = indices_to_columns(cols);
-        return dataset::combined_bitmap(v.begin(), v.end());
+        return derived().columns_validity(v).bitmap;
     }
     template <typename V>
     Buffer_ptr combined_bitmap(const std::initializer_list<V>& cols) const {
@@ -1052,8 +1104,9 @@ public:
     }
     template <typename IndexIter, util::enable_if_index_iterator_t<IndexIter, int> = 0>
     Buffer_ptr combined_bitmap(const IndexIter& begin, const IndexIter& end) const {
+        if (!derived().has_nulls()) return nullptr;
         Array_vector v = indices_to_columns(begin, end);
-        return dataset::combined_bitmap(v.begin(), v.end());
+        return derived().columns_validity(v).bitmap;
     }
     template <typename IndexIter, util::enable_if_index_iterator_t<IndexIter, int> = 0>
     Buffer_ptr combined_bitmap(const std::pair<IndexIter, IndexIter>& tuple) const {
@@ -1061,21 +1114,25 @@ public:
     }
     template <typename... Args, typename = std::enable_if_t<(... && !util::is_iterator_v<Args>), void>>
     Buffer_ptr combined_bitmap(const Args&... args) const {
+        if (!derived().has_nulls()) return nullptr;
         Array_vector v = indices_to_columns(args...);
-        return dataset::combined_bitmap(v.begin(), v.end());
+        return derived().columns_validity(v).bitmap;
     }
 
     ///////////////////////////// null_count /////////////////////////
     int64_t null_count() const {
+        if (!derived().has_nulls()) return 0;
         auto cols = derived().columns();
         return dataset::null_count(cols.begin(), cols.end());
     }
     template <typename Index, enable_if_index_t<Index, int> = 0>
     int64_t null_count(const Index& index) const {
+        if (!derived().has_nulls()) return 0;
         return derived().col(index)->null_count();
     }
     template <typename T, util::enable_if_index_container_t<T, int> = 0>
     int64_t null_count(const T& cols) const {
+        if (!derived().has_nulls()) return 0;
         Array_vector v = indices_to_columns(cols);
         return dataset::null_count(v.begin(), v.end());
     }
@@ -1085,6 +1142,7 @@ public:
     }
     template <typename IndexIter, util::enable_if_index_iterator_t<IndexIter, int> = 0>
     int64_t null_count(const IndexIter& begin, const IndexIter& end) const {
+        if (!derived().has_nulls()) return 0;
         Array_vector v = indices_to_columns(begin, end);
         return dataset::null_count(v.begin(), v.end());
     }
@@ -1094,14 +1152,15 @@ public:
     }
     template <typename... Args, typename = std::enable_if_t<(... && !util::is_iterator_v<Args>), void>>
     int64_t null_count(const Args&... args) const {
+        if (!derived().has_nulls()) return 0;
         Array_vector v = indices_to_columns(args...);
         return dataset::null_count(v.begin(), v.end());
     }
 
     ///////////////////////////// valid_rows /////////////////////////
     int64_t valid_rows() const {
-        auto cols = derived().columns();
-        return dataset::valid_rows(cols.begin(), cols.end());
+        if (!derived().has_nulls()) return derived().num_columns() > 0 ? derived().num_rows() : 0;
+        return derived().columns_validity(derived().columns()).valid_rows;
     }
     template <typename Index, enable_if_index_t<Index, int> = 0>
     int64_t valid_rows(const Index& index) const {
@@ -1117,8 +1176,9 @@ public:
     }
     template <typename IndexIter, util::enable_if_index_iterator_t<IndexIter, int> = 0>
     int64_t valid_rows(const IndexIter& begin, const IndexIter& end) const {
+        if (!derived().has_nulls()) return begin != end ? derived().num_rows() : 0;
         auto v = indices_to_columns(begin, end);
-        return dataset::valid_rows(v.begin(), v.end());
+        return derived().columns_validity(v).valid_rows;
     }
     template <typename IndexIter, util::enable_if_index_iterator_t<IndexIter, int> = 0>
     int64_t valid_rows(const std::pair<IndexIter, IndexIter>& tuple) const {
@@ -1126,8 +1186,13 @@ public:
     }
     template <typename... Args, typename = std::enable_if_t<(... && !util::is_iterator_v<Args>), void>>
     int64_t valid_rows(const Args&... args) const {
+        if (!derived().has_nulls()) {
+            auto num_columns = derived().num_columns();
+            return (size_argument(num_columns, args) + ...) > 0 ? derived().num_rows() : 0;
+        }
+
         auto v = indices_to_columns(args...);
-        return dataset::valid_rows(v.begin(), v.end());
+        return derived().columns_validity(v).valid_rows;
     }
 
     ///////////////////////////// min /////////////////////////
@@ -1942,12 +2007,22 @@ typename DataFrameBase<Derived>::loc_return DataFrameBase<Derived>::loc(const Ar
     return DataFrame(RecordBatch::Make(schema, derived().num_rows(), columns));
 }
 
+// Key of the schema metadata that stores the name of the weights column of a DataFrame (see with_weights()).
+inline constexpr const char* weights_metadata_key = "pybnesian:weights";
+
 class DataFrame : public DataFrameBase<DataFrame> {
 public:
-    DataFrame() : m_batch(arrow::RecordBatch::Make(arrow::schema({}), 0, Array_vector())) {}
-    DataFrame(int64_t num_rows) : m_batch(arrow::RecordBatch::Make(arrow::schema({}), num_rows, Array_vector())) {}
-
-    DataFrame(std::shared_ptr<RecordBatch> rb) : m_batch(rb) {}
+    DataFrame()
+        : m_batch(arrow::RecordBatch::Make(arrow::schema({}), 0, Array_vector())),
+          m_validity(std::make_shared<ValidityCache>(m_batch)),
+          m_weights(-1) {}
+    DataFrame(int64_t num_rows)
+        : m_batch(arrow::RecordBatch::Make(arrow::schema({}), num_rows, Array_vector())),
+          m_validity(std::make_shared<ValidityCache>(m_batch)),
+          m_weights(-1) {}
+
+    DataFrame(std::shared_ptr<RecordBatch> rb)
+        : m_batch(rb), m_validity(std::make_shared<ValidityCache>(m_batch)), m_weights(find_weights(m_batch)) {}
 
     const std::shared_ptr<RecordBatch>& record_batch() const { return m_batch; }
 
@@ -1959,7 +2034,8 @@ public:
 
     int num_columns() const { return m_batch->num_columns(); }
 
-    int num_variables() const { return m_batch->num_columns(); }
+    // Number of columns, excluding the weights column.
+    int num_variables() const { return m_batch->num_columns() - has_weights(); }
 
     bool has_column(int index) const {
         if (index < 0 || index >= m_batch->num_columns()) {
@@ -2036,7 +2112,38 @@ public:
     std::vector<int> discrete_columns() const;
     std::vector<int> continuous_columns() const;
 
+    // The rows of a DataFrame can have frequency weights: a row with weight w counts as w repetitions of the row. The
+    // weights column is not a variable of the data, so it is not returned by column_names(), discrete_columns() or
+    // continuous_columns(). The weights are kept by slice() and take(), but not by loc().
+    bool has_weights() const { return m_weights != -1; }
+    int weights_index() const { return m_weights; }
+    Array_ptr weights() const {
+        if (!has_weights()) throw std::invalid_argument("DataFrame does not have weights.");
+        return m_batch->column(m_weights);
+    }
+    // loc() of the columns that keeps the weights column, if the DataFrame has weights.
+    DataFrame loc_weighted(const std::vector<std::string>& columns) const;
+    // Sum of the weights of the rows set in the bitmap (all the rows if the bitmap is null).
+    double sum_weights(const Buffer_ptr& bitmap) const;
+    // Weights of the rows set in the bitmap (all the rows if the bitmap is null). The weights are 1 if the DataFrame
+    // does not have weights.
+    VectorXd weights_vector(const Buffer_ptr& bitmap) const;
+    // Sum of the weights of the valid rows of the columns. It is equal to valid_rows(args...) if the DataFrame does not
+    // have weights.
+    template <typename... Args>
+    double total_weight(const Args&... args) const {
+        if (!has_weights()) return static_cast<double>(valid_rows(args...));
+        return sum_weights(combined_bitmap(args...));
+    }
+
+    // True if any column has nulls. It is computed when the DataFrame is created.
+    bool has_nulls() const { return m_validity->has_nulls(); }
+    Validity columns_validity(const Array_vector& columns) const { return m_validity->combined_validity(columns); }
+
     DataFrame normalize() const;
+    // Hash of the schema and the (valid) values of the DataFrame. Two DataFrames with the same data have the same
+    // fingerprint, even if their buffers are sliced differently.
+    uint64_t fingerprint() const;
 
     DataFrame filter_null() const {
         if (null_count() == 0) {
@@ -2073,8 +2180,54 @@ public:
                                                             const std::vector<std::vector<int>::iterator>& test_limits);
 
 private:
+    static int find_weights(const std::shared_ptr<RecordBatch>& rb);
+
     std::shared_ptr<RecordBatch> m_batch;
+    std::shared_ptr<ValidityCache> m_validity;
+    // Index of the weights column, or -1 if the DataFrame does not have weights.
+    int m_weights;
+};
+
+// Record batches of an Arrow IPC (Feather V2) file. If memory_map is true, the columns are not loaded in memory: they
+// are backed by the memory-mapped file, so the operating system reads (and evicts) the pages as they are used. Only
+// the columns are read if the list is not empty.
+std::vector<std::shared_ptr<RecordBatch>> read_ipc_batches(const std::string& path,
+                                                           const std::vector<std::string>& columns,
+                                                           bool memory_map);
+// Reads an Arrow IPC file in a DataFrame (see read_ipc_batches()). A file with a single record batch is read without
+// copies. Otherwise, the record batches are concatenated: use read_chunked_ipc() to keep them separated.
+DataFrame read_ipc(const std::string& path, const std::vector<std::string>& columns, bool memory_map);
+
+// Bootstrap resample of the DataFrame: num_rows() rows sampled uniformly with replacement.
+DataFrame bootstrap_sample(const DataFrame& df, unsigned int seed);
+// Bootstrap resample of the DataFrame as frequency weights (see with_weights()): the weight of each row is the number
+// of times it is drawn, so the columns of df are shared and only the weights column is allocated. The rows of a
+// weighted DataFrame are drawn proportionally to their weights, as if each row was repeated (see expand_weights()).
+DataFrame bootstrap_weights(const DataFrame& df, unsigned int seed);
+
+// Returns the DataFrame with the column as weights. The weights must be non-negative and not null. They are converted
+// to double.
+DataFrame with_weights(const DataFrame& df, const std::string& column);
+// Returns the DataFrame without the weights mark. The weights column is kept as a normal column.
+DataFrame without_weights(const DataFrame& df);
+// Repeats each row of the DataFrame as many times as its weight, so the result does not have weights. The weights
+// must be integers.
+DataFrame expand_weights(const DataFrame& df);
+// Collapses the repeated rows of a discrete DataFrame into its unique rows, with a weights column named weights_name
+// that counts the repetitions of each row (or sums their weights if df already has weights). Two rows are equal if
+// they have the same categories, or nulls, in all the columns.
+DataFrame deduplicate(const DataFrame& df, const std::string& weights_name);
+
+// Weighted sufficient statistics of the continuous columns, computed on the rows that are valid in all the columns.
+struct WeightedMoments {
+    double total_weight;
+    VectorXd means;
+    // Weighted sum of squared deviations (scatter matrix).
+    MatrixXd sse;
 };
+
+WeightedMoments weighted_moments(const DataFrame& df, const std::vector<std::string>& columns);
+WeightedMoments weighted_moments(const DataFrame& df, const std::vector<int>& columns);
 }  // namespace dataset
 
 namespace pybind11::detail {
@@ -2104,6 +2257,14 @@ public:
             } else {
                 return false;
             }
+        } else if (pyarrow::is_table(py_ptr)) {
+            auto result = pyarrow::unwrap_table(py_ptr);
+            if (result.ok()) {
+                value = dataset::table_to_record_batch(result.ValueOrDie());
+                return true;
+            } else {
+                return false;
+            }
         } else if (dataset::is_pandas_dataframe(src)) {
             auto a = dataset::pandas_to_pyarrow_record_batch(src);
             auto result = pyarrow::unwrap_batch(a.ptr());
@@ -69,6 +69,13 @@ public:
 
     int num_variables() const { return m_origin->num_columns(); }
 
+    // The temporal slices are slices of the origin DataFrame, so they have nulls only if the origin DataFrame has
+    // nulls. The columns of a DynamicDataFrame belong to different slices, so their validity is not cached.
+    bool has_nulls() const { return m_origin.has_nulls(); }
+    Validity columns_validity(Array_vector columns) const {
+        return dataset::combined_validity(columns.begin(), columns.end());
+    }
+
     template <typename Index, enable_if_index_t<Index, int> = 0>
     void check_temporal_slice(const Index& index) const {
         if (index.temporal_slice < 0 || index.temporal_slice > m_markovian_order) {
@@ -1,11 +1,13 @@
 #include <factors/continuous/CKDE.hpp>
 #include <factors/continuous/LinearGaussianCPD.hpp>
 #include <factors/discrete/DiscreteFactor.hpp>
+#include <kde/UCV.hpp>
 #include <models/BayesianNetwork.hpp>
 #include <util/vech_ops.hpp>
 #include <util/basic_eigen_ops.hpp>
 
 using factors::discrete::DiscreteFactorType;
+using kde::UCV;
 using models::BayesianNetworkBase, models::ConditionalBayesianNetworkBase;
 
 namespace factors::continuous {
@@ -56,6 +58,20 @@ void CKDE::fit(const DataFrame& df) {
     m_fitted = true;
 }
 
+double CKDE::fit_cost(const DataFrame& df) const {
+    auto N = static_cast<double>(df->num_rows());
+    auto d = static_cast<double>(evidence().size() + 1);
+
+    // UCV evaluates every pair of training instances. The cost of the Python selectors is unknown, so it is assumed to be
+    // the same.
+    if (!m_bselector || m_bselector->is_python_derived() || std::dynamic_pointer_cast<UCV>(m_bselector)) {
+        return N * N * d;
+    }
+
+    // The joint and marginal bandwidths are computed, and the training data is copied.
+    return 2 * N * d * d + N * d;
+}
+
 VectorXd CKDE::logl(const DataFrame& df) const {
     check_fitted();
     auto type = df.same_type(m_variables);
@@ -66,9 +82,15 @@ VectorXd CKDE::logl(const DataFrame& df) const {
 
     switch (type->id()) {
         case Type::DOUBLE:
-            return _logl<arrow::DoubleType>(df);
+            if (m_precision == KDEPrecision::Mixed)
+                return _logl<arrow::DoubleType, true>(df);
+            else
+                return _logl<arrow::DoubleType, false>(df);
         case Type::FLOAT:
-            return _logl<arrow::FloatType>(df);
+            if (m_precision == KDEPrecision::Mixed)
+                return _logl<arrow::FloatType, true>(df);
+            else
+                return _logl<arrow::FloatType, false>(df);
         default:
             throw std::runtime_error("Unreachable code.");
     }
@@ -84,9 +106,15 @@ double CKDE::slogl(const DataFrame& df) const {
 
     switch (type->id()) {
         case Type::DOUBLE:
-            return _slogl<arrow::DoubleType>(df);
+            if (m_precision == KDEPrecision::Mixed)
+                return _slogl<arrow::DoubleType, true>(df);
+            else
+                return _slogl<arrow::DoubleType, false>(df);
         case Type::FLOAT:
-            return _slogl<arrow::FloatType>(df);
+            if (m_precision == KDEPrecision::Mixed)
+                return _slogl<arrow::FloatType, true>(df);
+            else
+                return _slogl<arrow::FloatType, false>(df);
         default:
             throw std::runtime_error("Unreachable code.");
     }
@@ -172,7 +200,9 @@ py::tuple CKDE::__getstate__() const {
 }
 
 CKDE CKDE::__setstate__(py::tuple& t) {
-    if (t.size() != 4) throw std::runtime_error("Not valid CKDE.");
+    // The precision was added in the 5th position, and the univariate method and its tolerance in the 6th and 7th. The
+    // CKDEs saved before use the native precision and the exact method.
+    if (t.size() != 4 && t.size() != 5 && t.size() != 7) throw std::runtime_error("Not valid CKDE.");
 
     CKDE ckde(t[0].cast<std::string>(), t[1].cast<std::vector<std::string>>());
 
@@ -187,29 +217,25 @@ CKDE CKDE::__setstate__(py::tuple& t) {
         ckde.m_joint = std::move(kde_joint);
 
         if (!ckde.evidence().empty()) {
-            auto& joint_bandwidth = ckde.m_joint.bandwidth();
-            auto d = ckde.m_variables.size();
-            auto marg_bandwidth = joint_bandwidth.bottomRightCorner(d - 1, d - 1);
-
             switch (ckde.m_training_type->id()) {
-                case Type::DOUBLE: {
-                    double* marg = (double*)malloc(ckde.N*(d-1)*sizeof(double));
-                    std::memcpy(marg, ckde.m_joint.training_raw<arrow::DoubleType>(), ckde.N*(d-1)*sizeof(double));
-                    ckde.m_marg.fit<arrow::DoubleType>(marg_bandwidth, marg, ckde.m_joint.data_type(), ckde.N);
+                case Type::DOUBLE:
+                    ckde.fit_marginal<arrow::DoubleType>();
                     break;
-                }
-                case Type::FLOAT: {
-                    float* marg = (float*)malloc(ckde.N*(d-1)*sizeof(float));
-                    std::memcpy(marg, &ckde.m_joint.training_raw<arrow::FloatType>()[ckde.N], ckde.N*(d-1)*sizeof(float));
-                    ckde.m_marg.fit<arrow::FloatType>(marg_bandwidth, marg, ckde.m_joint.data_type(), ckde.N);
+                case Type::FLOAT:
+                    ckde.fit_marginal<arrow::FloatType>();
                     break;
-                }
                 default:
                     throw std::invalid_argument("Wrong data type in CKDE.");
             }
         }
     }
 
+    if (t.size() >= 5) ckde.set_precision(kde::kde_precision_from_int(t[4].cast<int>()));
+    if (t.size() == 7) {
+        ckde.set_univariate_tolerance(t[6].cast<double>());
+        ckde.set_univariate_method(kde::univariate_kde_method_from_int(t[5].cast<int>()));
+    }
+
     return ckde;
 }
 
@@ -11,13 +11,14 @@
 #include <kde/NormalReferenceRule.hpp>
 #include <kde/KDE.hpp>
 #include <util/math_constants.hpp>
+#include <util/parallel.hpp>
 
 namespace py = pybind11;
 namespace pyarrow = arrow::py;
 using dataset::DataFrame;
 using Eigen::VectorXd, Eigen::VectorXi;
 using factors::FactorType, factors::discrete::DiscreteAdaptator;
-using kde::KDE, kde::BandwidthSelector, kde::NormalReferenceRule, kde::UnivariateKDE, kde::MultivariateKDE;
+using kde::KDE, kde::KDEPrecision, kde::UnivariateKDEMethod, kde::BandwidthSelector, kde::NormalReferenceRule, kde::UnivariateKDE, kde::MultivariateKDE;
 
 namespace factors::continuous {
 
@@ -71,7 +72,10 @@ public:
           m_bselector(b_selector),
           m_training_type(arrow::float64()),
           m_joint(),
-          m_marg() {
+          m_marg(),
+          m_precision(KDEPrecision::Native),
+          m_univariate_method(UnivariateKDEMethod::Exact),
+          m_univariate_tolerance(kde::default_univariate_tolerance) {
         if (b_selector == nullptr) throw std::runtime_error("Bandwidth selector procedure must be non-null.");
 
         m_variables.reserve(evidence.size() + 1);
@@ -113,7 +117,32 @@ public:
 
     std::shared_ptr<BandwidthSelector> bandwidth_type() const { return m_bselector; }
 
+    KDEPrecision precision() const { return m_precision; }
+    void set_precision(KDEPrecision precision) {
+        m_precision = precision;
+        m_joint.set_precision(precision);
+        m_marg.set_precision(precision);
+    }
+
+    // The univariate method is used by the joint KDE if the CKDE has no evidence, and by the marginal KDE if it has one
+    // evidence variable.
+    UnivariateKDEMethod univariate_method() const { return m_univariate_method; }
+    void set_univariate_method(UnivariateKDEMethod method) {
+        m_joint.set_univariate_method(method);
+        m_marg.set_univariate_method(method);
+        m_univariate_method = method;
+    }
+
+    double univariate_tolerance() const { return m_univariate_tolerance; }
+    void set_univariate_tolerance(double tolerance) {
+        m_joint.set_univariate_tolerance(tolerance);
+        m_marg.set_univariate_tolerance(tolerance);
+        m_univariate_tolerance = tolerance;
+    }
+
     void fit(const DataFrame& df) override;
+    bool thread_safe_fit() const override { return !m_bselector || !m_bselector->is_python_derived(); }
+    double fit_cost(const DataFrame& df) const override;
     VectorXd logl(const DataFrame& df) const override;
     double slogl(const DataFrame& df) const override;
 
@@ -137,9 +166,12 @@ private:
     void _fit(const DataFrame& df);
 
     template <typename ArrowType>
+    void fit_marginal();
+
+    template <typename ArrowType, bool mixed>
     VectorXd _logl(const DataFrame& df) const;
 
-    template <typename ArrowType>
+    template <typename ArrowType, bool mixed>
     double _slogl(const DataFrame& df) const;
 
     template <typename ArrowType>
@@ -148,14 +180,6 @@ private:
     template <typename ArrowType>
     Array_ptr _sample_multivariate(int n, const DataFrame& evidence_values, unsigned int seed) const;
 
-    template <typename ArrowType>
-    VectorXi _sample_indices_multivariate(Matrix<typename ArrowType::c_type, Dynamic, 1>& random_prob,
-                                          const DataFrame& evidence_values,
-                                          int n) const;
-
-    template <typename ArrowType, typename KDEType>
-    Matrix<int, Dynamic, 1> _sample_indices_from_weights(typename ArrowType::c_type* random_prob, typename ArrowType::c_type* test_buffer, int n) const;
-
     template <typename ArrowType>
     VectorXd _cdf(const DataFrame& df) const;
 
@@ -175,6 +199,9 @@ private:
     size_t N;
     KDE m_joint;
     KDE m_marg;
+    KDEPrecision m_precision;
+    UnivariateKDEMethod m_univariate_method;
+    double m_univariate_tolerance;
 };
 
 template <typename ArrowType>
@@ -182,21 +209,29 @@ void CKDE::_fit(const DataFrame& df) {
     m_joint.fit(df);
     N = m_joint.num_instances();
 
-    if (!this->evidence().empty()) {
-        auto& joint_bandwidth = m_joint.bandwidth();
-        auto d = m_variables.size();
-        auto marg_bandwidth = joint_bandwidth.bottomRightCorner(d - 1, d - 1);
-
-        m_marg.fit<ArrowType>(marg_bandwidth, &m_joint.training_raw<ArrowType>()[N], m_joint.data_type(), N);
-    }
+    if (!this->evidence().empty()) fit_marginal<ArrowType>();
 }
 
 template <typename ArrowType>
-VectorXd CKDE::_logl(const DataFrame& df) const {
+void CKDE::fit_marginal() {
     using CType = typename ArrowType::c_type;
+
+    auto& joint_bandwidth = m_joint.bandwidth();
+    auto d = m_variables.size();
+    auto marg_bandwidth = joint_bandwidth.bottomRightCorner(d - 1, d - 1);
+
+    // The training data of the marginal KDE are the evidence columns of the joint KDE, so it references the same buffer.
+    // The training instances also have the same weights.
+    auto marg_training = arrow::SliceBuffer(m_joint.training_buffer(), N * sizeof(CType), N * (d - 1) * sizeof(CType));
+    m_marg.fit<ArrowType>(marg_bandwidth, marg_training, m_joint.data_type(), N, m_joint.log_weights_buffer());
+}
+
+template <typename ArrowType, bool mixed>
+VectorXd CKDE::_logl(const DataFrame& df) const {
+    using CType = kde::LoglType<ArrowType, mixed>;
     using VectorType = Matrix<CType, Dynamic, 1>;
 
-    auto logl_joint = m_joint.logl_buffer<ArrowType>(df);
+    auto logl_joint = m_joint.logl_buffer<ArrowType, mixed>(df);
     auto combined_bitmap = df.combined_bitmap(m_variables);
     auto m = df->num_rows();
     if (combined_bitmap) m = util::bit_util::non_null_count(combined_bitmap, df->num_rows());
@@ -204,9 +239,9 @@ VectorXd CKDE::_logl(const DataFrame& df) const {
     if (!this->evidence().empty()) {
         VectorType logl_marg(m);
         if (combined_bitmap)
-            logl_marg = m_marg.logl_buffer<ArrowType>(df, combined_bitmap);
+            logl_marg = m_marg.logl_buffer<ArrowType, mixed>(df, combined_bitmap);
         else
-            logl_marg = m_marg.logl_buffer<ArrowType>(df);
+            logl_marg = m_marg.logl_buffer<ArrowType, mixed>(df);
         Kernel<CType>::instance().substract_vectors(logl_joint.data(), logl_marg.data(), m);
     }
 
@@ -238,12 +273,12 @@ VectorXd CKDE::_logl(const DataFrame& df) const {
     }
 }
 
-template <typename ArrowType>
+template <typename ArrowType, bool mixed>
 double CKDE::_slogl(const DataFrame& df) const {
-    using CType = typename ArrowType::c_type;
+    using CType = kde::LoglType<ArrowType, mixed>;
     using VectorType = Matrix<CType, Dynamic, 1>;
 
-    auto logl_joint = m_joint.logl_buffer<ArrowType>(df);
+    auto logl_joint = m_joint.logl_buffer<ArrowType, mixed>(df);
     auto combined_bitmap = df.combined_bitmap(m_variables);
     auto m = df->num_rows();
     if (combined_bitmap) m = util::bit_util::non_null_count(combined_bitmap, df->num_rows());
@@ -251,35 +286,46 @@ double CKDE::_slogl(const DataFrame& df) const {
     if (!this->evidence().empty()) {
         VectorType logl_marg(m);
         if (combined_bitmap)
-            logl_marg = m_marg.logl_buffer<ArrowType>(df, combined_bitmap);
+            logl_marg = m_marg.logl_buffer<ArrowType, mixed>(df, combined_bitmap);
         else
-            logl_marg = m_marg.logl_buffer<ArrowType>(df);
+            logl_marg = m_marg.logl_buffer<ArrowType, mixed>(df);
         Kernel<CType>::instance().substract_vectors(logl_joint.data(), logl_marg.data(), m);
     }
 
-    CType result = -1;
-    Kernel<CType>::instance().sum1d(logl_joint.data(), m, &result);
-    return static_cast<double>(result);
+    if constexpr (mixed) {
+        return Kernel<CType>::instance().sum1d_mixed(logl_joint.data(), m);
+    } else {
+        CType result = -1;
+        Kernel<CType>::instance().sum1d(logl_joint.data(), m, &result);
+        return static_cast<double>(result);
+    }
 }
 
 template <typename ArrowType>
 Array_ptr CKDE::_sample(int n, const DataFrame& evidence_values, unsigned int seed) const {
-    using CType = typename ArrowType::c_type;
-    using VectorType = Matrix<CType, Dynamic, 1>;
-
     if (this->evidence().empty()) {
         arrow::NumericBuilder<ArrowType> builder;
         RAISE_STATUS_ERROR(builder.Resize(n));
         std::mt19937 rng{seed};
         std::uniform_int_distribution<> uniform(0, N - 1);
 
-        std::normal_distribution<CType> normal(0, std::sqrt(m_joint.bandwidth()(0, 0)));
-        VectorType training_data(N);
-        std::memcpy(training_data.data(), m_joint.training_raw<ArrowType>(), N*sizeof(CType));
+        // The training instances are drawn proportionally to their weights, if the KDE is weighted.
+        std::discrete_distribution<> weighted;
+        auto log_weights = m_joint.log_weights_raw<ArrowType>();
+        if (log_weights) {
+            std::vector<double> weights(N);
+            for (size_t j = 0; j < N; ++j) {
+                weights[j] = std::exp(static_cast<double>(log_weights[j]));
+            }
+            weighted = std::discrete_distribution<>(weights.begin(), weights.end());
+        }
+
+        std::normal_distribution<typename ArrowType::c_type> normal(0, std::sqrt(m_joint.bandwidth()(0, 0)));
+        auto training_data = m_joint.training_raw<ArrowType>();
 
         for (auto i = 0; i < n; ++i) {
-            auto index = uniform(rng);
-            builder.UnsafeAppend(training_data(index) + normal(rng));
+            auto index = log_weights ? weighted(rng) : uniform(rng);
+            builder.UnsafeAppend(training_data[index] + normal(rng));
         }
 
         Array_ptr out;
@@ -301,145 +347,108 @@ Array_ptr CKDE::_sample_multivariate(int n, const DataFrame& evidence_values, un
 
     if (!evidence_values.has_columns(e)) throw std::domain_error("Evidence values not present for sampling.");
 
-    VectorType random_prob(n);
+    auto d = e.size();
+    std::vector<const CType*> evidence_raw;
+    evidence_raw.reserve(d);
+    for (size_t j = 0; j < d; ++j) {
+        auto evidence = evidence_values->GetColumnByName(e[j]);
+        auto dwn_evidence = std::static_pointer_cast<ArrowArrayType>(evidence);
+        evidence_raw.push_back(dwn_evidence->raw_values());
+    }
+
+    // The random numbers are drawn sequentially, so the result does not depend on the number of threads.
     std::mt19937 rng{seed};
     std::uniform_real_distribution<CType> uniform(0, 1);
+    VectorType random_prob(n);
     for (auto i = 0; i < n; ++i) {
         random_prob(i) = uniform(rng);
     }
 
-    VectorXi sample_indices = _sample_indices_multivariate<ArrowType>(random_prob, evidence_values, n);
-
     const auto& bandwidth = m_joint.bandwidth();
     const auto& marg_bandwidth = m_marg.bandwidth();
 
     auto cholesky = marg_bandwidth.llt();
     auto matrixL = cholesky.matrixL();
 
-    auto d = e.size();
     MatrixXd inverseL = MatrixXd::Identity(d, d);
 
     // Solves and saves the result in inverseL
     matrixL.solveInPlace(inverseL);
     auto R = inverseL * bandwidth.bottomLeftCorner(d, 1);
     auto cond_var = bandwidth(0, 0) - R.squaredNorm();
-    auto transform = (R.transpose() * inverseL).transpose().template cast<CType>();
-
-    MatrixType training_dataset(N, m_variables.size());
-    std::memcpy(training_dataset.data(), m_joint.training_raw<ArrowType>(), N*m_variables.size()*sizeof(CType));
-    MatrixType evidence_substract(n, e.size());
-    for (size_t j = 0; j < e.size(); ++j) {
-        auto evidence = evidence_values->GetColumnByName(e[j]);
-        auto dwn_evidence = std::static_pointer_cast<ArrowArrayType>(evidence);
-        auto raw_values = dwn_evidence->raw_values();
-        for (auto i = 0; i < n; ++i) {
-            evidence_substract(i, j) = raw_values[i] - training_dataset(sample_indices(i), j + 1);
-        }
-    }
-
-    auto cond_mean = (evidence_substract * transform).eval();
+    VectorType transform = (R.transpose() * inverseL).transpose().template cast<CType>();
+    MatrixType inverseL_ctype = inverseL.template cast<CType>();
 
     std::normal_distribution<CType> normal(0, std::sqrt(cond_var));
-    arrow::NumericBuilder<ArrowType> builder;
-    RAISE_STATUS_ERROR(builder.Resize(n));
-
+    VectorType noise(n);
     for (auto i = 0; i < n; ++i) {
-        cond_mean(i) += training_dataset(sample_indices(i), 0) + normal(rng);
-    }
-
-    RAISE_STATUS_ERROR(builder.AppendValues(cond_mean.data(), n));
-
-    Array_ptr out;
-    RAISE_STATUS_ERROR(builder.Finish(&out));
-
-    return out;
-}
-
-template <typename ArrowType>
-VectorXi CKDE::_sample_indices_multivariate(Matrix<typename ArrowType::c_type, Dynamic, 1>& random_prob,
-                                            const DataFrame& evidence_values,
-                                            int n) const {
-    using CType = typename ArrowType::c_type;
-    using ArrowArray = typename arrow::TypeTraits<ArrowType>::ArrayType;
-    using MatrixType = Matrix<CType, Dynamic, Dynamic>;
-
-    const auto& e = this->evidence();
-    MatrixType test_matrix(n, e.size());
-
-    for (size_t i = 0; i < e.size(); ++i) {
-        auto evidence = evidence_values->GetColumnByName(e[i]);
-        auto dwn_evidence = std::static_pointer_cast<ArrowArray>(evidence);
-        auto raw_evidence = dwn_evidence->raw_values();
-        std::memcpy(test_matrix.data() + i * n, raw_evidence, sizeof(CType) * n);
+        noise(i) = normal(rng);
     }
 
-    Matrix<int, Dynamic, 1> indices(n);
-    if (e.size() == 1)
-        indices = _sample_indices_from_weights<ArrowType, UnivariateKDE>(random_prob.data(), test_matrix.data(), n);
-    else 
-        indices = _sample_indices_from_weights<ArrowType, MultivariateKDE>(random_prob.data(), test_matrix.data(), n);
-    VectorXi res(n);
-    for(int i = 0; i < n; ++i)
-        res[i] = indices[i];
-    return res;
-}
+    // Column-major (N x (d + 1)) training data of the joint KDE. It is referenced, not copied.
+    const CType* training = m_joint.training_raw<ArrowType>();
+    const CType* log_weights = m_joint.log_weights_raw<ArrowType>();
 
-template <typename ArrowType, typename KDEType>
-Matrix<int, Dynamic, 1> CKDE::_sample_indices_from_weights(typename ArrowType::c_type* random_prob, typename ArrowType::c_type* test_buffer, int n) const {
-    using CType = typename ArrowType::c_type;
-    Kernel<CType> kernels = Kernel<CType>::instance();
+    VectorType result(n);
 
-    Matrix<int, Dynamic, 1> res(n);
+    // Each sample selects a training instance with probability proportional to the marginal kernel weights, by
+    // inverse-CDF over the weights of all the training instances. Only a buffer of N log-weights per thread is
+    // needed, instead of the (N x n) weight matrix. The log-weights and their sum (rescaled each time the maximum
+    // changes) are computed in a single pass, and the inverse-CDF pass stops at the selected instance.
+#pragma omp parallel num_threads(util::num_threads())
+    {
+        VectorType logw(N);
+        VectorType difference(d);
+        VectorType whitened(d);
 
-    for(int i = 0; i < n; ++i)
-        res.data()[i] = N - 1;
+#pragma omp for schedule(static)
+        for (auto i = 0; i < n; ++i) {
+            CType max_logw = -std::numeric_limits<CType>::infinity();
+            double total = 0;
+            for (size_t j = 0; j < N; ++j) {
+                for (size_t k = 0; k < d; ++k) {
+                    difference(k) = evidence_raw[k][i] - training[(k + 1) * N + j];
+                }
+
+                whitened.noalias() = inverseL_ctype.template triangularView<Eigen::Lower>() * difference;
+                logw(j) = -0.5 * whitened.squaredNorm();
+                if (log_weights) logw(j) += log_weights[j];
+
+                if (logw(j) > max_logw) {
+                    total = total * std::exp(max_logw - logw(j)) + 1;
+                    max_logw = logw(j);
+                } else {
+                    total += std::exp(logw(j) - max_logw);
+                }
+            }
 
-    auto allocated_m = std::min(n, 64);
-    auto iterations = static_cast<int>(std::ceil(static_cast<double>(n) / static_cast<double>(allocated_m)));
+            double threshold = random_prob(i) * total;
+            double accum = 0;
+            size_t index = N - 1;
+            for (size_t j = 0; j < N; ++j) {
+                accum += std::exp(logw(j) - max_logw);
+                if (threshold < accum) {
+                    index = j;
+                    break;
+                }
+            }
 
-    CType* out = (CType*)malloc(N * allocated_m * sizeof(CType));
-    CType* total_sum = (CType*)malloc(allocated_m*sizeof(CType));
+            CType cond_mean = training[index];
+            for (size_t k = 0; k < d; ++k) {
+                cond_mean += (evidence_raw[k][i] - training[(k + 1) * N + index]) * transform(k);
+            }
 
-    for (auto i = 0; i < (iterations - 1); ++i) {
-        KDEType::template execute_logl_mat<ArrowType>(m_marg.training_raw<ArrowType>(),
-                                                      N,
-                                                      test_buffer,
-                                                      n,
-                                                      i * allocated_m,
-                                                      allocated_m,
-                                                      this->evidence().size(),
-                                                      m_marg.cholesky_raw<ArrowType>(),
-                                                      m_marg.lognorm_const(),
-                                                    //   tmp,
-                                                      out);
-        kernels.exp_elementwise(out, N * allocated_m);
-        kernels.accum_sum_cols(out, N, allocated_m, total_sum);
-        kernels.normalize_accum_sum_mat_cols(out, N, total_sum, N - 1, allocated_m);
-        kernels.find_random_indices(out, N, i * allocated_m, random_prob, res.data(), N - 1, allocated_m);
+            result(i) = cond_mean + noise(i);
+        }
     }
-    auto offset = (iterations - 1) * allocated_m;
-    auto remaining_m = n - offset;
 
-    KDEType::template execute_logl_mat<ArrowType>(m_marg.training_raw<ArrowType>(),
-                                                  N,
-                                                  test_buffer,
-                                                  n,
-                                                  offset,
-                                                  remaining_m,
-                                                  this->evidence().size(),
-                                                  m_marg.cholesky_raw<ArrowType>(),
-                                                  m_marg.lognorm_const(),
-                                                //   tmp,
-                                                  out);
-    kernels.exp_elementwise(out, N * remaining_m);
-    kernels.accum_sum_cols(out, N, remaining_m, total_sum);
-    kernels.normalize_accum_sum_mat_cols(out, N, total_sum, N - 1, remaining_m);
-    kernels.find_random_indices(out, N, offset, random_prob, res.data(), N - 1, remaining_m);
+    arrow::NumericBuilder<ArrowType> builder;
+    RAISE_STATUS_ERROR(builder.AppendValues(result.data(), n));
 
-    free(total_sum);
-    free(out);
+    Array_ptr out;
+    RAISE_STATUS_ERROR(builder.Finish(&out));
 
-    return res;
+    return out;
 }
 
 template <typename ArrowType>
@@ -495,6 +504,12 @@ Matrix<typename ArrowType::c_type, Dynamic, 1> CKDE::_cdf_univariate(typename Ar
 
     CType* mu = (CType*)malloc(N*allocated_m*sizeof(CType));
 
+    // The cdf of each kernel is multiplied by its weight, if the KDE is weighted.
+    auto log_weights = m_joint.log_weights_raw<ArrowType>();
+    VectorType weights;
+    if (log_weights) weights = Map<const VectorType>(log_weights, N).array().exp().matrix();
+    auto inv_N = log_weights ? CType(1) : static_cast<CType>(1.0 / N);
+
     VectorType res(m);
     for (auto i = 0; i < (iterations - 1); ++i) {
         kernels.univariate_normal_cdf(m_joint.training_raw<ArrowType>(),
@@ -502,9 +517,10 @@ Matrix<typename ArrowType::c_type, Dynamic, 1> CKDE::_cdf_univariate(typename Ar
                                         test_buffer,
                                         static_cast<unsigned int>(i * allocated_m),
                                         static_cast<CType>(1.0 / std::sqrt(m_joint.bandwidth()(0, 0))),
-                                        static_cast<CType>(1.0 / N),
+                                        inv_N,
                                         mu,
                                         allocated_m);
+        if (log_weights) kernels.product_rows_vector(mu, N, weights.data(), N * allocated_m);
         kernels.sum_cols_offset(mu, N, allocated_m, res.data(), i * allocated_m);
     }
 
@@ -516,9 +532,10 @@ Matrix<typename ArrowType::c_type, Dynamic, 1> CKDE::_cdf_univariate(typename Ar
                                     test_buffer,
                                     offset,
                                     static_cast<CType>(1.0 / std::sqrt(m_joint.bandwidth()(0, 0))),
-                                    static_cast<CType>(1.0 / N),
+                                    inv_N,
                                     mu,
                                     remaining_m);
+    if (log_weights) kernels.product_rows_vector(mu, N, weights.data(), N * remaining_m);
     kernels.sum_cols_offset(mu, N, remaining_m, res.data(), offset);
 
     return res;
@@ -547,7 +564,10 @@ Matrix<typename ArrowType::c_type, Dynamic, 1> CKDE::_cdf_multivariate(typename
     auto allocated_m = std::min(m, 64u);
     auto iterations = static_cast<int>(std::ceil(static_cast<double>(m) / static_cast<double>(allocated_m)));
 
+    // The kernel weights are normalized by sum_W, so the constant only avoids underflows. If the KDE is weighted, the
+    // log-weights of the training instances are added.
     auto new_lognorm_marg = m_marg.lognorm_const() + std::log(N);
+    auto log_weights = m_marg.log_weights_raw<ArrowType>();
 
     auto tmp_mat_size = this->evidence().size() * (N>allocated_m?N:allocated_m);
 
@@ -571,6 +591,7 @@ Matrix<typename ArrowType::c_type, Dynamic, 1> CKDE::_cdf_multivariate(typename
                                                       new_lognorm_marg,
                                                     //   tmp,
                                                       W);
+        if (log_weights) kernels.sum_rows_vector(W, N, log_weights, N * allocated_m);
         kernels.exp_elementwise(W, N * allocated_m);
         kernels.sum_cols_offset(W, N, allocated_m, sum_W, 0);
 
@@ -606,6 +627,7 @@ Matrix<typename ArrowType::c_type, Dynamic, 1> CKDE::_cdf_multivariate(typename
                                                   new_lognorm_marg,
                                                 //   tmp,
                                                   W);
+    if (log_weights) kernels.sum_rows_vector(W, N, log_weights, N * remaining_m);
     kernels.exp_elementwise(W, N * remaining_m);
     kernels.sum_cols_offset(W, N, remaining_m, sum_W, 0);
 
@@ -640,7 +662,13 @@ py::tuple CKDE::__getstate__() const {
         joint_tuple = m_joint.__getstate__();
     }
 
-    return py::make_tuple(this->variable(), this->evidence(), m_fitted, joint_tuple);
+    return py::make_tuple(this->variable(),
+                          this->evidence(),
+                          m_fitted,
+                          joint_tuple,
+                          static_cast<int>(m_precision),
+                          static_cast<int>(m_univariate_method),
+                          m_univariate_tolerance);
 }
 
 // Fix const name: https://stackoverflow.com/a/15862594
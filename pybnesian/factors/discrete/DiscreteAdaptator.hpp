@@ -1,9 +1,12 @@
 #ifndef PYBNESIAN_FACTORS_DISCRETE_DISCRETEADAPTATOR_HPP
 #define PYBNESIAN_FACTORS_DISCRETE_DISCRETEADAPTATOR_HPP
 
+#include <algorithm>
+#include <numeric>
 #include <factors/factors.hpp>
 #include <factors/discrete/discrete_indices.hpp>
 #include <util/math_constants.hpp>
+#include <util/parallel.hpp>
 #include <fort.hpp>
 
 using Eigen::VectorXi;
@@ -16,6 +19,9 @@ public:
     virtual std::shared_ptr<Factor> initialize(const std::string& variable,
                                                const std::vector<std::string>& evidence,
                                                const Assignment& discrete_assignment) const = 0;
+    // True if the factors initialized with every set of parameters can be fitted concurrently (see
+    // Factor::thread_safe_fit()).
+    virtual bool thread_safe_fit(const std::string& variable, const std::vector<std::string>& evidence) const = 0;
 
     virtual py::tuple __getstate__() const = 0;
 };
@@ -42,6 +48,10 @@ public:
         }
     }
 
+    bool thread_safe_fit(const std::string& variable, const std::vector<std::string>& evidence) const override {
+        return initialize(variable, evidence, Assignment())->thread_safe_fit();
+    }
+
     py::tuple __getstate__() const override {
         return py::make_tuple(false, py::module_::import("pickle").attr("dumps")(m_args));
     }
@@ -79,6 +89,18 @@ public:
         }
     }
 
+    bool thread_safe_fit(const std::string& variable, const std::vector<std::string>& evidence) const override {
+        if (!std::make_shared<BaseFactor>(variable, evidence)->thread_safe_fit()) return false;
+
+        if constexpr (std::tuple_size_v<typename decltype(m_args)::mapped_type> > 0) {
+            for (const auto& p : m_args) {
+                if (!initialize(variable, evidence, p.first)->thread_safe_fit()) return false;
+            }
+        }
+
+        return true;
+    }
+
     py::tuple __getstate__() const override {
         return py::make_tuple(true, py::module_::import("pickle").attr("dumps")(m_args));
     }
@@ -87,6 +109,28 @@ private:
     std::unordered_map<Assignment, std::tuple<Args...>, AssignmentHash> m_args;
 };
 
+// Calls func(i) for each non-empty configuration i of the partition, largest first. The configurations are processed in
+// parallel if parallel is true, i.e. if the factors of the configurations can be fitted and evaluated concurrently.
+template <typename Func>
+void for_each_configuration(const DiscretePartition& partition, bool parallel, Func func) {
+    auto order = partition.largest_first();
+    std::exception_ptr eptr = nullptr;
+
+#pragma omp parallel for schedule(dynamic) if (parallel) num_threads(util::num_threads())
+    for (size_t k = 0; k < order.size(); ++k) {
+        try {
+            func(order[k]);
+        } catch (...) {
+#pragma omp critical
+            {
+                if (!eptr) eptr = std::current_exception();
+            }
+        }
+    }
+
+    if (eptr) std::rethrow_exception(eptr);
+}
+
 template <typename BaseFactor, typename BaseFitter, typename FactorName>
 class DiscreteAdaptator : public Factor {
 public:
@@ -127,6 +171,7 @@ public:
     bool fitted() const override { return m_fitted; }
 
     void fit(const DataFrame& df) override;
+    bool thread_safe_fit() const override;
     VectorXd logl(const DataFrame& df) const override;
     double slogl(const DataFrame& df) const override;
 
@@ -151,6 +196,13 @@ private:
         check_equal_domain(df, check_variable);
     }
 
+    // Columns of the base factors: the variable and the continuous evidence.
+    std::vector<std::string> continuous_columns() const {
+        std::vector<std::string> columns{variable()};
+        columns.insert(columns.end(), m_continuous_evidence.begin(), m_continuous_evidence.end());
+        return columns;
+    }
+
     std::unique_ptr<BaseFactorParameters> m_args;
     bool m_fitted;
     std::vector<std::string> m_discrete_evidence;
@@ -249,50 +301,36 @@ void DiscreteAdaptator<BaseFactor, BaseFitter, FactorName>::fit(const DataFrame&
         auto num_factors = m_cardinality.prod();
         m_factors.reserve(num_factors);
 
-        auto slices = discrete_slice_indices(df, m_discrete_evidence, m_strides, num_factors);
+        auto partition = discrete_partition(df, m_discrete_evidence, m_strides, num_factors, continuous_columns());
+        auto sorted_df = df.loc_weighted(continuous_columns()).take(partition.permutation);
 
         for (auto i = 0; i < num_factors; ++i) {
-            if (slices[i]) {
+            if (partition.length(i) > 0) {
                 auto assignment =
                     Assignment::from_index(i, m_discrete_evidence, m_discrete_values, m_cardinality, m_strides);
 
-                auto factor = m_args->initialize(variable(), m_continuous_evidence, assignment);
-                m_factors.push_back(std::move(factor));
-
-                if (!m_factors.back()->fitted()) {
-                    auto df_filtered = df.take(slices[i]);
-
-                    if (!BaseFitter::fit(m_factors.back(), df_filtered)) {
-                        m_factors.back() = nullptr;
-                    }
-                }
+                m_factors.push_back(m_args->initialize(variable(), m_continuous_evidence, assignment));
             } else {
                 m_factors.push_back(nullptr);
             }
         }
+
+        for_each_configuration(partition, thread_safe_fit(), [this, &partition, &sorted_df](int i) {
+            if (!m_factors[i]->fitted() && !BaseFitter::fit(m_factors[i], partition.slice(sorted_df, i))) {
+                m_factors[i] = nullptr;
+            }
+        });
     }
 
     m_fitted = true;
 }
 
-template <typename ArrowType>
-void logl_impl(const std::shared_ptr<Factor>& f, const DataFrame& df, const Array_ptr& indices, VectorXd& res) {
-    using ArrayType = typename arrow::TypeTraits<ArrowType>::ArrayType;
-    auto dwn_indices = std::static_pointer_cast<ArrayType>(indices);
-    auto raw_indices = dwn_indices->raw_values();
-
-    if (f) {
-        auto df_filtered = df.take(indices);
-        auto ll = f->logl(df_filtered);
+template <typename BaseFactor, typename BaseFitter, typename FactorName>
+bool DiscreteAdaptator<BaseFactor, BaseFitter, FactorName>::thread_safe_fit() const {
+    // Before the fit, the factors of the configurations are not initialized yet.
+    if (m_factors.empty()) return m_args->thread_safe_fit(variable(), evidence());
 
-        for (auto i = 0; i < dwn_indices->length(); ++i) {
-            res(raw_indices[i]) = ll(i);
-        }
-    } else {
-        for (auto i = 0; i < dwn_indices->length(); ++i) {
-            res(raw_indices[i]) = util::nan<double>;
-        }
-    }
+    return std::all_of(m_factors.begin(), m_factors.end(), [](const auto& f) { return !f || f->thread_safe_fit(); });
 }
 
 template <typename BaseFactor, typename BaseFitter, typename FactorName>
@@ -302,23 +340,24 @@ VectorXd DiscreteAdaptator<BaseFactor, BaseFitter, FactorName>::logl(const DataF
     if (m_discrete_evidence.empty()) {
         return m_factors[0]->logl(df);
     } else {
-        auto num_factors = m_factors.size();
-        auto slices = discrete_slice_indices(df, m_discrete_evidence, m_strides, num_factors);
+        auto partition = discrete_partition(df, m_discrete_evidence, m_strides, m_factors.size(), continuous_columns());
+        auto sorted_df = df.loc_weighted(continuous_columns()).take(partition.permutation);
+        auto raw_permutation = std::static_pointer_cast<arrow::Int32Array>(partition.permutation)->raw_values();
 
-        VectorXd res(df->num_rows());
+        // The rows with null values (or without a fitted factor) have NaN log-likelihood.
+        VectorXd res = VectorXd::Constant(df->num_rows(), util::nan<double>);
 
-        if (auto combined_bitmap = df.combined_bitmap(m_discrete_evidence)) {
-            auto bitmap_data = combined_bitmap->data();
-            for (auto i = 0; i < df->num_rows(); ++i) {
-                if (!util::bit_util::GetBit(bitmap_data, i)) res(i) = util::nan<double>;
-            }
-        }
+        auto parallel = thread_safe_fit();
+        for_each_configuration(partition, parallel, [this, &partition, &sorted_df, raw_permutation, &res](int i) {
+            if (m_factors[i]) {
+                auto ll = m_factors[i]->logl(partition.slice(sorted_df, i));
 
-        for (size_t i = 0; i < num_factors; ++i) {
-            if (slices[i]) {
-                logl_impl<arrow::Int32Type>(m_factors[i], df, slices[i], res);
+                auto offset = partition.offset(i);
+                for (auto j = 0, length = static_cast<int>(partition.length(i)); j < length; ++j) {
+                    res(raw_permutation[offset + j]) = ll(j);
+                }
             }
-        }
+        });
 
         return res;
     }
@@ -331,19 +370,18 @@ double DiscreteAdaptator<BaseFactor, BaseFitter, FactorName>::slogl(const DataFr
     if (m_discrete_evidence.empty()) {
         return m_factors[0]->slogl(df);
     } else {
-        auto num_factors = m_factors.size();
-        auto slices = discrete_slice_indices(df, m_discrete_evidence, m_strides, num_factors);
+        auto partition = discrete_partition(df, m_discrete_evidence, m_strides, m_factors.size(), continuous_columns());
+        auto sorted_df = df.loc_weighted(continuous_columns()).take(partition.permutation);
 
-        double res = 0;
+        // Summed in a fixed order, so the result does not depend on the scheduling of the configurations.
+        std::vector<double> configuration_slogl(m_factors.size(), 0);
 
-        for (size_t i = 0; i < num_factors; ++i) {
-            if (slices[i] && m_factors[i]) {
-                auto df_filtered = df.take(slices[i]);
-                res += m_factors[i]->slogl(df_filtered);
-            }
-        }
+        auto parallel = thread_safe_fit();
+        for_each_configuration(partition, parallel, [this, &partition, &sorted_df, &configuration_slogl](int i) {
+            if (m_factors[i]) configuration_slogl[i] = m_factors[i]->slogl(partition.slice(sorted_df, i));
+        });
 
-        return res;
+        return std::accumulate(configuration_slogl.begin(), configuration_slogl.end(), 0.);
     }
 }
 
@@ -95,6 +95,18 @@ public:
         check_fitted();
         return m_evidence_values;
     }
+    const VectorXd& logprob() const {
+        check_fitted();
+        return m_logprob;
+    }
+    const VectorXi& cardinality() const {
+        check_fitted();
+        return m_cardinality;
+    }
+    const VectorXi& strides() const {
+        check_fitted();
+        return m_strides;
+    }
     bool fitted() const override { return m_fitted; }
     void fit(const DataFrame& df) override;
     VectorXd logl(const DataFrame& df) const override;
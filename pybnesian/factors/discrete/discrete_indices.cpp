@@ -149,21 +149,37 @@ VectorXi joint_counts(const DataFrame& df,
     return counts;
 }
 
-VectorXi marginal_counts(const VectorXi& joint_counts,
-                         int index,
-                         const VectorXi& cardinality,
-                         const VectorXi& strides) {
-    auto result = VectorXi::Zero(cardinality(index)).eval();
+VectorXd weighted_joint_counts(const DataFrame& df,
+                               const std::string& variable,
+                               const std::vector<std::string>& evidence,
+                               const VectorXi& cardinality,
+                               const VectorXi& strides) {
+    if (!df.has_weights()) return joint_counts(df, variable, evidence, cardinality, strides).cast<double>();
 
-    auto stride = strides(index);
-    auto card = cardinality(index);
+    auto joint_values = cardinality.prod();
+
+    VectorXd counts = VectorXd::Zero(joint_values);
+    VectorXi indices = discrete_indices(df, variable, evidence, strides);
+    VectorXd weights = df.weights_vector(df.combined_bitmap(variable, evidence));
 
-    for (auto i = 0; i < joint_counts.rows(); ++i) {
-        auto vindex = (i / stride) % card;
-        result(vindex) += joint_counts(i);
+    for (auto i = 0; i < indices.rows(); ++i) {
+        counts(indices(i)) += weights(i);
     }
 
-    return result;
+    return counts;
+}
+
+VectorXd weighted_joint_counts(const ChunkedDataFrame& df,
+                               const std::string& variable,
+                               const std::vector<std::string>& evidence,
+                               const VectorXi& cardinality,
+                               const VectorXi& strides) {
+    VectorXd counts = weighted_joint_counts(df.chunk(0), variable, evidence, cardinality, strides);
+    for (auto i = 1; i < df.num_chunks(); ++i) {
+        counts += weighted_joint_counts(df.chunk(i), variable, evidence, cardinality, strides);
+    }
+
+    return counts;
 }
 
 std::vector<Array_ptr> discrete_slice_indices(const DataFrame& df,
@@ -203,6 +219,71 @@ std::vector<Array_ptr> discrete_slice_indices(const DataFrame& df,
     return slices;
 }
 
+std::vector<int> DiscretePartition::largest_first() const {
+    std::vector<int> order;
+    for (auto i = 0, num = num_configurations(); i < num; ++i) {
+        if (length(i) > 0) order.push_back(i);
+    }
+
+    std::stable_sort(order.begin(), order.end(), [this](int a, int b) { return length(a) > length(b); });
+    return order;
+}
+
+DiscretePartition discrete_partition(const DataFrame& df,
+                                     const std::vector<std::string>& discrete_vars,
+                                     const VectorXi& strides,
+                                     int num_factors,
+                                     const std::vector<std::string>& valid_columns) {
+    auto num_rows = df->num_rows();
+    auto indices = discrete_indices(df, discrete_vars, strides);
+
+    // Configuration of each row, or -1 if the row is not valid.
+    std::vector<int> configuration(num_rows);
+
+    if (df.null_count(discrete_vars) == 0) {
+        for (auto i = 0; i < num_rows; ++i) {
+            configuration[i] = indices(i);
+        }
+    } else {
+        auto bitmap = df.combined_bitmap(discrete_vars);
+        auto bitmap_data = bitmap->data();
+
+        for (auto i = 0, j = 0; i < num_rows; ++i) {
+            configuration[i] = util::bit_util::GetBit(bitmap_data, i) ? indices(j++) : -1;
+        }
+    }
+
+    if (auto bitmap = df.combined_bitmap(valid_columns)) {
+        auto bitmap_data = bitmap->data();
+        for (auto i = 0; i < num_rows; ++i) {
+            if (!util::bit_util::GetBit(bitmap_data, i)) configuration[i] = -1;
+        }
+    }
+
+    DiscretePartition partition;
+    partition.offsets.assign(num_factors + 1, 0);
+
+    for (auto c : configuration) {
+        if (c >= 0) ++partition.offsets[c + 1];
+    }
+
+    for (auto i = 0; i < num_factors; ++i) {
+        partition.offsets[i + 1] += partition.offsets[i];
+    }
+
+    std::vector<int> permutation(partition.offsets[num_factors]);
+    std::vector<int64_t> position(partition.offsets.begin(), partition.offsets.end() - 1);
+    for (auto i = 0; i < num_rows; ++i) {
+        if (configuration[i] >= 0) permutation[position[configuration[i]]++] = i;
+    }
+
+    arrow::NumericBuilder<arrow::Int32Type> builder;
+    RAISE_STATUS_ERROR(builder.AppendValues(permutation.data(), permutation.size()));
+    RAISE_STATUS_ERROR(builder.Finish(&partition.permutation));
+
+    return partition;
+}
+
 void check_domain_variable(const DataFrame& df,
                            const std::string& variable,
                            const std::vector<std::string>& variable_values) {
@@ -4,11 +4,12 @@
 #include <arrow/compute/api.h>
 #include <Eigen/Dense>
 #include <dataset/dataset.hpp>
+#include <dataset/chunked_dataframe.hpp>
 #include <factors/assignment.hpp>
 #include <util/hash_utils.hpp>
 
-using dataset::DataFrame;
-using Eigen::VectorXi;
+using dataset::DataFrame, dataset::ChunkedDataFrame;
+using Eigen::VectorXd, Eigen::VectorXi;
 
 namespace factors::discrete {
 
@@ -138,13 +139,70 @@ VectorXi joint_counts(const DataFrame& df,
                       const VectorXi& cardinality,
                       const VectorXi& strides);
 
-VectorXi marginal_counts(const VectorXi& joint_counts, int index, const VectorXi& cardinality, const VectorXi& strides);
+// Counts of each configuration of the variable and evidence, where each row counts as its weight. It is equal to
+// joint_counts() if the DataFrame does not have weights.
+VectorXd weighted_joint_counts(const DataFrame& df,
+                               const std::string& variable,
+                               const std::vector<std::string>& evidence,
+                               const VectorXi& cardinality,
+                               const VectorXi& strides);
+// weighted_joint_counts() summed over the chunks. The chunks have the same dictionaries, so they share the cardinality
+// and strides.
+VectorXd weighted_joint_counts(const ChunkedDataFrame& df,
+                               const std::string& variable,
+                               const std::vector<std::string>& evidence,
+                               const VectorXi& cardinality,
+                               const VectorXi& strides);
+
+template <typename Derived>
+Matrix<typename Derived::Scalar, Dynamic, 1> marginal_counts(const Eigen::MatrixBase<Derived>& joint_counts,
+                                                             int index,
+                                                             const VectorXi& cardinality,
+                                                             const VectorXi& strides) {
+    using VectorType = Matrix<typename Derived::Scalar, Dynamic, 1>;
+    VectorType result = VectorType::Zero(cardinality(index));
+
+    auto stride = strides(index);
+    auto card = cardinality(index);
+
+    for (auto i = 0; i < joint_counts.rows(); ++i) {
+        auto vindex = (i / stride) % card;
+        result(vindex) += joint_counts(i);
+    }
+
+    return result;
+}
 
 std::vector<Array_ptr> discrete_slice_indices(const DataFrame& df,
                                               const std::vector<std::string>& discrete_vars,
                                               const VectorXi& indices,
                                               int num_factors);
 
+// Rows of a DataFrame grouped by the configuration of some discrete variables. The rows of the configuration i are
+// permutation[offsets[i]:offsets[i + 1]], in their original order.
+struct DiscretePartition {
+    Array_ptr permutation;
+    std::vector<int64_t> offsets;
+
+    int num_configurations() const { return static_cast<int>(offsets.size()) - 1; }
+    int64_t offset(int i) const { return offsets[i]; }
+    int64_t length(int i) const { return offsets[i + 1] - offsets[i]; }
+
+    // Rows of the configuration i, where sorted_df = df.take(permutation).
+    DataFrame slice(const DataFrame& sorted_df, int i) const { return sorted_df.slice(offset(i), length(i)); }
+
+    // Non-empty configurations sorted by decreasing number of rows.
+    std::vector<int> largest_first() const;
+};
+
+// Computes a DiscretePartition in a single counting sort pass. The rows with null values in any of the discrete_vars or
+// the valid_columns are excluded.
+DiscretePartition discrete_partition(const DataFrame& df,
+                                     const std::vector<std::string>& discrete_vars,
+                                     const VectorXi& strides,
+                                     int num_factors,
+                                     const std::vector<std::string>& valid_columns);
+
 void check_domain_variable(const DataFrame& df,
                            const std::string& variable,
                            const std::vector<std::string>& variable_values);
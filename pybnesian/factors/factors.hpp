@@ -9,6 +9,7 @@
 #include <pybind11/pybind11.h>
 #include <dataset/dataset.hpp>
 #include <util/pickle.hpp>
+#include <util/profiling.hpp>
 
 using dataset::DataFrame;
 
@@ -178,6 +179,14 @@ public:
 
     virtual bool fitted() const = 0;
     virtual void fit(const DataFrame& df) = 0;
+    // Returns true if fit() can be called concurrently with the fit() of other factors. The Python factors need the GIL.
+    virtual bool thread_safe_fit() const { return !is_python_derived(); }
+    // Estimated relative cost of fit(). It is used to schedule the most expensive factors first when fitting a model. By
+    // default, the cost of a least squares fit is assumed.
+    virtual double fit_cost(const DataFrame& df) const {
+        auto d = static_cast<double>(m_evidence.size() + 1);
+        return static_cast<double>(df->num_rows()) * d * d;
+    }
     virtual VectorXd logl(const DataFrame& df) const = 0;
     virtual double slogl(const DataFrame& df) const = 0;
     // VectorXd cdf(const DataFrame& df) const;
@@ -197,6 +206,42 @@ private:
     std::vector<std::string> m_evidence;
 };
 
+// Timers of the fit() and logl()/slogl() of the factors. The measurements are grouped by the factor type.
+inline util::profiling::ScopedTimer factor_fit_timer(const FactorType& type) {
+    return util::profiling::ScopedTimer([&type]() { return "factor_fit/" + type.ToString(); });
+}
+
+inline util::profiling::ScopedTimer factor_logl_timer(const FactorType& type) {
+    return util::profiling::ScopedTimer([&type]() { return "factor_logl/" + type.ToString(); });
+}
+
+inline util::profiling::ScopedTimer factor_fit_timer(const Factor& factor) {
+    return util::profiling::ScopedTimer([&factor]() { return "factor_fit/" + factor.type()->ToString(); });
+}
+
+inline util::profiling::ScopedTimer factor_logl_timer(const Factor& factor) {
+    return util::profiling::ScopedTimer([&factor]() { return "factor_logl/" + factor.type()->ToString(); });
+}
+
+// slogl() of the factor that honours the frequency weights of df: the log-likelihood of each row is multiplied by its
+// weight. The rows with null values in the variable or the evidence are ignored, as in slogl().
+inline double weighted_slogl(const Factor& factor, const DataFrame& df) {
+    if (!df.has_weights()) return factor.slogl(df);
+
+    VectorXd logl = factor.logl(df);
+    auto bitmap = df.combined_bitmap(factor.variable(), factor.evidence());
+    auto weights = std::static_pointer_cast<arrow::DoubleArray>(df.weights())->raw_values();
+    auto bitmap_data = bitmap ? bitmap->data() : nullptr;
+
+    double accum = 0;
+    for (int64_t i = 0, rows = df->num_rows(); i < rows; ++i) {
+        // A row with weight 0 is not in the data, even if its log-likelihood is -inf.
+        if (weights[i] > 0 && (!bitmap_data || util::bit_util::GetBit(bitmap_data, i))) accum += weights[i] * logl(i);
+    }
+
+    return accum;
+}
+
 }  // namespace factors
 
 #endif  // PYBNESIAN_FACTORS_FACTORS_HPP
\ No newline at end of file
@@ -9,6 +9,7 @@
 #include <util/vector.hpp>
 #include <util/parameter_traits.hpp>
 #include <util/pickle.hpp>
+#include <util/profiling.hpp>
 
 namespace py = pybind11;
 
@@ -2710,12 +2711,12 @@ std::vector<std::string> DagImpl<Derived, BaseClass>::topological_sort() const {
 
 template <typename Derived, typename BaseClass>
 bool DagImpl<Derived, BaseClass>::can_add_arc_unsafe(int source, int target) const {
-    if (source != target && can_exist_arc(*this, source, target) &&
-        (this->num_parents_unsafe(source) == 0 || this->num_children_unsafe(target) == 0 ||
-         !this->has_path_unsafe(target, source))) {
-        return true;
-    }
-    return false;
+    if (source == target || !can_exist_arc(*this, source, target)) return false;
+
+    if (this->num_parents_unsafe(source) == 0 || this->num_children_unsafe(target) == 0) return true;
+
+    util::profiling::count("dag/cycle_checks");
+    return !this->has_path_unsafe(target, source);
 }
 
 template <typename Derived, typename BaseClass>
@@ -2725,6 +2726,7 @@ bool DagImpl<Derived, BaseClass>::can_flip_arc_unsafe(int source, int target) co
     if (this->has_arc_unsafe(source, target)) {
         if (this->num_parents_unsafe(target) == 1 || this->num_children_unsafe(source) == 1) return true;
 
+        util::profiling::count("dag/cycle_checks");
         bool thereis_path = this->has_path_unsafe_no_direct_arc(source, target);
         if (thereis_path) {
             return false;
@@ -2734,6 +2736,7 @@ bool DagImpl<Derived, BaseClass>::can_flip_arc_unsafe(int source, int target) co
     } else {
         if (this->num_parents_unsafe(target) == 0 || this->num_children_unsafe(source) == 0) return true;
 
+        util::profiling::count("dag/cycle_checks");
         bool thereis_path = this->has_path_unsafe(source, target);
         if (thereis_path) {
             return false;
@@ -0,0 +1,252 @@
+#include <inference/GaussianInference.hpp>
+#include <factors/continuous/LinearGaussianCPD.hpp>
+#include <util/math_constants.hpp>
+
+using factors::continuous::LinearGaussianCPD;
+using models::ConditionalBayesianNetworkBase;
+
+namespace inference {
+
+// Returns a (rows x variables) matrix. The rows with some null value are filled with NaN.
+MatrixXd to_double_matrix(const DataFrame& df, const std::vector<std::string>& variables) {
+    MatrixXd m(df->num_rows(), variables.size());
+
+    for (size_t j = 0; j < variables.size(); ++j) {
+        auto col = df.col(variables[j]);
+
+        switch (col->type_id()) {
+            case Type::DOUBLE: {
+                auto dwn = std::static_pointer_cast<arrow::DoubleArray>(col);
+                auto raw = dwn->raw_values();
+                for (int64_t i = 0; i < df->num_rows(); ++i) m(i, j) = raw[i];
+                break;
+            }
+            case Type::FLOAT: {
+                auto dwn = std::static_pointer_cast<arrow::FloatArray>(col);
+                auto raw = dwn->raw_values();
+                for (int64_t i = 0; i < df->num_rows(); ++i) m(i, j) = static_cast<double>(raw[i]);
+                break;
+            }
+            default:
+                throw std::invalid_argument("Wrong data type \"" + col->type()->ToString() + "\" for variable \"" +
+                                            variables[j] + "\". [double] or [float] data is expected.");
+        }
+
+        if (col->null_count() > 0) {
+            auto bitmap_data = col->null_bitmap_data();
+            for (int64_t i = 0; i < df->num_rows(); ++i) {
+                if (!util::bit_util::GetBit(bitmap_data, i)) m(i, j) = util::nan<double>;
+            }
+        }
+    }
+
+    return m;
+}
+
+ConditionalGaussian::ConditionalGaussian(std::vector<std::string> query,
+                                         std::vector<std::string> evidence,
+                                         MatrixXd gain,
+                                         VectorXd offset,
+                                         MatrixXd covariance)
+    : m_query(std::move(query)),
+      m_evidence(std::move(evidence)),
+      m_gain(std::move(gain)),
+      m_offset(std::move(offset)),
+      m_covariance(std::move(covariance)) {
+    auto llt_cov = m_covariance.llt();
+
+    if (llt_cov.info() != Eigen::Success)
+        throw std::invalid_argument("Conditional covariance of the query variables is not positive definite.");
+
+    m_cholesky = llt_cov.matrixL();
+    m_lognorm_const = -m_cholesky.diagonal().array().log().sum() -
+                      0.5 * static_cast<double>(m_query.size()) * std::log(2 * util::pi<double>);
+}
+
+MatrixXd ConditionalGaussian::mean(const DataFrame& df) const {
+    if (m_evidence.empty()) {
+        return m_offset.transpose().replicate(df->num_rows(), 1);
+    }
+
+    df.raise_has_columns(m_evidence);
+    auto e = to_double_matrix(df, m_evidence);
+
+    MatrixXd res = e * m_gain.transpose();
+    res.rowwise() += m_offset.transpose();
+    return res;
+}
+
+VectorXd ConditionalGaussian::logl(const DataFrame& df) const {
+    df.raise_has_columns(m_query);
+
+    MatrixXd centered = to_double_matrix(df, m_query) - mean(df);
+    // Solve L * z = (x - mu)^T for every row at once.
+    MatrixXd z = m_cholesky.triangularView<Eigen::Lower>().solve(centered.transpose());
+
+    VectorXd res = m_lognorm_const - 0.5 * z.colwise().squaredNorm().transpose().array();
+    return res;
+}
+
+std::string ConditionalGaussian::ToString() const {
+    std::string res = "ConditionalGaussian P(";
+
+    for (size_t i = 0; i < m_query.size(); ++i) {
+        if (i > 0) res += ", ";
+        res += m_query[i];
+    }
+
+    if (!m_evidence.empty()) {
+        res += " | ";
+        for (size_t i = 0; i < m_evidence.size(); ++i) {
+            if (i > 0) res += ", ";
+            res += m_evidence[i];
+        }
+    }
+
+    return res + ")";
+}
+
+GaussianInference::GaussianInference(const BayesianNetworkBase& model) : m_cache_mutex(), m_cache() {
+    if (dynamic_cast<const ConditionalBayesianNetworkBase*>(&model))
+        throw std::invalid_argument("GaussianInference cannot be applied to conditional Bayesian networks.");
+
+    if (!model.fitted()) throw std::invalid_argument("Model not fitted.");
+
+    m_nodes = model.graph().topological_sort();
+    auto n = m_nodes.size();
+    for (size_t i = 0; i < n; ++i) {
+        m_indices.insert({m_nodes[i], i});
+    }
+
+    m_mean = VectorXd(n);
+    m_covariance = MatrixXd::Zero(n, n);
+    // B(i, j) is the regression coefficient of the j-th node on the i-th node. Only nonzero if j is a parent of i, so
+    // B is strictly lower triangular in topological order.
+    MatrixXd B = MatrixXd::Zero(n, n);
+    VectorXd variances(n);
+
+    for (size_t i = 0; i < n; ++i) {
+        auto cpd = std::dynamic_pointer_cast<LinearGaussianCPD>(model.cpd(m_nodes[i]));
+        if (!cpd)
+            throw std::invalid_argument("GaussianInference requires LinearGaussianCPD factors. Node \"" + m_nodes[i] +
+                                        "\" has factor " + model.cpd(m_nodes[i])->ToString());
+
+        const auto& beta = cpd->beta();
+        const auto& evidence = cpd->evidence();
+
+        m_mean(i) = beta(0);
+        for (size_t k = 0; k < evidence.size(); ++k) {
+            auto p = m_indices.at(evidence[k]);
+            B(i, p) = beta(k + 1);
+            m_mean(i) += beta(k + 1) * m_mean(p);
+        }
+
+        // Cov(X_i, X_j) = sum_k beta_k Cov(X_pa_k, X_j) for the previous nodes j < i.
+        if (i > 0) {
+            m_covariance.row(i).head(i) = B.row(i).head(i) * m_covariance.topLeftCorner(i, i);
+            m_covariance.col(i).head(i) = m_covariance.row(i).head(i).transpose();
+        }
+
+        variances(i) = cpd->variance();
+        m_covariance(i, i) = variances(i) + m_covariance.row(i).head(i).dot(B.row(i).head(i));
+    }
+
+    // Canonical form: K = (I - B)^T D^-1 (I - B).
+    MatrixXd I_B = MatrixXd::Identity(n, n) - B;
+    m_precision = I_B.transpose() * variances.cwiseInverse().asDiagonal() * I_B;
+}
+
+std::vector<int> GaussianInference::check_variables(const std::vector<std::string>& variables) const {
+    std::vector<int> res;
+    res.reserve(variables.size());
+
+    for (const auto& v : variables) {
+        auto it = m_indices.find(v);
+        if (it == m_indices.end()) throw std::invalid_argument("Variable \"" + v + "\" not present in the model.");
+        res.push_back(it->second);
+    }
+
+    return res;
+}
+
+std::shared_ptr<ConditionalGaussian> GaussianInference::compute_conditional(const std::vector<std::string>& query,
+                                                                            const std::vector<std::string>& evidence,
+                                                                            const std::vector<int>& query_idx,
+                                                                            const std::vector<int>& evidence_idx) const {
+    auto q = query_idx.size();
+    auto e = evidence_idx.size();
+
+    VectorXd mu_q(q);
+    MatrixXd cov_qq(q, q);
+    for (size_t i = 0; i < q; ++i) {
+        mu_q(i) = m_mean(query_idx[i]);
+        for (size_t j = 0; j < q; ++j) {
+            cov_qq(i, j) = m_covariance(query_idx[i], query_idx[j]);
+        }
+    }
+
+    if (e == 0) {
+        return std::make_shared<ConditionalGaussian>(query, evidence, MatrixXd(q, 0), mu_q, cov_qq);
+    }
+
+    VectorXd mu_e(e);
+    MatrixXd cov_ee(e, e);
+    MatrixXd cov_eq(e, q);
+    for (size_t i = 0; i < e; ++i) {
+        mu_e(i) = m_mean(evidence_idx[i]);
+        for (size_t j = 0; j < e; ++j) {
+            cov_ee(i, j) = m_covariance(evidence_idx[i], evidence_idx[j]);
+        }
+
+        for (size_t j = 0; j < q; ++j) {
+            cov_eq(i, j) = m_covariance(evidence_idx[i], query_idx[j]);
+        }
+    }
+
+    auto llt_ee = cov_ee.llt();
+    if (llt_ee.info() != Eigen::Success)
+        throw std::invalid_argument("Covariance of the evidence variables is not positive definite.");
+
+    // K^T = Sigma_EE^-1 * Sigma_EQ
+    MatrixXd gain = llt_ee.solve(cov_eq).transpose();
+    VectorXd offset = mu_q - gain * mu_e;
+    MatrixXd cov = cov_qq - gain * cov_eq;
+
+    return std::make_shared<ConditionalGaussian>(query, evidence, std::move(gain), std::move(offset), std::move(cov));
+}
+
+std::shared_ptr<ConditionalGaussian> GaussianInference::conditional(const std::vector<std::string>& query,
+                                                                    const std::vector<std::string>& evidence) const {
+    if (query.empty()) throw std::invalid_argument("Query variables cannot be empty.");
+
+    auto query_idx = check_variables(query);
+    auto evidence_idx = check_variables(evidence);
+
+    std::unordered_set<int> query_set(query_idx.begin(), query_idx.end());
+    if (query_set.size() != query_idx.size()) throw std::invalid_argument("Query variables contain duplicates.");
+
+    std::unordered_set<int> evidence_set(evidence_idx.begin(), evidence_idx.end());
+    if (evidence_set.size() != evidence_idx.size())
+        throw std::invalid_argument("Evidence variables contain duplicates.");
+
+    for (auto e : evidence_idx) {
+        if (query_set.count(e) > 0)
+            throw std::invalid_argument("Variable \"" + m_nodes[e] + "\" is both a query and an evidence variable.");
+    }
+
+    auto key = std::make_pair(std::move(query_idx), std::move(evidence_idx));
+
+    {
+        std::lock_guard<std::mutex> lock(m_cache_mutex);
+        auto it = m_cache.find(key);
+        if (it != m_cache.end()) return it->second;
+    }
+
+    auto res = compute_conditional(query, evidence, key.first, key.second);
+
+    std::lock_guard<std::mutex> lock(m_cache_mutex);
+    // If other thread computed the same pattern, keep the first inserted result.
+    return m_cache.insert({std::move(key), res}).first->second;
+}
+
+}  // namespace inference
@@ -0,0 +1,130 @@
+#ifndef PYBNESIAN_INFERENCE_GAUSSIANINFERENCE_HPP
+#define PYBNESIAN_INFERENCE_GAUSSIANINFERENCE_HPP
+
+#include <mutex>
+#include <Eigen/Dense>
+#include <dataset/dataset.hpp>
+#include <models/BayesianNetwork.hpp>
+#include <util/hash_utils.hpp>
+
+using dataset::DataFrame;
+using Eigen::MatrixXd, Eigen::VectorXd, Eigen::LLT;
+using models::BayesianNetworkBase;
+
+namespace inference {
+
+// Conditional distribution N(mu_Q + K (e - mu_E), Sigma_Q|E) for a fixed (query, evidence) pattern. It stores the
+// Schur complement of the joint covariance so that it can be reused for any number of evidence rows.
+class ConditionalGaussian {
+public:
+    ConditionalGaussian(std::vector<std::string> query,
+                        std::vector<std::string> evidence,
+                        MatrixXd gain,
+                        VectorXd offset,
+                        MatrixXd covariance);
+
+    const std::vector<std::string>& query() const { return m_query; }
+    const std::vector<std::string>& evidence() const { return m_evidence; }
+
+    // K = Sigma_QE * Sigma_EE^-1
+    const MatrixXd& gain() const { return m_gain; }
+    // mu_Q - K * mu_E
+    const VectorXd& offset() const { return m_offset; }
+    // Sigma_QQ - K * Sigma_EQ
+    const MatrixXd& covariance() const { return m_covariance; }
+
+    MatrixXd mean(const DataFrame& df) const;
+    VectorXd logl(const DataFrame& df) const;
+
+    std::string ToString() const;
+
+private:
+    std::vector<std::string> m_query;
+    std::vector<std::string> m_evidence;
+    MatrixXd m_gain;
+    VectorXd m_offset;
+    MatrixXd m_covariance;
+    MatrixXd m_cholesky;
+    double m_lognorm_const;
+};
+
+struct PatternHash {
+    std::size_t operator()(const std::pair<std::vector<int>, std::vector<int>>& p) const {
+        std::size_t seed = p.first.size();
+        for (auto i : p.first) util::hash_combine(seed, i);
+        util::hash_combine(seed, -1);
+        for (auto i : p.second) util::hash_combine(seed, i);
+        return seed;
+    }
+};
+
+// Exact inference for Bayesian networks with LinearGaussianCPD factors. The network is compiled once (following the
+// topological order) into the joint multivariate normal distribution. Conditional distributions are cached by
+// (query, evidence) pattern, so repeated queries with the same pattern only cost a matrix product.
+class GaussianInference {
+public:
+    GaussianInference(const BayesianNetworkBase& model);
+
+    const std::vector<std::string>& nodes() const { return m_nodes; }
+    int num_nodes() const { return static_cast<int>(m_nodes.size()); }
+
+    const VectorXd& mean() const { return m_mean; }
+    const MatrixXd& covariance() const { return m_covariance; }
+    const MatrixXd& precision() const { return m_precision; }
+    VectorXd potential() const { return m_precision * m_mean; }
+
+    std::shared_ptr<ConditionalGaussian> conditional(const std::vector<std::string>& query,
+                                                     const std::vector<std::string>& evidence) const;
+
+    MatrixXd conditional_mean(const std::vector<std::string>& query,
+                              const std::vector<std::string>& evidence,
+                              const DataFrame& df) const {
+        return conditional(query, evidence)->mean(df);
+    }
+
+    MatrixXd conditional_covariance(const std::vector<std::string>& query,
+                                    const std::vector<std::string>& evidence) const {
+        return conditional(query, evidence)->covariance();
+    }
+
+    VectorXd logl(const std::vector<std::string>& query,
+                  const std::vector<std::string>& evidence,
+                  const DataFrame& df) const {
+        return conditional(query, evidence)->logl(df);
+    }
+
+    int num_cached() const {
+        std::lock_guard<std::mutex> lock(m_cache_mutex);
+        return static_cast<int>(m_cache.size());
+    }
+
+    void clear_cache() {
+        std::lock_guard<std::mutex> lock(m_cache_mutex);
+        m_cache.clear();
+    }
+
+    std::string ToString() const { return "GaussianInference(" + std::to_string(m_nodes.size()) + " nodes)"; }
+
+private:
+    std::vector<int> check_variables(const std::vector<std::string>& variables) const;
+    std::shared_ptr<ConditionalGaussian> compute_conditional(const std::vector<std::string>& query,
+                                                             const std::vector<std::string>& evidence,
+                                                             const std::vector<int>& query_idx,
+                                                             const std::vector<int>& evidence_idx) const;
+
+    std::vector<std::string> m_nodes;
+    std::unordered_map<std::string, int> m_indices;
+    VectorXd m_mean;
+    MatrixXd m_covariance;
+    MatrixXd m_precision;
+
+    mutable std::mutex m_cache_mutex;
+    mutable std::unordered_map<std::pair<std::vector<int>, std::vector<int>>,
+                               std::shared_ptr<ConditionalGaussian>,
+                               PatternHash>
+        m_cache;
+};
+
+}  // namespace inference
+
+#endif  // PYBNESIAN_INFERENCE_GAUSSIANINFERENCE_HPP
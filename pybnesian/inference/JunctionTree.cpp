@@ -0,0 +1,665 @@
+#include <numeric>
+#include <inference/JunctionTree.hpp>
+#include <factors/discrete/DiscreteFactor.hpp>
+#include <factors/discrete/discrete_indices.hpp>
+#include <util/math_constants.hpp>
+#include <util/parallel.hpp>
+
+using factors::discrete::DiscreteFactor, factors::discrete::check_domain_variable;
+using models::ConditionalBayesianNetworkBase;
+
+namespace inference {
+
+template <typename ArrowType>
+void fill_dictionary_codes(const Array_ptr& indices, std::vector<int>& codes) {
+    using ArrayType = typename arrow::TypeTraits<ArrowType>::ArrayType;
+    auto dwn_indices = std::static_pointer_cast<ArrayType>(indices);
+    auto raw_values = dwn_indices->raw_values();
+    for (int64_t i = 0; i < indices->length(); ++i) {
+        codes[i] = static_cast<int>(raw_values[i]);
+    }
+}
+
+// Returns the category index of each row of a categorical column. Null values are represented with -1.
+std::vector<int> dictionary_codes(const DataFrame& df, const std::string& variable) {
+    auto col = df.col(variable);
+    auto dict = std::static_pointer_cast<arrow::DictionaryArray>(col);
+    auto indices = dict->indices();
+
+    std::vector<int> codes(df->num_rows());
+    switch (indices->type_id()) {
+        case Type::INT8:
+            fill_dictionary_codes<arrow::Int8Type>(indices, codes);
+            break;
+        case Type::INT16:
+            fill_dictionary_codes<arrow::Int16Type>(indices, codes);
+            break;
+        case Type::INT32:
+            fill_dictionary_codes<arrow::Int32Type>(indices, codes);
+            break;
+        case Type::INT64:
+            fill_dictionary_codes<arrow::Int64Type>(indices, codes);
+            break;
+        default:
+            throw std::invalid_argument("Wrong indices array type of DictionaryArray.");
+    }
+
+    if (col->null_count() > 0) {
+        auto bitmap_data = col->null_bitmap_data();
+        for (int64_t i = 0; i < df->num_rows(); ++i) {
+            if (!util::bit_util::GetBit(bitmap_data, i)) codes[i] = -1;
+        }
+    }
+
+    return codes;
+}
+
+PotentialDomain make_domain(std::vector<int> variables, const VectorXi& node_cardinality) {
+    PotentialDomain d;
+    d.variables = std::move(variables);
+    d.cardinality = VectorXi(d.variables.size());
+    d.strides = VectorXi(d.variables.size());
+
+    int64_t size = 1;
+    for (size_t i = 0; i < d.variables.size(); ++i) {
+        d.cardinality(i) = node_cardinality(d.variables[i]);
+        d.strides(i) = static_cast<int>(size);
+        size *= d.cardinality(i);
+
+        if (size > std::numeric_limits<int>::max())
+            throw std::invalid_argument("The table of a clique is too large. Try another triangulation heuristic.");
+    }
+
+    d.size = static_cast<int>(size);
+    return d;
+}
+
+JunctionTree::JunctionTree(const BayesianNetworkBase& model, const std::string& heuristic, int max_cached)
+    : m_max_cached(max_cached), m_cache_mutex(), m_lru(), m_cache() {
+    if (max_cached < 0) throw std::invalid_argument("The maximum number of cached trees cannot be negative.");
+
+    if (heuristic != "min-fill" && heuristic != "min-weight")
+        throw std::invalid_argument("Wrong heuristic \"" + heuristic +
+                                    "\". Valid heuristics are: min-fill, min-weight");
+
+    if (dynamic_cast<const ConditionalBayesianNetworkBase*>(&model))
+        throw std::invalid_argument("JunctionTree cannot be applied to conditional Bayesian networks.");
+
+    if (!model.fitted()) throw std::invalid_argument("Model not fitted.");
+
+    m_nodes = model.nodes();
+    auto n = m_nodes.size();
+    m_cardinality = VectorXi(n);
+    m_values.reserve(n);
+
+    for (size_t i = 0; i < n; ++i) {
+        m_indices.insert({m_nodes[i], i});
+    }
+
+    std::vector<std::unordered_set<int>> moral(n);
+    for (size_t i = 0; i < n; ++i) {
+        auto cpd = std::dynamic_pointer_cast<DiscreteFactor>(model.cpd(m_nodes[i]));
+        if (!cpd)
+            throw std::invalid_argument("JunctionTree requires DiscreteFactor factors. Node \"" + m_nodes[i] +
+                                        "\" has factor " + model.cpd(m_nodes[i])->ToString());
+
+        m_values.push_back(cpd->variable_values());
+        m_cardinality(i) = cpd->variable_values().size();
+
+        std::vector<int> family;
+        family.reserve(cpd->evidence().size() + 1);
+        family.push_back(i);
+        for (const auto& p : cpd->evidence()) family.push_back(m_indices.at(p));
+
+        for (size_t j = 0; j < family.size(); ++j) {
+            for (size_t k = j + 1; k < family.size(); ++k) {
+                moral[family[j]].insert(family[k]);
+                moral[family[k]].insert(family[j]);
+            }
+        }
+    }
+
+    triangulate(heuristic, moral);
+    build_tree();
+    initialize_potentials(model);
+}
+
+void JunctionTree::triangulate(const std::string& heuristic, const std::vector<std::unordered_set<int>>& moral) {
+    auto n = m_nodes.size();
+    auto adj = moral;
+    std::vector<bool> eliminated(n, false);
+    std::vector<std::vector<int>> cliques;
+
+    // The log-cardinality avoids overflows when computing the weight of large cliques.
+    VectorXd log_cardinality = m_cardinality.cast<double>().array().log();
+    bool min_fill = heuristic == "min-fill";
+
+    for (size_t step = 0; step < n; ++step) {
+        int best = -1;
+        double best_cost = std::numeric_limits<double>::infinity();
+        double best_weight = std::numeric_limits<double>::infinity();
+
+        for (size_t v = 0; v < n; ++v) {
+            if (eliminated[v]) continue;
+
+            double weight = log_cardinality(v);
+            for (auto u : adj[v]) weight += log_cardinality(u);
+
+            double cost = weight;
+            if (min_fill) {
+                int fill = 0;
+                for (auto it = adj[v].begin(), end = adj[v].end(); it != end; ++it) {
+                    for (auto it2 = std::next(it); it2 != end; ++it2) {
+                        if (adj[*it].count(*it2) == 0) ++fill;
+                    }
+                }
+                cost = fill;
+            }
+
+            if (cost < best_cost || (cost == best_cost && weight < best_weight)) {
+                best = v;
+                best_cost = cost;
+                best_weight = weight;
+            }
+        }
+
+        std::vector<int> clique(adj[best].begin(), adj[best].end());
+        clique.push_back(best);
+        std::sort(clique.begin(), clique.end());
+
+        for (auto it = adj[best].begin(), end = adj[best].end(); it != end; ++it) {
+            for (auto it2 = std::next(it); it2 != end; ++it2) {
+                adj[*it].insert(*it2);
+                adj[*it2].insert(*it);
+            }
+        }
+
+        for (auto u : adj[best]) adj[u].erase(best);
+        adj[best].clear();
+        eliminated[best] = true;
+
+        // A clique created later can not contain a previously eliminated node, so it is only needed to check that the
+        // new clique is not contained in a previous one.
+        bool maximal = std::none_of(cliques.begin(), cliques.end(), [&clique](const std::vector<int>& c) {
+            return std::includes(c.begin(), c.end(), clique.begin(), clique.end());
+        });
+
+        if (maximal) cliques.push_back(std::move(clique));
+    }
+
+    m_cliques.reserve(cliques.size());
+    for (auto& c : cliques) {
+        m_cliques.push_back(make_domain(std::move(c), m_cardinality));
+    }
+}
+
+void JunctionTree::build_tree() {
+    auto num_cliques = m_cliques.size();
+
+    // Maximum spanning tree on the separator sizes (Kruskal). Separators can be empty, so the result is always a
+    // single tree even if the network is disconnected.
+    std::vector<std::tuple<int, int, int>> candidates;
+    for (size_t i = 0; i < num_cliques; ++i) {
+        for (size_t j = i + 1; j < num_cliques; ++j) {
+            std::vector<int> intersection;
+            std::set_intersection(m_cliques[i].variables.begin(),
+                                  m_cliques[i].variables.end(),
+                                  m_cliques[j].variables.begin(),
+                                  m_cliques[j].variables.end(),
+                                  std::back_inserter(intersection));
+            candidates.emplace_back(static_cast<int>(intersection.size()), static_cast<int>(i), static_cast<int>(j));
+        }
+    }
+
+    std::stable_sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b) {
+        return std::get<0>(a) > std::get<0>(b);
+    });
+
+    std::vector<int> component(num_cliques);
+    std::iota(component.begin(), component.end(), 0);
+    auto find = [&component](int i) {
+        while (component[i] != i) {
+            component[i] = component[component[i]];
+            i = component[i];
+        }
+        return i;
+    };
+
+    std::vector<std::vector<int>> tree_adj(num_cliques);
+    for (const auto& [weight, i, j] : candidates) {
+        auto ci = find(i);
+        auto cj = find(j);
+        if (ci != cj) {
+            component[ci] = cj;
+            tree_adj[i].push_back(j);
+            tree_adj[j].push_back(i);
+        }
+    }
+
+    m_parent_edge = std::vector<int>(num_cliques, -1);
+    m_order.reserve(num_cliques);
+    std::vector<bool> visited(num_cliques, false);
+
+    if (num_cliques > 0) {
+        m_order.push_back(0);
+        visited[0] = true;
+    }
+
+    for (size_t k = 0; k < m_order.size(); ++k) {
+        auto parent = m_order[k];
+        for (auto child : tree_adj[parent]) {
+            if (visited[child]) continue;
+            visited[child] = true;
+
+            std::vector<int> sep;
+            std::set_intersection(m_cliques[parent].variables.begin(),
+                                  m_cliques[parent].variables.end(),
+                                  m_cliques[child].variables.begin(),
+                                  m_cliques[child].variables.end(),
+                                  std::back_inserter(sep));
+
+            m_parent_edge[child] = m_edges.size();
+            m_edges.push_back(std::make_pair(parent, child));
+            m_separators.push_back(make_domain(std::move(sep), m_cardinality));
+            m_parent_maps.push_back(index_map(m_cliques[parent], m_separators.back()));
+            m_child_maps.push_back(index_map(m_cliques[child], m_separators.back()));
+            m_order.push_back(child);
+        }
+    }
+}
+
+VectorXi JunctionTree::index_map(const PotentialDomain& from, const PotentialDomain& to) const {
+    VectorXi map = VectorXi::Zero(from.size);
+
+    for (size_t j = 0; j < to.variables.size(); ++j) {
+        auto it = std::find(from.variables.begin(), from.variables.end(), to.variables[j]);
+        auto p = std::distance(from.variables.begin(), it);
+
+        auto stride = from.strides(p);
+        auto card = from.cardinality(p);
+        auto to_stride = to.strides(j);
+
+        for (int k = 0; k < from.size; ++k) {
+            map(k) += ((k / stride) % card) * to_stride;
+        }
+    }
+
+    return map;
+}
+
+int JunctionTree::smallest_clique_containing(const std::vector<int>& variables) const {
+    int best = -1;
+    for (size_t c = 0; c < m_cliques.size(); ++c) {
+        const auto& vars = m_cliques[c].variables;
+        bool contains = std::all_of(variables.begin(), variables.end(), [&vars](int v) {
+            return std::binary_search(vars.begin(), vars.end(), v);
+        });
+
+        if (contains && (best == -1 || m_cliques[c].size < m_cliques[best].size)) best = c;
+    }
+
+    return best;
+}
+
+void JunctionTree::initialize_potentials(const BayesianNetworkBase& model) {
+    m_initial_potentials.reserve(m_cliques.size());
+    for (const auto& c : m_cliques) {
+        m_initial_potentials.push_back(VectorXd::Ones(c.size));
+    }
+
+    m_home_clique.reserve(m_nodes.size());
+    for (size_t i = 0; i < m_nodes.size(); ++i) {
+        m_home_clique.push_back(smallest_clique_containing({static_cast<int>(i)}));
+    }
+
+    for (size_t i = 0; i < m_nodes.size(); ++i) {
+        auto cpd = std::static_pointer_cast<DiscreteFactor>(model.cpd(m_nodes[i]));
+
+        PotentialDomain family;
+        family.variables.push_back(i);
+        for (const auto& p : cpd->evidence()) family.variables.push_back(m_indices.at(p));
+        family.cardinality = cpd->cardinality();
+        family.strides = cpd->strides();
+        family.size = cpd->logprob().rows();
+
+        // The moral graph contains every family as a complete subgraph, so some clique contains it.
+        auto c = smallest_clique_containing(family.variables);
+        auto map = index_map(m_cliques[c], family);
+        VectorXd prob = cpd->logprob().array().exp();
+
+        auto& potential = m_initial_potentials[c];
+        for (int k = 0; k < potential.rows(); ++k) {
+            potential(k) *= prob(map(k));
+        }
+    }
+}
+
+int JunctionTree::check_variable(const std::string& variable) const {
+    auto it = m_indices.find(variable);
+    if (it == m_indices.end()) throw std::invalid_argument("Variable \"" + variable + "\" not present in the model.");
+    return it->second;
+}
+
+std::vector<std::vector<std::string>> JunctionTree::cliques() const {
+    std::vector<std::vector<std::string>> res;
+    res.reserve(m_cliques.size());
+
+    for (const auto& c : m_cliques) {
+        std::vector<std::string> names;
+        for (auto v : c.variables) names.push_back(m_nodes[v]);
+        res.push_back(std::move(names));
+    }
+
+    return res;
+}
+
+std::vector<std::vector<std::string>> JunctionTree::separators() const {
+    std::vector<std::vector<std::string>> res;
+    res.reserve(m_separators.size());
+
+    for (const auto& s : m_separators) {
+        std::vector<std::string> names;
+        for (auto v : s.variables) names.push_back(m_nodes[v]);
+        res.push_back(std::move(names));
+    }
+
+    return res;
+}
+
+int JunctionTree::treewidth() const {
+    size_t max_size = 0;
+    for (const auto& c : m_cliques) {
+        max_size = std::max(max_size, c.variables.size());
+    }
+
+    return static_cast<int>(max_size) - 1;
+}
+
+int64_t JunctionTree::total_table_size() const {
+    int64_t res = 0;
+    for (const auto& c : m_cliques) res += c.size;
+    return res;
+}
+
+JunctionTree::EvidenceBatch JunctionTree::group_evidence(const DataFrame& df,
+                                                         const std::unordered_set<int>& excluded) const {
+    EvidenceBatch batch;
+
+    for (size_t v = 0; v < m_nodes.size(); ++v) {
+        if (excluded.count(v) == 0 && df.has_columns(m_nodes[v])) {
+            check_domain_variable(df, m_nodes[v], m_values[v]);
+            batch.variables.push_back(v);
+        }
+    }
+
+    auto n = df->num_rows();
+    // Each row is encoded in mixed radix, where the digit of each variable is (value + 1), so that 0 represents null.
+    std::vector<int64_t> row_codes(n, 0);
+    int64_t radix = 1;
+    for (auto v : batch.variables) {
+        auto codes = dictionary_codes(df, m_nodes[v]);
+        for (int64_t i = 0; i < n; ++i) {
+            row_codes[i] += (codes[i] + 1) * radix;
+        }
+
+        if (radix > std::numeric_limits<int64_t>::max() / (m_cardinality(v) + 1))
+            throw std::invalid_argument("Too many evidence variables to encode the evidence configurations.");
+        radix *= m_cardinality(v) + 1;
+    }
+
+    std::unordered_map<int64_t, int> configuration_index;
+    batch.row_configuration.reserve(n);
+    for (int64_t i = 0; i < n; ++i) {
+        auto [it, inserted] = configuration_index.insert({row_codes[i], batch.codes.size()});
+        if (inserted) batch.codes.push_back(row_codes[i]);
+        batch.row_configuration.push_back(it->second);
+    }
+
+    batch.configurations.reserve(batch.codes.size());
+    for (auto code : batch.codes) {
+        std::vector<int> values;
+        values.reserve(batch.variables.size());
+        for (auto v : batch.variables) {
+            values.push_back(static_cast<int>(code % (m_cardinality(v) + 1)) - 1);
+            code /= m_cardinality(v) + 1;
+        }
+
+        batch.configurations.push_back(std::move(values));
+    }
+
+    return batch;
+}
+
+std::shared_ptr<const CalibratedTree> JunctionTree::calibrate(const std::vector<int>& evidence_variables,
+                                                              const std::vector<int>& values) const {
+    auto tree = std::make_shared<CalibratedTree>();
+    auto& potentials = tree->clique_potentials;
+    potentials = m_initial_potentials;
+    tree->log_evidence = 0;
+
+    if (m_order.empty()) return tree;
+
+    for (size_t i = 0; i < evidence_variables.size(); ++i) {
+        if (values[i] == -1) continue;
+
+        auto v = evidence_variables[i];
+        auto c = m_home_clique[v];
+        const auto& domain = m_cliques[c];
+        auto p = std::distance(domain.variables.begin(),
+                               std::lower_bound(domain.variables.begin(), domain.variables.end(), v));
+        auto stride = domain.strides(p);
+        auto card = domain.cardinality(p);
+
+        for (int k = 0; k < domain.size; ++k) {
+            if ((k / stride) % card != values[i]) potentials[c](k) = 0;
+        }
+    }
+
+    // Collect: the messages are normalized to avoid underflows, and their normalization constants are accumulated to
+    // compute log P(e).
+    std::vector<VectorXd> separators(m_edges.size());
+    double log_norm = 0;
+    for (auto it = m_order.rbegin(), end = m_order.rend(); it != end; ++it) {
+        auto e = m_parent_edge[*it];
+        if (e == -1) continue;
+
+        auto parent = m_edges[e].first;
+        const auto& child_pot = potentials[*it];
+        const auto& child_map = m_child_maps[e];
+        auto& message = separators[e];
+
+        message = VectorXd::Zero(m_separators[e].size);
+        for (int k = 0; k < child_pot.rows(); ++k) {
+            message(child_map(k)) += child_pot(k);
+        }
+
+        auto s = message.sum();
+        if (s == 0) {
+            tree->log_evidence = -std::numeric_limits<double>::infinity();
+            return tree;
+        }
+
+        message /= s;
+        log_norm += std::log(s);
+
+        auto& parent_pot = potentials[parent];
+        const auto& parent_map = m_parent_maps[e];
+        for (int k = 0; k < parent_pot.rows(); ++k) {
+            parent_pot(k) *= message(parent_map(k));
+        }
+    }
+
+    auto root = m_order.front();
+    auto root_sum = potentials[root].sum();
+    if (root_sum == 0) {
+        tree->log_evidence = -std::numeric_limits<double>::infinity();
+        return tree;
+    }
+
+    potentials[root] /= root_sum;
+    tree->log_evidence = log_norm + std::log(root_sum);
+
+    // Distribute
+    for (auto c : m_order) {
+        auto e = m_parent_edge[c];
+        if (e == -1) continue;
+
+        auto parent = m_edges[e].first;
+        const auto& parent_pot = potentials[parent];
+        const auto& parent_map = m_parent_maps[e];
+
+        VectorXd ratio = VectorXd::Zero(m_separators[e].size);
+        for (int k = 0; k < parent_pot.rows(); ++k) {
+            ratio(parent_map(k)) += parent_pot(k);
+        }
+
+        const auto& old_message = separators[e];
+        for (int j = 0; j < ratio.rows(); ++j) {
+            ratio(j) = (old_message(j) > 0) ? ratio(j) / old_message(j) : 0;
+        }
+
+        auto& child_pot = potentials[c];
+        const auto& child_map = m_child_maps[e];
+        for (int k = 0; k < child_pot.rows(); ++k) {
+            child_pot(k) *= ratio(child_map(k));
+        }
+
+        child_pot /= child_pot.sum();
+    }
+
+    return tree;
+}
+
+std::shared_ptr<const CalibratedTree> JunctionTree::cache_find(const EvidenceKey& key) const {
+    auto it = m_cache.find(key);
+    if (it == m_cache.end()) return nullptr;
+
+    m_lru.splice(m_lru.begin(), m_lru, it->second.second);
+    return it->second.first;
+}
+
+void JunctionTree::cache_insert(EvidenceKey key, std::shared_ptr<const CalibratedTree> tree) const {
+    if (m_max_cached == 0 || m_cache.count(key) > 0) return;
+
+    if (static_cast<int>(m_cache.size()) == m_max_cached) {
+        m_cache.erase(m_lru.back());
+        m_lru.pop_back();
+    }
+
+    m_lru.push_front(key);
+    m_cache.insert({std::move(key), std::make_pair(std::move(tree), m_lru.begin())});
+}
+
+std::vector<std::shared_ptr<const CalibratedTree>> JunctionTree::calibrate_batch(const EvidenceBatch& batch) const {
+    auto num_configurations = batch.codes.size();
+    std::vector<std::shared_ptr<const CalibratedTree>> trees(num_configurations);
+    std::vector<int> missing;
+
+    {
+        std::lock_guard<std::mutex> lock(m_cache_mutex);
+        for (size_t i = 0; i < num_configurations; ++i) {
+            trees[i] = cache_find(std::make_pair(batch.variables, batch.codes[i]));
+            if (!trees[i]) missing.push_back(i);
+        }
+    }
+
+#pragma omp parallel for schedule(dynamic) num_threads(util::num_threads())
+    for (size_t i = 0; i < missing.size(); ++i) {
+        auto index = missing[i];
+        trees[index] = calibrate(batch.variables, batch.configurations[index]);
+    }
+
+    std::lock_guard<std::mutex> lock(m_cache_mutex);
+    for (auto index : missing) {
+        cache_insert(std::make_pair(batch.variables, batch.codes[index]), trees[index]);
+    }
+
+    return trees;
+}
+
+VectorXd marginalize_tree(const CalibratedTree& tree, int clique, const VectorXi& map, int size) {
+    if (tree.log_evidence == -std::numeric_limits<double>::infinity()) {
+        return VectorXd::Constant(size, util::nan<double>);
+    }
+
+    VectorXd res = VectorXd::Zero(size);
+    const auto& potential = tree.clique_potentials[clique];
+    for (int k = 0; k < potential.rows(); ++k) {
+        res(map(k)) += potential(k);
+    }
+
+    return res / res.sum();
+}
+
+std::pair<int, PotentialDomain> JunctionTree::query_domain(const std::vector<std::string>& variables) const {
+    if (variables.empty()) throw std::invalid_argument("Query variables cannot be empty.");
+
+    std::vector<int> query_idx;
+    query_idx.reserve(variables.size());
+    for (const auto& v : variables) query_idx.push_back(check_variable(v));
+
+    std::unordered_set<int> query_set(query_idx.begin(), query_idx.end());
+    if (query_set.size() != query_idx.size()) throw std::invalid_argument("Query variables contain duplicates.");
+
+    std::vector<int> sorted_query = query_idx;
+    std::sort(sorted_query.begin(), sorted_query.end());
+    auto c = smallest_clique_containing(sorted_query);
+    if (c == -1)
+        throw std::invalid_argument(
+            "The query variables are not contained in a clique of the junction tree. Query the variables separately.");
+
+    return std::make_pair(c, make_domain(std::move(query_idx), m_cardinality));
+}
+
+VectorXd JunctionTree::prior(const std::vector<std::string>& variables) const {
+    auto [c, target] = query_domain(variables);
+    auto map = index_map(m_cliques[c], target);
+
+    // Single configuration without evidence.
+    EvidenceBatch batch;
+    batch.codes.push_back(0);
+    batch.configurations.push_back({});
+    auto trees = calibrate_batch(batch);
+
+    return marginalize_tree(*trees[0], c, map, target.size);
+}
+
+MatrixXd JunctionTree::query(const std::vector<std::string>& variables, const DataFrame& df) const {
+    auto [c, target] = query_domain(variables);
+    auto map = index_map(m_cliques[c], target);
+
+    std::unordered_set<int> query_set(target.variables.begin(), target.variables.end());
+    auto batch = group_evidence(df, query_set);
+    auto trees = calibrate_batch(batch);
+
+    std::vector<VectorXd> marginals;
+    marginals.reserve(trees.size());
+    for (const auto& t : trees) {
+        marginals.push_back(marginalize_tree(*t, c, map, target.size));
+    }
+
+    MatrixXd res(df->num_rows(), target.size);
+    for (int64_t i = 0; i < df->num_rows(); ++i) {
+        res.row(i) = marginals[batch.row_configuration[i]].transpose();
+    }
+
+    return res;
+}
+
+VectorXd JunctionTree::log_probability_evidence(const DataFrame& df) const {
+    auto batch = group_evidence(df, {});
+    auto trees = calibrate_batch(batch);
+
+    VectorXd res(df->num_rows());
+    for (int64_t i = 0; i < df->num_rows(); ++i) {
+        res(i) = trees[batch.row_configuration[i]]->log_evidence;
+    }
+
+    return res;
+}
+
+VectorXd JunctionTree::probability_evidence(const DataFrame& df) const {
+    return log_probability_evidence(df).array().exp();
+}
+
+}  // namespace inference
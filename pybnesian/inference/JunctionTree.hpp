@@ -0,0 +1,149 @@
+#ifndef PYBNESIAN_INFERENCE_JUNCTIONTREE_HPP
+#define PYBNESIAN_INFERENCE_JUNCTIONTREE_HPP
+
+#include <list>
+#include <mutex>
+#include <Eigen/Dense>
+#include <dataset/dataset.hpp>
+#include <models/BayesianNetwork.hpp>
+#include <util/hash_utils.hpp>
+
+using dataset::DataFrame;
+using Eigen::MatrixXd, Eigen::VectorXd, Eigen::VectorXi;
+using models::BayesianNetworkBase;
+
+namespace inference {
+
+// A clique (or separator) table. The table is stored contiguously with the same strides convention as DiscreteFactor:
+// the first variable has stride 1 and strides(i) = strides(i - 1) * cardinality(i - 1).
+struct PotentialDomain {
+    std::vector<int> variables;
+    VectorXi cardinality;
+    VectorXi strides;
+    int size;
+};
+
+// A junction tree calibrated for a given evidence configuration. The potentials are proportional to the posterior
+// marginals of each clique.
+struct CalibratedTree {
+    std::vector<VectorXd> clique_potentials;
+    // log P(e)
+    double log_evidence;
+};
+
+// Evidence variables and the code of their configuration.
+using EvidenceKey = std::pair<std::vector<int>, int64_t>;
+
+struct EvidenceKeyHash {
+    std::size_t operator()(const EvidenceKey& k) const {
+        std::size_t seed = k.first.size();
+        for (auto i : k.first) util::hash_combine(seed, i);
+        util::hash_combine(seed, k.second);
+        return seed;
+    }
+};
+
+// Exact inference for Bayesian networks with DiscreteFactor CPDs. The moral graph is triangulated with a greedy
+// elimination heuristic ("min-fill" or "min-weight") and compiled into a junction tree. Each clique-to-separator
+// projection is precomputed as an index map, so message passing is a flat gather/scatter over contiguous tables.
+//
+// The evidence of a DataFrame is grouped by configuration: the tree is calibrated once for each unique configuration
+// (in parallel) and the calibrated trees are cached for later queries. The cache keeps the max_cached most recently
+// used configurations.
+class JunctionTree {
+public:
+    JunctionTree(const BayesianNetworkBase& model, const std::string& heuristic = "min-fill", int max_cached = 1024);
+
+    const std::vector<std::string>& nodes() const { return m_nodes; }
+    int num_nodes() const { return static_cast<int>(m_nodes.size()); }
+    const std::vector<std::string>& variable_values(const std::string& variable) const {
+        return m_values[check_variable(variable)];
+    }
+
+    std::vector<std::vector<std::string>> cliques() const;
+    const std::vector<std::pair<int, int>>& edges() const { return m_edges; }
+    std::vector<std::vector<std::string>> separators() const;
+    int treewidth() const;
+    int64_t total_table_size() const;
+
+    VectorXd prior(const std::vector<std::string>& variables) const;
+    MatrixXd query(const std::vector<std::string>& variables, const DataFrame& df) const;
+    VectorXd probability_evidence(const DataFrame& df) const;
+    VectorXd log_probability_evidence(const DataFrame& df) const;
+
+    int num_cached() const {
+        std::lock_guard<std::mutex> lock(m_cache_mutex);
+        return static_cast<int>(m_cache.size());
+    }
+
+    int max_cached() const { return m_max_cached; }
+
+    void clear_cache() {
+        std::lock_guard<std::mutex> lock(m_cache_mutex);
+        m_cache.clear();
+        m_lru.clear();
+    }
+
+    std::string ToString() const {
+        return "JunctionTree(" + std::to_string(m_nodes.size()) + " nodes, " + std::to_string(m_cliques.size()) +
+               " cliques)";
+    }
+
+private:
+    struct EvidenceBatch {
+        std::vector<int> variables;
+        // Configuration of each row, and the observed values (-1 if null) of each unique configuration.
+        std::vector<int> row_configuration;
+        std::vector<std::vector<int>> configurations;
+        std::vector<int64_t> codes;
+    };
+
+    int check_variable(const std::string& variable) const;
+    std::pair<int, PotentialDomain> query_domain(const std::vector<std::string>& variables) const;
+    void triangulate(const std::string& heuristic, const std::vector<std::unordered_set<int>>& moral);
+    void build_tree();
+    void initialize_potentials(const BayesianNetworkBase& model);
+    VectorXi index_map(const PotentialDomain& from, const PotentialDomain& to) const;
+    int smallest_clique_containing(const std::vector<int>& variables) const;
+
+    EvidenceBatch group_evidence(const DataFrame& df, const std::unordered_set<int>& excluded) const;
+    std::shared_ptr<const CalibratedTree> calibrate(const std::vector<int>& evidence_variables,
+                                                    const std::vector<int>& values) const;
+    std::vector<std::shared_ptr<const CalibratedTree>> calibrate_batch(const EvidenceBatch& batch) const;
+    // The cache methods must be called with m_cache_mutex locked.
+    std::shared_ptr<const CalibratedTree> cache_find(const EvidenceKey& key) const;
+    void cache_insert(EvidenceKey key, std::shared_ptr<const CalibratedTree> tree) const;
+
+    std::vector<std::string> m_nodes;
+    std::unordered_map<std::string, int> m_indices;
+    std::vector<std::vector<std::string>> m_values;
+    VectorXi m_cardinality;
+
+    std::vector<PotentialDomain> m_cliques;
+    std::vector<VectorXd> m_initial_potentials;
+    // Smallest clique containing each node.
+    std::vector<int> m_home_clique;
+
+    // (parent clique, child clique) pairs of the junction tree.
+    std::vector<std::pair<int, int>> m_edges;
+    std::vector<PotentialDomain> m_separators;
+    // Breadth-first order of the cliques: parents always come before their children.
+    std::vector<int> m_order;
+    // For each clique, the index of the edge to its parent (-1 for roots).
+    std::vector<int> m_parent_edge;
+    std::vector<VectorXi> m_child_maps;
+    std::vector<VectorXi> m_parent_maps;
+
+    int m_max_cached;
+    mutable std::mutex m_cache_mutex;
+    // The keys ordered from the most to the least recently used, and the cached tree and position in m_lru of each key.
+    mutable std::list<EvidenceKey> m_lru;
+    mutable std::unordered_map<EvidenceKey,
+                               std::pair<std::shared_ptr<const CalibratedTree>, std::list<EvidenceKey>::iterator>,
+                               EvidenceKeyHash>
+        m_cache;
+};
+
+}  // namespace inference
+
+#endif  // PYBNESIAN_INFERENCE_JUNCTIONTREE_HPP
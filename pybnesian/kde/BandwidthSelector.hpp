@@ -42,6 +42,22 @@ public:
     virtual py::tuple __getstate__() const = 0;
 };
 
+// Sample covariance and number of instances of the variables, used by the reference rules. A row of a weighted
+// DataFrame counts as many instances as its weight (see DataFrame::has_weights()).
+template <typename ArrowType>
+std::pair<Matrix<typename ArrowType::c_type, Dynamic, Dynamic>, double> sample_cov(
+    const DataFrame& df, const std::vector<std::string>& variables) {
+    using CType = typename ArrowType::c_type;
+
+    if (df.has_weights()) {
+        auto moments = dataset::weighted_moments(df, variables);
+        Matrix<CType, Dynamic, Dynamic> cov = (moments.sse / (moments.total_weight - 1)).template cast<CType>();
+        return std::make_pair(std::move(cov), moments.total_weight);
+    }
+
+    return std::make_pair(*df.cov<ArrowType>(variables), static_cast<double>(df.valid_rows(variables)));
+}
+
 }  // namespace kde
 
 #endif  // PYBNESIAN_KDE_BANDWIDTHSELECTOR_HPP
\ No newline at end of file
@@ -0,0 +1,255 @@
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <limits>
+#include <numeric>
+#include <unsupported/Eigen/FFT>
+#include <kde/FastUnivariateKDE.hpp>
+#include <util/arrow_macros.hpp>
+#include <util/math_constants.hpp>
+
+namespace kde {
+
+FastUnivariateKDE::FastUnivariateKDE(UnivariateKDEMethod method,
+                                     std::shared_ptr<arrow::Buffer> training,
+                                     std::shared_ptr<arrow::Buffer> log_weights,
+                                     arrow::Type::type training_type,
+                                     int64_t N,
+                                     double bandwidth,
+                                     double tolerance)
+    : m_method(method),
+      m_sorted_training(std::move(training)),
+      m_sorted_log_weights(std::move(log_weights)),
+      m_float(false),
+      m_N(N),
+      m_references_training(true),
+      m_bandwidth(bandwidth),
+      m_tolerance(tolerance),
+      m_lognorm_const(0),
+      m_min_log_weight(0),
+      m_window_sq(0),
+      m_evaluation_cost(0),
+      m_grid_origin(0),
+      m_grid_step(0),
+      m_grid(),
+      m_grid_floor(0) {
+    if (m_method == UnivariateKDEMethod::Exact)
+        throw std::invalid_argument("FastUnivariateKDE cannot use the Exact method.");
+    if (!m_sorted_training || m_N <= 0) throw std::invalid_argument("FastUnivariateKDE needs training data.");
+    if (!(m_bandwidth > 0) || !std::isfinite(m_bandwidth))
+        throw std::invalid_argument("FastUnivariateKDE needs a positive bandwidth.");
+    if (!(m_tolerance > 0 && m_tolerance < 1)) throw std::invalid_argument("The tolerance must be in the range (0, 1).");
+
+    switch (training_type) {
+        case arrow::Type::DOUBLE:
+            initialize<double>();
+            break;
+        case arrow::Type::FLOAT:
+            m_float = true;
+            initialize<float>();
+            break;
+        default:
+            throw std::invalid_argument("FastUnivariateKDE needs [double] or [float] training data.");
+    }
+}
+
+template <typename CType>
+void FastUnivariateKDE::initialize() {
+    auto raw = sorted_raw<CType>();
+    if (!std::is_sorted(raw, raw + m_N)) {
+        // The training buffer can be shared with other KDEs or memory-mapped, so it is not sorted in place.
+        RAISE_RESULT_ERROR(std::shared_ptr<arrow::Buffer> sorted, arrow::AllocateBuffer(m_N * sizeof(CType)))
+        auto sorted_data = reinterpret_cast<CType*>(sorted->mutable_data());
+
+        if (m_sorted_log_weights) {
+            // The log-weights are sorted with the training instances.
+            std::vector<int64_t> order(m_N);
+            std::iota(order.begin(), order.end(), 0);
+            std::stable_sort(order.begin(), order.end(), [raw](int64_t a, int64_t b) { return raw[a] < raw[b]; });
+
+            RAISE_RESULT_ERROR(std::shared_ptr<arrow::Buffer> sorted_weights,
+                               arrow::AllocateBuffer(m_N * sizeof(CType)))
+            auto log_weights = sorted_log_weights<CType>();
+            auto sorted_weights_data = reinterpret_cast<CType*>(sorted_weights->mutable_data());
+            for (int64_t i = 0; i < m_N; ++i) {
+                sorted_data[i] = raw[order[i]];
+                sorted_weights_data[i] = log_weights[order[i]];
+            }
+
+            m_sorted_log_weights = std::move(sorted_weights);
+        } else {
+            std::copy(raw, raw + m_N, sorted_data);
+            std::sort(sorted_data, sorted_data + m_N);
+        }
+
+        m_sorted_training = std::move(sorted);
+        m_references_training = false;
+        raw = sorted_raw<CType>();
+    }
+
+    auto N = static_cast<double>(m_N);
+    m_lognorm_const = -std::log(m_bandwidth) - 0.5 * std::log(2 * util::pi<double>);
+    if (auto log_weights = sorted_log_weights<CType>())
+        m_min_log_weight = static_cast<double>(*std::min_element(log_weights, log_weights + m_N));
+    else
+        m_min_log_weight = -std::log(N);
+    m_window_sq = -2 * (std::log(m_tolerance) + m_min_log_weight);
+
+    // Expected number of training instances in the window of a test instance, plus the binary searches.
+    auto range = static_cast<double>(raw[m_N - 1]) - static_cast<double>(raw[0]);
+    auto window_fraction = range > 0 ? std::min(1., 2 * std::sqrt(m_window_sq) * m_bandwidth / range) : 1.;
+    m_evaluation_cost = static_cast<int64_t>(N * window_fraction + 2 * std::log2(N)) + 1;
+
+    if (m_method == UnivariateKDEMethod::Binned) {
+        build_grid<CType>();
+        // Most of the test instances are interpolated in the grid.
+        if (has_grid()) m_evaluation_cost = 16;
+    }
+}
+
+template <typename CType>
+void FastUnivariateKDE::build_grid() {
+    auto raw = sorted_raw<CType>();
+    auto front = static_cast<double>(raw[0]);
+    auto back = static_cast<double>(raw[m_N - 1]);
+
+    // The error of the linear binning and the linear interpolation of a kernel at distance d·h is approximately
+    // (step / h)² · (d² + 1) / 8 (relative to the kernel). The step bounds it by the tolerance up to the window distance.
+    m_grid_step = m_bandwidth * std::sqrt(2 * m_tolerance / (1 + m_window_sq));
+    // The kernel is truncated where its value is tolerance times smaller than in the SortedWindow method, so the
+    // truncation error is negligible for the densities larger than m_grid_floor.
+    auto half_width = static_cast<int64_t>(
+        std::ceil(std::sqrt(m_window_sq - 2 * std::log(m_tolerance)) * m_bandwidth / m_grid_step));
+    auto data_bins = static_cast<int64_t>(std::floor((back - front) / m_grid_step)) + 2;
+
+    // The circular convolution of the FFT does not wrap around if the size is at least data_bins + 2·half_width.
+    int64_t fft_size = 1;
+    while (fft_size < data_bins + 2 * half_width) {
+        fft_size *= 2;
+        if (fft_size > max_binned_fft_size) return;
+    }
+
+    // Linear binning of the weights of the training data.
+    auto log_weights = sorted_log_weights<CType>();
+    auto uniform_weight = 1. / static_cast<double>(m_N);
+    std::vector<double> counts(fft_size, 0.);
+    for (int64_t i = 0; i < m_N; ++i) {
+        auto position = (static_cast<double>(raw[i]) - front) / m_grid_step;
+        auto bin = std::min(static_cast<int64_t>(position), data_bins - 2);
+        auto t = position - static_cast<double>(bin);
+        auto w = log_weights ? std::exp(static_cast<double>(log_weights[i])) : uniform_weight;
+        counts[bin] += w * (1 - t);
+        counts[bin + 1] += w * t;
+    }
+
+    // Kernel sampled at the grid offsets. The negative offsets are stored at the end (circular indexing).
+    std::vector<double> kernel(fft_size, 0.);
+    auto kernel_const = std::exp(m_lognorm_const);
+    for (int64_t l = 0; l <= half_width; ++l) {
+        auto d = static_cast<double>(l) * m_grid_step / m_bandwidth;
+        auto k = kernel_const * std::exp(-0.5 * d * d);
+        kernel[l] = k;
+        if (l > 0) kernel[fft_size - l] = k;
+    }
+
+    Eigen::FFT<double> fft;
+    std::vector<std::complex<double>> counts_freq, kernel_freq;
+    fft.fwd(counts_freq, counts);
+    fft.fwd(kernel_freq, kernel);
+
+    for (size_t i = 0; i < counts_freq.size(); ++i) {
+        counts_freq[i] *= kernel_freq[i];
+    }
+
+    std::vector<double> convolution;
+    fft.inv(convolution, counts_freq);
+
+    // The grid starts half_width steps before the first training instance.
+    auto grid_size = data_bins + 2 * half_width;
+    m_grid.resize(grid_size);
+    for (int64_t g = 0; g < grid_size; ++g) {
+        auto index = g - half_width;
+        m_grid[g] = convolution[(index + fft_size) % fft_size];
+    }
+
+    m_grid_origin = front - static_cast<double>(half_width) * m_grid_step;
+
+    // The truncation of the kernels adds an absolute error of at most tolerance² times the peak of the kernel with the
+    // smallest weight, and the
+    // roundoff error of the FFT is relative to the largest value. The densities that are not much larger than these
+    // errors are evaluated with the SortedWindow method.
+    auto max_density = *std::max_element(m_grid.begin(), m_grid.end());
+    auto roundoff_floor = max_density * 100 * std::numeric_limits<double>::epsilon() * std::log2(fft_size) / m_tolerance;
+    auto truncation_floor = m_tolerance * std::exp(m_min_log_weight + m_lognorm_const);
+    m_grid_floor = std::max(roundoff_floor, truncation_floor);
+}
+
+template <typename CType>
+double FastUnivariateKDE::window_logl(double x) const {
+    const auto begin = sorted_raw<CType>();
+    const auto end = begin + m_N;
+
+    const auto log_weights = sorted_log_weights<CType>();
+
+    auto upper = std::lower_bound(begin, end, x);
+    auto nearest = upper;
+    auto dmin = std::numeric_limits<double>::infinity();
+    if (upper != end) dmin = (*upper - x) / m_bandwidth;
+    if (upper != begin && (x - *(upper - 1)) / m_bandwidth < dmin) {
+        nearest = upper - 1;
+        dmin = (x - *nearest) / m_bandwidth;
+    }
+
+    if (std::isnan(dmin)) return std::numeric_limits<double>::quiet_NaN();
+    // Every kernel underflows, e.g. for x = ±inf.
+    if (std::isinf(dmin * dmin)) return -std::numeric_limits<double>::infinity();
+
+    auto nearest_log_weight = log_weights ? static_cast<double>(log_weights[nearest - begin]) : m_min_log_weight;
+
+    // The omitted instances (with total weight at most 1) contribute at most exp(-k²/2) =
+    // tolerance·exp(nearest_log_weight - dmin²/2), which is tolerance times the contribution of the nearest training
+    // instance. So, the error of the logarithm is at most the tolerance.
+    auto k = std::sqrt(dmin * dmin + m_window_sq + 2 * (m_min_log_weight - nearest_log_weight));
+    auto first = std::lower_bound(begin, upper, x - k * m_bandwidth);
+    auto last = std::upper_bound(upper, end, x + k * m_bandwidth);
+
+    // The exponents are shifted by the nearest instance, to avoid underflows.
+    double sum = 0;
+    if (log_weights) {
+        for (auto it = first; it != last; ++it) {
+            auto d = (*it - x) / m_bandwidth;
+            sum += std::exp(static_cast<double>(log_weights[it - begin]) - nearest_log_weight -
+                            0.5 * (d * d - dmin * dmin));
+        }
+    } else {
+        for (auto it = first; it != last; ++it) {
+            auto d = (*it - x) / m_bandwidth;
+            sum += std::exp(-0.5 * (d * d - dmin * dmin));
+        }
+    }
+
+    return std::log(sum) + nearest_log_weight - 0.5 * dmin * dmin + m_lognorm_const;
+}
+
+double FastUnivariateKDE::logl(double x) const {
+    if (std::isinf(x)) return -std::numeric_limits<double>::infinity();
+
+    if (has_grid()) {
+        auto position = (x - m_grid_origin) / m_grid_step;
+
+        if (position >= 0 && position < static_cast<double>(m_grid.size() - 1)) {
+            auto g = static_cast<size_t>(position);
+            auto t = position - static_cast<double>(g);
+            auto density = (1 - t) * m_grid[g] + t * m_grid[g + 1];
+
+            if (density > m_grid_floor) return std::log(density);
+        }
+    }
+
+    if (m_float)
+        return window_logl<float>(x);
+    else
+        return window_logl<double>(x);
+}
+
+}  // namespace kde
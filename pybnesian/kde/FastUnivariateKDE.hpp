@@ -0,0 +1,120 @@
+#ifndef PYBNESIAN_KDE_FASTUNIVARIATEKDE_HPP
+#define PYBNESIAN_KDE_FASTUNIVARIATEKDE_HPP
+
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <arrow/api.h>
+#include <util/parallel.hpp>
+
+namespace kde {
+
+// Method used to evaluate the log-likelihood of the univariate KDEs:
+//  - Exact: every test instance is compared with every training instance. The cost is O(N·M).
+//  - SortedWindow: the training data is sorted, and only the training instances within ±k·h of each test instance are
+//    visited (found with binary search). The window is chosen for each test instance, so the absolute error of each
+//    log-likelihood value is at most the tolerance.
+//  - Binned: the training data is linearly binned on a grid, and the density on the grid is computed with an FFT
+//    convolution when the KDE is fitted. Each test instance is then evaluated with a linear interpolation in O(1). The
+//    grid step is chosen so the relative error of the density is of the order of the tolerance. The test
+//    instances outside the grid, or with a density too small to be accurate after the FFT, are evaluated with the
+//    SortedWindow method.
+enum class UnivariateKDEMethod { Exact, SortedWindow, Binned };
+
+inline UnivariateKDEMethod univariate_kde_method_from_int(int m) {
+    switch (m) {
+        case static_cast<int>(UnivariateKDEMethod::Exact):
+            return UnivariateKDEMethod::Exact;
+        case static_cast<int>(UnivariateKDEMethod::SortedWindow):
+            return UnivariateKDEMethod::SortedWindow;
+        case static_cast<int>(UnivariateKDEMethod::Binned):
+            return UnivariateKDEMethod::Binned;
+        default:
+            throw std::runtime_error("Not valid UnivariateKDEMethod: " + std::to_string(m));
+    }
+}
+
+// Default tolerance of the SortedWindow and Binned methods.
+constexpr double default_univariate_tolerance = 1e-6;
+
+// Maximum size of the FFT of the Binned method. If a larger grid is needed, the SortedWindow method is used.
+constexpr int64_t max_binned_fft_size = int64_t{1} << 22;
+
+// Evaluates the log-likelihood of a univariate Gaussian KDE with the SortedWindow or Binned methods. It is built once
+// when the KDE is fitted, and it is not modified afterwards, so it can be shared by the copies of the KDE.
+//
+// The training data ([double] or [float] values) must be sorted. If the training buffer of the KDE is already sorted,
+// it is referenced. Otherwise, a sorted copy is kept. The log-weights of the training instances (see KDEWeights.hpp)
+// have the same type as the training data, and they are null if every instance has weight 1 / N.
+class FastUnivariateKDE {
+public:
+    FastUnivariateKDE(UnivariateKDEMethod method,
+                      std::shared_ptr<arrow::Buffer> training,
+                      std::shared_ptr<arrow::Buffer> log_weights,
+                      arrow::Type::type training_type,
+                      int64_t N,
+                      double bandwidth,
+                      double tolerance);
+
+    UnivariateKDEMethod method() const { return m_method; }
+    // True if the training buffer is referenced, instead of a sorted copy.
+    bool references_training() const { return m_references_training; }
+    // True if the Binned method could build its grid.
+    bool has_grid() const { return !m_grid.empty(); }
+
+    // The density of ±inf is 0, so their log-likelihood is -inf.
+    double logl(double x) const;
+
+    template <typename T, typename OutType>
+    void logl(const T* test, int64_t m, OutType* res) const {
+        util::parallel_for(m, m_evaluation_cost, [this, test, res](int64_t i) {
+            res[i] = static_cast<OutType>(logl(static_cast<double>(test[i])));
+        });
+    }
+
+private:
+    template <typename CType>
+    const CType* sorted_raw() const {
+        return reinterpret_cast<const CType*>(m_sorted_training->data());
+    }
+
+    template <typename CType>
+    const CType* sorted_log_weights() const {
+        return m_sorted_log_weights ? reinterpret_cast<const CType*>(m_sorted_log_weights->data()) : nullptr;
+    }
+
+    template <typename CType>
+    void initialize();
+    template <typename CType>
+    double window_logl(double x) const;
+    template <typename CType>
+    void build_grid();
+
+    UnivariateKDEMethod m_method;
+    std::shared_ptr<arrow::Buffer> m_sorted_training;
+    std::shared_ptr<arrow::Buffer> m_sorted_log_weights;
+    bool m_float;
+    int64_t m_N;
+    bool m_references_training;
+    double m_bandwidth;
+    double m_tolerance;
+    // log(1 / (h·sqrt(2π)))
+    double m_lognorm_const;
+    // Smallest log-weight of the training instances (-log(N) without weights).
+    double m_min_log_weight;
+    // -2·log(tolerance · exp(m_min_log_weight)). The window of a test instance with the nearest training instance at
+    // distance d·h and log-weight l is ±sqrt(d² + m_window_sq + 2·(m_min_log_weight - l))·h.
+    double m_window_sq;
+    int64_t m_evaluation_cost;
+
+    double m_grid_origin;
+    double m_grid_step;
+    std::vector<double> m_grid;
+    double m_grid_floor;
+};
+
+}  // namespace kde
+
+#endif  // PYBNESIAN_KDE_FASTUNIVARIATEKDE_HPP
@@ -1,3 +1,4 @@
+#include <algorithm>
 #include <kde/KDE.hpp>
 #include <arrow/python/helpers.h>
 
@@ -9,7 +10,7 @@ void KDE::copy_bandwidth() {
     auto llt_matrix = llt_cov.matrixLLT();
 
     m_lognorm_const = -llt_matrix.diagonal().array().log().sum() -
-                      0.5 * m_variables.size() * std::log(2 * util::pi<double>) - std::log(N);
+                      0.5 * m_variables.size() * std::log(2 * util::pi<double>) + log_uniform_weight();
 
     switch (m_training_type->id()) {
         case Type::DOUBLE: {
@@ -65,6 +66,21 @@ void KDE::fit(const DataFrame& df) {
     }
 
     m_fitted = true;
+    build_fast_univariate();
+}
+
+void KDE::build_fast_univariate() {
+    m_fast_univariate = nullptr;
+
+    if (!m_fitted || m_variables.size() != 1 || m_univariate_method == UnivariateKDEMethod::Exact) return;
+
+    // A degenerate bandwidth (e.g. constant training data) is evaluated with the exact method.
+    auto bandwidth = std::sqrt(m_bandwidth(0, 0));
+    if (!(bandwidth > 0) || !std::isfinite(bandwidth)) return;
+
+    // The training buffer is referenced if it is sorted (see _fit()).
+    m_fast_univariate = std::make_shared<FastUnivariateKDE>(
+        m_univariate_method, m_training, m_log_weights, m_training_type->id(), N, bandwidth, m_univariate_tolerance);
 }
 
 VectorXd KDE::logl(const DataFrame& df) const {
@@ -77,9 +93,15 @@ VectorXd KDE::logl(const DataFrame& df) const {
 
     switch (type->id()) {
         case Type::DOUBLE:
-            return _logl<arrow::DoubleType>(df);
+            if (m_precision == KDEPrecision::Mixed)
+                return _logl<arrow::DoubleType, true>(df);
+            else
+                return _logl<arrow::DoubleType, false>(df);
         case Type::FLOAT:
-            return _logl<arrow::FloatType>(df);
+            if (m_precision == KDEPrecision::Mixed)
+                return _logl<arrow::FloatType, true>(df);
+            else
+                return _logl<arrow::FloatType, false>(df);
         default:
             throw std::runtime_error("Unreachable code.");
     }
@@ -95,9 +117,15 @@ double KDE::slogl(const DataFrame& df) const {
 
     switch (type->id()) {
         case Type::DOUBLE:
-            return _slogl<arrow::DoubleType>(df);
+            if (m_precision == KDEPrecision::Mixed)
+                return _slogl<arrow::DoubleType, true>(df);
+            else
+                return _slogl<arrow::DoubleType, false>(df);
         case Type::FLOAT:
-            return _slogl<arrow::FloatType>(df);
+            if (m_precision == KDEPrecision::Mixed)
+                return _slogl<arrow::FloatType, true>(df);
+            else
+                return _slogl<arrow::FloatType, false>(df);
         default:
             throw std::runtime_error("Unreachable code.");
     }
@@ -116,9 +144,16 @@ py::tuple KDE::__getstate__() const {
 }
 
 KDE KDE::__setstate__(py::tuple& t) {
-    if (t.size() != 8) throw std::runtime_error("Not valid KDE.");
+    // The precision was added in the 9th position, the univariate method and its tolerance in the 10th and 11th, and
+    // the log-weights in the 12th. The KDEs saved before use the native precision, the exact method and no weights.
+    if (t.size() != 8 && t.size() != 9 && t.size() != 11 && t.size() != 12) throw std::runtime_error("Not valid KDE.");
 
     KDE kde(t[0].cast<std::vector<std::string>>());
+    if (t.size() >= 9) kde.m_precision = kde_precision_from_int(t[8].cast<int>());
+    if (t.size() >= 11) {
+        kde.m_univariate_method = univariate_kde_method_from_int(t[9].cast<int>());
+        kde.m_univariate_tolerance = t[10].cast<double>();
+    }
 
     kde.m_fitted = t[1].cast<bool>();
     kde.m_bselector = t[2].cast<std::shared_ptr<BandwidthSelector>>();
@@ -139,9 +174,9 @@ KDE KDE::__setstate__(py::tuple& t) {
                 kde.m_H_cholesky_double = Matrix<double, Dynamic, 1>(nvar * nvar);
                 std::memcpy(kde.m_H_cholesky_double.data(), llt_matrix.data(), nvar * nvar*sizeof(double));
 
-                auto training_data = t[4].cast<VectorXd>();
-                kde.m_training_double = Matrix<double, Dynamic, 1>(kde.N * nvar);
-                std::memcpy(kde.m_training_double.data(), training_data.data(), kde.N * nvar*sizeof(double));
+                kde.m_training = util::array_to_buffer<double>(t[4].cast<py::array>());
+                if (t.size() == 12 && !t[11].is_none())
+                    kde.m_log_weights = util::array_to_buffer<double>(t[11].cast<py::array>());
                 break;
             }
             case Type::FLOAT: {
@@ -149,14 +184,22 @@ KDE KDE::__setstate__(py::tuple& t) {
                 kde.m_H_cholesky_float = Matrix<float, Dynamic, 1>(nvar * nvar);
                 std::memcpy(kde.m_H_cholesky_float.data(), casted_cholesky.data(), nvar * nvar*sizeof(float));
 
-                auto training_data = t[4].cast<VectorXf>();
-                kde.m_training_float = Matrix<float, Dynamic, 1>(kde.N * nvar);
-                std::memcpy(kde.m_training_float.data(), training_data.data(), kde.N*nvar*sizeof(float));
+                kde.m_training = util::array_to_buffer<float>(t[4].cast<py::array>());
+                if (t.size() == 12 && !t[11].is_none())
+                    kde.m_log_weights = util::array_to_buffer<float>(t[11].cast<py::array>());
                 break;
             }
             default:
                 throw std::runtime_error("Not valid data type in KDE.");
         }
+
+        if (kde.m_training->size() != static_cast<int64_t>(kde.N * nvar * kde.m_training_type->bit_width() / 8))
+            throw std::runtime_error("Not valid KDE.");
+        if (kde.m_log_weights &&
+            kde.m_log_weights->size() != static_cast<int64_t>(kde.N * kde.m_training_type->bit_width() / 8))
+            throw std::runtime_error("Not valid KDE.");
+
+        kde.build_fast_univariate();
     }
 
     return kde;
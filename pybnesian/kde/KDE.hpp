@@ -1,15 +1,20 @@
 #ifndef PYBNESIAN_KDE_KDE_HPP
 #define PYBNESIAN_KDE_KDE_HPP
 
+#include <algorithm>
 #include <iostream>
 #include <pybind11/stl.h>
 #include <pybind11/eigen.h>
 #include <kde/BandwidthSelector.hpp>
 #include <kde/NormalReferenceRule.hpp>
+#include <kde/KDEPrecision.hpp>
+#include <kde/FastUnivariateKDE.hpp>
+#include <kde/KDEWeights.hpp>
 #include <util/math_constants.hpp>
 #include <util/pickle.hpp>
+#include <util/binary_serialization.hpp>
 #include <kernels/kernel.hpp>
-#include <omp.h>
+#include <util/parallel.hpp>
 
 namespace kde {
 
@@ -118,34 +123,29 @@ void MultivariateKDE::execute_logl_mat(const typename ArrowType::c_type* trainin
     using CType = typename ArrowType::c_type;
 
     auto tmp_mat_size = matrices_cols * (training_rows>test_length?training_rows:test_length);
-#pragma omp parallel
-#pragma omp single
-{
-    Kernel<CType> kernels = Kernel<CType>::instance();
-    int n_tasks = omp_get_num_threads();
+    Kernel<CType>& kernels = Kernel<CType>::instance();
+    // Each iteration solves a triangular system for every row of the other matrix.
+    int64_t iteration_cost = static_cast<int64_t>(matrices_cols) * matrices_cols * tmp_mat_size;
     if (training_rows > test_length) {
-#pragma omp taskloop num_tasks(n_tasks)
-        for (uint i = 0; i < test_length; ++i) {
+        util::parallel_for(test_length, iteration_cost, [&](int64_t i) {
                 CType* tmp_mat_raw = (CType*)malloc(tmp_mat_size * sizeof(CType));
                 kernels.substract_domain_specific_new(training_mat, training_rows, 0, training_rows, test_mat, test_physical_rows, test_offset, i, matrices_cols, tmp_mat_raw);
                 kernels.solve_specific_new(tmp_mat_raw, training_rows, matrices_cols, cholesky);
                 kernels.square_inplace_new(tmp_mat_raw, training_rows * matrices_cols);
                 kernels.logl_values_mat_column_new(tmp_mat_raw, matrices_cols, output_mat, training_rows, i, lognorm_const, training_rows);
                 free(tmp_mat_raw);
-        }
+        });
     } else {
-#pragma omp taskloop num_tasks(n_tasks)
-        for (uint i = 0; i < training_rows; ++i) {
+        util::parallel_for(training_rows, iteration_cost, [&](int64_t i) {
                 CType* tmp_mat_raw = (CType*)malloc(tmp_mat_size * sizeof(CType));
                 kernels.substract_domain_specific_new(test_mat, test_physical_rows, test_offset, test_length, training_mat, training_rows, 0, i, matrices_cols, tmp_mat_raw);
                 kernels.solve_specific_new(tmp_mat_raw, test_length, matrices_cols, cholesky);
                 kernels.square_inplace_new(tmp_mat_raw, test_length * matrices_cols);
                 kernels.logl_values_mat_row_new(tmp_mat_raw, matrices_cols, output_mat, training_rows, i, lognorm_const, test_length);
                 free(tmp_mat_raw);
-        }
+        });
     }
 }
-}
 
 template <typename ArrowType>
 void MultivariateKDE::execute_conditional_means(const typename ArrowType::c_type* joint_training,
@@ -184,7 +184,11 @@ public:
           m_bandwidth(),
           m_lognorm_const(0),
           N(0),
-          m_training_type(arrow::float64()) {}
+          m_training_type(arrow::float64()),
+          m_precision(KDEPrecision::Native),
+          m_univariate_method(UnivariateKDEMethod::Exact),
+          m_univariate_tolerance(default_univariate_tolerance),
+          m_fast_univariate() {}
 
     KDE(std::vector<std::string> variables) : KDE(variables, std::make_shared<NormalReferenceRule>()) {}
 
@@ -195,7 +199,11 @@ public:
           m_bandwidth(),
           m_lognorm_const(0),
           N(0),
-          m_training_type(arrow::float64()) {
+          m_training_type(arrow::float64()),
+          m_precision(KDEPrecision::Native),
+          m_univariate_method(UnivariateKDEMethod::Exact),
+          m_univariate_tolerance(default_univariate_tolerance),
+          m_fast_univariate() {
         if (b_selector == nullptr) throw std::runtime_error("Bandwidth selector procedure must be non-null.");
 
         if (m_variables.empty()) {
@@ -208,9 +216,15 @@ public:
 
     template <typename ArrowType, typename EigenMatrix>
     void fit(EigenMatrix bandwidth,
-             typename ArrowType::c_type* training_data,
+             const typename ArrowType::c_type* training_data,
              std::shared_ptr<arrow::DataType> training_type,
              int training_instances);
+    template <typename ArrowType, typename EigenMatrix>
+    void fit(EigenMatrix bandwidth,
+             Buffer_ptr training_data,
+             std::shared_ptr<arrow::DataType> training_type,
+             int training_instances,
+             Buffer_ptr log_weights = nullptr);
 
     const MatrixXd& bandwidth() const { return m_bandwidth; }
     void setBandwidth(MatrixXd& new_bandwidth) {
@@ -223,26 +237,24 @@ public:
 
         m_bandwidth = new_bandwidth;
         if (m_bandwidth.rows() > 0) copy_bandwidth();
+        build_fast_univariate();
     }
 
     template <typename ArrowType>
-    typename ArrowType::c_type* training_raw() { 
-        using CType = typename ArrowType::c_type;
-        if constexpr (std::is_same_v<CType, double>) {
-            return m_training_double.data(); 
-        } else {
-            return m_training_float.data();
-        }
+    const typename ArrowType::c_type* training_raw() const {
+        return reinterpret_cast<const typename ArrowType::c_type*>(m_training->data());
     }
 
+    // Training data in column-major order. It is never modified, so it can be shared with other KDEs (e.g. the marginal
+    // KDE of a CKDE) and it can reference a memory-mapped file.
+    const Buffer_ptr& training_buffer() const { return m_training; }
+
+    // Log-weights of the training instances (see KDEWeights.hpp), or null if the KDE was fitted without weights.
+    const Buffer_ptr& log_weights_buffer() const { return m_log_weights; }
+
     template <typename ArrowType>
-    const typename ArrowType::c_type* training_raw() const { 
-        using CType = typename ArrowType::c_type;
-        if constexpr (std::is_same_v<CType, double>) {
-            return m_training_double.data(); 
-        } else {
-            return m_training_float.data();
-        }
+    const typename ArrowType::c_type* log_weights_raw() const {
+        return m_log_weights ? reinterpret_cast<const typename ArrowType::c_type*>(m_log_weights->data()) : nullptr;
     }
 
     template <typename ArrowType>
@@ -283,12 +295,29 @@ public:
 
     std::shared_ptr<BandwidthSelector> bandwidth_type() const { return m_bselector; }
 
+    KDEPrecision precision() const { return m_precision; }
+    void set_precision(KDEPrecision precision) { m_precision = precision; }
+
+    // The univariate method is only used if the KDE has one variable.
+    UnivariateKDEMethod univariate_method() const { return m_univariate_method; }
+    void set_univariate_method(UnivariateKDEMethod method) {
+        m_univariate_method = method;
+        build_fast_univariate();
+    }
+
+    double univariate_tolerance() const { return m_univariate_tolerance; }
+    void set_univariate_tolerance(double tolerance) {
+        if (!(tolerance > 0 && tolerance < 1)) throw std::invalid_argument("The tolerance must be in the range (0, 1).");
+        m_univariate_tolerance = tolerance;
+        build_fast_univariate();
+    }
+
     VectorXd logl(const DataFrame& df) const;
 
-    template <typename ArrowType>
-    Matrix<typename ArrowType::c_type, Dynamic, 1> logl_buffer(const DataFrame& df) const;
-    template <typename ArrowType>
-    Matrix<typename ArrowType::c_type, Dynamic, 1> logl_buffer(const DataFrame& df, Buffer_ptr& bitmap) const;
+    template <typename ArrowType, bool mixed = false>
+    Matrix<LoglType<ArrowType, mixed>, Dynamic, 1> logl_buffer(const DataFrame& df) const;
+    template <typename ArrowType, bool mixed = false>
+    Matrix<LoglType<ArrowType, mixed>, Dynamic, 1> logl_buffer(const DataFrame& df, Buffer_ptr& bitmap) const;
 
     double slogl(const DataFrame& df) const;
 
@@ -307,15 +336,18 @@ private:
 
     template <typename ArrowType, bool contains_null>
     void _fit(const DataFrame& df);
-    template <typename ArrowType>
+    template <typename ArrowType, bool mixed>
     VectorXd _logl(const DataFrame& df) const;
-    template <typename ArrowType>
+    template <typename ArrowType, bool mixed>
     double _slogl(const DataFrame& df) const;
 
-    template <typename ArrowType, typename KDEType>
-    void _logl_impl(typename ArrowType::c_type* test_buffer, int m, typename ArrowType::c_type* res) const;
+    template <typename ArrowType, typename KDEType, bool mixed>
+    void _logl_impl(typename ArrowType::c_type* test_buffer, int m, LoglType<ArrowType, mixed>* res) const;
 
     void copy_bandwidth();
+    void build_fast_univariate();
+    // log(1 / N) if the kernels are not weighted. Otherwise, the log-weights are added to each kernel.
+    double log_uniform_weight() const { return m_log_weights ? 0 : -std::log(N); }
 
     template <typename ArrowType>
     py::tuple __getstate__() const;
@@ -326,28 +358,31 @@ private:
     MatrixXd m_bandwidth;
     Matrix<double, Dynamic, Dynamic> m_H_cholesky_double;
     Matrix<float, Dynamic, 1> m_H_cholesky_float;
-    Matrix<double, Dynamic, 1> m_training_double;
-    Matrix<float, Dynamic, 1> m_training_float;
+    Buffer_ptr m_training;
+    Buffer_ptr m_log_weights;
     double m_lognorm_const;
     int N;
     std::shared_ptr<arrow::DataType> m_training_type;
+    KDEPrecision m_precision;
+    UnivariateKDEMethod m_univariate_method;
+    double m_univariate_tolerance;
+    // Built when the KDE is fitted, if it is univariate and m_univariate_method is not Exact.
+    std::shared_ptr<const FastUnivariateKDE> m_fast_univariate;
 };
 
 template <typename ArrowType>
 DataFrame KDE::_training_data() const {
-    arrow::NumericBuilder<ArrowType> builder;
+    using CType = typename ArrowType::c_type;
+    using ArrayType = typename arrow::TypeTraits<ArrowType>::ArrayType;
 
     std::vector<Array_ptr> columns;
     arrow::SchemaBuilder b(arrow::SchemaBuilder::ConflictPolicy::CONFLICT_ERROR);
     for (size_t i = 0; i < m_variables.size(); ++i) {
-        auto status = builder.Resize(N);
-        RAISE_STATUS_ERROR(builder.AppendValues(training_raw<ArrowType>() + i * N, N));
-
-        Array_ptr out;
-        RAISE_STATUS_ERROR(builder.Finish(&out));
+        // The columns reference the training buffer.
+        auto values = arrow::SliceBuffer(m_training, i * N * sizeof(CType), N * sizeof(CType));
+        auto out = std::make_shared<ArrayType>(N, values);
 
         columns.push_back(out);
-        builder.Reset();
 
         auto f = arrow::field(m_variables[i], out->type());
         RAISE_STATUS_ERROR(b.AddField(f));
@@ -381,24 +416,57 @@ void KDE::_fit(const DataFrame& df) {
     }
 
     auto training_data = df.to_eigen<false, ArrowType, contains_null>(m_variables);
-    N = training_data->rows();
-    if constexpr (std::is_same_v<CType, double>) {
-        m_training_double = Matrix<double, Dynamic, 1>(N * d);
-        memcpy(m_training_double.data(), training_data->data(), N*d*sizeof(double));
+    // The order of the training instances does not change the density. The new buffer is sorted, so the fast
+    // univariate methods can reference it instead of a sorted copy.
+    bool sort = d == 1 && m_univariate_method != UnivariateKDEMethod::Exact;
+
+    if (df.has_weights()) {
+        Buffer_ptr bitmap;
+        if constexpr (contains_null) bitmap = df.combined_bitmap(m_variables);
+
+        auto weights = training_weights(df, bitmap);
+        if (sort) {
+            auto raw = training_data->data();
+            std::stable_sort(weights.rows.begin(), weights.rows.end(), [raw](int64_t a, int64_t b) {
+                return raw[a] < raw[b];
+            });
+        }
+
+        N = weights.rows.size();
+        m_training = take_rows(training_data->data(), training_data->rows(), d, weights.rows);
+        m_log_weights = take_log_weights<CType>(weights);
     } else {
-        m_training_float = Matrix<float, Dynamic, 1>(N * d);
-        memcpy(m_training_float.data(), training_data->data(), N*d*sizeof(float));
+        N = training_data->rows();
+        m_training = util::copy_to_buffer(training_data->data(), N * d);
+        m_log_weights = nullptr;
+
+        if (sort) {
+            auto raw = reinterpret_cast<CType*>(m_training->mutable_data());
+            std::sort(raw, raw + N);
+        }
     }
 
     m_lognorm_const =
-        -llt_matrix.diagonal().array().log().sum() - 0.5 * d * std::log(2 * util::pi<double>) - std::log(N);
+        -llt_matrix.diagonal().array().log().sum() - 0.5 * d * std::log(2 * util::pi<double>) + log_uniform_weight();
 }
 
 template <typename ArrowType, typename EigenMatrix>
 void KDE::fit(EigenMatrix bandwidth,
-              typename ArrowType::c_type* training_data,
+              const typename ArrowType::c_type* training_data,
               std::shared_ptr<arrow::DataType> training_type,
               int training_instances) {
+    fit<ArrowType>(bandwidth,
+                   util::copy_to_buffer(training_data, static_cast<int64_t>(training_instances) * m_variables.size()),
+                   training_type,
+                   training_instances);
+}
+
+template <typename ArrowType, typename EigenMatrix>
+void KDE::fit(EigenMatrix bandwidth,
+              Buffer_ptr training_data,
+              std::shared_ptr<arrow::DataType> training_type,
+              int training_instances,
+              Buffer_ptr log_weights) {
     using CType = typename ArrowType::c_type;
 
     if ((bandwidth.rows() != bandwidth.cols()) || (static_cast<size_t>(bandwidth.rows()) != m_variables.size())) {
@@ -423,27 +491,24 @@ void KDE::fit(EigenMatrix bandwidth,
     }
 
     N = training_instances;
-    if constexpr (std::is_same_v<CType, double>) {
-        m_training_double = Matrix<double, Dynamic, 1>(N * d);
-        std::memcpy(m_training_double.data(), training_data, N*d*sizeof(double));
-    } else {
-        m_training_float = Matrix<float, Dynamic, 1>(N * d);
-        std::memcpy(m_training_float.data(), training_data, N*d*sizeof(float));
-    }
+    m_training = std::move(training_data);
+    m_log_weights = std::move(log_weights);
 
     m_training_type = training_type;
-    m_lognorm_const = -cholesky.diagonal().array().log().sum() - 0.5 * d * std::log(2 * util::pi<double>) - std::log(N);
+    m_lognorm_const =
+        -cholesky.diagonal().array().log().sum() - 0.5 * d * std::log(2 * util::pi<double>) + log_uniform_weight();
     m_fitted = true;
+    build_fast_univariate();
 }
 
-template <typename ArrowType>
+template <typename ArrowType, bool mixed>
 VectorXd KDE::_logl(const DataFrame& df) const {
-    using CType = typename ArrowType::c_type;
+    using CType = LoglType<ArrowType, mixed>;
     using VectorType = Matrix<CType, Dynamic, 1>;
 
     if (df.null_count(m_variables) == 0) {
         VectorType read_data(df->num_rows());
-        read_data = logl_buffer<ArrowType>(df);
+        read_data = logl_buffer<ArrowType, mixed>(df);
         if constexpr (!std::is_same_v<CType, double>)
             return read_data.template cast<double>();
         else
@@ -454,7 +519,7 @@ VectorXd KDE::_logl(const DataFrame& df) const {
         auto bitmap = df.combined_bitmap(m_variables);
         auto bitmap_data = bitmap->data();
 
-        read_data = logl_buffer<ArrowType>(df);
+        read_data = logl_buffer<ArrowType, mixed>(df);
 
         VectorXd res(df->num_rows());
 
@@ -470,50 +535,56 @@ VectorXd KDE::_logl(const DataFrame& df) const {
     }
 }
 
-template <typename ArrowType>
+template <typename ArrowType, bool mixed>
 double KDE::_slogl(const DataFrame& df) const {
     using CType = typename ArrowType::c_type;
 
     auto m = df.valid_rows(m_variables);
-    auto logl_mat = logl_buffer<ArrowType>(df);
+    auto logl_mat = logl_buffer<ArrowType, mixed>(df);
 
-    CType result = -1;
-    Kernel<CType>::instance().sum1d(logl_mat.data(), m, &result);
-    return static_cast<double>(result);
+    if constexpr (mixed) {
+        return Kernel<double>::instance().sum1d_mixed(logl_mat.data(), m);
+    } else {
+        CType result = -1;
+        Kernel<CType>::instance().sum1d(logl_mat.data(), m, &result);
+        return static_cast<double>(result);
+    }
 }
 
-template <typename ArrowType>
-Matrix<typename ArrowType::c_type, Dynamic, 1> KDE::logl_buffer(const DataFrame& df) const {
-    using CType = typename ArrowType::c_type;
-    using VectorType = Matrix<CType, Dynamic, 1>;
+template <typename ArrowType, bool mixed>
+Matrix<LoglType<ArrowType, mixed>, Dynamic, 1> KDE::logl_buffer(const DataFrame& df) const {
+    using VectorType = Matrix<LoglType<ArrowType, mixed>, Dynamic, 1>;
 
     auto test_matrix = df.to_eigen<false, ArrowType>(m_variables);
 
     VectorType res(test_matrix->rows());
-    if (m_variables.size() == 1)
-        _logl_impl<ArrowType, UnivariateKDE>(test_matrix->data(), test_matrix->rows(), res.data());
+    if (m_fast_univariate)
+        m_fast_univariate->logl(test_matrix->data(), test_matrix->rows(), res.data());
+    else if (m_variables.size() == 1)
+        _logl_impl<ArrowType, UnivariateKDE, mixed>(test_matrix->data(), test_matrix->rows(), res.data());
     else
-        _logl_impl<ArrowType, MultivariateKDE>(test_matrix->data(), test_matrix->rows(), res.data());
+        _logl_impl<ArrowType, MultivariateKDE, mixed>(test_matrix->data(), test_matrix->rows(), res.data());
     return res;
 }
 
-template <typename ArrowType>
-Matrix<typename ArrowType::c_type, Dynamic, 1> KDE::logl_buffer(const DataFrame& df, Buffer_ptr& bitmap) const {
-    using CType = typename ArrowType::c_type;
-    using VectorType = Matrix<CType, Dynamic, 1>;
+template <typename ArrowType, bool mixed>
+Matrix<LoglType<ArrowType, mixed>, Dynamic, 1> KDE::logl_buffer(const DataFrame& df, Buffer_ptr& bitmap) const {
+    using VectorType = Matrix<LoglType<ArrowType, mixed>, Dynamic, 1>;
 
     auto test_matrix = df.to_eigen<false, ArrowType>(bitmap, m_variables);
 
     VectorType res(test_matrix->rows());
-    if (m_variables.size() == 1)
-        _logl_impl<ArrowType, UnivariateKDE>(test_matrix->data(), test_matrix->rows(), res.data());
+    if (m_fast_univariate)
+        m_fast_univariate->logl(test_matrix->data(), test_matrix->rows(), res.data());
+    else if (m_variables.size() == 1)
+        _logl_impl<ArrowType, UnivariateKDE, mixed>(test_matrix->data(), test_matrix->rows(), res.data());
     else
-        _logl_impl<ArrowType, MultivariateKDE>(test_matrix->data(), test_matrix->rows(), res.data());
+        _logl_impl<ArrowType, MultivariateKDE, mixed>(test_matrix->data(), test_matrix->rows(), res.data());
     return res;
 }
 
-template <typename ArrowType, typename KDEType>
-void KDE::_logl_impl(typename ArrowType::c_type* test_buffer, int m, typename ArrowType::c_type* res) const {
+template <typename ArrowType, typename KDEType, bool mixed>
+void KDE::_logl_impl(typename ArrowType::c_type* test_buffer, int m, LoglType<ArrowType, mixed>* res) const {
     using CType = typename ArrowType::c_type;
     Kernel<CType> kernels = Kernel<CType>::instance();
 
@@ -535,7 +606,11 @@ void KDE::_logl_impl(typename ArrowType::c_type* test_buffer, int m, typename Ar
                                                       cholesky_raw<ArrowType>(),
                                                       m_lognorm_const,
                                                       out);
-        kernels.logsumexp_cols_offset(out, N, allocated_m, res, i * allocated_m);
+        if (m_log_weights) kernels.sum_rows_vector(out, N, log_weights_raw<ArrowType>(), N * allocated_m);
+        if constexpr (mixed)
+            kernels.logsumexp_cols_offset_mixed(out, N, allocated_m, res, i * allocated_m);
+        else
+            kernels.logsumexp_cols_offset(out, N, allocated_m, res, i * allocated_m);
     }
     free(out);
 
@@ -552,32 +627,47 @@ void KDE::_logl_impl(typename ArrowType::c_type* test_buffer, int m, typename Ar
                                                   cholesky_raw<ArrowType>(),
                                                   m_lognorm_const,
                                                   out);
-    kernels.logsumexp_cols_offset(out, N, remaining_m, res, (iterations - 1) * allocated_m);
+    if (m_log_weights) kernels.sum_rows_vector(out, N, log_weights_raw<ArrowType>(), N * remaining_m);
+    if constexpr (mixed)
+        kernels.logsumexp_cols_offset_mixed(out, N, remaining_m, res, (iterations - 1) * allocated_m);
+    else
+        kernels.logsumexp_cols_offset(out, N, remaining_m, res, (iterations - 1) * allocated_m);
     free(out);
 }
 
 template <typename ArrowType>
 py::tuple KDE::__getstate__() const {
     using CType = typename ArrowType::c_type;
-    using VectorType = Matrix<CType, Dynamic, 1>;
 
     MatrixXd bw;
-    VectorType training_data;
+    py::object training_data = py::none();
+    py::object log_weights = py::none();
     double lognorm_const = -1;
     int N_export = -1;
     int training_type = -1;
 
     if (m_fitted) {
-        training_data = VectorType(N * m_variables.size());
-        std::memcpy(training_data.data(), training_raw<ArrowType>(), N*m_variables.size()*sizeof(CType));
+        // The array references the training buffer, so it is not copied.
+        training_data = util::buffer_to_array<CType>(m_training, N * m_variables.size());
+        if (m_log_weights) log_weights = util::buffer_to_array<CType>(m_log_weights, N);
         lognorm_const = m_lognorm_const;
         training_type = static_cast<int>(m_training_type->id());
         N_export = N;
         bw = m_bandwidth;
     }
 
-    return py::make_tuple(
-        m_variables, m_fitted, m_bselector, bw, training_data, lognorm_const, N_export, training_type);
+    return py::make_tuple(m_variables,
+                          m_fitted,
+                          m_bselector,
+                          bw,
+                          training_data,
+                          lognorm_const,
+                          N_export,
+                          training_type,
+                          static_cast<int>(m_precision),
+                          static_cast<int>(m_univariate_method),
+                          m_univariate_tolerance,
+                          log_weights);
 }
 
 }  // namespace kde
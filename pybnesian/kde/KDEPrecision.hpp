@@ -0,0 +1,34 @@
+#ifndef PYBNESIAN_KDE_KDEPRECISION_HPP
+#define PYBNESIAN_KDE_KDEPRECISION_HPP
+
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+namespace kde {
+
+// Precision policy used to evaluate the KDE models:
+//  - Native: all the computations use the data type of the training data.
+//  - Mixed: the kernels are evaluated in the data type of the training data, but the log-sum-exp over the training
+//    instances and the sum of the log-likelihoods are accumulated in double with compensated summation. With float
+//    training data, the memory traffic is halved without losing the accuracy of the reductions.
+enum class KDEPrecision { Native, Mixed };
+
+inline KDEPrecision kde_precision_from_int(int p) {
+    switch (p) {
+        case static_cast<int>(KDEPrecision::Native):
+            return KDEPrecision::Native;
+        case static_cast<int>(KDEPrecision::Mixed):
+            return KDEPrecision::Mixed;
+        default:
+            throw std::runtime_error("Not valid KDEPrecision: " + std::to_string(p));
+    }
+}
+
+// Type of the log-likelihood values computed by a KDE.
+template <typename ArrowType, bool mixed>
+using LoglType = std::conditional_t<mixed, double, typename ArrowType::c_type>;
+
+}  // namespace kde
+
+#endif  // PYBNESIAN_KDE_KDEPRECISION_HPP
@@ -0,0 +1,71 @@
+#ifndef PYBNESIAN_KDE_KDEWEIGHTS_HPP
+#define PYBNESIAN_KDE_KDEWEIGHTS_HPP
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+#include <dataset/dataset.hpp>
+#include <util/binary_serialization.hpp>
+
+using dataset::DataFrame;
+
+namespace kde {
+
+// A KDE fitted with a weighted DataFrame (see DataFrame::has_weights()) keeps each training instance once, and the
+// kernel of the i-th instance is weighted by w_i / sum(w) instead of 1 / N. The instances with weight 0 are dropped.
+struct TrainingWeights {
+    // Positions of the instances with positive weight, among the valid rows of the DataFrame.
+    std::vector<int64_t> rows;
+    // log(w_i / sum(w)) of all the valid rows of the DataFrame.
+    VectorXd log_weights;
+};
+
+// Weights of the rows set in the bitmap (all the rows if the bitmap is null). The DataFrame must have weights.
+inline TrainingWeights training_weights(const DataFrame& df, const Buffer_ptr& bitmap) {
+    auto w = df.weights_vector(bitmap);
+    auto total = w.sum();
+    if (!(total > 0)) throw std::invalid_argument("A KDE cannot be fitted with a total weight of 0.");
+
+    TrainingWeights res;
+    res.rows.reserve(w.rows());
+    for (int64_t i = 0; i < w.rows(); ++i) {
+        if (w(i) > 0) res.rows.push_back(i);
+    }
+
+    res.log_weights = (w / total).array().log().matrix();
+    return res;
+}
+
+// Returns a new column-major buffer with the selected rows of the column-major matrix data.
+template <typename CType>
+Buffer_ptr take_rows(const CType* data, int64_t physical_rows, int64_t cols, const std::vector<int64_t>& rows) {
+    auto n = static_cast<int64_t>(rows.size());
+    RAISE_RESULT_ERROR(Buffer_ptr buffer, arrow::AllocateBuffer(n * cols * sizeof(CType)))
+    auto out = reinterpret_cast<CType*>(buffer->mutable_data());
+
+    for (int64_t j = 0; j < cols; ++j) {
+        for (int64_t i = 0; i < n; ++i) {
+            out[j * n + i] = data[j * physical_rows + rows[i]];
+        }
+    }
+
+    return buffer;
+}
+
+// Returns a new buffer with the log-weights of the selected rows, in the order of weights.rows.
+template <typename CType>
+Buffer_ptr take_log_weights(const TrainingWeights& weights) {
+    auto n = static_cast<int64_t>(weights.rows.size());
+    RAISE_RESULT_ERROR(Buffer_ptr buffer, arrow::AllocateBuffer(n * sizeof(CType)))
+    auto out = reinterpret_cast<CType*>(buffer->mutable_data());
+
+    for (int64_t i = 0; i < n; ++i) {
+        out[i] = static_cast<CType>(weights.log_weights(weights.rows[i]));
+    }
+
+    return buffer;
+}
+
+}  // namespace kde
+
+#endif  // PYBNESIAN_KDE_KDEWEIGHTS_HPP
@@ -12,14 +12,14 @@ public:
     VectorXd diag_bandwidth(const DataFrame& df, const std::vector<std::string>& variables) const override {
         if (variables.empty()) return VectorXd(0);
 
-        size_t valid_rows = df.valid_rows(variables);
+        auto valid_rows = df.total_weight(variables);
         if (valid_rows <= variables.size()) {
             std::stringstream ss;
             ss << "Diagonal bandwidth matrix of " << std::to_string(variables.size()) << " variables [" << variables[0];
             for (size_t i = 1; i < variables.size(); ++i) {
                 ss << ", " << variables[i];
             }
-            ss << "] cannot be estimated with " << std::to_string(valid_rows) << " instances";
+            ss << "] cannot be estimated with " << valid_rows << " instances";
 
             throw util::singular_covariance_data(ss.str());
         }
@@ -37,14 +37,14 @@ public:
     MatrixXd bandwidth(const DataFrame& df, const std::vector<std::string>& variables) const override {
         if (variables.empty()) return MatrixXd(0, 0);
 
-        auto valid_rows = df.valid_rows(variables);
-        if (static_cast<size_t>(valid_rows) <= variables.size()) {
+        auto valid_rows = df.total_weight(variables);
+        if (valid_rows <= variables.size()) {
             std::stringstream ss;
             ss << "Bandwidth matrix of " << std::to_string(variables.size()) << " variables [" << variables[0];
             for (size_t i = 1; i < variables.size(); ++i) {
                 ss << ", " << variables[i];
             }
-            ss << "] cannot be estimated with " << std::to_string(valid_rows) << " instances";
+            ss << "] cannot be estimated with " << valid_rows << " instances";
 
             throw util::singular_covariance_data(ss.str());
         }
@@ -72,8 +72,7 @@ private:
     VectorXd diag_bandwidth(const DataFrame& df, const std::vector<std::string>& variables) const {
         using CType = typename ArrowType::c_type;
 
-        auto cov_ptr = df.cov<ArrowType>(variables);
-        auto& cov = *cov_ptr;
+        auto [cov, instances] = sample_cov<ArrowType>(df, variables);
 
         if (!util::is_psd(cov)) {
             std::stringstream ss;
@@ -89,7 +88,7 @@ private:
         auto delta = (cov.array().colwise() * diag.cwiseInverse().array()).matrix();
         auto delta_inv = delta.inverse();
 
-        auto N = static_cast<CType>(df.valid_rows(variables));
+        auto N = static_cast<CType>(instances);
         auto d = static_cast<CType>(variables.size());
 
         auto delta_inv_trace = delta_inv.trace();
@@ -109,9 +108,9 @@ private:
     MatrixXd bandwidth(const DataFrame& df, const std::vector<std::string>& variables) const {
         using CType = typename ArrowType::c_type;
 
-        auto cov = df.cov<ArrowType>(variables);
+        auto [cov, instances] = sample_cov<ArrowType>(df, variables);
 
-        if (!util::is_psd(*cov)) {
+        if (!util::is_psd(cov)) {
             std::stringstream ss;
             ss << "Covariance matrix for variables [" << variables[0];
             for (size_t i = 1; i < variables.size(); ++i) {
@@ -121,15 +120,15 @@ private:
             throw util::singular_covariance_data(ss.str());
         }
 
-        auto N = static_cast<CType>(df.valid_rows(variables));
+        auto N = static_cast<CType>(instances);
         auto d = static_cast<CType>(variables.size());
 
         auto k = std::pow(4. / (N * (d + 2.)), 2. / (d + 4));
 
         if constexpr (std::is_same_v<ArrowType, arrow::DoubleType>) {
-            return k * (*cov);
+            return k * cov;
         } else {
-            return k * cov->template cast<double>();
+            return k * cov.template cast<double>();
         }
     }
 };
@@ -32,7 +32,7 @@ void ProductKDE::copy_bandwidth() {
     }
 
     m_lognorm_const = -0.5 * m_variables.size() * std::log(2 * util::pi<double>) -
-                      0.5 * m_bandwidth.array().log().sum() - std::log(N);
+                      0.5 * m_bandwidth.array().log().sum() + log_uniform_weight();
 }
 
 DataFrame ProductKDE::training_data() const {
@@ -84,9 +84,15 @@ VectorXd ProductKDE::logl(const DataFrame& df) const {
 
     switch (type->id()) {
         case Type::DOUBLE:
-            return _logl<arrow::DoubleType>(df);
+            if (m_precision == KDEPrecision::Mixed)
+                return _logl<arrow::DoubleType, true>(df);
+            else
+                return _logl<arrow::DoubleType, false>(df);
         case Type::FLOAT:
-            return _logl<arrow::FloatType>(df);
+            if (m_precision == KDEPrecision::Mixed)
+                return _logl<arrow::FloatType, true>(df);
+            else
+                return _logl<arrow::FloatType, false>(df);
         default:
             throw std::runtime_error("Unreachable code.");
     }
@@ -102,9 +108,15 @@ double ProductKDE::slogl(const DataFrame& df) const {
 
     switch (type->id()) {
         case Type::DOUBLE:
-            return _slogl<arrow::DoubleType>(df);
+            if (m_precision == KDEPrecision::Mixed)
+                return _slogl<arrow::DoubleType, true>(df);
+            else
+                return _slogl<arrow::DoubleType, false>(df);
         case Type::FLOAT:
-            return _slogl<arrow::FloatType>(df);
+            if (m_precision == KDEPrecision::Mixed)
+                return _slogl<arrow::FloatType, true>(df);
+            else
+                return _slogl<arrow::FloatType, false>(df);
         default:
             throw std::runtime_error("Unreachable code.");
     }
@@ -123,9 +135,12 @@ py::tuple ProductKDE::__getstate__() const {
 }
 
 ProductKDE ProductKDE::__setstate__(py::tuple& t) {
-    if (t.size() != 8) throw std::runtime_error("Not valid ProductKDE.");
+    // The precision was added in the 9th position, and the log-weights in the 10th. The ProductKDEs saved before use
+    // the native precision and no weights.
+    if (t.size() != 8 && t.size() != 9 && t.size() != 10) throw std::runtime_error("Not valid ProductKDE.");
 
     ProductKDE kde(t[0].cast<std::vector<std::string>>());
+    if (t.size() >= 9) kde.m_precision = kde_precision_from_int(t[8].cast<int>());
 
     kde.m_fitted = t[1].cast<bool>();
     kde.m_bselector = t[2].cast<std::shared_ptr<BandwidthSelector>>();
@@ -137,41 +152,37 @@ ProductKDE ProductKDE::__setstate__(py::tuple& t) {
         kde.N = static_cast<size_t>(t[6].cast<int>());
         kde.m_training_type = pyarrow::GetPrimitiveType(static_cast<arrow::Type::type>(t[7].cast<int>()));
 
-        switch (kde.m_training_type->id()) {
-            case Type::DOUBLE: {
-                auto data = t[4].cast<std::vector<VectorXd>>();
-
-                for (size_t i = 0; i < kde.m_variables.size(); ++i) {
-                    Matrix<double, Dynamic, 1> aux(kde.N);
-                    std::memcpy(aux.data(), data[i].data(), kde.N*sizeof(double));
-                    kde.m_training_double.push_back(aux);
-
-                    Matrix<double, Dynamic, 1>  aux2(1);
-                    aux2[0] = kde.m_bandwidth(i);
-                    kde.m_bandwidth_double.push_back(aux2);
-                }
-
-                break;
+        auto data = t[4].cast<std::vector<py::array>>();
+        if (data.size() != kde.m_variables.size()) throw std::runtime_error("Not valid ProductKDE.");
+
+        for (const auto& column : data) {
+            switch (kde.m_training_type->id()) {
+                case Type::DOUBLE:
+                    kde.m_training.push_back(util::array_to_buffer<double>(column));
+                    break;
+                case Type::FLOAT:
+                    kde.m_training.push_back(util::array_to_buffer<float>(column));
+                    break;
+                default:
+                    throw std::runtime_error("Not valid data type in ProductKDE.");
             }
-            case Type::FLOAT: {
-                auto data = t[4].cast<std::vector<VectorXf>>();
 
-                for (size_t i = 0; i < kde.m_variables.size(); ++i) {
-                    auto casted_bw = static_cast<float>(kde.m_bandwidth(i));
-                    Matrix<float, Dynamic, 1> aux(kde.N);
-                    std::memcpy(aux.data(), data[i].data(), kde.N*sizeof(float));
-                    kde.m_training_float.push_back(aux);
+            if (kde.m_training.back()->size() != static_cast<int64_t>(kde.N * kde.m_training_type->bit_width() / 8))
+                throw std::runtime_error("Not valid ProductKDE.");
+        }
 
-                    Matrix<float, Dynamic, 1>  aux2(1);
-                    aux2[0] = casted_bw;
-                    kde.m_bandwidth_float.push_back(aux2);
-                }
+        if (t.size() == 10 && !t[9].is_none()) {
+            auto log_weights = t[9].cast<py::array>();
+            if (kde.m_training_type->id() == Type::DOUBLE)
+                kde.m_log_weights = util::array_to_buffer<double>(log_weights);
+            else
+                kde.m_log_weights = util::array_to_buffer<float>(log_weights);
 
-                break;
-            }
-            default:
-                throw std::runtime_error("Not valid data type in ProductKDE.");
+            if (kde.m_log_weights->size() != static_cast<int64_t>(kde.N * kde.m_training_type->bit_width() / 8))
+                throw std::runtime_error("Not valid ProductKDE.");
         }
+
+        kde.copy_bandwidth();
     }
 
     return kde;
@@ -2,8 +2,11 @@
 #define PYBNESIAN_KDE_PRODUCTKDE_HPP
 
 #include <util/pickle.hpp>
+#include <util/binary_serialization.hpp>
 #include <kde/BandwidthSelector.hpp>
 #include <kde/NormalReferenceRule.hpp>
+#include <kde/KDEPrecision.hpp>
+#include <kde/KDEWeights.hpp>
 #include <util/math_constants.hpp>
 #include <iostream>
 #include <kernels/kernel.hpp>
@@ -17,12 +20,18 @@ public:
           m_fitted(),
           m_bselector(std::make_shared<NormalReferenceRule>()),
           N(0),
-          m_training_type(arrow::float64()) {}
+          m_training_type(arrow::float64()),
+          m_precision(KDEPrecision::Native) {}
 
     ProductKDE(std::vector<std::string> variables) : ProductKDE(variables, std::make_shared<NormalReferenceRule>()) {}
 
     ProductKDE(std::vector<std::string> variables, std::shared_ptr<BandwidthSelector> b_selector)
-        : m_variables(variables), m_fitted(false), m_bselector(b_selector), N(0), m_training_type(arrow::float64()) {
+        : m_variables(variables),
+          m_fitted(false),
+          m_bselector(b_selector),
+          N(0),
+          m_training_type(arrow::float64()),
+          m_precision(KDEPrecision::Native) {
         if (b_selector == nullptr) throw std::runtime_error("Bandwidth selector procedure must be non-null.");
 
         if (m_variables.empty()) {
@@ -62,10 +71,13 @@ public:
 
     std::shared_ptr<BandwidthSelector> bandwidth_type() const { return m_bselector; }
 
+    KDEPrecision precision() const { return m_precision; }
+    void set_precision(KDEPrecision precision) { m_precision = precision; }
+
     VectorXd logl(const DataFrame& df) const;
 
-    template <typename ArrowType>
-    Matrix<typename ArrowType::c_type, Dynamic, 1> logl_buffer(const DataFrame& df) const;
+    template <typename ArrowType, bool mixed = false>
+    Matrix<LoglType<ArrowType, mixed>, Dynamic, 1> logl_buffer(const DataFrame& df) const;
 
     double slogl(const DataFrame& df) const;
 
@@ -86,9 +98,9 @@ private:
     template <typename ArrowType, bool contains_null>
     void _fit(const DataFrame& df);
 
-    template <typename ArrowType>
+    template <typename ArrowType, bool mixed>
     VectorXd _logl(const DataFrame& df) const;
-    template <typename ArrowType>
+    template <typename ArrowType, bool mixed>
     double _slogl(const DataFrame& df) const;
 
     template <typename ArrowType>
@@ -97,10 +109,22 @@ private:
                           const unsigned int test_length,
                           typename ArrowType::c_type* output_mat) const;
 
-    template <typename ArrowType>
-    void _logl_impl(typename ArrowType::c_type* test_buffer, int m, typename ArrowType::c_type* res) const;
+    template <typename ArrowType, bool mixed>
+    void _logl_impl(typename ArrowType::c_type* test_buffer, int m, LoglType<ArrowType, mixed>* res) const;
 
     void copy_bandwidth();
+    // log(1 / N) if the kernels are not weighted. Otherwise, the log-weights are added to each kernel.
+    double log_uniform_weight() const { return m_log_weights ? 0 : -std::log(N); }
+
+    template <typename ArrowType>
+    const typename ArrowType::c_type* training_raw(size_t i) const {
+        return reinterpret_cast<const typename ArrowType::c_type*>(m_training[i]->data());
+    }
+
+    template <typename ArrowType>
+    const typename ArrowType::c_type* log_weights_raw() const {
+        return reinterpret_cast<const typename ArrowType::c_type*>(m_log_weights->data());
+    }
 
     template <typename ArrowType>
     py::tuple __getstate__() const;
@@ -111,37 +135,25 @@ private:
     VectorXd m_bandwidth;
     std::vector<Matrix<double, Dynamic, 1>> m_bandwidth_double;
     std::vector<Matrix<float, Dynamic, 1>> m_bandwidth_float;
-    std::vector<Matrix<double, Dynamic, 1>> m_training_double;
-    std::vector<Matrix<float, Dynamic, 1>> m_training_float;
+    // Training data of each variable. The buffers are never modified, so they can reference a memory-mapped file.
+    std::vector<Buffer_ptr> m_training;
+    // Log-weights of the training instances (see KDEWeights.hpp), or null if the ProductKDE was fitted without weights.
+    Buffer_ptr m_log_weights;
     double m_lognorm_const;
     size_t N;
     std::shared_ptr<arrow::DataType> m_training_type;
+    KDEPrecision m_precision;
 };
 
 template <typename ArrowType>
 DataFrame ProductKDE::_training_data() const {
-    using CType = typename ArrowType::c_type;
-    arrow::NumericBuilder<ArrowType> builder;
-
-    const CType* tmp;
+    using ArrayType = typename arrow::TypeTraits<ArrowType>::ArrayType;
 
     std::vector<Array_ptr> columns;
     arrow::SchemaBuilder b(arrow::SchemaBuilder::ConflictPolicy::CONFLICT_ERROR);
     for (size_t i = 0; i < m_variables.size(); ++i) {
-        if constexpr (std::is_same_v<CType, double>) {
-            tmp = m_training_double[i].data();
-        } else {
-            tmp = m_training_float[i].data();
-        }
-
-        auto status = builder.Resize(N);
-        RAISE_STATUS_ERROR(builder.AppendValues(tmp, N));
-
-        Array_ptr out;
-        RAISE_STATUS_ERROR(builder.Finish(&out));
-
+        auto out = std::make_shared<ArrayType>(N, m_training[i]);
         columns.push_back(out);
-        builder.Reset();
 
         auto f = arrow::field(m_variables[i], out->type());
         RAISE_STATUS_ERROR(b.AddField(f));
@@ -161,13 +173,20 @@ void ProductKDE::_fit(const DataFrame& df) {
     if (static_cast<size_t>(m_bandwidth.rows()) != m_variables.size()) m_bandwidth = VectorXd(m_variables.size());
     m_bandwidth_double.clear();
     m_bandwidth_float.clear();
-    m_training_double.clear();
-    m_training_float.clear();
+    m_training.clear();
 
     Buffer_ptr combined_bitmap;
     if constexpr (contains_null) combined_bitmap = df.combined_bitmap(m_variables);
 
     N = df.valid_rows(m_variables);
+    m_log_weights = nullptr;
+
+    TrainingWeights weights;
+    if (df.has_weights()) {
+        weights = training_weights(df, combined_bitmap);
+        N = weights.rows.size();
+        m_log_weights = take_log_weights<CType>(weights);
+    }
 
     m_bandwidth = m_bselector->diag_bandwidth(df, m_variables);
 
@@ -186,34 +205,24 @@ void ProductKDE::_fit(const DataFrame& df) {
 
         if constexpr (contains_null) {
             auto column = df.to_eigen<false, ArrowType>(combined_bitmap, m_variables[i]);
-            VectorType aux(N);
-            std::memcpy(aux.data(), column->data(), N*sizeof(CType));
-            if constexpr (std::is_same_v<CType, double>) {
-                m_training_double.push_back(aux);
-            } else {
-                m_training_float.push_back(aux);
-            }
+            m_training.push_back(m_log_weights ? take_rows(column->data(), column->rows(), 1, weights.rows)
+                                               : util::copy_to_buffer(column->data(), N));
         } else {
             auto column = df.to_eigen<false, ArrowType, false>(m_variables[i]);
-            VectorType aux(N);
-            std::memcpy(aux.data(), column->data(), N*sizeof(CType));
-            if constexpr (std::is_same_v<CType, double>) {
-                m_training_double.push_back(aux);
-            } else {
-                m_training_float.push_back(aux);
-            }
+            m_training.push_back(m_log_weights ? take_rows(column->data(), column->rows(), 1, weights.rows)
+                                               : util::copy_to_buffer(column->data(), N));
         }
     }
 
     m_lognorm_const = -0.5 * static_cast<double>(m_variables.size()) * std::log(2 * util::pi<double>) -
-                      0.5 * m_bandwidth.array().log().sum() - std::log(N);
+                      0.5 * m_bandwidth.array().log().sum() + log_uniform_weight();
 }
 
-template <typename ArrowType>
+template <typename ArrowType, bool mixed>
 VectorXd ProductKDE::_logl(const DataFrame& df) const {
-    using CType = typename ArrowType::c_type;
+    using CType = LoglType<ArrowType, mixed>;
 
-    auto read_data = logl_buffer<ArrowType>(df);
+    auto read_data = logl_buffer<ArrowType, mixed>(df);
     if (df.null_count(m_variables) == 0) {
         if constexpr (!std::is_same_v<CType, double>)
             return read_data.template cast<double>();
@@ -237,16 +246,15 @@ VectorXd ProductKDE::_logl(const DataFrame& df) const {
     }
 }
 
-template <typename ArrowType>
-Matrix<typename ArrowType::c_type, Dynamic, 1> ProductKDE::logl_buffer(const DataFrame& df) const {
-    using CType = typename ArrowType::c_type;
-    using VectorType = Matrix<CType, Dynamic, 1>;
+template <typename ArrowType, bool mixed>
+Matrix<LoglType<ArrowType, mixed>, Dynamic, 1> ProductKDE::logl_buffer(const DataFrame& df) const {
+    using VectorType = Matrix<LoglType<ArrowType, mixed>, Dynamic, 1>;
 
     auto test_matrix = df.to_eigen<false, ArrowType>(m_variables);
     auto m = test_matrix->rows();
 
     VectorType res(m);
-    _logl_impl<ArrowType>(test_matrix->data(), m, res.data());
+    _logl_impl<ArrowType, mixed>(test_matrix->data(), m, res.data());
     return res;
 }
 
@@ -258,11 +266,7 @@ void ProductKDE::product_logl_mat(typename ArrowType::c_type* test_buffer,
     using CType = typename ArrowType::c_type;
     Kernel<CType> kernels = Kernel<CType>::instance();
 
-    const CType* m_training_tmp;
-    if constexpr (std::is_same_v<CType, double>)
-        m_training_tmp = m_training_double[0].data();
-    else
-        m_training_tmp = m_training_float[0].data();
+    const CType* m_training_tmp = training_raw<ArrowType>(0);
 
     CType m_cl_bandwidth_tmp;
     if constexpr (std::is_same_v<CType, double>)
@@ -273,10 +277,7 @@ void ProductKDE::product_logl_mat(typename ArrowType::c_type* test_buffer,
     kernels.prod_logl_values_1d_mat(m_training_tmp, N, test_buffer, test_offset, m_cl_bandwidth_tmp, m_lognorm_const, output_mat, test_length);
 
     for (size_t i = 1; i < m_variables.size(); ++i) {
-        if constexpr (std::is_same_v<CType, double>)
-            m_training_tmp = m_training_double[i].data();
-        else
-            m_training_tmp = m_training_float[i].data();
+        m_training_tmp = training_raw<ArrowType>(i);
 
         if constexpr (std::is_same_v<CType, double>)
             m_cl_bandwidth_tmp = m_bandwidth_double[i][0];
@@ -285,10 +286,12 @@ void ProductKDE::product_logl_mat(typename ArrowType::c_type* test_buffer,
 
         kernels.add_logl_values_1d_mat(m_training_tmp, N, test_buffer, (i * test_length) + test_offset, m_cl_bandwidth_tmp, output_mat, test_length);
     }
+
+    if (m_log_weights) kernels.sum_rows_vector(output_mat, N, log_weights_raw<ArrowType>(), N * test_length);
 }
 
-template <typename ArrowType>
-void ProductKDE::_logl_impl(typename ArrowType::c_type* test_buffer, int m, typename ArrowType::c_type* res) const {
+template <typename ArrowType, bool mixed>
+void ProductKDE::_logl_impl(typename ArrowType::c_type* test_buffer, int m, LoglType<ArrowType, mixed>* res) const {
     using CType = typename ArrowType::c_type;
 
     Kernel<CType> kernels = Kernel<CType>::instance();
@@ -300,56 +303,71 @@ void ProductKDE::_logl_impl(typename ArrowType::c_type* test_buffer, int m, type
 
     for (auto i = 0; i < (iterations - 1); ++i) {
         product_logl_mat<ArrowType>(test_buffer, i * allocated_m, allocated_m, tmp);
-        kernels.logsumexp_cols_offset(tmp, N, allocated_m, res, i * allocated_m);
+        if constexpr (mixed)
+            kernels.logsumexp_cols_offset_mixed(tmp, N, allocated_m, res, i * allocated_m);
+        else
+            kernels.logsumexp_cols_offset(tmp, N, allocated_m, res, i * allocated_m);
     }
 
     auto remaining_m = m - (iterations - 1) * allocated_m;
     product_logl_mat<ArrowType>(test_buffer, m - remaining_m, remaining_m, tmp);
-    kernels.logsumexp_cols_offset(tmp, N, remaining_m, res, m - remaining_m);
+    if constexpr (mixed)
+        kernels.logsumexp_cols_offset_mixed(tmp, N, remaining_m, res, m - remaining_m);
+    else
+        kernels.logsumexp_cols_offset(tmp, N, remaining_m, res, m - remaining_m);
     free(tmp);
 }
 
-template <typename ArrowType>
+template <typename ArrowType, bool mixed>
 double ProductKDE::_slogl(const DataFrame& df) const {
     using CType = typename ArrowType::c_type;
 
     auto m = df.valid_rows(m_variables);
-    auto logl_buff = logl_buffer<ArrowType>(df);
+    auto logl_buff = logl_buffer<ArrowType, mixed>(df);
 
-    CType result = -1;
-    Kernel<CType>::instance().sum1d(logl_buff.data(), m, &result);
-    return static_cast<double>(result);
+    if constexpr (mixed) {
+        return Kernel<double>::instance().sum1d_mixed(logl_buff.data(), m);
+    } else {
+        CType result = -1;
+        Kernel<CType>::instance().sum1d(logl_buff.data(), m, &result);
+        return static_cast<double>(result);
+    }
 }
 
 template <typename ArrowType>
 py::tuple ProductKDE::__getstate__() const {
     using CType = typename ArrowType::c_type;
-    using VectorType = Matrix<CType, Dynamic, 1>;
 
     VectorXd bw;
-    std::vector<VectorType> training_data;
+    std::vector<py::array> training_data;
+    py::object log_weights = py::none();
     double lognorm_const = -1;
     int N_export = -1;
     int training_type = -1;
 
     if (m_fitted) {
         for (size_t i = 0; i < m_variables.size(); ++i) {
-            VectorType column(N);
-            if constexpr (std::is_same_v<CType, double>) {
-                column = m_training_double[i];
-            } else {
-                column = m_training_float[i];
-            }
+            training_data.push_back(util::buffer_to_array<CType>(m_training[i], N));
         }
 
+        if (m_log_weights) log_weights = util::buffer_to_array<CType>(m_log_weights, N);
+
         lognorm_const = m_lognorm_const;
         training_type = static_cast<int>(m_training_type->id());
         N_export = N;
         bw = m_bandwidth;
     }
 
-    return py::make_tuple(
-        m_variables, m_fitted, m_bselector, bw, training_data, lognorm_const, N_export, training_type);
+    return py::make_tuple(m_variables,
+                          m_fitted,
+                          m_bselector,
+                          bw,
+                          training_data,
+                          lognorm_const,
+                          N_export,
+                          training_type,
+                          static_cast<int>(m_precision),
+                          log_weights);
 }
 
 }  // namespace kde
@@ -8,14 +8,14 @@ public:
     VectorXd diag_bandwidth(const DataFrame& df, const std::vector<std::string>& variables) const override {
         if (variables.empty()) return VectorXd(0);
 
-        size_t valid_rows = df.valid_rows(variables);
+        auto valid_rows = df.total_weight(variables);
         if (valid_rows <= 1) {
             std::stringstream ss;
             ss << "Diagonal bandwidth matrix of " << std::to_string(variables.size()) << " variables [" << variables[0];
             for (size_t i = 1; i < variables.size(); ++i) {
                 ss << ", " << variables[i];
             }
-            ss << "] cannot be estimated with " << std::to_string(valid_rows) << " instances";
+            ss << "] cannot be estimated with " << valid_rows << " instances";
 
             throw util::singular_covariance_data(ss.str());
         }
@@ -33,14 +33,14 @@ public:
     MatrixXd bandwidth(const DataFrame& df, const std::vector<std::string>& variables) const override {
         if (variables.empty()) return MatrixXd(0, 0);
 
-        size_t valid_rows = df.valid_rows(variables);
+        auto valid_rows = df.total_weight(variables);
         if (valid_rows <= variables.size()) {
             std::stringstream ss;
             ss << "Bandwidth matrix of " << std::to_string(variables.size()) << " variables [" << variables[0];
             for (size_t i = 1; i < variables.size(); ++i) {
                 ss << ", " << variables[i];
             }
-            ss << "] cannot be estimated with " << std::to_string(valid_rows) << " instances";
+            ss << "] cannot be estimated with " << valid_rows << " instances";
 
             throw util::singular_covariance_data(ss.str());
         }
@@ -66,9 +66,15 @@ private:
     VectorXd diag_bandwidth(const DataFrame& df, const std::vector<std::string>& variables) const {
         using CType = typename ArrowType::c_type;
 
-        auto N = static_cast<CType>(df.valid_rows(variables));
         auto d = static_cast<CType>(variables.size());
 
+        if (df.has_weights()) {
+            auto [cov, instances] = sample_cov<ArrowType>(df, variables);
+            auto k = std::pow(static_cast<CType>(instances), -2. / (d + 4.));
+            return k * cov.diagonal().template cast<double>();
+        }
+
+        auto N = static_cast<CType>(df.valid_rows(variables));
         auto k = std::pow(N, -2. / (d + 4.));
         VectorXd bandwidth(variables.size());
 
@@ -91,9 +97,9 @@ private:
     MatrixXd bandwidth(const DataFrame& df, const std::vector<std::string>& variables) const {
         using CType = typename ArrowType::c_type;
 
-        auto cov = df.cov<ArrowType>(variables);
+        auto [cov, instances] = sample_cov<ArrowType>(df, variables);
 
-        if (!util::is_psd(*cov)) {
+        if (!util::is_psd(cov)) {
             std::stringstream ss;
             ss << "Covariance matrix for variables [" << variables[0];
             for (size_t i = 1; i < variables.size(); ++i) {
@@ -103,15 +109,15 @@ private:
             throw util::singular_covariance_data(ss.str());
         }
 
-        auto N = static_cast<CType>(df.valid_rows(variables));
+        auto N = static_cast<CType>(instances);
         auto d = static_cast<CType>(variables.size());
 
         auto k = std::pow(N, -2. / (d + 4));
 
         if constexpr (std::is_same_v<ArrowType, arrow::DoubleType>) {
-            return k * (*cov);
+            return k * cov;
         } else {
-            return k * cov->template cast<double>();
+            return k * cov.template cast<double>();
         }
     }
 };
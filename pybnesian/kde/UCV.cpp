@@ -1,3 +1,4 @@
+#include <mutex>
 #include <kde/UCV.hpp>
 #include <kde/NormalReferenceRule.hpp>
 #include <util/math_constants.hpp>
@@ -9,6 +10,10 @@ using opencl::OpenCLConfig, opencl::OpenCL_kernel_traits;
 
 namespace kde {
 
+// The OpenCL kernels are shared, so the UCV bandwidths of different KDEs (e.g. the CPDs of a model fitted in parallel)
+// are computed one at a time.
+std::mutex ucv_opencl_mutex;
+
 class UnivariateUCVScore {
 public:
     template <typename ArrowType>
@@ -493,6 +498,8 @@ double wrap_ucv_optim(unsigned n, const double* x, double*, void* my_func_data)
 VectorXd UCV::diag_bandwidth(const DataFrame& df, const std::vector<std::string>& variables) const {
     if (variables.empty()) return VectorXd(0);
 
+    std::lock_guard<std::mutex> lock(ucv_opencl_mutex);
+
     NormalReferenceRule nr;
 
     auto normal_bandwidth = nr.diag_bandwidth(df, variables);
@@ -529,6 +536,8 @@ VectorXd UCV::diag_bandwidth(const DataFrame& df, const std::vector<std::string>
 MatrixXd UCV::bandwidth(const DataFrame& df, const std::vector<std::string>& variables) const {
     if (variables.empty()) return MatrixXd(0, 0);
 
+    std::lock_guard<std::mutex> lock(ucv_opencl_mutex);
+
     NormalReferenceRule nr;
 
     auto normal_bandwidth = nr.bandwidth(df, variables);
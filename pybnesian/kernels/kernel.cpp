@@ -3,7 +3,7 @@
 
 #include <kernels/kernel.hpp>
 #include <iostream>
-#include <omp.h>
+#include <util/parallel.hpp>
 
 template <class T>
 Kernel<T>::Kernel(){
@@ -108,18 +108,13 @@ void Kernel<T>::max_mat_cols(const T* mat,
                              uint output_offset,
                             //  uint size_dim1,
                              uint size_dim2) {
-#pragma omp parallel
-#pragma omp single
-{
-    #pragma omp taskloop num_tasks(omp_get_num_threads())
-    for (uint j = 0; j < size_dim2; ++j) {
+    util::parallel_for(size_dim2, mat_rows, [=](int64_t j) {
         T max = -std::numeric_limits<T>::max();
         for (uint i = 0; i < mat_rows; ++i) {
             max = std::max(mat[IDX(i, j, mat_rows)], max);
         }
         output[output_offset + j] = max;
-    }
-}
+    });
 }
 
 template <class T>
@@ -130,17 +125,12 @@ void Kernel<T>::sum_mat_cols(const T* mat,
                              uint output_offset,
                             //  uint size_dim1,
                              uint size_dim2) {
-#pragma omp parallel
-#pragma omp single
-{
-    #pragma omp taskloop num_tasks(omp_get_num_threads())
-    for (uint j = 0; j < size_dim2; ++j) {
+    util::parallel_for(size_dim2, mat_rows, [=](int64_t j) {
         T sum = 0;
         for (uint i = 0; i < mat_rows; ++i)
             sum+=mat[IDX(i, j, mat_rows)];
         output[output_offset + j] = sum;
-    }
-}
+    });
 }
 
 template <class T>
@@ -148,15 +138,12 @@ void Kernel<T>::logsumexp_coeffs(T* input,
                                  uint input_rows,
                                  T* max,
                                  uint size) {
-#pragma omp parallel
-#pragma omp single
-{
-    #pragma omp taskloop num_tasks(omp_get_num_threads())
-    for (uint idx = 0; idx < size; ++idx) {
-        uint col = COL(idx, input_rows);
-        input[idx] = exp(input[idx] - max[col]);
-    }
-}
+    // The matrix is processed by columns, so each task computes a contiguous block.
+    uint cols = size / input_rows;
+    util::parallel_for(cols, input_rows, [=](int64_t col) {
+        for (uint idx = col * input_rows, end = idx + input_rows; idx < end; ++idx)
+            input[idx] = exp(input[idx] - max[col]);
+    });
 }
 
 template <class T>
@@ -294,20 +281,13 @@ void Kernel<T>::logl_values_1d_mat(const T* train_vector,
                                    T lognorm_factor,
                                    T* result,
                                    uint test_length) {
-    int size = train_rows * test_length;
-#pragma omp parallel
-#pragma omp single
-{
-    int n_tasks = omp_get_num_threads();
-    int gs = std::max(size / n_tasks, 1);
-    #pragma omp taskloop grainsize(gs)
-    for (int i = 0; i < size; ++i) {
-        int train_idx = ROW(i, train_rows);
-        int test_idx = COL(i, train_rows);
-        T d = (train_vector[train_idx] - test_vector[test_offset + test_idx]) / standard_deviation[0];
-        result[i] = (-0.5*d*d) + lognorm_factor;
-    }
-}
+    util::parallel_for(test_length, train_rows, [=](int64_t test_idx) {
+        T* result_col = result + test_idx * train_rows;
+        for (uint train_idx = 0; train_idx < train_rows; ++train_idx) {
+            T d = (train_vector[train_idx] - test_vector[test_offset + test_idx]) / standard_deviation[0];
+            result_col[train_idx] = (-0.5*d*d) + lognorm_factor;
+        }
+    });
 }
 
 template <class T>
@@ -437,6 +417,18 @@ void Kernel<T>::product_elementwise(T* mat1, T* mat2, uint size) {
         mat1[i] *= mat2[i];
 }
 
+template <class T>
+void Kernel<T>::sum_rows_vector(T* mat, uint mat_rows, const T* vec, uint size) {
+    for (uint i = 0; i < size; ++i)
+        mat[i] += vec[ROW(i, mat_rows)];
+}
+
+template <class T>
+void Kernel<T>::product_rows_vector(T* mat, uint mat_rows, const T* vec, uint size) {
+    for (uint i = 0; i < size; ++i)
+        mat[i] *= vec[ROW(i, mat_rows)];
+}
+
 template <class T>
 void Kernel<T>::division_elementwise(T* mat1,
                                      uint mat1_offset,
@@ -614,4 +606,47 @@ void Kernel<T>::reduction1d(const T* input_vec, int input_length, T* output_buff
     free(tmp);
 }
 
+// MIXED PRECISION KERNELS
+
+// Neumaier's variant of the Kahan summation: the rounding error of each addition is accumulated in compensation, so the
+// error of the sum does not grow with the number of values.
+template <class T>
+void Kernel<T>::compensated_add(double& sum, double& compensation, double value) {
+    double t = sum + value;
+    if (std::abs(sum) >= std::abs(value))
+        compensation += (sum - t) + value;
+    else
+        compensation += (value - t) + sum;
+    sum = t;
+}
+
+template <class T>
+void Kernel<T>::logsumexp_cols_offset_mixed(const T* input_mat,
+                                            int input_rows,
+                                            int input_cols,
+                                            double* output_vec,
+                                            int output_offset) {
+    util::parallel_for(input_cols, input_rows, [=](int64_t j) {
+        const T* col = input_mat + j * input_rows;
+
+        double max = -std::numeric_limits<double>::max();
+        for (int i = 0; i < input_rows; ++i)
+            max = std::max(static_cast<double>(col[i]), max);
+
+        double sum = 0, compensation = 0;
+        for (int i = 0; i < input_rows; ++i)
+            compensated_add(sum, compensation, std::exp(static_cast<double>(col[i]) - max));
+
+        output_vec[output_offset + j] = std::log(sum + compensation) + max;
+    });
+}
+
+template <class T>
+double Kernel<T>::sum1d_mixed(const T* input_vec, int input_length) {
+    double sum = 0, compensation = 0;
+    for (int i = 0; i < input_length; ++i)
+        compensated_add(sum, compensation, static_cast<double>(input_vec[i]));
+    return sum + compensation;
+}
+
 #endif
@@ -44,6 +44,9 @@ class Kernel {
         void univariate_normal_cdf(const T* means, uint means_physical_rows, const T* x, uint x_offset, T inv_std, T inv_N, T* cdf_mat, uint m);
         void normal_cdf(T* means, uint means_physical_rows, T* x, uint x_offset, T inv_std, uint size);
         void product_elementwise(T* mat1, T* mat2, uint size);
+        // Adds (multiplies) vec[i] to (by) each value of the i-th row of the column-major matrix mat.
+        void sum_rows_vector(T* mat, uint mat_rows, const T* vec, uint size);
+        void product_rows_vector(T* mat, uint mat_rows, const T* vec, uint size);
         void division_elementwise(T* mat1, uint mat1_offset, T* mat2, uint size);
         void accum_sum_mat_cols(T* mat, uint mat_rows, T* local_block, T* sums, uint size_dim1, uint size_dim2, uint local_size);
         // AUXILIAR KERNELS
@@ -58,6 +61,9 @@ class Kernel {
         void sum1d(const T* input_vec, int input_length, T* output);
         template <typename Reduction>
         void reduction1d(const T* input_vec, int input_length, T* output_buffer, int output_offset);
+        // MIXED PRECISION KERNELS: the values are read in T, but accumulated in double with compensated summation.
+        void logsumexp_cols_offset_mixed(const T* input_mat, int input_rows, int input_cols, double* output_vec, int output_offset);
+        double sum1d_mixed(const T* input_vec, int input_length);
 
         // REDUCTIONS
 
@@ -74,6 +80,8 @@ class Kernel {
     private:
     
         Kernel();
+
+        static void compensated_add(double& sum, double& compensation, double value);
 };
 
 
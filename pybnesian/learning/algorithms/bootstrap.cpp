@@ -0,0 +1,355 @@
+#include <algorithm>
+#include <set>
+#include <learning/algorithms/bootstrap.hpp>
+#include <learning/algorithms/hillclimbing.hpp>
+#include <learning/algorithms/pc.hpp>
+#include <learning/algorithms/mmhc.hpp>
+#include <util/validate_options.hpp>
+
+namespace learning::algorithms {
+
+BootstrapFrequencies::BootstrapFrequencies(const std::vector<std::string>& nodes)
+    : m_nodes(nodes),
+      m_indices(),
+      m_num_replicates(0),
+      m_directed(nodes.size() * nodes.size()),
+      m_adjacent(nodes.size() * nodes.size()) {
+    for (size_t i = 0; i < m_nodes.size(); ++i) {
+        if (!m_indices.insert({m_nodes[i], static_cast<int>(i)}).second)
+            throw std::invalid_argument("Node " + m_nodes[i] + " is repeated.");
+    }
+}
+
+int BootstrapFrequencies::index(const std::string& node) const {
+    auto it = m_indices.find(node);
+    if (it == m_indices.end()) throw std::out_of_range("Node " + node + " not present in the bootstrap frequencies.");
+
+    return it->second;
+}
+
+void BootstrapFrequencies::add(const LearnedStructure& structure) {
+    auto n = m_nodes.size();
+
+    // The bidirected arcs of the PC are counted once as an adjacency.
+    std::set<std::pair<int, int>> adjacencies;
+
+    for (const auto& arc : structure.arcs) {
+        auto s = index(arc.first);
+        auto t = index(arc.second);
+        ++m_directed[s * n + t];
+        adjacencies.insert({std::min(s, t), std::max(s, t)});
+    }
+
+    for (const auto& edge : structure.edges) {
+        auto n1 = index(edge.first);
+        auto n2 = index(edge.second);
+        adjacencies.insert({std::min(n1, n2), std::max(n1, n2)});
+    }
+
+    for (const auto& adj : adjacencies) {
+        ++m_adjacent[adj.first * n + adj.second];
+        ++m_adjacent[adj.second * n + adj.first];
+    }
+
+    ++m_num_replicates;
+}
+
+double BootstrapFrequencies::arc_frequency(const std::string& source, const std::string& target) const {
+    if (m_num_replicates == 0) return 0;
+    return static_cast<double>(directed(index(source), index(target))) / m_num_replicates;
+}
+
+double BootstrapFrequencies::edge_frequency(const std::string& n1, const std::string& n2) const {
+    if (m_num_replicates == 0) return 0;
+    return static_cast<double>(adjacent(index(n1), index(n2))) / m_num_replicates;
+}
+
+std::vector<std::tuple<std::string, std::string, double>> BootstrapFrequencies::arcs() const {
+    std::vector<std::tuple<std::string, std::string, double>> res;
+    for (size_t s = 0; s < m_nodes.size(); ++s) {
+        for (size_t t = 0; t < m_nodes.size(); ++t) {
+            if (auto count = directed(s, t); count > 0)
+                res.emplace_back(m_nodes[s], m_nodes[t], static_cast<double>(count) / m_num_replicates);
+        }
+    }
+
+    return res;
+}
+
+std::vector<std::tuple<std::string, std::string, double>> BootstrapFrequencies::edges() const {
+    std::vector<std::tuple<std::string, std::string, double>> res;
+    for (size_t n1 = 0; n1 < m_nodes.size(); ++n1) {
+        for (size_t n2 = n1 + 1; n2 < m_nodes.size(); ++n2) {
+            if (auto count = adjacent(n1, n2); count > 0)
+                res.emplace_back(m_nodes[n1], m_nodes[n2], static_cast<double>(count) / m_num_replicates);
+        }
+    }
+
+    return res;
+}
+
+void BootstrapFrequencies::check_threshold(double threshold) const {
+    if (threshold <= 0 || threshold > 1) throw std::invalid_argument("The threshold must be in the interval (0, 1].");
+    if (m_num_replicates == 0) throw std::invalid_argument("There are no bootstrap replicates.");
+}
+
+Dag BootstrapFrequencies::averaged_dag(double threshold) const {
+    check_threshold(threshold);
+
+    // Edges above the threshold, oriented in the most frequent direction. The ties are oriented following the order
+    // of the nodes.
+    std::vector<std::pair<int, int>> selected;
+    for (size_t n1 = 0; n1 < m_nodes.size(); ++n1) {
+        for (size_t n2 = n1 + 1; n2 < m_nodes.size(); ++n2) {
+            if (adjacent(n1, n2) >= threshold * m_num_replicates) {
+                if (directed(n2, n1) > directed(n1, n2))
+                    selected.push_back({n2, n1});
+                else
+                    selected.push_back({n1, n2});
+            }
+        }
+    }
+
+    std::stable_sort(selected.begin(), selected.end(), [this](const auto& a, const auto& b) {
+        return adjacent(a.first, a.second) > adjacent(b.first, b.second);
+    });
+
+    Dag dag(m_nodes);
+    for (const auto& arc : selected) {
+        if (dag.can_add_arc(m_nodes[arc.first], m_nodes[arc.second])) {
+            dag.add_arc(m_nodes[arc.first], m_nodes[arc.second]);
+        } else if (dag.can_add_arc(m_nodes[arc.second], m_nodes[arc.first])) {
+            dag.add_arc(m_nodes[arc.second], m_nodes[arc.first]);
+        }
+    }
+
+    return dag;
+}
+
+PartiallyDirectedGraph BootstrapFrequencies::averaged_pdag(double threshold) const {
+    check_threshold(threshold);
+
+    auto min_count = threshold * m_num_replicates;
+
+    PartiallyDirectedGraph pdag(m_nodes);
+    for (size_t n1 = 0; n1 < m_nodes.size(); ++n1) {
+        for (size_t n2 = n1 + 1; n2 < m_nodes.size(); ++n2) {
+            if (adjacent(n1, n2) < min_count) continue;
+
+            auto forward = directed(n1, n2);
+            auto backward = directed(n2, n1);
+
+            if (forward >= min_count && forward > backward)
+                pdag.add_arc(m_nodes[n1], m_nodes[n2]);
+            else if (backward >= min_count && backward > forward)
+                pdag.add_arc(m_nodes[n2], m_nodes[n1]);
+            else
+                pdag.add_edge(m_nodes[n1], m_nodes[n2]);
+        }
+    }
+
+    return pdag;
+}
+
+// MutualInformation does not support frequency weights.
+bool weighted_test(const std::string& test_str) { return test_str != "mutual-info"; }
+
+unsigned int random_seed(std::optional<unsigned int> seed) {
+    if (seed)
+        return *seed;
+    else
+        return std::random_device{}();
+}
+
+BootstrapFrequencies bootstrap_hc(const DataFrame& df,
+                                  const std::shared_ptr<BayesianNetworkType> bn_type,
+                                  const std::shared_ptr<BayesianNetworkBase> start,
+                                  const std::optional<std::string>& score_str,
+                                  const std::optional<std::vector<std::string>>& operators_str,
+                                  const ArcStringVector& arc_blacklist,
+                                  const ArcStringVector& arc_whitelist,
+                                  const FactorTypeVector& type_blacklist,
+                                  const FactorTypeVector& type_whitelist,
+                                  int max_indegree,
+                                  int max_iters,
+                                  double epsilon,
+                                  int patience,
+                                  int num_replicates,
+                                  std::optional<unsigned int> seed,
+                                  int num_folds,
+                                  double test_holdout_ratio,
+                                  int num_threads) {
+    if (!bn_type && !start) {
+        throw std::invalid_argument("\"bn_type\" or \"start\" parameter must be specified.");
+    }
+
+    const auto& bn_type_ = [&start, &bn_type]() -> const BayesianNetworkType& {
+        if (start)
+            return start->type_ref();
+        else
+            return *bn_type;
+    }();
+
+    if (bn_type_.is_python_derived() || (start && start->is_python_derived()))
+        throw std::invalid_argument("bootstrap_hc() does not support Bayesian network models implemented in Python.");
+
+    util::check_valid_operators(bn_type_, operators_str, arc_blacklist, arc_whitelist, max_indegree, type_whitelist);
+
+    if (max_iters == 0) max_iters = std::numeric_limits<int>::max();
+
+    const auto start_model = [&start, &bn_type_, &df]() -> const std::shared_ptr<BayesianNetworkBase> {
+        if (start)
+            return start;
+        else
+            return bn_type_.new_bn(df.column_names());
+    }();
+
+    return bootstrap_structure(
+        df,
+        start_model->nodes(),
+        num_replicates,
+        random_seed(seed),
+        concurrent_learning(bn_type_),
+        num_threads,
+        true,
+        [&](const DataFrame& resample, unsigned int replicate_seed) {
+            auto operators = util::check_valid_operators(
+                bn_type_, operators_str, arc_blacklist, arc_whitelist, max_indegree, type_whitelist);
+            auto score =
+                util::check_valid_score(resample, bn_type_, score_str, replicate_seed, num_folds, test_holdout_ratio);
+
+            GreedyHillClimbing hc;
+            auto model = hc.estimate(*operators,
+                                     *score,
+                                     *start_model,
+                                     arc_blacklist,
+                                     arc_whitelist,
+                                     type_blacklist,
+                                     type_whitelist,
+                                     nullptr,
+                                     max_indegree,
+                                     max_iters,
+                                     epsilon,
+                                     patience,
+                                     0);
+
+            return LearnedStructure{model->arcs(), {}};
+        });
+}
+
+BootstrapFrequencies bootstrap_pc(const DataFrame& df,
+                                  const std::string& test_str,
+                                  const std::vector<std::string>& nodes,
+                                  const ArcStringVector& arc_blacklist,
+                                  const ArcStringVector& arc_whitelist,
+                                  const EdgeStringVector& edge_blacklist,
+                                  const EdgeStringVector& edge_whitelist,
+                                  double alpha,
+                                  bool use_sepsets,
+                                  double ambiguous_threshold,
+                                  bool allow_bidirected,
+                                  int num_replicates,
+                                  std::optional<unsigned int> seed,
+                                  int num_threads) {
+    auto bootstrap_nodes = nodes.empty() ? df.column_names() : nodes;
+
+    return bootstrap_structure(
+        df,
+        bootstrap_nodes,
+        num_replicates,
+        random_seed(seed),
+        true,
+        num_threads,
+        weighted_test(test_str),
+        [&](const DataFrame& resample, unsigned int) {
+            auto test = util::check_valid_independence_test(resample, test_str);
+
+            PC pc;
+            auto pdag = pc.estimate(*test,
+                                    nodes,
+                                    arc_blacklist,
+                                    arc_whitelist,
+                                    edge_blacklist,
+                                    edge_whitelist,
+                                    alpha,
+                                    use_sepsets,
+                                    ambiguous_threshold,
+                                    allow_bidirected,
+                                    0);
+
+            return LearnedStructure{pdag.arcs(), pdag.edges()};
+        });
+}
+
+BootstrapFrequencies bootstrap_mmhc(const DataFrame& df,
+                                    const std::shared_ptr<BayesianNetworkType> bn_type,
+                                    const std::string& test_str,
+                                    const std::optional<std::string>& score_str,
+                                    const std::optional<std::vector<std::string>>& operators_str,
+                                    const std::vector<std::string>& nodes,
+                                    const ArcStringVector& arc_blacklist,
+                                    const ArcStringVector& arc_whitelist,
+                                    const EdgeStringVector& edge_blacklist,
+                                    const EdgeStringVector& edge_whitelist,
+                                    const FactorTypeVector& type_blacklist,
+                                    const FactorTypeVector& type_whitelist,
+                                    int max_indegree,
+                                    int max_iters,
+                                    double epsilon,
+                                    int patience,
+                                    double alpha,
+                                    int num_replicates,
+                                    std::optional<unsigned int> seed,
+                                    int num_folds,
+                                    double test_holdout_ratio,
+                                    int num_threads) {
+    if (!bn_type) throw std::invalid_argument("\"bn_type\" parameter must be specified.");
+    if (bn_type->is_python_derived())
+        throw std::invalid_argument("bootstrap_mmhc() does not support Bayesian network types implemented in Python.");
+
+    util::check_valid_operators(*bn_type, operators_str, arc_blacklist, arc_whitelist, max_indegree, type_whitelist);
+
+    if (max_iters == 0) max_iters = std::numeric_limits<int>::max();
+
+    auto bootstrap_nodes = nodes.empty() ? df.column_names() : nodes;
+
+    return bootstrap_structure(
+        df,
+        bootstrap_nodes,
+        num_replicates,
+        random_seed(seed),
+        concurrent_learning(*bn_type),
+        num_threads,
+        weighted_test(test_str),
+        [&](const DataFrame& resample, unsigned int replicate_seed) {
+            auto test = util::check_valid_independence_test(resample, test_str);
+            auto operators = util::check_valid_operators(
+                *bn_type, operators_str, arc_blacklist, arc_whitelist, max_indegree, type_whitelist);
+            auto score =
+                util::check_valid_score(resample, *bn_type, score_str, replicate_seed, num_folds, test_holdout_ratio);
+
+            MMHC mmhc;
+            auto model = mmhc.estimate(*test,
+                                       *operators,
+                                       *score,
+                                       nodes,
+                                       *bn_type,
+                                       arc_blacklist,
+                                       arc_whitelist,
+                                       edge_blacklist,
+                                       edge_whitelist,
+                                       type_blacklist,
+                                       type_whitelist,
+                                       nullptr,
+                                       max_indegree,
+                                       max_iters,
+                                       epsilon,
+                                       patience,
+                                       alpha,
+                                       0);
+
+            return LearnedStructure{model->arcs(), {}};
+        });
+}
+
+}  // namespace learning::algorithms
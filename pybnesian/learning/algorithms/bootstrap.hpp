@@ -0,0 +1,175 @@
+#ifndef PYBNESIAN_LEARNING_ALGORITHMS_BOOTSTRAP_HPP
+#define PYBNESIAN_LEARNING_ALGORITHMS_BOOTSTRAP_HPP
+
+#include <exception>
+#include <random>
+#include <tuple>
+#include <dataset/dataset.hpp>
+#include <graph/generic_graph.hpp>
+#include <models/BayesianNetwork.hpp>
+#include <util/parallel.hpp>
+
+using dataset::DataFrame;
+using graph::Dag, graph::PartiallyDirectedGraph;
+using models::BayesianNetworkBase, models::BayesianNetworkType;
+using util::ArcStringVector, util::EdgeStringVector;
+
+namespace learning::algorithms {
+
+// Arcs (directed) and edges (undirected) learned by a bootstrap replicate.
+struct LearnedStructure {
+    ArcStringVector arcs;
+    EdgeStringVector edges;
+};
+
+// Frequencies of the arcs and edges learned in the bootstrap replicates of a structure learning algorithm:
+//  - arc_frequency(source, target): fraction of replicates with the arc source -> target.
+//  - edge_frequency(n1, n2): fraction of replicates where n1 and n2 are adjacent (an arc in any direction, or an
+//    undirected edge).
+class BootstrapFrequencies {
+public:
+    BootstrapFrequencies(const std::vector<std::string>& nodes);
+
+    const std::vector<std::string>& nodes() const { return m_nodes; }
+    int num_replicates() const { return m_num_replicates; }
+
+    void add(const LearnedStructure& structure);
+
+    double arc_frequency(const std::string& source, const std::string& target) const;
+    double edge_frequency(const std::string& n1, const std::string& n2) const;
+
+    // Arcs and edges learned in some replicate, with their frequencies.
+    std::vector<std::tuple<std::string, std::string, double>> arcs() const;
+    std::vector<std::tuple<std::string, std::string, double>> edges() const;
+
+    // Dag with the edges with edge_frequency() >= threshold. Each edge is oriented in the most frequent direction. The
+    // edges are added by descending frequency, and an edge is reversed if it would create a cycle.
+    Dag averaged_dag(double threshold) const;
+    // PartiallyDirectedGraph with the edges with edge_frequency() >= threshold. An edge is an arc if the frequency of
+    // the arc is >= threshold and greater than the frequency of the opposite arc. Otherwise, it is an undirected edge.
+    PartiallyDirectedGraph averaged_pdag(double threshold) const;
+
+private:
+    int index(const std::string& node) const;
+    int directed(int source, int target) const { return m_directed[source * m_nodes.size() + target]; }
+    int adjacent(int n1, int n2) const { return m_adjacent[n1 * m_nodes.size() + n2]; }
+    void check_threshold(double threshold) const;
+
+    std::vector<std::string> m_nodes;
+    std::unordered_map<std::string, int> m_indices;
+    int m_num_replicates;
+    // Number of replicates with the arc i -> j in m_directed[i*n + j], and the number of replicates where i and j are
+    // adjacent in m_adjacent[i*n + j] (symmetric).
+    std::vector<int> m_directed;
+    std::vector<int> m_adjacent;
+};
+
+// Runs learn(resample, seed) on num_replicates bootstrap resamples of df, and returns the frequencies of the learned
+// arcs and edges. Each replicate has its own seed, so the result does not depend on the number of threads. The
+// replicates are run in parallel if parallel is true. If weighted is true, each resample is df with the bootstrap
+// counts as frequency weights (see dataset::bootstrap_weights()), so the rows of df are not copied. Otherwise, the
+// resampled rows are copied (see dataset::bootstrap_sample()), for learning algorithms that do not support weights.
+template <typename Learn>
+BootstrapFrequencies bootstrap_structure(const DataFrame& df,
+                                         const std::vector<std::string>& nodes,
+                                         int num_replicates,
+                                         unsigned int seed,
+                                         bool parallel,
+                                         int num_threads,
+                                         bool weighted,
+                                         Learn learn) {
+    if (num_replicates < 1) throw std::invalid_argument("The number of bootstrap replicates must be positive.");
+    if (num_threads <= 0) num_threads = util::num_threads();
+
+    std::vector<LearnedStructure> structures(num_replicates);
+    std::exception_ptr exception;
+
+#pragma omp parallel for schedule(dynamic) num_threads(num_threads) if (parallel)
+    for (int r = 0; r < num_replicates; ++r) {
+        try {
+            std::seed_seq seq{seed, static_cast<unsigned int>(r)};
+            std::mt19937 rng(seq);
+            auto replicate_seed = rng();
+
+            // The resample is freed after the replicate, so only num_threads resamples are in memory.
+            auto resample = weighted ? dataset::bootstrap_weights(df, replicate_seed)
+                                     : dataset::bootstrap_sample(df, replicate_seed);
+            structures[r] = learn(resample, replicate_seed);
+        } catch (...) {
+#pragma omp critical
+            {
+                if (!exception) exception = std::current_exception();
+            }
+        }
+    }
+
+    if (exception) std::rethrow_exception(exception);
+
+    BootstrapFrequencies frequencies(nodes);
+    for (const auto& s : structures) {
+        frequencies.add(s);
+    }
+
+    return frequencies;
+}
+
+BootstrapFrequencies bootstrap_hc(const DataFrame& df,
+                                  const std::shared_ptr<BayesianNetworkType> bn_type,
+                                  const std::shared_ptr<BayesianNetworkBase> start,
+                                  const std::optional<std::string>& score_str,
+                                  const std::optional<std::vector<std::string>>& operators_str,
+                                  const ArcStringVector& arc_blacklist,
+                                  const ArcStringVector& arc_whitelist,
+                                  const FactorTypeVector& type_blacklist,
+                                  const FactorTypeVector& type_whitelist,
+                                  int max_indegree,
+                                  int max_iters,
+                                  double epsilon,
+                                  int patience,
+                                  int num_replicates,
+                                  std::optional<unsigned int> seed,
+                                  int num_folds,
+                                  double test_holdout_ratio,
+                                  int num_threads);
+
+BootstrapFrequencies bootstrap_pc(const DataFrame& df,
+                                  const std::string& test_str,
+                                  const std::vector<std::string>& nodes,
+                                  const ArcStringVector& arc_blacklist,
+                                  const ArcStringVector& arc_whitelist,
+                                  const EdgeStringVector& edge_blacklist,
+                                  const EdgeStringVector& edge_whitelist,
+                                  double alpha,
+                                  bool use_sepsets,
+                                  double ambiguous_threshold,
+                                  bool allow_bidirected,
+                                  int num_replicates,
+                                  std::optional<unsigned int> seed,
+                                  int num_threads);
+
+BootstrapFrequencies bootstrap_mmhc(const DataFrame& df,
+                                    const std::shared_ptr<BayesianNetworkType> bn_type,
+                                    const std::string& test_str,
+                                    const std::optional<std::string>& score_str,
+                                    const std::optional<std::vector<std::string>>& operators_str,
+                                    const std::vector<std::string>& nodes,
+                                    const ArcStringVector& arc_blacklist,
+                                    const ArcStringVector& arc_whitelist,
+                                    const EdgeStringVector& edge_blacklist,
+                                    const EdgeStringVector& edge_whitelist,
+                                    const FactorTypeVector& type_blacklist,
+                                    const FactorTypeVector& type_whitelist,
+                                    int max_indegree,
+                                    int max_iters,
+                                    double epsilon,
+                                    int patience,
+                                    double alpha,
+                                    int num_replicates,
+                                    std::optional<unsigned int> seed,
+                                    int num_folds,
+                                    double test_holdout_ratio,
+                                    int num_threads);
+
+}  // namespace learning::algorithms
+
+#endif  // PYBNESIAN_LEARNING_ALGORITHMS_BOOTSTRAP_HPP
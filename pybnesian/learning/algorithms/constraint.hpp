@@ -3,16 +3,15 @@
 
 #include <graph/generic_graph.hpp>
 #include <learning/independences/independence.hpp>
-#include <learning/independences/continuous/RCoT.hpp>
 #include <util/progress.hpp>
 #include <util/combinations.hpp>
+#include <util/parallel.hpp>
 #include <stdio.h>
 
 using graph::PartiallyDirectedGraph;
 using learning::independences::IndependenceTest;
 using util::BaseProgressBar;
 using util::Combinations, util::Combinations2Sets;
-using learning::independences::continuous::RCoT;
 
 namespace learning::algorithms {
 
@@ -334,11 +333,9 @@ void direct_unshielded_triples(G& pdag,
     progress.set_text("Finding v-structures");
     progress.set_progress(0);
 
-    bool is_not_RCoT = !dynamic_cast<const RCoT*>(&test);
-
     auto nodes = pdag.raw_nodes();
 
-    #pragma omp parallel if(is_not_RCoT)
+    #pragma omp parallel num_threads(util::num_threads())
     {
     #pragma omp for schedule(dynamic)
     for (size_t i = 0; i < nodes.size(); ++i) {
@@ -395,11 +392,9 @@ std::vector<vstructure> direct_unshielded_triples_interactive(G& pdag,
                                                               double ambiguous_threshold) {
     std::vector<vstructure> vs;
 
-    bool is_not_RCoT = !dynamic_cast<const RCoT*>(&test);
-
     auto nodes = pdag.raw_nodes();
 
-    #pragma omp parallel if(is_not_RCoT)
+    #pragma omp parallel num_threads(util::num_threads())
     {
     #pragma omp for schedule(dynamic)
     for (size_t i = 0; i < nodes.size(); ++i) {
@@ -1,14 +1,20 @@
+#include <algorithm>
+#include <random>
+#include <set>
 #include <learning/algorithms/hillclimbing.hpp>
 #include <util/validate_options.hpp>
 #include <dataset/dataset.hpp>
 #include <models/BayesianNetwork.hpp>
 #include <models/GaussianNetwork.hpp>
+#include <models/CLGNetwork.hpp>
+#include <models/DiscreteBN.hpp>
 #include <models/SemiparametricBN.hpp>
 #include <models/KDENetwork.hpp>
 #include <learning/scores/scores.hpp>
 #include <learning/scores/bic.hpp>
 #include <learning/scores/cv_likelihood.hpp>
 #include <learning/scores/holdout_likelihood.hpp>
+#include <learning/scores/cached_score.hpp>
 #include <learning/operators/operators.hpp>
 
 using namespace dataset;
@@ -89,4 +95,193 @@ std::shared_ptr<BayesianNetworkBase> hc(const DataFrame& df,
                        verbose);
 }
 
+bool concurrent_learning(const BayesianNetworkType& bn_type) { return !bn_type.is_python_derived(); }
+
+using ArcNameSet = std::set<std::pair<std::string, std::string>>;
+
+// Applies num_edits random arc additions, removals and flips to the model. The edits keep the whitelisted arcs, do not
+// add blacklisted arcs and respect max_indegree.
+void perturb_arcs(BayesianNetworkBase& model,
+                  int num_edits,
+                  const ArcNameSet& blacklist,
+                  const ArcNameSet& whitelist,
+                  int max_indegree,
+                  std::mt19937& rng) {
+    const auto& nodes = model.nodes();
+    if (nodes.size() < 2) return;
+
+    std::uniform_int_distribution<size_t> random_node(0, nodes.size() - 1);
+    std::bernoulli_distribution remove(0.5);
+
+    auto can_add_parent = [&model, max_indegree](const std::string& node) {
+        return max_indegree <= 0 || model.num_parents(node) < max_indegree;
+    };
+
+    // Most of the random pairs can be edited, but the number of attempts is bounded for the very restricted graphs.
+    int applied = 0;
+    for (int attempts = 0; applied < num_edits && attempts < 100 * num_edits; ++attempts) {
+        const auto& source = nodes[random_node(rng)];
+        const auto& target = nodes[random_node(rng)];
+
+        if (source == target || model.has_arc(target, source)) continue;
+
+        if (model.has_arc(source, target)) {
+            if (whitelist.count({source, target}) > 0) continue;
+
+            if (remove(rng)) {
+                model.remove_arc(source, target);
+            } else {
+                if (blacklist.count({target, source}) > 0 || !can_add_parent(source) ||
+                    !model.can_flip_arc(source, target))
+                    continue;
+                model.flip_arc(source, target);
+            }
+        } else {
+            if (blacklist.count({source, target}) > 0 || !can_add_parent(target) ||
+                !model.can_add_arc(source, target))
+                continue;
+            model.add_arc(source, target);
+        }
+
+        ++applied;
+    }
+}
+
+double final_score(const Score& score, const BayesianNetworkBase& model) {
+    if (auto validated = dynamic_cast<const ValidatedScore*>(&score)) return validated->vscore(model);
+
+    return score.score(model);
+}
+
+std::vector<RestartResult> hc_restarts(const DataFrame& df,
+                                       const std::shared_ptr<BayesianNetworkType> bn_type,
+                                       const std::shared_ptr<BayesianNetworkBase> start,
+                                       const std::optional<std::string>& score_str,
+                                       const std::optional<std::vector<std::string>>& operators_str,
+                                       const ArcStringVector& arc_blacklist,
+                                       const ArcStringVector& arc_whitelist,
+                                       const FactorTypeVector& type_blacklist,
+                                       const FactorTypeVector& type_whitelist,
+                                       int max_indegree,
+                                       int max_iters,
+                                       double epsilon,
+                                       int patience,
+                                       int num_restarts,
+                                       const std::string& perturbation,
+                                       int num_perturbations,
+                                       std::optional<unsigned int> seed,
+                                       int num_folds,
+                                       double test_holdout_ratio,
+                                       int num_threads) {
+    if (!bn_type && !start) {
+        throw std::invalid_argument("\"bn_type\" or \"start\" parameter must be specified.");
+    }
+
+    if (num_restarts < 1) throw std::invalid_argument("The number of restarts must be positive.");
+    if (perturbation != "arcs" && perturbation != "bootstrap")
+        throw std::invalid_argument("Wrong perturbation \"" + perturbation +
+                                    "\". Valid options are \"arcs\" and \"bootstrap\".");
+    if (num_perturbations < 0) throw std::invalid_argument("The number of perturbations must be non-negative.");
+
+    auto iseed = [seed]() {
+        if (seed)
+            return *seed;
+        else
+            return std::random_device{}();
+    }();
+
+    const auto& bn_type_ = [&start, &bn_type]() -> const BayesianNetworkType& {
+        if (start)
+            return start->type_ref();
+        else
+            return *bn_type;
+    }();
+
+    if (bn_type_.is_python_derived() || (start && start->is_python_derived()))
+        throw std::invalid_argument("hc_restarts() does not support Bayesian network models implemented in Python.");
+
+    // Checks the operators before starting the restarts. Each restart creates its own OperatorSet.
+    util::check_valid_operators(bn_type_, operators_str, arc_blacklist, arc_whitelist, max_indegree, type_whitelist);
+
+    if (max_iters == 0) max_iters = std::numeric_limits<int>::max();
+
+    const auto start_model = [&start, &bn_type_, &df]() -> const std::shared_ptr<BayesianNetworkBase> {
+        if (start)
+            return start;
+        else
+            return bn_type_.new_bn(df.column_names());
+    }();
+
+    auto score = learning::scores::cached_score(
+        util::check_valid_score(df, bn_type_, score_str, iseed, num_folds, test_holdout_ratio));
+
+    ArcNameSet blacklist(arc_blacklist.begin(), arc_blacklist.end());
+    ArcNameSet whitelist(arc_whitelist.begin(), arc_whitelist.end());
+
+    auto learn = [&](Score& s, const BayesianNetworkBase& initial) {
+        auto operators = util::check_valid_operators(
+            bn_type_, operators_str, arc_blacklist, arc_whitelist, max_indegree, type_whitelist);
+
+        GreedyHillClimbing hc;
+        return hc.estimate(*operators,
+                           s,
+                           initial,
+                           arc_blacklist,
+                           arc_whitelist,
+                           type_blacklist,
+                           type_whitelist,
+                           nullptr,
+                           max_indegree,
+                           max_iters,
+                           epsilon,
+                           patience,
+                           0);
+    };
+
+    bool parallel = concurrent_learning(bn_type_);
+    if (num_threads <= 0) num_threads = util::num_threads();
+
+    std::vector<RestartResult> results(num_restarts);
+    std::exception_ptr exception;
+
+#pragma omp parallel for schedule(dynamic) num_threads(num_threads) if (parallel)
+    for (int r = 0; r < num_restarts; ++r) {
+        try {
+            // Each restart has its own random generator, so the result does not depend on the scheduling.
+            std::seed_seq seq{iseed, static_cast<unsigned int>(r)};
+            std::mt19937 rng(seq);
+
+            auto initial = start_model->clone();
+            if (r > 0) {
+                if (perturbation == "arcs") {
+                    perturb_arcs(*initial, num_perturbations, blacklist, whitelist, max_indegree, rng);
+                } else {
+                    auto bootstrap_seed = rng();
+                    auto bootstrap_df = dataset::bootstrap_weights(df, bootstrap_seed);
+                    auto bootstrap_score = util::check_valid_score(
+                        bootstrap_df, bn_type_, score_str, bootstrap_seed, num_folds, test_holdout_ratio);
+                    initial = learn(*bootstrap_score, *initial);
+                }
+            }
+
+            auto model = learn(*score, *initial);
+            auto model_score = final_score(*score, *model);
+            results[r] = RestartResult{model, model_score, r};
+        } catch (...) {
+#pragma omp critical
+            {
+                if (!exception) exception = std::current_exception();
+            }
+        }
+    }
+
+    if (exception) std::rethrow_exception(exception);
+
+    std::stable_sort(results.begin(), results.end(), [](const RestartResult& a, const RestartResult& b) {
+        return a.score > b.score;
+    });
+
+    return results;
+}
+
 }  // namespace learning::algorithms
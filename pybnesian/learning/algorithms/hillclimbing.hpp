@@ -12,6 +12,7 @@
 #include <learning/algorithms/callbacks/save_model.hpp>
 #include <util/validate_whitelists.hpp>
 #include <util/math_constants.hpp>
+#include <util/profiling.hpp>
 #include <util/progress.hpp>
 #include <util/vector.hpp>
 
@@ -47,6 +48,45 @@ std::shared_ptr<BayesianNetworkBase> hc(const DataFrame& df,
                                         double test_holdout_ratio,
                                         int verbose = 0);
 
+// True if many models of bn_type can be learned concurrently. The types implemented in Python need the GIL, so their
+// models must be learned sequentially.
+bool concurrent_learning(const BayesianNetworkType& bn_type);
+
+// A model learned by one of the restarts of hc_restarts() and its score.
+struct RestartResult {
+    std::shared_ptr<BayesianNetworkBase> model;
+    double score;
+    int restart;
+};
+
+// Runs num_restarts hill-climbings in parallel from different initial structures, and returns the learned models
+// sorted by descending score (the validation score for the ValidatedScores). The first restart starts from the start
+// model. The rest start from a perturbation of it:
+//  - "arcs": num_perturbations random arc additions, removals and flips.
+//  - "bootstrap": the model learned by a hill-climbing on a bootstrap sample of df.
+// All the restarts share the local scores of the same score (see learning::scores::CachedScore). The result only
+// depends on the seed, not on the number of threads.
+std::vector<RestartResult> hc_restarts(const DataFrame& df,
+                                       const std::shared_ptr<BayesianNetworkType> bn_type,
+                                       const std::shared_ptr<BayesianNetworkBase> start,
+                                       const std::optional<std::string>& score_str,
+                                       const std::optional<std::vector<std::string>>& operators_str,
+                                       const ArcStringVector& arc_blacklist,
+                                       const ArcStringVector& arc_whitelist,
+                                       const FactorTypeVector& type_blacklist,
+                                       const FactorTypeVector& type_whitelist,
+                                       int max_indegree,
+                                       int max_iters,
+                                       double epsilon,
+                                       int patience,
+                                       int num_restarts,
+                                       const std::string& perturbation,
+                                       int num_perturbations,
+                                       std::optional<unsigned int> seed,
+                                       int num_folds,
+                                       double test_holdout_ratio,
+                                       int num_threads);
+
 template <typename T>
 double validation_delta_score(const T& model,
                               const ValidatedScore& val_score,
@@ -77,6 +117,7 @@ std::shared_ptr<T> estimate_hc(OperatorSet& op_set,
                                double epsilon,
                                int patience,
                                int verbose) {
+    util::profiling::ScopedTimer hc_timer("hc/total");
     auto spinner = util::indeterminate_spinner(verbose);
     spinner->update_status("Checking dataset...");
 
@@ -112,6 +153,7 @@ std::shared_ptr<T> estimate_hc(OperatorSet& op_set,
 
     spinner->update_status("Caching scores...");
 
+    util::profiling::ScopedTimer cache_timer("hc/cache_scores");
     LocalScoreCache local_validation = [&]() {
         if constexpr (std::is_base_of_v<ValidatedScore, S>) {
             LocalScoreCache lc(*current_model);
@@ -124,7 +166,8 @@ std::shared_ptr<T> estimate_hc(OperatorSet& op_set,
         }
     }();
     op_set.cache_scores(*current_model, score);
-   
+    cache_timer.stop();
+
     int p = 0;
     double accumulated_offset = 0;
 
@@ -135,8 +178,10 @@ std::shared_ptr<T> estimate_hc(OperatorSet& op_set,
     auto iter = 0;
     while (iter < max_iters) {
         ++iter;
-        
+        util::profiling::count("hc/iterations");
+
         auto best_op = [&]() {
+            util::profiling::ScopedTimer find_max_timer("hc/find_max");
             if constexpr (zero_patience)
                 return op_set.find_max(*current_model);
             else
@@ -182,7 +227,11 @@ std::shared_ptr<T> estimate_hc(OperatorSet& op_set,
         best_op->apply(*prev_current_model);
         
         if (callback) callback->call(*current_model, best_op.get(), score, iter);
-        op_set.update_scores(*current_model, score, nodes_changed);
+
+        {
+            util::profiling::ScopedTimer update_timer("hc/update_scores");
+            op_set.update_scores(*current_model, score, nodes_changed);
+        }
 
         if constexpr (std::is_base_of_v<ValidatedScore, S>) {
             spinner->update_status(best_op->ToString() + " | Validation delta: " + std::to_string(validation_delta));
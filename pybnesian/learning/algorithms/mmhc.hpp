@@ -13,6 +13,9 @@ using models::BayesianNetworkBase, models::ConditionalBayesianNetworkBase, model
 
 namespace learning::algorithms {
 
+// Removes j from the CPC of i if i is not in the CPC of j.
+void remove_asymmetries(std::vector<std::unordered_set<int>>& cpcs);
+
 class MMHC {
 public:
     std::shared_ptr<BayesianNetworkBase> estimate(const IndependenceTest& test,
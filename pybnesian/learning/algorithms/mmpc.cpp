@@ -4,6 +4,7 @@
 #include <learning/algorithms/mmpc.hpp>
 #include <Eigen/Dense>
 #include <util/combinations.hpp>
+#include <util/profiling.hpp>
 #include <util/progress.hpp>
 #include <util/vector.hpp>
 #include <util/validate_whitelists.hpp>
@@ -916,6 +917,8 @@ std::vector<std::unordered_set<int>> mmpc_all_variables(const IndependenceTest&
                                                         const EdgeSet& edge_blacklist,
                                                         const EdgeSet& edge_whitelist,
                                                         util::BaseProgressBar& progress) {
+    util::profiling::ScopedTimer timer("mmpc/skeleton");
+
     auto [cpcs, to_be_checked] = generate_cpcs(g, arc_whitelist, edge_blacklist, edge_whitelist);
 
     BNCPCAssoc assoc(g, alpha);
@@ -1003,6 +1006,7 @@ void estimate(G& skeleton,
               double ambiguous_threshold,
               bool allow_bidirected,
               int verbose) {
+    util::profiling::ScopedTimer mmpc_timer("mmpc/total");
     auto restrictions =
         util::validate_restrictions(skeleton, varc_blacklist, varc_whitelist, vedge_blacklist, vedge_whitelist);
 
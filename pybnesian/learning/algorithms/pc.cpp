@@ -4,18 +4,17 @@
 #include <learning/algorithms/constraint.hpp>
 #include <util/combinations.hpp>
 #include <util/validate_whitelists.hpp>
+#include <util/profiling.hpp>
+#include <util/parallel.hpp>
 #include <util/progress.hpp>
 #include <util/vector.hpp>
 #include <omp.h>
-#include <learning/independences/continuous/RCoT.hpp>
 
 using graph::PartiallyDirectedGraph, graph::UndirectedGraph, graph::Arc, graph::ArcHash, graph::Edge, graph::EdgeHash,
     graph::EdgeEqualTo;
 
 using util::Combinations, util::Combinations2Sets, util::ProgressBar;
 
-using learning::independences::continuous::RCoT;
-
 namespace learning::algorithms {
 
 template <typename G>
@@ -54,7 +53,7 @@ void filter_marginal_skeleton(G& skeleton,
 
     const auto& nodes = skeleton.nodes();
 
-#pragma omp parallel
+#pragma omp parallel num_threads(util::num_threads())
     {
         for (int i = 0; i < nnodes - 1; ++i) {
             auto index = skeleton.index(nodes[i]);
@@ -81,7 +80,7 @@ void filter_marginal_skeleton(G& skeleton,
 
     if constexpr (graph::is_conditional_graph_v<G>) {
         const auto& interface_nodes = skeleton.interface_nodes();
-#pragma omp parallel
+#pragma omp parallel num_threads(util::num_threads())
         {
             for (size_t i = 0; i < nodes.size(); ++i) {
                 const auto& node = nodes[i];
@@ -118,7 +117,7 @@ void filter_marginal_skeleton_interactive(G& skeleton,
 
     const auto& nodes = skeleton.nodes();
 
-#pragma omp parallel
+#pragma omp parallel num_threads(util::num_threads())
     {
         for (int i = 0; i < nnodes - 1; ++i) {
             auto index = skeleton.index(nodes[i]);
@@ -211,8 +210,7 @@ void filter_univariate_skeleton(G& skeleton,
 
     std::vector<Edge> edges_to_remove;
 
-    bool is_not_RCoT = !dynamic_cast<const RCoT*>(&test);
-#pragma omp parallel if (is_not_RCoT)
+#pragma omp parallel num_threads(util::num_threads())
     {
 #pragma omp for schedule(dynamic)
         for (size_t i = 0; i < edges.size(); ++i) {
@@ -244,9 +242,7 @@ void filter_univariate_skeleton_interactive(G& skeleton,
         edges.push_back(edge);
     }
 
-    bool is_not_RCoT = !dynamic_cast<const RCoT*>(&test);
-
-#pragma omp parallel if (is_not_RCoT)
+#pragma omp parallel num_threads(util::num_threads())
     {
 #pragma omp for schedule(dynamic)
         for (size_t i = 0; i < edges.size(); ++i) {
@@ -416,6 +412,8 @@ void find_multivariate_sepset_interactive(
 template <typename G>
 SepSet find_skeleton(
     G& g, const IndependenceTest& test, double alpha, EdgeSet& edge_whitelist, util::BaseProgressBar& progress) {
+    util::profiling::ScopedTimer timer("pc/skeleton");
+
     if (static_cast<size_t>(g.num_edges()) == edge_whitelist.size()) {
         return SepSet{};
     }
@@ -433,8 +431,6 @@ SepSet find_skeleton(
     std::vector<Edge> edges_to_remove;
     auto limit = 2;
 
-    bool is_not_RCoT = !dynamic_cast<const RCoT*>(&test);
-
     while (static_cast<size_t>(g.num_edges()) > edge_whitelist.size() && !max_cardinality(g, limit)) {
         progress.set_max_progress(g.num_edges() - edge_whitelist.size());
         progress.set_text("Sepset Order " + std::to_string(limit));
@@ -443,7 +439,7 @@ SepSet find_skeleton(
         for (const auto& edge : g.edge_indices()) {
             edges.push_back(edge);
         }
-#pragma omp parallel if (is_not_RCoT)
+#pragma omp parallel num_threads(util::num_threads())
         {
 #pragma omp for schedule(dynamic)
             for (size_t i = 0; i < edges.size(); ++i) {
@@ -482,6 +478,7 @@ void estimate(G& skeleton,
               double ambiguous_threshold,
               bool allow_bidirected,
               int verbose) {
+    util::profiling::ScopedTimer pc_timer("pc/total");
     auto restrictions =
         util::validate_restrictions(skeleton, varc_blacklist, varc_whitelist, vedge_blacklist, vedge_whitelist);
 
@@ -628,15 +625,13 @@ SepList PC::compute_sepsets_of_size(PartiallyDirectedGraph& g,
         return sepset;
     }
 
-    bool is_not_RCoT = !dynamic_cast<const RCoT*>(&test);
-
     if (sepset_size > 1 && static_cast<size_t>(g.num_edges()) > restrictions.edge_whitelist.size() &&
         !max_cardinality(g, sepset_size)) {
         std::vector<Edge> edges;
         for (const auto& edge : g.edge_indices()) {
             edges.push_back(edge);
         }
-#pragma omp parallel if (is_not_RCoT)
+#pragma omp parallel num_threads(util::num_threads())
         {
 #pragma omp for schedule(dynamic)
             for (size_t i = 0; i < edges.size(); ++i) {
@@ -652,6 +647,29 @@ SepList PC::compute_sepsets_of_size(PartiallyDirectedGraph& g,
     return sepset;
 }
 
+std::unique_ptr<SepsetJob> PC::start_sepsets_of_size(const PartiallyDirectedGraph& g,
+                                                     std::shared_ptr<const IndependenceTest> test,
+                                                     const ArcStringVector& varc_blacklist,
+                                                     const ArcStringVector& varc_whitelist,
+                                                     const EdgeStringVector& vedge_blacklist,
+                                                     const EdgeStringVector& vedge_whitelist,
+                                                     int sepset_size,
+                                                     bool speculate,
+                                                     int num_threads,
+                                                     const EdgeStringVector& vpriority_edges) const {
+    auto restrictions =
+        util::validate_restrictions(g, varc_blacklist, varc_whitelist, vedge_blacklist, vedge_whitelist);
+
+    std::vector<Edge> priority_edges;
+    priority_edges.reserve(vpriority_edges.size());
+    for (const auto& e : vpriority_edges) {
+        priority_edges.push_back({g.index(e.first), g.index(e.second)});
+    }
+
+    return std::make_unique<SepsetJob>(
+        g, test, restrictions.edge_whitelist, sepset_size, speculate, num_threads, priority_edges);
+}
+
 PartiallyDirectedGraph PC::apply_adjacency_search(PartiallyDirectedGraph& skeleton,
                                                   const IndependenceTest& test,
                                                   const ArcStringVector& varc_blacklist,
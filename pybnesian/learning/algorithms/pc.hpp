@@ -4,6 +4,7 @@
 #include <graph/generic_graph.hpp>
 #include <learning/independences/independence.hpp>
 #include <learning/algorithms/constraint.hpp>
+#include <learning/algorithms/sepset_job.hpp>
 
 using graph::PartiallyDirectedGraph, graph::ConditionalPartiallyDirectedGraph;
 using learning::algorithms::SepList;
@@ -48,6 +49,18 @@ public:
                                     const EdgeStringVector& vedge_whitelist,
                                     int sepset_size) const;
 
+    // Starts the computation of compute_sepsets_of_size() in the background. See SepsetJob.
+    std::unique_ptr<SepsetJob> start_sepsets_of_size(const PartiallyDirectedGraph& g,
+                                                     std::shared_ptr<const IndependenceTest> test,
+                                                     const ArcStringVector& varc_blacklist,
+                                                     const ArcStringVector& varc_whitelist,
+                                                     const EdgeStringVector& vedge_blacklist,
+                                                     const EdgeStringVector& vedge_whitelist,
+                                                     int sepset_size,
+                                                     bool speculate,
+                                                     int num_threads,
+                                                     const EdgeStringVector& vpriority_edges = {}) const;
+
     PartiallyDirectedGraph apply_adjacency_search(PartiallyDirectedGraph& pdag, const IndependenceTest& test,
                                     const ArcStringVector& arc_blacklist,
                                     const ArcStringVector& arc_whitelist,
@@ -0,0 +1,344 @@
+#include <algorithm>
+#include <chrono>
+#include <learning/algorithms/sepset_job.hpp>
+#include <util/combinations.hpp>
+#include <util/parallel.hpp>
+#include <util/profiling.hpp>
+
+using util::Combinations, util::Combinations2Sets;
+
+namespace learning::algorithms {
+
+SepList SepsetResults::to_seplist() const {
+    SepList seplist;
+    for (size_t i = 0; i < size(); ++i) {
+        auto begin = sepsets.begin() + i * sepset_size;
+        seplist.insert({node1[i], node2[i]}, std::unordered_set<int>(begin, begin + sepset_size), pvalues[i]);
+    }
+
+    return seplist;
+}
+
+// Calls f with the names of each candidate sepset of size sep_size for the edge, in the same order as
+// PC::compute_sepsets_of_size(). The enumeration stops if f returns false.
+template <typename F>
+void for_each_sepset(const PartiallyDirectedGraph& g, const Edge& edge, int sep_size, F&& f) {
+    if (sep_size == 0) {
+        f(std::vector<std::string>{});
+        return;
+    }
+
+    if (sep_size == 1) {
+        std::unordered_set<int> u;
+        const auto& n1 = g.raw_node(edge.first);
+        const auto& n2 = g.raw_node(edge.second);
+
+        u.insert(n1.neighbors().begin(), n1.neighbors().end());
+        u.insert(n1.parents().begin(), n1.parents().end());
+        u.insert(n2.neighbors().begin(), n2.neighbors().end());
+        u.insert(n2.parents().begin(), n2.parents().end());
+
+        u.erase(edge.first);
+        u.erase(edge.second);
+
+        for (auto cond : u) {
+            if (!f(std::vector<std::string>{g.name(cond)})) return;
+        }
+
+        return;
+    }
+
+    const auto& nbr1 = g.neighbor_set(edge.first);
+    const auto& pa1 = g.parent_set(edge.first);
+    const auto& nbr2 = g.neighbor_set(edge.second);
+    const auto& pa2 = g.parent_set(edge.second);
+
+    bool set1_valid = static_cast<int>(nbr1.size() + pa1.size()) > sep_size;
+    bool set2_valid = static_cast<int>(nbr2.size() + pa2.size()) > sep_size;
+
+    if (!set1_valid && !set2_valid) return;
+
+    auto candidates = [&g](const auto& nbr, const auto& pa, int other) {
+        std::vector<std::string> u;
+        u.reserve(nbr.size() + pa.size());
+        for (auto n : nbr) {
+            if (n != other) u.push_back(g.name(n));
+        }
+        for (auto p : pa) u.push_back(g.name(p));
+        return u;
+    };
+
+    auto iterate = [&f](auto& comb) {
+        for (const auto& sepset : comb) {
+            if (!f(sepset)) return;
+        }
+    };
+
+    if (set1_valid && set2_valid) {
+        Combinations2Sets comb(candidates(nbr1, pa1, edge.second), candidates(nbr2, pa2, edge.first), sep_size);
+        iterate(comb);
+    } else if (set1_valid) {
+        Combinations comb(candidates(nbr1, pa1, edge.second), sep_size);
+        iterate(comb);
+    } else {
+        Combinations comb(candidates(nbr2, pa2, edge.first), sep_size);
+        iterate(comb);
+    }
+}
+
+SepsetJob::SepsetJob(const PartiallyDirectedGraph& g,
+                     std::shared_ptr<const IndependenceTest> test,
+                     const EdgeSet& edge_whitelist,
+                     int sepset_size,
+                     bool speculate,
+                     int num_threads,
+                     const std::vector<Edge>& priority_edges)
+    : m_graph(g),
+      m_test(test),
+      m_edge_whitelist(edge_whitelist),
+      m_sepset_size(sepset_size),
+      m_speculate(speculate),
+      m_cancelled(false),
+      m_mutex(),
+      m_cv(),
+      m_queue(),
+      m_removed_edges(),
+      m_num_edges(0),
+      m_num_finished(0),
+      m_running(0),
+      m_done(false),
+      m_finished(false),
+      m_error(),
+      m_results{sepset_size, {}, {}, {}, {}},
+      m_polled(0),
+      m_threads() {
+    if (!m_test) throw std::invalid_argument("Independence test is null.");
+    if (sepset_size < 0) throw std::invalid_argument("The sepset size must be non-negative.");
+    if (m_speculate && !dynamic_cast<const CachedIndependenceTest*>(m_test.get()))
+        throw std::invalid_argument("The speculative tests need a CachedIndependenceTest to store the p-values.");
+
+    for (const auto& edge : m_graph.edge_indices()) {
+        if (m_edge_whitelist.count(edge) == 0) m_queue.push_back(Task{edge, false});
+    }
+    m_num_edges = static_cast<int>(m_queue.size());
+
+    // The priority edges are sorted before the threads start, so they are the first tested edges.
+    if (!priority_edges.empty()) prioritize(priority_edges);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        update_state();
+    }
+
+    if (num_threads <= 0) num_threads = util::num_threads();
+
+    m_threads.reserve(num_threads);
+    for (int i = 0; i < num_threads; ++i) {
+        m_threads.emplace_back(&SepsetJob::worker, this);
+    }
+}
+
+SepsetJob::~SepsetJob() {
+    cancel();
+    for (auto& t : m_threads) {
+        t.join();
+    }
+}
+
+int SepsetJob::num_edges() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_num_edges;
+}
+
+int SepsetJob::num_finished_edges() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_num_finished;
+}
+
+bool SepsetJob::done() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_done;
+}
+
+SepsetResults SepsetJob::poll() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    rethrow_error();
+
+    SepsetResults res{m_sepset_size,
+                      std::vector<int>(m_results.node1.begin() + m_polled, m_results.node1.end()),
+                      std::vector<int>(m_results.node2.begin() + m_polled, m_results.node2.end()),
+                      std::vector<int>(m_results.sepsets.begin() + m_polled * m_sepset_size, m_results.sepsets.end()),
+                      std::vector<double>(m_results.pvalues.begin() + m_polled, m_results.pvalues.end())};
+
+    m_polled = m_results.size();
+    return res;
+}
+
+SepsetResults SepsetJob::results() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    rethrow_error();
+    return m_results;
+}
+
+void SepsetJob::prioritize(const std::vector<Edge>& edges) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::unordered_map<Edge, size_t, EdgeHash, EdgeEqualTo> priority;
+    for (size_t i = 0; i < edges.size(); ++i) {
+        priority.insert({edges[i], i});
+    }
+
+    // The speculative tasks are always after the tasks of size sepset_size, so they keep their relative order.
+    std::stable_sort(m_queue.begin(), m_queue.end(), [&priority](const Task& a, const Task& b) {
+        if (a.speculative != b.speculative) return b.speculative;
+
+        auto pa = priority.find(a.edge);
+        auto pb = priority.find(b.edge);
+        if (pa == priority.end()) return false;
+        if (pb == priority.end()) return true;
+        return pa->second < pb->second;
+    });
+}
+
+void SepsetJob::remove_edges(const std::vector<Edge>& edges) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_removed_edges.insert(edges.begin(), edges.end());
+
+    auto removed = std::remove_if(m_queue.begin(), m_queue.end(), [this](const Task& t) {
+        if (m_removed_edges.count(t.edge) == 0) return false;
+        if (!t.speculative) --m_num_edges;
+        return true;
+    });
+    m_queue.erase(removed, m_queue.end());
+
+    update_state();
+}
+
+void SepsetJob::cancel() {
+    m_cancelled = true;
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_queue.clear();
+    m_done = true;
+    update_state();
+}
+
+bool SepsetJob::wait(double timeout, bool speculative) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    auto finished = [this, speculative]() { return (speculative ? m_finished : m_done) || m_error; };
+    if (timeout < 0) {
+        m_cv.wait(lock, finished);
+    } else {
+        m_cv.wait_for(lock, std::chrono::duration<double>(timeout), finished);
+    }
+
+    rethrow_error();
+    return speculative ? m_finished : m_done;
+}
+
+void SepsetJob::worker() {
+    Task task;
+    while (pop_task(task)) {
+        try {
+            run_task(task);
+        } catch (...) {
+            m_cancelled = true;
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (!m_error) m_error = std::current_exception();
+            m_queue.clear();
+            m_done = true;
+        }
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        --m_running;
+        if (!task.speculative && !m_cancelled) ++m_num_finished;
+        update_state();
+    }
+}
+
+bool SepsetJob::pop_task(Task& task) {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv.wait(lock, [this]() { return m_finished || !m_queue.empty(); });
+
+    if (m_queue.empty()) return false;
+
+    task = m_queue.front();
+    m_queue.pop_front();
+    ++m_running;
+    return true;
+}
+
+void SepsetJob::run_task(const Task& task) {
+    const auto& first_name = m_graph.name(task.edge.first);
+    const auto& second_name = m_graph.name(task.edge.second);
+    auto sep_size = task.speculative ? m_sepset_size + 1 : m_sepset_size;
+
+    for_each_sepset(m_graph, task.edge, sep_size, [&](const std::vector<std::string>& sepset) {
+        if (m_cancelled.load(std::memory_order_relaxed)) return false;
+
+        double pvalue;
+        switch (sepset.size()) {
+            case 0:
+                pvalue = m_test->pvalue(first_name, second_name);
+                break;
+            case 1:
+                pvalue = m_test->pvalue(first_name, second_name, sepset[0]);
+                break;
+            default:
+                pvalue = m_test->pvalue(first_name, second_name, sepset);
+        }
+
+        if (task.speculative) {
+            util::profiling::count("sepset_job/speculative_tests");
+        } else {
+            std::vector<int> indices;
+            indices.reserve(sepset.size());
+            for (const auto& name : sepset) {
+                indices.push_back(m_graph.index(name));
+            }
+            std::sort(indices.begin(), indices.end());
+
+            push_result(task.edge, std::move(indices), pvalue);
+        }
+
+        return true;
+    });
+}
+
+void SepsetJob::push_result(const Edge& edge, std::vector<int>&& sepset, double pvalue) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_results.node1.push_back(edge.first);
+    m_results.node2.push_back(edge.second);
+    m_results.sepsets.insert(m_results.sepsets.end(), sepset.begin(), sepset.end());
+    m_results.pvalues.push_back(pvalue);
+}
+
+void SepsetJob::enqueue_speculative() {
+    // No task is running, so the graph can be modified.
+    for (const auto& edge : m_removed_edges) {
+        if (m_graph.has_edge_unsafe(edge.first, edge.second)) m_graph.remove_edge_unsafe(edge.first, edge.second);
+    }
+
+    for (const auto& edge : m_graph.edge_indices()) {
+        if (m_edge_whitelist.count(edge) == 0) m_queue.push_back(Task{edge, true});
+    }
+}
+
+void SepsetJob::update_state() {
+    if (!m_done && m_num_finished == m_num_edges) {
+        m_done = true;
+        if (m_speculate && !m_cancelled && m_running == 0) enqueue_speculative();
+    }
+
+    if (m_done && m_queue.empty() && m_running == 0) m_finished = true;
+
+    m_cv.notify_all();
+}
+
+void SepsetJob::rethrow_error() const {
+    if (m_error) std::rethrow_exception(m_error);
+}
+
+}  // namespace learning::algorithms
@@ -0,0 +1,129 @@
+#ifndef PYBNESIAN_LEARNING_ALGORITHMS_SEPSET_JOB_HPP
+#define PYBNESIAN_LEARNING_ALGORITHMS_SEPSET_JOB_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <graph/generic_graph.hpp>
+#include <learning/independences/independence.hpp>
+#include <learning/independences/cached_independence.hpp>
+#include <learning/algorithms/constraint.hpp>
+
+using graph::PartiallyDirectedGraph, graph::Edge, graph::EdgeHash, graph::EdgeEqualTo;
+using learning::independences::IndependenceTest, learning::independences::CachedIndependenceTest;
+using util::EdgeSet;
+
+namespace learning::algorithms {
+
+// Results of the independence tests of a SepsetJob in columnar form. Each row i is the test of the edge
+// (node1[i], node2[i]) conditioned on the sepset_size nodes sepsets[i*sepset_size:(i+1)*sepset_size] (sorted), which
+// returned pvalues[i]. The nodes are the indices in the PartiallyDirectedGraph.
+struct SepsetResults {
+    int sepset_size;
+    std::vector<int> node1;
+    std::vector<int> node2;
+    std::vector<int> sepsets;
+    std::vector<double> pvalues;
+
+    size_t size() const { return pvalues.size(); }
+    SepList to_seplist() const;
+};
+
+// Computes all the independence tests of size sepset_size of the interactive PC (see PC::compute_sepsets_of_size()) in
+// a pool of background threads. The caller can read the results progressively while the job runs (poll()), and can
+// change the order of the pending edges (prioritize()) or drop them (remove_edges()) when the user modifies the
+// partially directed graph.
+//
+// If speculate is true, the tests of size sepset_size + 1 are computed when the job finishes, on the graph without the
+// removed edges. Their p-values are not returned: they are stored in the cache of the test (which must be a
+// CachedIndependenceTest), so the next job finds them already computed.
+class SepsetJob {
+public:
+    SepsetJob(const PartiallyDirectedGraph& g,
+              std::shared_ptr<const IndependenceTest> test,
+              const EdgeSet& edge_whitelist,
+              int sepset_size,
+              bool speculate,
+              int num_threads,
+              const std::vector<Edge>& priority_edges = {});
+
+    SepsetJob(const SepsetJob&) = delete;
+    SepsetJob& operator=(const SepsetJob&) = delete;
+
+    ~SepsetJob();
+
+    int sepset_size() const { return m_sepset_size; }
+    bool speculate() const { return m_speculate; }
+    int num_threads() const { return static_cast<int>(m_threads.size()); }
+
+    // Number of edges to test, and the number of edges already tested.
+    int num_edges() const;
+    int num_finished_edges() const;
+
+    // True if all the edges of size sepset_size were tested (or removed), or if the job was cancelled.
+    bool done() const;
+    bool cancelled() const { return m_cancelled.load(); }
+
+    // Returns the results computed since the last call to poll().
+    SepsetResults poll();
+    // Returns all the results computed so far.
+    SepsetResults results() const;
+
+    // Moves the pending tests of the edges to the front of the queue, in the same order.
+    void prioritize(const std::vector<Edge>& edges);
+    // Drops the pending tests of the edges. The speculative tests do not use the removed edges.
+    void remove_edges(const std::vector<Edge>& edges);
+
+    // Stops the job as soon as possible. The results computed before cancelling are kept.
+    void cancel();
+    // Waits until done() (timeout < 0 waits forever). If speculative is true, it also waits for the speculative tests.
+    // Returns whether the job is done. It rethrows the exceptions of the test.
+    bool wait(double timeout = -1, bool speculative = false);
+
+private:
+    struct Task {
+        Edge edge;
+        bool speculative;
+    };
+
+    void worker();
+    bool pop_task(Task& task);
+    void run_task(const Task& task);
+    void push_result(const Edge& edge, std::vector<int>&& sepset, double pvalue);
+    void enqueue_speculative();
+    // Updates the state of the job after a change of the queue. The mutex must be locked.
+    void update_state();
+    void rethrow_error() const;
+
+    PartiallyDirectedGraph m_graph;
+    std::shared_ptr<const IndependenceTest> m_test;
+    EdgeSet m_edge_whitelist;
+    int m_sepset_size;
+    bool m_speculate;
+
+    std::atomic<bool> m_cancelled;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_cv;
+    std::deque<Task> m_queue;
+    EdgeSet m_removed_edges;
+    int m_num_edges;
+    int m_num_finished;
+    int m_running;
+    bool m_done;
+    bool m_finished;
+    std::exception_ptr m_error;
+
+    SepsetResults m_results;
+    size_t m_polled;
+
+    std::vector<std::thread> m_threads;
+};
+
+}  // namespace learning::algorithms
+
+#endif  // PYBNESIAN_LEARNING_ALGORITHMS_SEPSET_JOB_HPP
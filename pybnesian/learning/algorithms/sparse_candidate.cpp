@@ -0,0 +1,109 @@
+#include <algorithm>
+#include <exception>
+#include <learning/algorithms/sparse_candidate.hpp>
+#include <learning/algorithms/mmhc.hpp>
+#include <learning/algorithms/mmpc.hpp>
+#include <util/parallel.hpp>
+#include <util/progress.hpp>
+
+namespace learning::algorithms {
+
+std::vector<std::string> candidate_nodes(const IndependenceTest& test, const std::vector<std::string>& nodes) {
+    if (nodes.empty()) return test.variable_names();
+
+    if (!test.has_variables(nodes))
+        throw std::invalid_argument("IndependenceTest do not contain all the variables in nodes list.");
+
+    return nodes;
+}
+
+// Selects the (at most) k nodes of others with the smallest marginal p-value with node.
+std::vector<std::string> strongest_associations(const IndependenceTest& test,
+                                                const std::string& node,
+                                                const std::vector<std::string>& others,
+                                                int k) {
+    std::vector<std::pair<double, int>> pvalues;
+    pvalues.reserve(others.size());
+
+    for (size_t i = 0; i < others.size(); ++i) {
+        if (others[i] != node) pvalues.push_back({test.pvalue(node, others[i]), static_cast<int>(i)});
+    }
+
+    auto num_selected = std::min(static_cast<size_t>(k), pvalues.size());
+    std::partial_sort(pvalues.begin(), pvalues.begin() + num_selected, pvalues.end());
+
+    std::vector<std::string> selected;
+    selected.reserve(num_selected);
+    for (size_t i = 0; i < num_selected; ++i) {
+        selected.push_back(others[pvalues[i].second]);
+    }
+
+    return selected;
+}
+
+CandidateParents association_candidates(const IndependenceTest& test, const std::vector<std::string>& nodes, int k) {
+    if (k <= 0) throw std::invalid_argument("The number of candidates must be positive.");
+
+    auto vnodes = candidate_nodes(test, nodes);
+    std::vector<std::vector<std::string>> candidates(vnodes.size());
+    std::exception_ptr exception;
+
+#pragma omp parallel for schedule(dynamic) num_threads(util::num_threads())
+    for (size_t i = 0; i < vnodes.size(); ++i) {
+        try {
+            candidates[i] = strongest_associations(test, vnodes[i], vnodes, k);
+        } catch (...) {
+#pragma omp critical
+            {
+                if (!exception) exception = std::current_exception();
+            }
+        }
+    }
+
+    if (exception) std::rethrow_exception(exception);
+
+    CandidateParents res;
+    for (size_t i = 0; i < vnodes.size(); ++i) {
+        res.insert({vnodes[i], std::move(candidates[i])});
+    }
+
+    return res;
+}
+
+CandidateParents mmpc_candidates(const IndependenceTest& test,
+                                 const std::vector<std::string>& nodes,
+                                 double alpha,
+                                 int max_candidates,
+                                 int verbose) {
+    if (alpha <= 0 || alpha >= 1) throw std::invalid_argument("alpha must be a number between 0 and 1.");
+    if (max_candidates < 0) throw std::invalid_argument("max_candidates must be non-negative.");
+
+    PartiallyDirectedGraph skeleton(candidate_nodes(test, nodes));
+
+    auto progress = util::progress_bar(verbose);
+    auto cpcs = mmpc_all_variables(test, skeleton, alpha, ArcSet{}, EdgeSet{}, EdgeSet{}, *progress);
+    remove_asymmetries(cpcs);
+
+    CandidateParents res;
+    for (const auto& node : skeleton.nodes()) {
+        const auto& cpc = cpcs[skeleton.index(node)];
+        std::vector<int> sorted_cpc(cpc.begin(), cpc.end());
+        std::sort(sorted_cpc.begin(), sorted_cpc.end());
+
+        std::vector<std::string> cpc_names;
+        cpc_names.reserve(sorted_cpc.size());
+        for (auto c : sorted_cpc) {
+            cpc_names.push_back(skeleton.name(c));
+        }
+
+        if (max_candidates > 0 && cpc_names.size() > static_cast<size_t>(max_candidates)) {
+            cpc_names = strongest_associations(test, node, cpc_names, max_candidates);
+        }
+
+        res.insert({node, std::move(cpc_names)});
+    }
+
+    return res;
+}
+
+}  // namespace learning::algorithms
@@ -0,0 +1,27 @@
+#ifndef PYBNESIAN_LEARNING_ALGORITHMS_SPARSE_CANDIDATE_HPP
+#define PYBNESIAN_LEARNING_ALGORITHMS_SPARSE_CANDIDATE_HPP
+
+#include <learning/independences/independence.hpp>
+#include <learning/operators/operators.hpp>
+
+using learning::independences::IndependenceTest;
+using learning::operators::CandidateParents;
+
+namespace learning::algorithms {
+
+// Candidate parents of each node for a SparseArcOperatorSet: the k nodes with the smallest marginal p-value (the
+// strongest marginal association) with the node. If nodes is empty, all the variables of the test are used.
+CandidateParents association_candidates(const IndependenceTest& test, const std::vector<std::string>& nodes, int k);
+
+// Candidate parents of each node for a SparseArcOperatorSet: the candidate parents and children (CPC) estimated by
+// MMPC, after removing the asymmetries as in MMHC. If max_candidates > 0, only the max_candidates nodes of the CPC with
+// the smallest marginal p-value are kept. If nodes is empty, all the variables of the test are used.
+CandidateParents mmpc_candidates(const IndependenceTest& test,
+                                 const std::vector<std::string>& nodes,
+                                 double alpha,
+                                 int max_candidates,
+                                 int verbose);
+
+}  // namespace learning::algorithms
+
+#endif  // PYBNESIAN_LEARNING_ALGORITHMS_SPARSE_CANDIDATE_HPP
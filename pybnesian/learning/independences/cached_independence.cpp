@@ -0,0 +1,172 @@
+#include <algorithm>
+#include <learning/independences/cached_independence.hpp>
+#include <util/pickle.hpp>
+
+namespace learning::independences {
+
+void dump_results(std::string name, const py::tuple& results) {
+    auto open = py::module_::import("io").attr("open");
+
+    if (name.size() < 7 || name.substr(name.size() - 7) != ".pickle") name += ".pickle";
+
+    auto file = open(name, "wb");
+    py::module_::import("pickle").attr("dump")(results, file, 2);
+    file.attr("close")();
+}
+
+// Checks that the fingerprint and test description saved at position offset of t match the cache.
+void check_saved_test(const CachedIndependenceTest& cache, const py::tuple& t, size_t offset, const std::string& name) {
+    if (t[offset].cast<uint64_t>() != cache.fingerprint()) {
+        throw std::invalid_argument("The results in " + name + " were computed on a different dataset.");
+    }
+
+    auto saved_test = t[offset + 1].cast<std::string>();
+    auto test = cache.test().ToString();
+    if (saved_test != test) {
+        throw std::invalid_argument("The results in " + name + " were computed with a different independence test (" +
+                                    saved_test + " instead of " + test + ").");
+    }
+}
+
+CITestKey CachedIndependenceTest::canonical_key(const std::string& v1,
+                                                const std::string& v2,
+                                                std::vector<std::string>::const_iterator ev_begin,
+                                                std::vector<std::string>::const_iterator ev_end) {
+    CITestKey key;
+    key.reserve(2 + std::distance(ev_begin, ev_end));
+
+    if (v1 < v2) {
+        key.push_back(v1);
+        key.push_back(v2);
+    } else {
+        key.push_back(v2);
+        key.push_back(v1);
+    }
+
+    key.insert(key.end(), ev_begin, ev_end);
+    std::sort(key.begin() + 2, key.end());
+    return key;
+}
+
+template <typename Compute>
+double CachedIndependenceTest::cached_pvalue(CITestKey&& key, Compute compute) const {
+    auto& stripe = m_stripes[CITestKeyHash{}(key) % num_stripes];
+
+    {
+        std::lock_guard<std::mutex> lock(stripe.mutex);
+        auto it = stripe.results.find(key);
+        if (it != stripe.results.end()) {
+            util::profiling::count("ci_cache/hits");
+            return it->second;
+        }
+    }
+
+    util::profiling::count("ci_cache/misses");
+
+    // The test is computed without holding the lock, so the rest of the threads can use the stripe.
+    auto pvalue = compute();
+
+    std::lock_guard<std::mutex> lock(stripe.mutex);
+    stripe.results.insert({std::move(key), pvalue});
+    return pvalue;
+}
+
+double CachedIndependenceTest::pvalue(const std::string& v1, const std::string& v2) const {
+    std::vector<std::string> empty;
+    return cached_pvalue(canonical_key(v1, v2, empty.begin(), empty.end()),
+                         [this, &v1, &v2]() { return m_test->pvalue(v1, v2); });
+}
+
+double CachedIndependenceTest::pvalue(const std::string& v1, const std::string& v2, const std::string& ev) const {
+    std::vector<std::string> evidence{ev};
+    return cached_pvalue(canonical_key(v1, v2, evidence.begin(), evidence.end()),
+                         [this, &v1, &v2, &ev]() { return m_test->pvalue(v1, v2, ev); });
+}
+
+double CachedIndependenceTest::pvalue(const std::string& v1,
+                                      const std::string& v2,
+                                      const std::vector<std::string>& ev) const {
+    return cached_pvalue(canonical_key(v1, v2, ev.begin(), ev.end()),
+                         [this, &v1, &v2, &ev]() { return m_test->pvalue(v1, v2, ev); });
+}
+
+int CachedIndependenceTest::num_cached() const {
+    int total = 0;
+    for (auto& stripe : m_stripes) {
+        std::lock_guard<std::mutex> lock(stripe.mutex);
+        total += stripe.results.size();
+    }
+
+    return total;
+}
+
+void CachedIndependenceTest::clear_cache() {
+    for (auto& stripe : m_stripes) {
+        std::lock_guard<std::mutex> lock(stripe.mutex);
+        stripe.results.clear();
+    }
+}
+
+std::vector<CITestResult> CachedIndependenceTest::results() const {
+    std::vector<CITestResult> res;
+
+    for (auto& stripe : m_stripes) {
+        std::lock_guard<std::mutex> lock(stripe.mutex);
+        for (const auto& [key, pvalue] : stripe.results) {
+            res.push_back({key[0], key[1], std::vector<std::string>(key.begin() + 2, key.end()), pvalue});
+        }
+    }
+
+    return res;
+}
+
+void CachedIndependenceTest::insert_results(const std::vector<CITestResult>& results) {
+    for (const auto& [v1, v2, ev, pvalue] : results) {
+        auto key = canonical_key(v1, v2, ev.begin(), ev.end());
+        auto& stripe = m_stripes[CITestKeyHash{}(key) % num_stripes];
+
+        std::lock_guard<std::mutex> lock(stripe.mutex);
+        stripe.results.insert({std::move(key), pvalue});
+    }
+}
+
+void CachedIndependenceTest::save(const std::string& name) const {
+    dump_results(name, py::make_tuple(m_fingerprint, m_test->ToString(), results()));
+}
+
+void CachedIndependenceTest::load(const std::string& name) {
+    auto t = util::load(name).cast<py::tuple>();
+
+    if (t.size() != 3) {
+        throw std::runtime_error("Not valid CachedIndependenceTest results.");
+    }
+
+    check_saved_test(*this, t, 0, name);
+    insert_results(t[2].cast<std::vector<CITestResult>>());
+}
+
+void CachedDynamicIndependenceTest::save(const std::string& name) const {
+    dump_results(name,
+                 py::make_tuple(m_static.fingerprint(),
+                                m_static.test().ToString(),
+                                m_static.results(),
+                                m_transition.fingerprint(),
+                                m_transition.test().ToString(),
+                                m_transition.results()));
+}
+
+void CachedDynamicIndependenceTest::load(const std::string& name) {
+    auto t = util::load(name).cast<py::tuple>();
+
+    if (t.size() != 6) {
+        throw std::runtime_error("Not valid CachedDynamicIndependenceTest results.");
+    }
+
+    check_saved_test(m_static, t, 0, name);
+    check_saved_test(m_transition, t, 3, name);
+
+    m_static.insert_results(t[2].cast<std::vector<CITestResult>>());
+    m_transition.insert_results(t[5].cast<std::vector<CITestResult>>());
+}
+
+}  // namespace learning::independences
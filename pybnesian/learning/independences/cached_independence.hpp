@@ -0,0 +1,116 @@
+#ifndef PYBNESIAN_LEARNING_INDEPENDENCES_CACHED_INDEPENDENCE_HPP
+#define PYBNESIAN_LEARNING_INDEPENDENCES_CACHED_INDEPENDENCE_HPP
+
+#include <array>
+#include <mutex>
+#include <learning/independences/independence.hpp>
+#include <util/hash_utils.hpp>
+
+namespace learning::independences {
+
+// Canonical key of a test: the sorted pair (x, y) followed by the sorted conditioning set.
+using CITestKey = std::vector<std::string>;
+
+struct CITestKeyHash {
+    std::size_t operator()(const CITestKey& key) const {
+        std::size_t seed = key.size();
+        for (const auto& name : key) util::hash_combine(seed, name);
+        return seed;
+    }
+};
+
+// (x, y, conditioning set, p-value)
+using CITestResult = std::tuple<std::string, std::string, std::vector<std::string>, double>;
+
+// Memoizes the p-values of any IndependenceTest. The results are stored in a lock-striped hash table, so the same cache
+// can be used concurrently by the parallel loops of the constraint-based algorithms. The results can be saved to disk
+// and loaded in later sessions: the cache stores the fingerprint of the data and the description of the wrapped test
+// (IndependenceTest::ToString()), and only the results computed on the same data with the same test are loaded.
+class CachedIndependenceTest : public IndependenceTest {
+public:
+    CachedIndependenceTest(std::shared_ptr<const IndependenceTest> test, const DataFrame& df)
+        : CachedIndependenceTest(test, df.fingerprint()) {}
+    CachedIndependenceTest(std::shared_ptr<const IndependenceTest> test, uint64_t fingerprint)
+        : m_test(test), m_fingerprint(fingerprint), m_stripes() {
+        if (!m_test) throw std::invalid_argument("Independence test is null.");
+    }
+
+    double pvalue(const std::string& v1, const std::string& v2) const override;
+    double pvalue(const std::string& v1, const std::string& v2, const std::string& ev) const override;
+    double pvalue(const std::string& v1, const std::string& v2, const std::vector<std::string>& ev) const override;
+
+    int num_variables() const override { return m_test->num_variables(); }
+    std::vector<std::string> variable_names() const override { return m_test->variable_names(); }
+    const std::string& name(int i) const override { return m_test->name(i); }
+    bool has_variables(const std::string& name) const override { return m_test->has_variables(name); }
+    bool has_variables(const std::vector<std::string>& cols) const override { return m_test->has_variables(cols); }
+
+    std::string ToString() const override { return "CachedIndependenceTest(" + m_test->ToString() + ")"; }
+
+    const IndependenceTest& test() const { return *m_test; }
+    uint64_t fingerprint() const { return m_fingerprint; }
+
+    int num_cached() const;
+    void clear_cache();
+
+    std::vector<CITestResult> results() const;
+    void insert_results(const std::vector<CITestResult>& results);
+
+    void save(const std::string& name) const;
+    void load(const std::string& name);
+
+private:
+    static constexpr int num_stripes = 64;
+
+    struct Stripe {
+        std::mutex mutex;
+        std::unordered_map<CITestKey, double, CITestKeyHash> results;
+    };
+
+    static CITestKey canonical_key(const std::string& v1,
+                                   const std::string& v2,
+                                   std::vector<std::string>::const_iterator ev_begin,
+                                   std::vector<std::string>::const_iterator ev_end);
+
+    template <typename Compute>
+    double cached_pvalue(CITestKey&& key, Compute compute) const;
+
+    std::shared_ptr<const IndependenceTest> m_test;
+    uint64_t m_fingerprint;
+    mutable std::array<Stripe, num_stripes> m_stripes;
+};
+
+// Dynamic version of CachedIndependenceTest: the static and transition tests are cached independently.
+class CachedDynamicIndependenceTest : public DynamicIndependenceTest {
+public:
+    CachedDynamicIndependenceTest(std::shared_ptr<const DynamicIndependenceTest> test, const DynamicDataFrame& df)
+        : m_test(test),
+          m_static(std::shared_ptr<const IndependenceTest>(test, &test->static_tests()), df.static_df()),
+          m_transition(std::shared_ptr<const IndependenceTest>(test, &test->transition_tests()),
+                       df.transition_df()) {}
+
+    const CachedIndependenceTest& static_tests() const override { return m_static; }
+    const CachedIndependenceTest& transition_tests() const override { return m_transition; }
+    CachedIndependenceTest& static_tests() { return m_static; }
+    CachedIndependenceTest& transition_tests() { return m_transition; }
+
+    std::vector<std::string> variable_names() const override { return m_test->variable_names(); }
+    const std::string& name(int i) const override { return m_test->name(i); }
+    bool has_variables(const std::string& name) const override { return m_test->has_variables(name); }
+    bool has_variables(const std::vector<std::string>& cols) const override { return m_test->has_variables(cols); }
+
+    int num_variables() const override { return m_test->num_variables(); }
+    int markovian_order() const override { return m_test->markovian_order(); }
+
+    void save(const std::string& name) const;
+    void load(const std::string& name);
+
+private:
+    std::shared_ptr<const DynamicIndependenceTest> m_test;
+    CachedIndependenceTest m_static;
+    CachedIndependenceTest m_transition;
+};
+
+}  // namespace learning::independences
+
+#endif  // PYBNESIAN_LEARNING_INDEPENDENCES_CACHED_INDEPENDENCE_HPP
@@ -4,21 +4,31 @@ namespace learning::independences::continuous {
 
 template <typename ArrowType>
 double RCoT::pvalue(const std::string& x, const std::string& y) const {
+    auto x_index = m_df.index(x);
+    auto y_index = m_df.index(y);
+
     if (m_df.null_count(x, y) == 0) {
-        auto x_vec = m_df.to_eigen<false, ArrowType, false>(x);
-        auto y_vec = m_df.to_eigen<false, ArrowType, false>(y);
-        if (util::sse(*x_vec) == 0 || util::sse(*y_vec) == 0) return 1;
-        return RIT<false>(m_df.index(x), m_df.index(y), *x_vec, *y_vec);
+        if (m_constant[x_index] || m_constant[y_index]) return 1;
+
+        auto& cache = xy_features<typename ArrowType::c_type>();
+        auto feat_x = cached_fourier_features<ArrowType>(cache, {x_index}, m_num_random_fourier_xy);
+        auto feat_y = cached_fourier_features<ArrowType>(cache, {y_index}, m_num_random_fourier_xy);
+        return RIT(*feat_x, *feat_y);
     } else {
         auto combined_bitmap = m_df.combined_bitmap(x, y);
         auto x_vec = m_df.to_eigen<false, ArrowType>(combined_bitmap, x);
         auto y_vec = m_df.to_eigen<false, ArrowType>(combined_bitmap, y);
         if (util::sse(*x_vec) == 0 || util::sse(*y_vec) == 0) return 1;
-        return RIT<true>(m_df.index(x), m_df.index(y), *x_vec, *y_vec);
+
+        auto feat_x = fourier_features(*x_vec, {x_index}, m_num_random_fourier_xy);
+        auto feat_y = fourier_features(*y_vec, {y_index}, m_num_random_fourier_xy);
+        return RIT(feat_x, feat_y);
     }
 }
 
 double RCoT::pvalue(const std::string& x, const std::string& y) const {
+    auto timer = pvalue_timer("RCoT", 0);
+
     auto type = m_df.same_type(x, y);
     switch (type->id()) {
         case Type::DOUBLE: {
@@ -34,18 +44,23 @@ double RCoT::pvalue(const std::string& x, const std::string& y) const {
 
 template <typename ArrowType>
 double RCoT::pvalue(const std::string& x, const std::string& y, const std::string& z) const {
-    if (m_df.null_count(x, y, z) == 0) {
-        auto x_vec = m_df.to_eigen<false, ArrowType, false>(x);
-        auto y_vec = m_df.to_eigen<false, ArrowType, false>(y);
+    auto x_index = m_df.index(x);
+    auto y_index = m_df.index(y);
+    auto z_index = m_df.index(z);
 
-        if (util::sse(*x_vec) == 0 || util::sse(*y_vec) == 0) return 1;
+    if (m_df.null_count(x, y, z) == 0) {
+        if (m_constant[x_index] || m_constant[y_index]) return 1;
 
-        auto z_vec = m_df.to_eigen<false, ArrowType, false>(z);
+        auto& cache = xy_features<typename ArrowType::c_type>();
+        auto feat_x = cached_fourier_features<ArrowType>(cache, {x_index}, m_num_random_fourier_xy);
+        auto feat_y = cached_fourier_features<ArrowType>(cache, {y_index}, m_num_random_fourier_xy);
 
-        if (util::sse(*z_vec) == 0) {
-            return RIT<false>(m_df.index(x), m_df.index(y), *x_vec, *y_vec);
+        if (m_constant[z_index]) {
+            return RIT(*feat_x, *feat_y);
         } else {
-            return RSingleZ<false>(m_df.index(x), m_df.index(y), m_df.index(z), *x_vec, *y_vec, *z_vec);
+            auto feat_z = cached_fourier_features<ArrowType>(
+                z_features<typename ArrowType::c_type>(), {z_index}, m_num_random_fourier_z);
+            return TestWithZ(*feat_x, *feat_y, *feat_z);
         }
     } else {
         auto combined_bitmap = m_df.combined_bitmap(x, y, z);
@@ -56,15 +71,21 @@ double RCoT::pvalue(const std::string& x, const std::string& y, const std::strin
 
         auto z_vec = m_df.to_eigen<false, ArrowType>(combined_bitmap, z);
 
+        auto feat_x = fourier_features(*x_vec, {x_index}, m_num_random_fourier_xy);
+        auto feat_y = fourier_features(*y_vec, {y_index}, m_num_random_fourier_xy);
+
         if (util::sse(*z_vec) == 0) {
-            return RIT<true>(m_df.index(x), m_df.index(y), *x_vec, *y_vec);
+            return RIT(feat_x, feat_y);
         } else {
-            return RSingleZ<true>(m_df.index(x), m_df.index(y), m_df.index(z), *x_vec, *y_vec, *z_vec);
+            auto feat_z = fourier_features(*z_vec, {z_index}, m_num_random_fourier_z);
+            return TestWithZ(feat_x, feat_y, feat_z);
         }
     }
 }
 
 double RCoT::pvalue(const std::string& x, const std::string& y, const std::string& z) const {
+    auto timer = pvalue_timer("RCoT", 1);
+
     auto type = m_df.same_type(x, y, z);
     switch (type->id()) {
         case Type::DOUBLE: {
@@ -80,40 +101,30 @@ double RCoT::pvalue(const std::string& x, const std::string& y, const std::strin
 
 template <typename ArrowType>
 double RCoT::pvalue(const std::string& x, const std::string& y, const std::vector<std::string>& z) const {
-    if (m_df.null_count(x, y, z) == 0) {
-        auto x_vec = m_df.to_eigen<false, ArrowType, false>(x);
-        auto y_vec = m_df.to_eigen<false, ArrowType, false>(y);
-
-        if (util::sse(*x_vec) == 0 || util::sse(*y_vec) == 0) return 1;
-
-        auto z_mat = m_df.to_eigen<false, ArrowType, false>(z);
+    auto x_index = m_df.index(x);
+    auto y_index = m_df.index(y);
 
-        auto z_sse = util::sse_cols(*z_mat);
-
-        bool zall_valid = true;
-        for (auto i = 0; i < z_sse.rows(); ++i) {
-            if (z_sse(i) == 0) {
-                zall_valid = false;
-                break;
-            }
+    if (m_df.null_count(x, y, z) == 0) {
+        if (m_constant[x_index] || m_constant[y_index]) return 1;
+
+        auto& cache = xy_features<typename ArrowType::c_type>();
+        auto feat_x = cached_fourier_features<ArrowType>(cache, {x_index}, m_num_random_fourier_xy);
+        auto feat_y = cached_fourier_features<ArrowType>(cache, {y_index}, m_num_random_fourier_xy);
+
+        // The conditioning set is sorted, so the features of a set do not depend on the order of z.
+        std::vector<int> z_indices;
+        z_indices.reserve(z.size());
+        for (const auto& name : z) {
+            auto index = m_df.index(name);
+            if (!m_constant[index]) z_indices.push_back(index);
         }
 
-        if (!zall_valid) {
-            std::vector<std::string> valid_names;
-
-            for (auto i = 0; i < z_sse.rows(); ++i) {
-                if (z_sse(i) > 0) {
-                    valid_names.push_back(m_df.name(z[i]));
-                }
-            }
+        if (z_indices.empty()) return RIT(*feat_x, *feat_y);
 
-            if (!valid_names.empty())
-                z_mat = m_df.to_eigen<false, ArrowType, false>(valid_names);
-            else
-                return RIT<false>(m_df.index(x), m_df.index(y), *x_vec, *y_vec);
-        }
-
-        return RMultiZ<false>(m_df.index(x), m_df.index(y), *x_vec, *y_vec, *z_mat);
+        std::sort(z_indices.begin(), z_indices.end());
+        auto& z_cache = z_features<typename ArrowType::c_type>();
+        auto feat_z = cached_fourier_features<ArrowType>(z_cache, z_indices, m_num_random_fourier_z);
+        return TestWithZ(*feat_x, *feat_y, *feat_z);
     } else {
         auto combined_bitmap = m_df.combined_bitmap(x, y, z);
         auto x_vec = m_df.to_eigen<false, ArrowType>(combined_bitmap, x);
@@ -125,38 +136,38 @@ double RCoT::pvalue(const std::string& x, const std::string& y, const std::vecto
 
         auto z_sse = util::sse_cols(*z_mat);
 
-        bool zall_valid = true;
-        for (auto i = 0; z_sse.rows(); ++i) {
-            if (z_sse(i) == 0) {
-                zall_valid = false;
-                break;
+        std::vector<int> z_indices;
+        std::vector<std::string> valid_names;
+        for (auto i = 0; i < z_sse.rows(); ++i) {
+            if (z_sse(i) > 0) {
+                z_indices.push_back(m_df.index(z[i]));
+                valid_names.push_back(z[i]);
             }
         }
 
-        if (!zall_valid) {
-            std::vector<std::string> valid_names;
-
-            for (auto i = 0; z_sse.rows(); ++i) {
-                if (z_sse(i) > 0) {
-                    valid_names.push_back(m_df.name(z[i]));
-                }
-            }
+        if (valid_names.empty()) {
+            auto feat_x = fourier_features(*x_vec, {x_index}, m_num_random_fourier_xy);
+            auto feat_y = fourier_features(*y_vec, {y_index}, m_num_random_fourier_xy);
+            return RIT(feat_x, feat_y);
+        }
 
-            if (!valid_names.empty()) {
-                combined_bitmap = m_df.combined_bitmap(x, y, valid_names);
-                x_vec = m_df.to_eigen<false, ArrowType>(combined_bitmap, x);
-                y_vec = m_df.to_eigen<false, ArrowType>(combined_bitmap, y);
-                z_mat = m_df.to_eigen<false, ArrowType>(valid_names);
-            } else {
-                return RIT<true>(m_df.index(x), m_df.index(y), *x_vec, *y_vec);
-            }
+        if (valid_names.size() < z.size()) {
+            combined_bitmap = m_df.combined_bitmap(x, y, valid_names);
+            x_vec = m_df.to_eigen<false, ArrowType>(combined_bitmap, x);
+            y_vec = m_df.to_eigen<false, ArrowType>(combined_bitmap, y);
+            z_mat = m_df.to_eigen<false, ArrowType>(combined_bitmap, valid_names);
         }
 
-        return RMultiZ<true>(m_df.index(x), m_df.index(y), *x_vec, *y_vec, *z_mat);
+        auto feat_x = fourier_features(*x_vec, {x_index}, m_num_random_fourier_xy);
+        auto feat_y = fourier_features(*y_vec, {y_index}, m_num_random_fourier_xy);
+        auto feat_z = fourier_features(*z_mat, z_indices, m_num_random_fourier_z);
+        return TestWithZ(feat_x, feat_y, feat_z);
     }
 }
 
 double RCoT::pvalue(const std::string& x, const std::string& y, const std::vector<std::string>& z) const {
+    auto timer = pvalue_timer("RCoT", z.size());
+
     auto type = m_df.same_type(x, y, z);
     switch (type->id()) {
         case Type::DOUBLE: {
@@ -1,12 +1,15 @@
 #ifndef PYBNESIAN_LEARNING_INDEPENDENCES_CONTINUOUS_RCOT_HPP
 #define PYBNESIAN_LEARNING_INDEPENDENCES_CONTINUOUS_RCOT_HPP
 
+#include <limits>
+#include <mutex>
 #include <random>
 #include <Eigen/Eigenvalues>
 #include <learning/independences/independence.hpp>
 #include <util/math_constants.hpp>
 #include <util/basic_eigen_ops.hpp>
 #include <util/chisquaresum.hpp>
+#include <util/hash_utils.hpp>
 
 using learning::independences::IndependenceTest;
 
@@ -40,20 +43,85 @@ typename MatrixType::Scalar rf_sigma_impl(MatrixType& m) {
     return median;
 }
 
+struct IndicesHash {
+    std::size_t operator()(const std::vector<int>& indices) const {
+        std::size_t seed = indices.size();
+        for (auto i : indices) util::hash_combine(seed, i);
+        return seed;
+    }
+};
+
+// Thread-safe cache of normalized random fourier features, indexed by the (sorted) column indices of the variables.
+// Once inserted, the features are never modified, so they can be shared between concurrent tests. The features are
+// computed outside the lock: if two threads compute the same entry, the first inserted is kept (both are equal, because
+// the random features are seeded with the column indices).
+template <typename Scalar>
+class FourierFeaturesCache {
+public:
+    using MatrixType = Matrix<Scalar, Dynamic, Dynamic>;
+
+    FourierFeaturesCache(size_t max_size) : m_mutex(), m_features(), m_size(0), m_max_size(max_size) {}
+
+    std::shared_ptr<const MatrixType> find(const std::vector<int>& indices) const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_features.find(indices);
+        if (it != m_features.end()) return it->second;
+        return nullptr;
+    }
+
+    std::shared_ptr<const MatrixType> insert(const std::vector<int>& indices,
+                                             std::shared_ptr<const MatrixType> features) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_features.find(indices);
+        if (it != m_features.end()) return it->second;
+
+        // If the cache is full, the features are used for this test only.
+        if (m_size + features->size() > m_max_size) return features;
+
+        m_size += features->size();
+        m_features.insert({indices, features});
+        return features;
+    }
+
+    int num_cached() const {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        return static_cast<int>(m_features.size());
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_features.clear();
+        m_size = 0;
+    }
+
+private:
+    mutable std::mutex m_mutex;
+    std::unordered_map<std::vector<int>, std::shared_ptr<const MatrixType>, IndicesHash> m_features;
+    size_t m_size;
+    size_t m_max_size;
+};
+
+// Maximum number of scalars stored in the cache of random fourier features for the conditioning sets.
+constexpr size_t rcot_max_cached_z = static_cast<size_t>(1) << 25;
+
+// RCoT is re-entrant: the random fourier features of the variables without null values are computed lazily (once per
+// variable or conditioning set) and shared between tests. Every other temporary matrix is local to each call, so
+// pvalue() can be called concurrently from multiple threads.
 class RCoT : public IndependenceTest {
 public:
-    RCoT(const DataFrame& df, int random_fourier_xy = 5, int random_fourier_z = 100)
-        : m_df(df.normalize()),
+    RCoT(const DataFrame& df,
+         int random_fourier_xy = 5,
+         int random_fourier_z = 100,
+         unsigned int seed = std::random_device{}())
+        : m_df(check_unweighted(df, "RCoT").normalize()),
           m_num_random_fourier_xy(random_fourier_xy),
           m_num_random_fourier_z(random_fourier_z),
-          m_dfourier_x(),
-          m_dfourier_y(),
-          m_dfourier_z(),
-          m_dsigma(),
-          m_ffourier_x(),
-          m_ffourier_y(),
-          m_ffourier_z(),
-          m_fsigma() {
+          m_seed(seed),
+          m_constant(df->num_columns(), false),
+          m_dxy_features(std::numeric_limits<size_t>::max()),
+          m_dz_features(rcot_max_cached_z),
+          m_fxy_features(std::numeric_limits<size_t>::max()),
+          m_fz_features(rcot_max_cached_z) {
         auto continuous_indices = df.continuous_columns();
 
         if (continuous_indices.size() < 2) {
@@ -64,32 +132,20 @@ public:
 
         switch (type->id()) {
             case Type::DOUBLE: {
-                m_dfourier_x = MatrixXd(df.num_rows(), m_num_random_fourier_xy);
-                m_dfourier_y = MatrixXd(df.num_rows(), m_num_random_fourier_xy);
-                m_dfourier_z = MatrixXd(df.num_rows(), m_num_random_fourier_z);
-                m_tmp_dcov = MatrixXd(df.num_rows(), m_num_random_fourier_xy * m_num_random_fourier_xy);
-                m_dsigma = VectorXd(df->num_columns());
-
                 for (auto c : continuous_indices) {
                     if (m_df.null_count(c) == 0) {
                         auto x_vec = m_df.to_eigen<false, arrow::DoubleType, false>(c);
-                        m_dsigma(c) = rf_sigma_impl(*x_vec);
+                        m_constant[c] = util::sse(*x_vec) == 0;
                     }
                 }
 
                 break;
             }
             case Type::FLOAT: {
-                m_ffourier_x = MatrixXf(df.num_rows(), m_num_random_fourier_xy);
-                m_ffourier_y = MatrixXf(df.num_rows(), m_num_random_fourier_xy);
-                m_ffourier_z = MatrixXf(df.num_rows(), m_num_random_fourier_z);
-                m_tmp_fcov = MatrixXf(df.num_rows(), m_num_random_fourier_xy * m_num_random_fourier_xy);
-                m_fsigma = VectorXf(df->num_columns());
-
                 for (auto c : continuous_indices) {
                     if (m_df.null_count(c) == 0) {
                         auto x_vec = m_df.to_eigen<false, arrow::FloatType, false>(c);
-                        m_fsigma(c) = rf_sigma_impl(*x_vec);
+                        m_constant[c] = util::sse(*x_vec) == 0;
                     }
                 }
 
@@ -122,94 +178,77 @@ public:
 
     bool has_variables(const std::vector<std::string>& cols) const override { return m_df.has_columns(cols); }
 
-private:
-    template <typename Scalar>
-    Scalar rf_sigma(int index) const {
-        if constexpr (std::is_same_v<Scalar, double>)
-            return m_dsigma(index);
-        else
-            return m_fsigma(index);
+    std::string ToString() const override {
+        return "RCoT(random_fourier_xy=" + std::to_string(m_num_random_fourier_xy) +
+               ", random_fourier_z=" + std::to_string(m_num_random_fourier_z) +
+               ", seed=" + std::to_string(m_seed) + ")";
     }
 
-    template <typename Scalar>
-    Matrix<Scalar, Dynamic, Dynamic>& fourier_x() const {
-        if constexpr (std::is_same_v<Scalar, double>)
-            return m_dfourier_x;
-        else
-            return m_ffourier_x;
+    int num_cached_features() const {
+        return m_dxy_features.num_cached() + m_dz_features.num_cached() + m_fxy_features.num_cached() +
+               m_fz_features.num_cached();
     }
 
-    template <typename Scalar>
-    Matrix<Scalar, Dynamic, Dynamic>& fourier_y() const {
-        if constexpr (std::is_same_v<Scalar, double>)
-            return m_dfourier_y;
-        else
-            return m_ffourier_y;
+    void clear_cache() {
+        m_dxy_features.clear();
+        m_dz_features.clear();
+        m_fxy_features.clear();
+        m_fz_features.clear();
     }
 
+private:
     template <typename Scalar>
-    Matrix<Scalar, Dynamic, Dynamic>& fourier_z() const {
+    FourierFeaturesCache<Scalar>& xy_features() const {
         if constexpr (std::is_same_v<Scalar, double>)
-            return m_dfourier_z;
+            return m_dxy_features;
         else
-            return m_ffourier_z;
+            return m_fxy_features;
     }
 
     template <typename Scalar>
-    Matrix<Scalar, Dynamic, Dynamic>& tmp_cov() const {
+    FourierFeaturesCache<Scalar>& z_features() const {
         if constexpr (std::is_same_v<Scalar, double>)
-            return m_tmp_dcov;
+            return m_dz_features;
         else
-            return m_tmp_fcov;
+            return m_fz_features;
     }
 
-    template <typename Mat>
-    Matrix<typename Mat::Scalar, Dynamic, 1> eigenvalues_covariance(Mat& fourier_x, Mat& fourier_y) const;
-
-    template <typename VectorType, typename FeatureType>
-    double RIT_impl(
-        VectorType& x, VectorType& y, FeatureType& feat_x, FeatureType& feat_y, double sigma_x, double sigma_y) const;
-    template <bool contains_null, typename VectorType>
-    double RIT(int x_index, int y_index, VectorType& x, VectorType& y) const;
+    template <typename InputMatrix>
+    Matrix<typename InputMatrix::Scalar, Dynamic, Dynamic> fourier_features(InputMatrix& m,
+                                                                            const std::vector<int>& indices,
+                                                                            int num_features) const;
 
-    template <typename VectorType, typename MatType, typename FeatureType>
-    double TestWithZ_impl(VectorType& x,
-                          VectorType& y,
-                          MatType& z,
-                          FeatureType& feat_x,
-                          FeatureType& feat_y,
-                          FeatureType& feat_z,
-                          double sigma_x,
-                          double sigma_y,
-                          double sigma_z) const;
+    template <typename ArrowType>
+    std::shared_ptr<const Matrix<typename ArrowType::c_type, Dynamic, Dynamic>> cached_fourier_features(
+        FourierFeaturesCache<typename ArrowType::c_type>& cache,
+        const std::vector<int>& indices,
+        int num_features) const;
 
-    template <bool contains_null, typename VectorType>
-    double RSingleZ(int x_index, int y_index, int z_index, VectorType& x, VectorType& y, VectorType& z) const;
+    template <typename MatrixType>
+    double RIT(const MatrixType& feat_x, const MatrixType& feat_y) const;
 
-    template <bool contains_null, typename VectorType, typename MatType>
-    double RMultiZ(int x_index, int y_index, VectorType& x, VectorType& y, MatType& z) const;
+    template <typename MatrixType>
+    double TestWithZ(const MatrixType& feat_x, const MatrixType& feat_y, const MatrixType& feat_z) const;
 
     DataFrame m_df;
     int m_num_random_fourier_xy;
     int m_num_random_fourier_z;
-    // Cache fourier matrices and sigmas (double or float).
-    mutable MatrixXd m_dfourier_x;
-    mutable MatrixXd m_dfourier_y;
-    mutable MatrixXd m_dfourier_z;
-    mutable MatrixXd m_tmp_dcov;
-    VectorXd m_dsigma;
-    mutable MatrixXf m_ffourier_x;
-    mutable MatrixXf m_ffourier_y;
-    mutable MatrixXf m_ffourier_z;
-    mutable MatrixXf m_tmp_fcov;
-    VectorXf m_fsigma;
+    unsigned int m_seed;
+    // Columns (without null values) with zero variance.
+    std::vector<bool> m_constant;
+    // Cache fourier features (double or float).
+    mutable FourierFeaturesCache<double> m_dxy_features;
+    mutable FourierFeaturesCache<double> m_dz_features;
+    mutable FourierFeaturesCache<float> m_fxy_features;
+    mutable FourierFeaturesCache<float> m_fz_features;
 };
 
 template <typename InputMatrix, typename OutputMatrix>
 void random_fourier_features(InputMatrix& m,
                              typename InputMatrix::Scalar sigma,
                              int num_features,
-                             OutputMatrix& fourier_features) {
+                             OutputMatrix& fourier_features,
+                             std::mt19937& rng) {
     static_assert(std::is_same_v<typename InputMatrix::Scalar, typename OutputMatrix::Scalar>,
                   "Input/Output matrices must have the same type");
 
@@ -220,7 +259,6 @@ void random_fourier_features(InputMatrix& m,
     MatrixType W(m.cols(), num_features);
     VectorType b(num_features);
 
-    std::mt19937 rng(std::random_device{}());
     std::normal_distribution<Scalar> normal;
     for (auto j = 0; j < W.cols(); ++j) {
         for (auto i = 0; i < W.rows(); ++i) {
@@ -240,11 +278,12 @@ void random_fourier_features(InputMatrix& m,
     fourier_features = fourier_features * util::root_two<Scalar>;
 }
 
-template <typename Mat, typename TmpMat>
-Matrix<typename Mat::Scalar, Dynamic, 1> eigenvalues_covariance_impl(Mat& fourier_x, Mat& fourier_y, TmpMat& tmp_mat) {
+template <typename Mat>
+Matrix<typename Mat::Scalar, Dynamic, 1> eigenvalues_covariance(const Mat& fourier_x, const Mat& fourier_y) {
     using Scalar = typename Mat::Scalar;
     using MatrixType = Matrix<Scalar, Dynamic, Dynamic>;
 
+    MatrixType tmp_mat(fourier_x.rows(), fourier_x.cols() * fourier_y.cols());
     for (int i = 0; i < fourier_x.cols(); ++i) {
         tmp_mat.block(0, i * fourier_y.cols(), tmp_mat.rows(), fourier_y.cols()) =
             fourier_y.array().colwise() * fourier_x.col(i).array();
@@ -254,19 +293,6 @@ Matrix<typename Mat::Scalar, Dynamic, 1> eigenvalues_covariance_impl(Mat& fourie
     return eigen_solver.eigenvalues();
 }
 
-template <typename Mat>
-Matrix<typename Mat::Scalar, Dynamic, 1> RCoT::eigenvalues_covariance(Mat& fourier_x, Mat& fourier_y) const {
-    using Scalar = typename Mat::Scalar;
-    auto& cc = tmp_cov<Scalar>();
-
-    if (fourier_x.rows() != cc.rows()) {
-        auto tmp = cc.topRows(fourier_x.rows());
-        return eigenvalues_covariance_impl(fourier_x, fourier_y, tmp);
-    } else {
-        return eigenvalues_covariance_impl(fourier_x, fourier_y, cc);
-    }
-}
-
 template <typename VectorType>
 Matrix<typename VectorType::Scalar, Dynamic, 1> filter_positive_elements(const VectorType& v) {
     using Scalar = typename VectorType::Scalar;
@@ -284,21 +310,11 @@ Matrix<typename VectorType::Scalar, Dynamic, 1> filter_positive_elements(const V
     return res;
 }
 
-template <typename VectorType, typename FeatureType>
-double RCoT::RIT_impl(
-    VectorType& x, VectorType& y, FeatureType& feat_x, FeatureType& feat_y, double sigma_x, double sigma_y) const {
-    random_fourier_features(x, sigma_x, m_num_random_fourier_xy, feat_x);
-    random_fourier_features(y, sigma_y, m_num_random_fourier_xy, feat_y);
-
-    util::normalize_cols(feat_x);
-    util::normalize_cols(feat_y);
-
-    auto Cxy = util::cov(feat_x, feat_y);
-    auto sta = x.rows() * Cxy.squaredNorm();
-    auto eigs = eigenvalues_covariance(feat_x, feat_y);
-    auto pos_eigs = filter_positive_elements(eigs);
+template <typename VectorType, typename Scalar>
+double rcot_pvalue(const VectorType& eigenvalues, Scalar sta, bool use_hbe) {
+    auto pos_eigs = filter_positive_elements(eigenvalues);
 
-    if (pos_eigs.rows() < 4) {
+    if (use_hbe || pos_eigs.rows() < 4) {
         auto pvalue = util::hbe_complement(pos_eigs, sta);
         if (pvalue < 0) return 0;
         return pvalue;
@@ -315,136 +331,78 @@ double RCoT::RIT_impl(
     }
 }
 
-template <bool contains_null, typename VectorType>
-double RCoT::RIT(int x_index, int y_index, VectorType& x, VectorType& y) const {
-    using Scalar = typename VectorType::Scalar;
+template <typename InputMatrix>
+Matrix<typename InputMatrix::Scalar, Dynamic, Dynamic> RCoT::fourier_features(InputMatrix& m,
+                                                                              const std::vector<int>& indices,
+                                                                              int num_features) const {
+    using Scalar = typename InputMatrix::Scalar;
+    using MatrixType = Matrix<Scalar, Dynamic, Dynamic>;
 
-    if constexpr (contains_null) {
-        Scalar sigma_x = rf_sigma_impl(x);
-        Scalar sigma_y = rf_sigma_impl(y);
+    // The random projection only depends on the seed and the variables, so the features of a variable are the same
+    // regardless of the test (or the thread) that computes them.
+    std::vector<unsigned int> seed_data{m_seed, static_cast<unsigned int>(num_features)};
+    seed_data.insert(seed_data.end(), indices.begin(), indices.end());
+    std::seed_seq seq(seed_data.begin(), seed_data.end());
+    std::mt19937 rng(seq);
+
+    MatrixType features(m.rows(), num_features);
+    random_fourier_features(m, rf_sigma_impl(m), num_features, features, rng);
+    util::normalize_cols(features);
+    return features;
+}
+
+template <typename ArrowType>
+std::shared_ptr<const Matrix<typename ArrowType::c_type, Dynamic, Dynamic>> RCoT::cached_fourier_features(
+    FourierFeaturesCache<typename ArrowType::c_type>& cache,
+    const std::vector<int>& indices,
+    int num_features) const {
+    using MatrixType = Matrix<typename ArrowType::c_type, Dynamic, Dynamic>;
 
-        auto feat_x = fourier_x<Scalar>().topRows(x.rows());
-        auto feat_y = fourier_y<Scalar>().topRows(y.rows());
+    if (auto features = cache.find(indices)) return features;
 
-        return RIT_impl(x, y, feat_x, feat_y, sigma_x, sigma_y);
+    std::shared_ptr<const MatrixType> features;
+    if (indices.size() == 1) {
+        auto v = m_df.to_eigen<false, ArrowType, false>(indices[0]);
+        features = std::make_shared<const MatrixType>(fourier_features(*v, indices, num_features));
     } else {
-        Scalar sigma_x = rf_sigma<Scalar>(x_index);
-        Scalar sigma_y = rf_sigma<Scalar>(y_index);
+        auto m = m_df.to_eigen<false, ArrowType, false>(indices);
+        features = std::make_shared<const MatrixType>(fourier_features(*m, indices, num_features));
+    }
 
-        auto& feat_x = fourier_x<Scalar>();
-        auto& feat_y = fourier_y<Scalar>();
+    return cache.insert(indices, std::move(features));
+}
 
-        return RIT_impl(x, y, feat_x, feat_y, sigma_x, sigma_y);
-    }
+template <typename MatrixType>
+double RCoT::RIT(const MatrixType& feat_x, const MatrixType& feat_y) const {
+    auto Cxy = util::cov(feat_x, feat_y);
+    auto sta = feat_x.rows() * Cxy.squaredNorm();
+    auto eigs = eigenvalues_covariance(feat_x, feat_y);
+    return rcot_pvalue(eigs, sta, false);
 }
 
-template <typename VectorType, typename MatType, typename FeatureType>
-double RCoT::TestWithZ_impl(VectorType& x,
-                            VectorType& y,
-                            MatType& z,
-                            FeatureType& feat_x,
-                            FeatureType& feat_y,
-                            FeatureType& feat_z,
-                            double sigma_x,
-                            double sigma_y,
-                            double sigma_z) const {
-    random_fourier_features(x, sigma_x, m_num_random_fourier_xy, feat_x);
-    random_fourier_features(y, sigma_y, m_num_random_fourier_xy, feat_y);
-    random_fourier_features(z, sigma_z, m_num_random_fourier_z, feat_z);
-
-    util::normalize_cols(feat_x);
-    util::normalize_cols(feat_y);
-    util::normalize_cols(feat_z);
+template <typename MatrixType>
+double RCoT::TestWithZ(const MatrixType& feat_x, const MatrixType& feat_y, const MatrixType& feat_z) const {
+    using ResultType = Matrix<typename MatrixType::Scalar, Dynamic, Dynamic>;
 
     auto Cxy = util::cov(feat_x, feat_y);
 
-    auto Czz = util::cov(feat_z);
+    ResultType Czz = util::cov(feat_z);
     Czz.diagonal().array() += 1e-10;
 
-    auto i_Czz = Czz.inverse();
+    ResultType i_Czz = Czz.inverse();
 
     auto Cxz = util::cov(feat_x, feat_z);
     auto Czy = util::cov(feat_z, feat_y);
 
-    auto z_i_Czz = feat_z * i_Czz;
-    feat_x = feat_x - z_i_Czz * Cxz.transpose();
-    feat_y = feat_y - z_i_Czz * Czy;
+    ResultType z_i_Czz = feat_z * i_Czz;
+    ResultType res_x = feat_x - z_i_Czz * Cxz.transpose();
+    ResultType res_y = feat_y - z_i_Czz * Czy;
 
     auto Cxy_z = Cxy - Cxz * i_Czz * Czy;
 
-    auto sta = x.rows() * Cxy_z.squaredNorm();
-    auto eigs = eigenvalues_covariance(feat_x, feat_y);
-    auto pos_eigs = filter_positive_elements(eigs);
-
-    if (m_num_random_fourier_z == 1 || pos_eigs.rows() < 4) {
-        auto pvalue = util::hbe_complement(pos_eigs, sta);
-        if (pvalue < 0) return 0;
-        return pvalue;
-    }
-
-    try {
-        auto pvalue = util::lpb4_complement(pos_eigs, sta);
-        if (pvalue < 0) return 0;
-        return pvalue;
-    } catch (std::exception&) {
-        auto pvalue = util::hbe_complement(pos_eigs, sta);
-        if (pvalue < 0) return 0;
-        return pvalue;
-    }
-}
-
-template <bool contains_null, typename VectorType>
-double RCoT::RSingleZ(int x_index, int y_index, int z_index, VectorType& x, VectorType& y, VectorType& z) const {
-    using Scalar = typename VectorType::Scalar;
-
-    if constexpr (contains_null) {
-        Scalar sigma_x = rf_sigma_impl(x);
-        Scalar sigma_y = rf_sigma_impl(y);
-        Scalar sigma_z = rf_sigma_impl(z);
-
-        auto feat_x = fourier_x<Scalar>().topRows(x.rows());
-        auto feat_y = fourier_y<Scalar>().topRows(y.rows());
-        auto feat_z = fourier_z<Scalar>().topRows(z.rows());
-
-        return TestWithZ_impl(x, y, z, feat_x, feat_y, feat_z, sigma_x, sigma_y, sigma_z);
-    } else {
-        Scalar sigma_x = rf_sigma<Scalar>(x_index);
-        Scalar sigma_y = rf_sigma<Scalar>(y_index);
-        Scalar sigma_z = rf_sigma<Scalar>(z_index);
-
-        auto& feat_x = fourier_x<Scalar>();
-        auto& feat_y = fourier_y<Scalar>();
-        auto& feat_z = fourier_z<Scalar>();
-
-        return TestWithZ_impl(x, y, z, feat_x, feat_y, feat_z, sigma_x, sigma_y, sigma_z);
-    }
-}
-
-template <bool contains_null, typename VectorType, typename MatType>
-double RCoT::RMultiZ(int x_index, int y_index, VectorType& x, VectorType& y, MatType& z) const {
-    using Scalar = typename VectorType::Scalar;
-
-    if constexpr (contains_null) {
-        Scalar sigma_x = rf_sigma_impl(x);
-        Scalar sigma_y = rf_sigma_impl(y);
-        Scalar sigma_z = rf_sigma_impl(z);
-
-        auto feat_x = fourier_x<Scalar>().topRows(x.rows());
-        auto feat_y = fourier_y<Scalar>().topRows(y.rows());
-        auto feat_z = fourier_z<Scalar>().topRows(z.rows());
-
-        return TestWithZ_impl(x, y, z, feat_x, feat_y, feat_z, sigma_x, sigma_y, sigma_z);
-    } else {
-        Scalar sigma_x = rf_sigma<Scalar>(x_index);
-        Scalar sigma_y = rf_sigma<Scalar>(y_index);
-        Scalar sigma_z = rf_sigma_impl(z);
-
-        auto& feat_x = fourier_x<Scalar>();
-        auto& feat_y = fourier_y<Scalar>();
-        auto& feat_z = fourier_z<Scalar>();
-
-        return TestWithZ_impl(x, y, z, feat_x, feat_y, feat_z, sigma_x, sigma_y, sigma_z);
-    }
+    auto sta = feat_x.rows() * Cxy_z.squaredNorm();
+    auto eigs = eigenvalues_covariance(res_x, res_y);
+    return rcot_pvalue(eigs, sta, m_num_random_fourier_z == 1);
 }
 
 using DynamicRCoT = DynamicIndependenceTestAdaptator<RCoT>;
@@ -6,18 +6,23 @@ using boost::math::students_t_distribution;
 
 namespace learning::independences::continuous {
 
-double cor_pvalue(double cor, int df) {
+double cor_pvalue(double cor, double df) {
     double statistic = cor * sqrt(df) / sqrt(1 - cor * cor);
-    students_t_distribution tdist(static_cast<double>(df));
+    students_t_distribution tdist(df);
     return 2 * cdf(complement(tdist, fabs(statistic)));
 }
 
 double LinearCorrelation::pvalue_cached(const std::string& v1, const std::string& v2) const {
     double cor = cor_0cond(m_cov, cached_index(v1), cached_index(v2));
-    return cor_pvalue(cor, m_df->num_rows() - 2);
+    return cor_pvalue(cor, m_total_weight - 2);
 }
 
 double LinearCorrelation::pvalue_impl(const std::string& v1, const std::string& v2) const {
+    if (m_chunks.requires_moments()) {
+        auto moments = m_chunks.moments({v1, v2});
+        return cor_pvalue(cor_0cond(moments.sse, 0, 1), moments.total_weight - 2);
+    }
+
     auto [cor, df] = [this, &v1, &v2]() {
         switch (m_df.col(v1)->type_id()) {
             case Type::DOUBLE: {
@@ -42,10 +47,15 @@ double LinearCorrelation::pvalue_impl(const std::string& v1, const std::string&
 
 double LinearCorrelation::pvalue_cached(const std::string& v1, const std::string& v2, const std::string& ev) const {
     double cor = cor_1cond(m_cov, cached_index(v1), cached_index(v2), cached_index(ev));
-    return cor_pvalue(cor, m_df->num_rows() - 3);
+    return cor_pvalue(cor, m_total_weight - 3);
 }
 
 double LinearCorrelation::pvalue_impl(const std::string& v1, const std::string& v2, const std::string& ev) const {
+    if (m_chunks.requires_moments()) {
+        auto moments = m_chunks.moments({v1, v2, ev});
+        return cor_pvalue(cor_general(moments.sse), moments.total_weight - 3);
+    }
+
     auto [cor, df] = [this, &v1, &v2, &ev]() {
         switch (m_df.col(v1)->type_id()) {
             case Type::DOUBLE: {
@@ -91,12 +101,20 @@ double LinearCorrelation::pvalue_cached(const std::string& v1,
     }
 
     double cor = cor_general(cov);
-    return cor_pvalue(cor, m_df->num_rows() - 2 - k);
+    return cor_pvalue(cor, m_total_weight - 2 - k);
 }
 
 double LinearCorrelation::pvalue_impl(const std::string& v1,
                                       const std::string& v2,
                                       const std::vector<std::string>& ev) const {
+    if (m_chunks.requires_moments()) {
+        std::vector<std::string> columns{v1, v2};
+        columns.insert(columns.end(), ev.begin(), ev.end());
+
+        auto moments = m_chunks.moments(columns);
+        return cor_pvalue(cor_general(moments.sse), moments.total_weight - 2 - static_cast<double>(ev.size()));
+    }
+
     auto [cor, df] = [this, &v1, &v2, &ev]() {
         int k = ev.size();
         switch (m_df.col(v1)->type_id()) {
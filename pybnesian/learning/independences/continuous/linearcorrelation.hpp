@@ -3,16 +3,17 @@
 
 #include <algorithm>
 #include <dataset/dataset.hpp>
+#include <dataset/chunked_dataframe.hpp>
 #include <learning/independences/independence.hpp>
 #include <util/math_constants.hpp>
 
-using dataset::DataFrame;
+using dataset::DataFrame, dataset::ChunkedDataFrame;
 using Eigen::LLT, Eigen::Ref;
 using learning::independences::IndependenceTest;
 
 namespace learning::independences::continuous {
 
-double cor_pvalue(double cor, int df);
+double cor_pvalue(double cor, double df);
 
 template <typename EigenMat>
 double cor_0cond(const EigenMat& cov, int v1, int v2) {
@@ -67,18 +68,32 @@ double cor_general(EigenMatrix& cov) {
 
 class LinearCorrelation : public IndependenceTest {
 public:
-    LinearCorrelation(const DataFrame& df) : m_df(df), m_cached_cov(false), m_indices(), m_cov() {
-        auto continuous_indices = df.continuous_columns();
+    LinearCorrelation(const DataFrame& df) : LinearCorrelation(ChunkedDataFrame(df)) {}
+    // The covariances are computed from the moments merged over the chunks.
+    LinearCorrelation(const ChunkedDataFrame& df)
+        : m_df(df.schema_df()), m_chunks(df), m_cached_cov(false), m_indices(), m_cov(), m_total_weight(0) {
+        auto continuous_indices = m_df.continuous_columns();
 
         if (continuous_indices.size() < 2) {
             throw std::invalid_argument("DataFrame does not contain enough continuous columns.");
         }
 
-        if (m_df.null_count(continuous_indices) == 0) {
+        if (m_chunks.null_count(continuous_indices) == 0) {
             m_cached_cov = true;
+            m_total_weight = m_chunks.total_weight(continuous_indices);
             for (int i = 0, size = continuous_indices.size(); i < size; ++i) {
                 m_indices.insert(std::make_pair(m_df->column_name(continuous_indices[i]), i));
             }
+
+            if (m_chunks.requires_moments()) {
+                std::vector<std::string> continuous_names;
+                for (auto i : continuous_indices) continuous_names.push_back(m_df.name(i));
+
+                auto moments = m_chunks.moments(continuous_names);
+                m_cov = moments.sse / (moments.total_weight - 1);
+                return;
+            }
+
             switch (m_df.same_type(continuous_indices)->id()) {
                 case Type::DOUBLE:
                     m_cov = *(m_df.cov<arrow::DoubleType, false>(continuous_indices).release());
@@ -93,6 +108,8 @@ public:
     }
 
     double pvalue(const std::string& v1, const std::string& v2) const override {
+        auto timer = pvalue_timer("LinearCorrelation", 0);
+
         if (m_cached_cov)
             return pvalue_cached(v1, v2);
         else
@@ -100,6 +117,8 @@ public:
     }
 
     double pvalue(const std::string& v1, const std::string& v2, const std::string& ev) const override {
+        auto timer = pvalue_timer("LinearCorrelation", 1);
+
         if (m_cached_cov)
             return pvalue_cached(v1, v2, ev);
         else
@@ -107,13 +126,15 @@ public:
     }
 
     double pvalue(const std::string& v1, const std::string& v2, const std::vector<std::string>& ev) const override {
+        auto timer = pvalue_timer("LinearCorrelation", ev.size());
+
         if (m_cached_cov)
             return pvalue_cached(v1, v2, ev);
         else
             return pvalue_impl(v1, v2, ev);
     }
 
-    int num_variables() const override { return m_df->num_columns(); }
+    int num_variables() const override { return m_df.num_variables(); }
 
     std::vector<std::string> variable_names() const override { return m_df.column_names(); }
 
@@ -123,6 +144,8 @@ public:
 
     bool has_variables(const std::vector<std::string>& cols) const override { return m_df.has_columns(cols); }
 
+    std::string ToString() const override { return "LinearCorrelation"; }
+
 private:
     int cached_index(int v) const {
         auto it = m_indices.find(m_df->column_name(v));
@@ -148,9 +171,12 @@ private:
     double pvalue_impl(const std::string& v1, const std::string& v2, const std::vector<std::string>& ev) const;
 
     const DataFrame m_df;
+    const ChunkedDataFrame m_chunks;
     bool m_cached_cov;
     std::unordered_map<std::string, int> m_indices;
     MatrixXd m_cov;
+    // Number of rows (or sum of weights) used to compute m_cov.
+    double m_total_weight;
 };
 
 using DynamicLinearCorrelation = DynamicIndependenceTestAdaptator<LinearCorrelation>;
@@ -151,6 +151,8 @@ double KMutualInformation::mi(const std::string& x, const std::string& y, const
 }
 
 double KMutualInformation::pvalue(const std::string& x, const std::string& y) const {
+    auto timer = pvalue_timer("KMutualInformation", 0);
+
     auto value = mi(x, y);
 
     auto shuffled_df = m_ranked_df.loc(Copy(x), y);
@@ -171,6 +173,8 @@ double KMutualInformation::pvalue(const std::string& x, const std::string& y) co
 }
 
 double KMutualInformation::pvalue(const std::string& x, const std::string& y, const std::string& z) const {
+    auto timer = pvalue_timer("KMutualInformation", 1);
+
     auto original_mi = mi(x, y, z);
     auto z_df = m_df.loc(z);
     auto shuffled_df = m_ranked_df.loc(Copy(x), y, z);
@@ -180,6 +184,8 @@ double KMutualInformation::pvalue(const std::string& x, const std::string& y, co
 }
 
 double KMutualInformation::pvalue(const std::string& x, const std::string& y, const std::vector<std::string>& z) const {
+    auto timer = pvalue_timer("KMutualInformation", z.size());
+
     auto original_mi = mi(x, y, z);
     auto z_df = m_df.loc(z);
     auto shuffled_df = m_ranked_df.loc(Copy(x), y, z);
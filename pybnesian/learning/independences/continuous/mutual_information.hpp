@@ -74,7 +74,7 @@ class KMutualInformation : public IndependenceTest {
 public:
     KMutualInformation(
         DataFrame df, int k, unsigned int seed = std::random_device{}(), int shuffle_neighbors = 5, int samples = 1000)
-        : m_df(df),
+        : m_df(check_unweighted(df, "KMutualInformation")),
           m_ranked_df(rank_data<arrow::FloatType>(df)),
           m_k(k),
           m_seed(seed),
@@ -106,6 +106,12 @@ public:
 
     bool has_variables(const std::vector<std::string>& cols) const override { return m_df.has_columns(cols); }
 
+    std::string ToString() const override {
+        return "KMutualInformation(k=" + std::to_string(m_k) + ", seed=" + std::to_string(m_seed) +
+               ", shuffle_neighbors=" + std::to_string(m_shuffle_neighbors) + ", samples=" + std::to_string(m_samples) +
+               ")";
+    }
+
 private:
     DataFrame m_df;
     DataFrame m_ranked_df;
@@ -6,9 +6,11 @@
 namespace learning::independences::discrete {
 
 double ChiSquare::pvalue(const std::string& v1, const std::string& v2) const {
+    auto timer = pvalue_timer("ChiSquare", 0);
+
     std::vector<std::string> dummy_v2{v2};
     auto [cardinality, strides] = factors::discrete::create_cardinality_strides(m_df, v1, dummy_v2);
-    auto joint_counts = factors::discrete::joint_counts(m_df, v1, dummy_v2, cardinality, strides);
+    auto joint_counts = factors::discrete::weighted_joint_counts(m_chunks, v1, dummy_v2, cardinality, strides);
 
     auto v1_marg = factors::discrete::marginal_counts(joint_counts, 0, cardinality, strides);
     auto v2_marg = factors::discrete::marginal_counts(joint_counts, 1, cardinality, strides);
@@ -18,7 +20,7 @@ double ChiSquare::pvalue(const std::string& v1, const std::string& v2) const {
     double statistic = 0;
     for (int i = 0; i < cardinality(0); ++i) {
         for (int j = 0; j < cardinality(1); ++j) {
-            auto expected = static_cast<double>(v1_marg(i) * v2_marg(j)) * inv_obs;
+            auto expected = v1_marg(i) * v2_marg(j) * inv_obs;
 
             if (expected != 0) {
                 auto index = i + j * strides(1);
@@ -36,9 +38,11 @@ double ChiSquare::pvalue(const std::string& v1, const std::string& v2) const {
 }
 
 double ChiSquare::pvalue(const std::string& v1, const std::string& v2, const std::string& ev) const {
+    auto timer = pvalue_timer("ChiSquare", 1);
+
     std::vector<std::string> dummy_vars{v2, ev};
     auto [cardinality, strides] = factors::discrete::create_cardinality_strides(m_df, v1, dummy_vars);
-    auto joint_counts = factors::discrete::joint_counts(m_df, v1, dummy_vars, cardinality, strides);
+    auto joint_counts = factors::discrete::weighted_joint_counts(m_chunks, v1, dummy_vars, cardinality, strides);
 
     auto evidence_marg = factors::discrete::marginal_counts(joint_counts, 2, cardinality, strides);
 
@@ -60,7 +64,7 @@ double ChiSquare::pvalue(const std::string& v1, const std::string& v2, const std
 
         for (int i = 0; i < cardinality(0); ++i) {
             for (int j = 0; j < cardinality(1); ++j) {
-                auto expected = static_cast<double>(v1_marg(i) * v2_marg(j)) * inv_obs;
+                auto expected = v1_marg(i) * v2_marg(j) * inv_obs;
 
                 if (expected != 0) {
                     auto index = offset + i + j * strides(1);
@@ -79,12 +83,14 @@ double ChiSquare::pvalue(const std::string& v1, const std::string& v2, const std
 }
 
 double ChiSquare::pvalue(const std::string& v1, const std::string& v2, const std::vector<std::string>& ev) const {
+    auto timer = pvalue_timer("ChiSquare", ev.size());
+
     std::vector<std::string> dummy_vars{v2};
     dummy_vars.reserve(ev.size() + 1);
     dummy_vars.insert(dummy_vars.end(), ev.begin(), ev.end());
 
     auto [cardinality, strides] = factors::discrete::create_cardinality_strides(m_df, v1, dummy_vars);
-    auto joint_counts = factors::discrete::joint_counts(m_df, v1, dummy_vars, cardinality, strides);
+    auto joint_counts = factors::discrete::weighted_joint_counts(m_chunks, v1, dummy_vars, cardinality, strides);
 
     auto evidence_configurations = cardinality.tail(ev.size()).prod();
     auto vars_configurations = cardinality(0) * cardinality(1);
@@ -94,9 +100,9 @@ double ChiSquare::pvalue(const std::string& v1, const std::string& v2, const std
     for (auto k = 0; k < evidence_configurations; ++k) {
         auto offset = k * vars_configurations;
 
-        int total_sum = 0;
-        auto marginal_v1 = VectorXi::Zero(cardinality(0)).eval();
-        auto marginal_v2 = VectorXi::Zero(cardinality(1)).eval();
+        double total_sum = 0;
+        auto marginal_v1 = VectorXd::Zero(cardinality(0)).eval();
+        auto marginal_v2 = VectorXd::Zero(cardinality(1)).eval();
 
         for (auto i = 0; i < cardinality(0); ++i) {
             for (auto j = 0; j < cardinality(1); ++j) {
@@ -109,11 +115,11 @@ double ChiSquare::pvalue(const std::string& v1, const std::string& v2, const std
 
         if (total_sum == 0) continue;
 
-        auto inv_obs = 1. / static_cast<double>(total_sum);
+        auto inv_obs = 1. / total_sum;
 
         for (auto i = 0; i < cardinality(0); ++i) {
             for (auto j = 0; j < cardinality(1); ++j) {
-                auto expected = static_cast<double>(marginal_v1(i) * marginal_v2(j)) * inv_obs;
+                auto expected = marginal_v1(i) * marginal_v2(j) * inv_obs;
 
                 if (expected != 0) {
                     auto c = joint_counts(offset + i + j * strides(1));
@@ -421,6 +421,8 @@ double compute_pvalue(double original_mi, std::vector<double>& permutation_stats
 }
 
 double MixedKMutualInformation::pvalue(const std::string& x, const std::string& y) const {
+    auto timer = pvalue_timer("MixedKMutualInformation", 0);
+
     std::mt19937 rng{m_seed};
     std::vector<bool> is_discrete_column;
     bool discrete_present = false;
@@ -484,6 +486,8 @@ double MixedKMutualInformation::pvalue(const std::string& x, const std::string&
 }
 
 double MixedKMutualInformation::pvalue(const std::string& x, const std::string& y, const std::string& z) const {
+    auto timer = pvalue_timer("MixedKMutualInformation", 1);
+
     auto subset_df = m_scaled_df.loc(x, y, z);
     std::vector<bool> is_discrete_column;
     bool discrete_present = false;
@@ -515,6 +519,8 @@ double MixedKMutualInformation::pvalue(const std::string& x, const std::string&
 double MixedKMutualInformation::pvalue(const std::string& x,
                                        const std::string& y,
                                        const std::vector<std::string>& z) const {
+    auto timer = pvalue_timer("MixedKMutualInformation", z.size());
+
     auto subset_df = m_scaled_df.loc(x, y, z);
     std::vector<bool> is_discrete_column;
     bool discrete_present = false;
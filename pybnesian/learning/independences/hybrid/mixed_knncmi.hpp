@@ -40,13 +40,14 @@ public:
                          bool gamma_approx = true,
                          bool adaptive_k = true,
                          int tree_leafsize = 16)
-        : m_df(df),
+        : m_df(check_unweighted(df, "MixedKMutualInformation")),
           m_scaled_df(scale_data(df, scaling)),
           m_datatype(),
           m_k(k),
           m_seed(seed),
           m_shuffle_neighbors(shuffle_neighbors),
           m_samples(samples),
+          m_scaling(scaling),
           m_gamma_approx(gamma_approx),
           m_adaptive_k(adaptive_k),
           m_tree_leafsize(tree_leafsize) {
@@ -71,6 +72,14 @@ public:
 
     bool has_variables(const std::vector<std::string>& cols) const override { return m_df.has_columns(cols); }
 
+    std::string ToString() const override {
+        return "MixedKMutualInformation(k=" + std::to_string(m_k) + ", seed=" + std::to_string(m_seed) +
+               ", shuffle_neighbors=" + std::to_string(m_shuffle_neighbors) + ", samples=" + std::to_string(m_samples) +
+               ", scaling=" + m_scaling + ", gamma_approx=" + (m_gamma_approx ? "true" : "false") +
+               ", adaptive_k=" + (m_adaptive_k ? "true" : "false") + ", tree_leafsize=" +
+               std::to_string(m_tree_leafsize) + ")";
+    }
+
 private:
     double shuffled_pvalue(double original_mi,
                            int k,
@@ -92,6 +101,7 @@ private:
     unsigned int m_seed;
     int m_shuffle_neighbors;
     int m_samples;
+    std::string m_scaling;
     bool m_gamma_approx;
     bool m_adaptive_k;
     int m_tree_leafsize;
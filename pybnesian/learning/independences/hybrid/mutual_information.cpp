@@ -1127,6 +1127,8 @@ double MutualInformation::calculate_df(const std::string& x, const std::string&
 }
 
 double MutualInformation::pvalue(const std::string& x, const std::string& y) const {
+    auto timer = pvalue_timer("MutualInformation", 0);
+
     auto mi_value = mi(x, y);
 
     // Multiply by 2*N to obtain 2*N*MI(X; Y). This follows a X^2 distribution.
@@ -1386,6 +1388,8 @@ double MutualInformation::calculate_df(const std::string& x, const std::string&
 }
 
 double MutualInformation::pvalue(const std::string& x, const std::string& y, const std::string& z) const {
+    auto timer = pvalue_timer("MutualInformation", 1);
+
     auto mi_value = mi(x, y, z);
     // Multiply by 2*N to obtain 2*N*MI(X; Y). This follows a X^2 distribution.
     mi_value *= 2 * m_df.valid_rows(x, y, z);
@@ -1747,6 +1751,8 @@ double MutualInformation::calculate_df(const std::string& x,
 }
 
 double MutualInformation::pvalue(const std::string& x, const std::string& y, const std::vector<std::string>& z) const {
+    auto timer = pvalue_timer("MutualInformation", z.size());
+
     std::vector<std::string> discrete_z;
     std::vector<std::string> continuous_z;
 
@@ -11,7 +11,8 @@ namespace learning::independences::hybrid {
 
 class MutualInformation : public IndependenceTest {
 public:
-    MutualInformation(const DataFrame& df, bool asymptotic_df = true) : m_df(df), m_asymptotic_df(asymptotic_df) {
+    MutualInformation(const DataFrame& df, bool asymptotic_df = true)
+        : m_df(check_unweighted(df, "MutualInformation")), m_asymptotic_df(asymptotic_df) {
         for (int i = 0; i < m_df->num_columns(); ++i) {
             if (!m_df.is_discrete(i) && !m_df.is_continuous(i))
                 throw std::invalid_argument("Wrong data type (" + m_df.col(i)->type()->ToString() + ") for column " +
@@ -33,6 +34,10 @@ public:
     bool has_variables(const std::string& name) const override { return m_df.has_columns(name); }
     bool has_variables(const std::vector<std::string>& cols) const override { return m_df.has_columns(cols); }
 
+    std::string ToString() const override {
+        return std::string("MutualInformation(asymptotic_df=") + (m_asymptotic_df ? "true" : "false") + ")";
+    }
+
 private:
     double mi_discrete(const std::string& x, const std::string& y) const;
     template <bool contains_null, typename IndicesArrowType, typename ContinuousArrowType>
@@ -1,17 +1,34 @@
 #ifndef PYBNESIAN_LEARNING_INDEPENDENCES_INDEPENDENCE_HPP
 #define PYBNESIAN_LEARNING_INDEPENDENCES_INDEPENDENCE_HPP
 
+#include <stdexcept>
 #include <string>
 #include <vector>
 #include <dataset/dataset.hpp>
 #include <dataset/dynamic_dataset.hpp>
 #include <util/util_types.hpp>
+#include <util/profiling.hpp>
 
 using dataset::DataFrame, dataset::DynamicDataFrame, dataset::DynamicVariable, dataset::DynamicAdaptator;
 using util::ArcStringVector;
 
 namespace learning::independences {
 
+// Times a p-value computation of the test test_name. The measurements are grouped by the size of the conditioning set.
+inline util::profiling::ScopedTimer pvalue_timer(const char* test_name, size_t conditioning_size) {
+    return util::profiling::ScopedTimer([test_name, conditioning_size]() {
+        return std::string("ci_test/") + test_name + "/" + std::to_string(conditioning_size);
+    });
+}
+
+// Returns df if it does not have frequency weights. The tests that cannot weight the instances call this function in
+// their constructors, so a weighted DataFrame is not silently used as if each row had weight 1.
+inline const DataFrame& check_unweighted(const DataFrame& df, const char* test_name) {
+    if (df.has_weights())
+        throw std::invalid_argument(std::string(test_name) + " does not support DataFrames with weights.");
+    return df;
+}
+
 class IndependenceTest {
 public:
     using int_iterator = typename std::vector<int>::const_iterator;
@@ -28,6 +45,10 @@ public:
     virtual const std::string& name(int i) const = 0;
     virtual bool has_variables(const std::string& name) const = 0;
     virtual bool has_variables(const std::vector<std::string>& cols) const = 0;
+
+    // Description of the test and every parameter that changes its p-values. It identifies the saved results of a
+    // CachedIndependenceTest.
+    virtual std::string ToString() const { return "IndependenceTest"; }
 };
 
 class DynamicIndependenceTest {
@@ -1,8 +1,12 @@
+#include <algorithm>
+#include <cstring>
+#include <numeric>
 #include <models/BayesianNetwork.hpp>
 #include <models/SemiparametricBN.hpp>
 #include <learning/scores/scores.hpp>
 #include <learning/operators/operators.hpp>
 #include <util/validate_whitelists.hpp>
+#include <util/arrow_macros.hpp>
 
 using models::BayesianNetworkType, models::SemiparametricBNType;
 
@@ -16,6 +20,71 @@ std::shared_ptr<Operator> AddArc::opposite(const ConditionalBayesianNetworkBase&
     return opposite(static_cast<const BayesianNetworkBase&>(m));
 }
 
+void OperatorTable::sort_by_delta(int k) {
+    std::vector<size_t> order(size());
+    std::iota(order.begin(), order.end(), 0);
+
+    auto by_delta = [this](size_t i1, size_t i2) { return m_delta[i1] > m_delta[i2]; };
+    if (k >= 0 && static_cast<size_t>(k) < order.size()) {
+        std::partial_sort(order.begin(), order.begin() + k, order.end(), by_delta);
+        order.resize(k);
+    } else {
+        std::stable_sort(order.begin(), order.end(), by_delta);
+    }
+
+    auto permute = [&order](auto& v) {
+        std::remove_reference_t<decltype(v)> sorted;
+        sorted.reserve(order.size());
+        for (auto i : order) sorted.push_back(std::move(v[i]));
+        v = std::move(sorted);
+    };
+
+    permute(m_type);
+    permute(m_source);
+    permute(m_target);
+    permute(m_node_type);
+    permute(m_delta);
+}
+
+DataFrame OperatorTable::to_dataframe() const {
+    auto n = static_cast<int64_t>(size());
+
+    arrow::StringBuilder type_builder, source_builder, target_builder, node_type_builder;
+    arrow::DoubleBuilder delta_builder;
+
+    for (int64_t i = 0; i < n; ++i) {
+        bool change_node_type = std::strcmp(m_type[i], "ChangeNodeType") == 0;
+
+        RAISE_STATUS_ERROR(type_builder.Append(m_type[i]));
+        RAISE_STATUS_ERROR(source_builder.Append(m_source[i]));
+
+        if (change_node_type) {
+            RAISE_STATUS_ERROR(target_builder.AppendNull());
+            RAISE_STATUS_ERROR(node_type_builder.Append(m_node_type[i]));
+        } else {
+            RAISE_STATUS_ERROR(target_builder.Append(m_target[i]));
+            RAISE_STATUS_ERROR(node_type_builder.AppendNull());
+        }
+    }
+
+    RAISE_STATUS_ERROR(delta_builder.AppendValues(m_delta.data(), n));
+
+    std::vector<Array_ptr> columns(5);
+    RAISE_STATUS_ERROR(type_builder.Finish(&columns[0]));
+    RAISE_STATUS_ERROR(source_builder.Finish(&columns[1]));
+    RAISE_STATUS_ERROR(target_builder.Finish(&columns[2]));
+    RAISE_STATUS_ERROR(node_type_builder.Finish(&columns[3]));
+    RAISE_STATUS_ERROR(delta_builder.Finish(&columns[4]));
+
+    auto schema = arrow::schema({arrow::field("type", arrow::utf8()),
+                                 arrow::field("source", arrow::utf8()),
+                                 arrow::field("target", arrow::utf8()),
+                                 arrow::field("node_type", arrow::utf8()),
+                                 arrow::field("delta", arrow::float64())});
+
+    return DataFrame(arrow::RecordBatch::Make(schema, n, columns));
+}
+
 void ArcOperatorSet::update_valid_ops(const BayesianNetworkBase& model) {
     int num_nodes = model.num_nodes();
 
@@ -97,6 +166,39 @@ double cache_score_operation(const BayesianNetworkBase& model,
     }
 }
 
+// Version of cache_score_operation() with the indices of the nodes, so the local scores of the operator are computed
+// without the names of the parents. columns is the Score::node_columns() of the model.
+double cache_score_operation(const BayesianNetworkBase& model,
+                             const Score& score,
+                             const NodeColumns& columns,
+                             int source,
+                             int target,
+                             util::ParentSet& parents_target,
+                             double source_cached_score,
+                             double target_cached_score) {
+    if (std::find(parents_target.begin(), parents_target.end(), source) != parents_target.end()) {
+        util::swap_remove_v(parents_target, source);
+        auto d = score.local_score(model, columns, target, parents_target) - target_cached_score;
+        parents_target.push_back(source);
+        return d;
+    } else if (model.has_arc(model.name(target), model.name(source))) {
+        auto new_parents_source = model.parent_indices(source);
+        util::swap_remove_v(new_parents_source, target);
+
+        parents_target.push_back(source);
+        double d = score.local_score(model, columns, source, new_parents_source) +
+                   score.local_score(model, columns, target, parents_target) - source_cached_score -
+                   target_cached_score;
+        parents_target.pop_back();
+        return d;
+    } else {
+        parents_target.push_back(source);
+        double d = score.local_score(model, columns, target, parents_target) - target_cached_score;
+        parents_target.pop_back();
+        return d;
+    }
+}
+
 void ArcOperatorSet::cache_scores(const BayesianNetworkBase& model, const Score& score) {
     if (!score.compatible_bn(model)) {
         throw std::invalid_argument("BayesianNetwork is not compatible with the score.");
@@ -109,23 +211,27 @@ void ArcOperatorSet::cache_scores(const BayesianNetworkBase& model, const Score&
     }
 
     update_valid_ops(model);
+    m_node_columns = score.node_columns(model);
 
     auto bn_type = model.type();
     for (const auto& target_node : model.nodes()) {
-        std::vector<std::string> new_parents_target = model.parents(target_node);
-        int target_collapsed = model.collapsed_index(target_node);
+        int target_index = model.index(target_node);
+        int target_collapsed = model.collapsed_from_index(target_index);
+        auto new_parents_target = model.parent_indices(target_index);
         for (const auto& source_node : model.nodes()) {
-            int source_collapsed = model.collapsed_index(source_node);
+            int source_index = model.index(source_node);
+            int source_collapsed = model.collapsed_from_index(source_index);
             if (valid_op(source_collapsed, target_collapsed) &&
                 bn_type->can_have_arc(model, source_node, target_node)) {
                 delta(source_collapsed, target_collapsed) =
                     cache_score_operation(model,
                                           score,
-                                          source_node,
-                                          target_node,
+                                          m_node_columns,
+                                          source_index,
+                                          target_index,
                                           new_parents_target,
-                                          m_local_cache->local_score(model, source_node),
-                                          m_local_cache->local_score(model, target_node));
+                                          m_local_cache->collapsed_local_score(source_collapsed),
+                                          m_local_cache->collapsed_local_score(target_collapsed));
             }
         }
     }
@@ -293,52 +399,130 @@ std::shared_ptr<Operator> ArcOperatorSet::find_max(const ConditionalBayesianNetw
         return find_max_indegree<false>(model, tabu_set);
 }
 
+void ArcOperatorSet::append_legal_operators(const BayesianNetworkBase& model, OperatorTable& table, int top_k) const {
+    raise_uninitialized();
+
+    auto delta_ptr = delta.data();
+    std::sort(
+        sorted_idx.begin(), sorted_idx.end(), [&delta_ptr](auto i1, auto i2) { return delta_ptr[i1] > delta_ptr[i2]; });
+
+    bool limited_indegree = max_indegree > 0;
+    int appended = 0;
+    for (auto it = sorted_idx.begin(), end = sorted_idx.end(); it != end && (top_k < 0 || appended < top_k); ++it) {
+        auto idx = *it;
+        auto source_collapsed = idx % model.num_nodes();
+        auto target_collapsed = idx / model.num_nodes();
+
+        const auto& source = model.collapsed_name(source_collapsed);
+        const auto& target = model.collapsed_name(target_collapsed);
+        auto d = delta(source_collapsed, target_collapsed);
+
+        if (model.has_arc(source, target)) {
+            table.add_arc_operator("RemoveArc", source, target, d);
+            ++appended;
+        } else if (limited_indegree && model.num_parents(target) >= max_indegree) {
+            continue;
+        } else if (model.has_arc(target, source)) {
+            if (model.can_flip_arc(target, source)) {
+                table.add_arc_operator("FlipArc", target, source, d);
+                ++appended;
+            }
+        } else if (model.can_add_arc(source, target)) {
+            table.add_arc_operator("AddArc", source, target, d);
+            ++appended;
+        }
+    }
+}
+
+void ArcOperatorSet::append_legal_operators(const ConditionalBayesianNetworkBase& model,
+                                            OperatorTable& table,
+                                            int top_k) const {
+    raise_uninitialized();
+
+    auto delta_ptr = delta.data();
+    std::sort(
+        sorted_idx.begin(), sorted_idx.end(), [&delta_ptr](auto i1, auto i2) { return delta_ptr[i1] > delta_ptr[i2]; });
+
+    bool limited_indegree = max_indegree > 0;
+    int appended = 0;
+    for (auto it = sorted_idx.begin(), end = sorted_idx.end(); it != end && (top_k < 0 || appended < top_k); ++it) {
+        auto idx = *it;
+        auto source_joint_collapsed = idx % model.num_joint_nodes();
+        auto target_collapsed = idx / model.num_joint_nodes();
+
+        const auto& source = model.joint_collapsed_name(source_joint_collapsed);
+        const auto& target = model.collapsed_name(target_collapsed);
+        auto d = delta(source_joint_collapsed, target_collapsed);
+
+        if (model.has_arc(source, target)) {
+            table.add_arc_operator("RemoveArc", source, target, d);
+            ++appended;
+        } else if (limited_indegree && model.num_parents(target) >= max_indegree) {
+            continue;
+        } else if (model.is_interface(source)) {
+            // The interface nodes cannot have parents, so the arc cannot create cycles.
+            if (model.type_ref().can_have_arc(model, source, target)) {
+                table.add_arc_operator("AddArc", source, target, d);
+                ++appended;
+            }
+        } else if (model.has_arc(target, source)) {
+            if (model.can_flip_arc(target, source)) {
+                table.add_arc_operator("FlipArc", target, source, d);
+                ++appended;
+            }
+        } else if (model.can_add_arc(source, target)) {
+            table.add_arc_operator("AddArc", source, target, d);
+            ++appended;
+        }
+    }
+}
+
 void ArcOperatorSet::update_incoming_arcs_scores(const BayesianNetworkBase& model,
                                                  const Score& score,
                                                  const std::string& target_node) {
-    auto target_collapsed = model.collapsed_index(target_node);
-    auto parents = model.parents(target_node);
+    auto target_index = model.index(target_node);
+    auto target_collapsed = model.collapsed_from_index(target_index);
+    auto target_cached = this->m_local_cache->collapsed_local_score(target_collapsed);
+    auto parents = model.parent_indices(target_index);
 
     auto bn_type = model.type();
     for (const auto& source_node : model.nodes()) {
-        auto source_collapsed = model.collapsed_index(source_node);
+        auto source_index = model.index(source_node);
+        auto source_collapsed = model.collapsed_from_index(source_index);
 
         if (valid_op(source_collapsed, target_collapsed)) {
             if (model.has_arc(source_node, target_node)) {
                 // Update remove arc: source_node -> target_node
-                util::swap_remove_v(parents, source_node);
-                double d = score.local_score(model, target_node, parents) -
-                           this->m_local_cache->local_score(model, target_node);
-                parents.push_back(source_node);
+                util::swap_remove_v(parents, source_index);
+                double d = score.local_score(model, m_node_columns, target_index, parents) - target_cached;
+                parents.push_back(source_index);
                 delta(source_collapsed, target_collapsed) = d;
 
                 // Update flip arc: source_node -> target_node
                 if (valid_op(target_collapsed, source_collapsed) &&
                     bn_type->can_have_arc(model, target_node, source_node)) {
-                    auto parents_source = model.parents(source_node);
-                    parents_source.push_back(target_node);
-                    delta(target_collapsed, source_collapsed) = d +
-                                                                score.local_score(model, source_node, parents_source) -
-                                                                this->m_local_cache->local_score(model, source_node);
+                    auto parents_source = model.parent_indices(source_index);
+                    parents_source.push_back(target_index);
+                    delta(target_collapsed, source_collapsed) =
+                        d + score.local_score(model, m_node_columns, source_index, parents_source) -
+                        this->m_local_cache->collapsed_local_score(source_collapsed);
                 }
             } else if (model.has_arc(target_node, source_node) &&
                        bn_type->can_have_arc(model, source_node, target_node)) {
                 // Update flip arc: target_node -> source_node
-                auto parents_source = model.parents(source_node);
-                util::swap_remove_v(parents_source, target_node);
+                auto parents_source = model.parent_indices(source_index);
+                util::swap_remove_v(parents_source, target_index);
 
-                parents.push_back(source_node);
-                double d = score.local_score(model, source_node, parents_source) +
-                           score.local_score(model, target_node, parents) -
-                           this->m_local_cache->local_score(model, source_node) -
-                           this->m_local_cache->local_score(model, target_node);
+                parents.push_back(source_index);
+                double d = score.local_score(model, m_node_columns, source_index, parents_source) +
+                           score.local_score(model, m_node_columns, target_index, parents) -
+                           this->m_local_cache->collapsed_local_score(source_collapsed) - target_cached;
                 parents.pop_back();
                 delta(source_collapsed, target_collapsed) = d;
             } else if (bn_type->can_have_arc(model, source_node, target_node)) {
                 // Update add arc: source_node -> target_node
-                parents.push_back(source_node);
-                double d = score.local_score(model, target_node, parents) -
-                           this->m_local_cache->local_score(model, target_node);
+                parents.push_back(source_index);
+                double d = score.local_score(model, m_node_columns, target_index, parents) - target_cached;
                 parents.pop_back();
                 delta(source_collapsed, target_collapsed) = d;
             }
@@ -358,6 +542,11 @@ void ArcOperatorSet::update_scores(const BayesianNetworkBase& model,
         }
     }
 
+    // The node types of the variables can change.
+    if (!m_node_columns.empty()) {
+        for (const auto& n : variables) m_node_columns.update(model, model.index(n));
+    }
+
     for (uint i = 0; i < variables.size(); ++i) {
         const auto& n = variables[i];
         update_incoming_arcs_scores(model, score, n);
@@ -438,6 +627,384 @@ void ArcOperatorSet::update_scores(const ConditionalBayesianNetworkBase& model,
     }
 }
 
+SparseArcOperatorSet::SparseArcOperatorSet(CandidateParents candidates,
+                                           ArcStringVector blacklist,
+                                           ArcStringVector whitelist,
+                                           int indegree,
+                                           int max_candidates,
+                                           int reselect_every)
+    : m_candidates(std::move(candidates)),
+      m_num_candidates(),
+      m_candidate_idx(),
+      m_candidate_of(),
+      m_invalid_parents(),
+      delta(),
+      sorted_idx(),
+      m_blacklist(blacklist),
+      m_whitelist(whitelist),
+      max_indegree(indegree),
+      m_max_candidates(max_candidates),
+      m_reselect_every(reselect_every),
+      m_num_updates(0),
+      m_node_columns() {
+    if (max_candidates < 0) throw std::invalid_argument("max_candidates must be non-negative.");
+    if (reselect_every < 0) throw std::invalid_argument("reselect_every must be non-negative.");
+
+    for (const auto& c : m_candidates) {
+        m_num_candidates.insert({c.first, static_cast<int>(c.second.size())});
+    }
+}
+
+void SparseArcOperatorSet::update_candidate_indices(const BayesianNetworkBase& model) {
+    int num_nodes = model.num_nodes();
+
+    m_candidate_idx.assign(num_nodes, std::vector<int>{});
+    m_candidate_of.assign(num_nodes, std::vector<int>{});
+
+    for (const auto& c : m_candidates) {
+        if (!model.contains_node(c.first))
+            throw std::invalid_argument("Node " + c.first + " in the candidate parents not present in the graph.");
+
+        auto target = model.collapsed_index(c.first);
+        for (const auto& candidate : c.second) {
+            if (!model.contains_node(candidate))
+                throw std::invalid_argument("Candidate parent " + candidate + " of node " + c.first +
+                                            " not present in the graph.");
+
+            auto source = model.collapsed_index(candidate);
+            if (source == target || is_candidate(source, target)) continue;
+
+            m_candidate_idx[target].push_back(source);
+            m_candidate_of[source].push_back(target);
+        }
+    }
+}
+
+void SparseArcOperatorSet::update_valid_ops(const BayesianNetworkBase& model) {
+    auto restrictions = util::validate_restrictions(model, m_blacklist, m_whitelist);
+
+    m_invalid_parents.assign(model.num_nodes(), std::unordered_set<int>{});
+
+    for (const auto& whitelist_arc : restrictions.arc_whitelist) {
+        int source_index = model.collapsed_from_index(whitelist_arc.first);
+        int target_index = model.collapsed_from_index(whitelist_arc.second);
+
+        m_invalid_parents[target_index].insert(source_index);
+        m_invalid_parents[source_index].insert(target_index);
+    }
+
+    for (const auto& blacklist_arc : restrictions.arc_blacklist) {
+        int source_index = model.collapsed_from_index(blacklist_arc.first);
+        int target_index = model.collapsed_from_index(blacklist_arc.second);
+
+        m_invalid_parents[target_index].insert(source_index);
+    }
+
+    update_candidate_indices(model);
+}
+
+bool SparseArcOperatorSet::valid_arc(const BayesianNetworkBase& model, int source, int target) const {
+    return source != target && m_invalid_parents[target].count(source) == 0 &&
+           model.type_ref().can_have_arc(model, model.collapsed_name(source), model.collapsed_name(target));
+}
+
+bool SparseArcOperatorSet::is_candidate(int source, int target) const {
+    const auto& c = m_candidate_idx[target];
+    return std::find(c.begin(), c.end(), source) != c.end();
+}
+
+void SparseArcOperatorSet::update_target_scores(const BayesianNetworkBase& model, const Score& score, int target) {
+    auto target_index = model.index_from_collapsed(target);
+    auto parents = model.parent_indices(target_index);
+    auto target_cached = m_local_cache->collapsed_local_score(target);
+
+    auto& target_delta = delta[target];
+    target_delta.clear();
+
+    auto add_operator = [&](int source) {
+        if (!valid_arc(model, source, target)) return;
+
+        auto d = cache_score_operation(model,
+                                       score,
+                                       m_node_columns,
+                                       model.index_from_collapsed(source),
+                                       target_index,
+                                       parents,
+                                       m_local_cache->collapsed_local_score(source),
+                                       target_cached);
+        target_delta.push_back({source, d});
+    };
+
+    for (auto source : m_candidate_idx[target]) {
+        add_operator(source);
+    }
+
+    // The parents that are not candidates can only be removed.
+    for (auto parent : model.parent_indices(target_index)) {
+        auto source = model.collapsed_from_index(parent);
+        if (!is_candidate(source, target)) add_operator(source);
+    }
+}
+
+void SparseArcOperatorSet::update_arc_score(const BayesianNetworkBase& model,
+                                            const Score& score,
+                                            int source,
+                                            int target) {
+    for (auto& arc_delta : delta[target]) {
+        if (arc_delta.source == source) {
+            auto target_index = model.index_from_collapsed(target);
+            auto parents = model.parent_indices(target_index);
+
+            arc_delta.delta = cache_score_operation(model,
+                                                    score,
+                                                    m_node_columns,
+                                                    model.index_from_collapsed(source),
+                                                    target_index,
+                                                    parents,
+                                                    m_local_cache->collapsed_local_score(source),
+                                                    m_local_cache->collapsed_local_score(target));
+            return;
+        }
+    }
+}
+
+void SparseArcOperatorSet::cache_scores(const BayesianNetworkBase& model, const Score& score) {
+    if (!score.compatible_bn(model)) {
+        throw std::invalid_argument("BayesianNetwork is not compatible with the score.");
+    }
+
+    initialize_local_cache(model);
+
+    if (owns_local_cache()) {
+        this->m_local_cache->cache_local_scores(model, score);
+    }
+
+    update_valid_ops(model);
+    m_node_columns = score.node_columns(model);
+
+    delta.assign(model.num_nodes(), std::vector<ArcDelta>{});
+    for (int i = 0; i < model.num_nodes(); ++i) {
+        update_target_scores(model, score, i);
+    }
+
+    m_num_updates = 0;
+}
+
+void SparseArcOperatorSet::update_scores(const BayesianNetworkBase& model,
+                                         const Score& score,
+                                         const std::vector<std::string>& variables) {
+    raise_uninitialized();
+
+    if (owns_local_cache()) {
+        for (const auto& n : variables) {
+            m_local_cache->update_local_score(model, score, n);
+        }
+    }
+
+    if (!m_node_columns.empty()) {
+        for (const auto& n : variables) m_node_columns.update(model, model.index(n));
+    }
+
+    if (m_reselect_every > 0 && ++m_num_updates % m_reselect_every == 0) {
+        reselect_candidates(model, score);
+        return;
+    }
+
+    std::vector<int> changed;
+    changed.reserve(variables.size());
+    for (const auto& n : variables) {
+        changed.push_back(model.collapsed_index(n));
+    }
+
+    for (auto target : changed) {
+        update_target_scores(model, score, target);
+    }
+
+    // The flip of an arc target -> source also depends on the local score of source.
+    for (auto source : changed) {
+        for (auto target : m_candidate_of[source]) {
+            if (std::find(changed.begin(), changed.end(), target) == changed.end())
+                update_arc_score(model, score, source, target);
+        }
+    }
+}
+
+void SparseArcOperatorSet::reselect_candidates(const BayesianNetworkBase& model, const Score& score) {
+    raise_uninitialized();
+
+    CandidateParents new_candidates;
+    std::vector<std::pair<int, double>> gains;
+
+    for (int target = 0; target < model.num_nodes(); ++target) {
+        const auto& target_node = model.collapsed_name(target);
+        auto parents = model.parents(target_node);
+
+        auto it = m_num_candidates.find(target_node);
+        int k = m_max_candidates > 0 ? m_max_candidates : (it != m_num_candidates.end() ? it->second : 0);
+
+        std::unordered_set<int> seen{target};
+        for (const auto& p : parents) {
+            seen.insert(model.collapsed_index(p));
+        }
+
+        std::vector<int> pool;
+        auto consider = [&](int source) {
+            if (seen.insert(source).second && valid_arc(model, source, target)) pool.push_back(source);
+        };
+
+        for (auto c : m_candidate_idx[target]) {
+            consider(c);
+            for (auto cc : m_candidate_idx[c]) consider(cc);
+        }
+        for (auto c : m_candidate_of[target]) consider(c);
+        for (const auto& ch : model.children(target_node)) consider(model.collapsed_index(ch));
+
+        auto& target_candidates = new_candidates[target_node];
+        target_candidates = parents;
+
+        int remaining = k - static_cast<int>(parents.size());
+        if (remaining <= 0 || pool.empty()) continue;
+
+        auto target_index = model.index_from_collapsed(target);
+        auto parent_indices = model.parent_indices(target_index);
+        auto target_cached = m_local_cache->collapsed_local_score(target);
+        gains.clear();
+        for (auto source : pool) {
+            parent_indices.push_back(model.index_from_collapsed(source));
+            auto gain = score.local_score(model, m_node_columns, target_index, parent_indices) - target_cached;
+            gains.push_back({source, gain});
+            parent_indices.pop_back();
+        }
+
+        auto num_selected = std::min(static_cast<size_t>(remaining), gains.size());
+        std::partial_sort(gains.begin(), gains.begin() + num_selected, gains.end(), [](const auto& a, const auto& b) {
+            return a.second > b.second || (a.second == b.second && a.first < b.first);
+        });
+
+        for (size_t i = 0; i < num_selected; ++i) {
+            target_candidates.push_back(model.collapsed_name(gains[i].first));
+        }
+    }
+
+    m_candidates = std::move(new_candidates);
+    update_candidate_indices(model);
+
+    for (int i = 0; i < model.num_nodes(); ++i) {
+        update_target_scores(model, score, i);
+    }
+}
+
+int SparseArcOperatorSet::num_operators() const {
+    int total = 0;
+    for (const auto& target_delta : delta) {
+        total += static_cast<int>(target_delta.size());
+    }
+
+    return total;
+}
+
+void SparseArcOperatorSet::sort_operators() const {
+    sorted_idx.clear();
+    sorted_idx.reserve(num_operators());
+
+    for (size_t target = 0; target < delta.size(); ++target) {
+        for (size_t i = 0; i < delta[target].size(); ++i) {
+            sorted_idx.push_back({static_cast<int>(target), static_cast<int>(i)});
+        }
+    }
+
+    std::sort(sorted_idx.begin(), sorted_idx.end(), [this](const auto& i1, const auto& i2) {
+        return delta[i1.first][i1.second].delta > delta[i2.first][i2.second].delta;
+    });
+}
+
+template <bool limited_indegree>
+std::shared_ptr<Operator> SparseArcOperatorSet::find_max_indegree(const BayesianNetworkBase& model,
+                                                                  const OperatorTabuSet* tabu_set) const {
+    sort_operators();
+
+    for (const auto& idx : sorted_idx) {
+        const auto& arc_delta = delta[idx.first][idx.second];
+
+        const auto& source = model.collapsed_name(arc_delta.source);
+        const auto& target = model.collapsed_name(idx.first);
+
+        std::shared_ptr<Operator> op;
+        if (model.has_arc(source, target)) {
+            op = std::make_shared<RemoveArc>(source, target, arc_delta.delta);
+        } else {
+            if constexpr (limited_indegree) {
+                if (model.num_parents(target) >= max_indegree) {
+                    continue;
+                }
+            }
+
+            if (model.has_arc(target, source)) {
+                if (model.can_flip_arc(target, source))
+                    op = std::make_shared<FlipArc>(target, source, arc_delta.delta);
+            } else if (model.can_add_arc(source, target)) {
+                op = std::make_shared<AddArc>(source, target, arc_delta.delta);
+            }
+        }
+
+        if (op && (!tabu_set || !tabu_set->contains(op))) return op;
+    }
+
+    return nullptr;
+}
+
+std::shared_ptr<Operator> SparseArcOperatorSet::find_max(const BayesianNetworkBase& model) const {
+    raise_uninitialized();
+
+    if (max_indegree > 0)
+        return find_max_indegree<true>(model, nullptr);
+    else
+        return find_max_indegree<false>(model, nullptr);
+}
+
+std::shared_ptr<Operator> SparseArcOperatorSet::find_max(const BayesianNetworkBase& model,
+                                                         const OperatorTabuSet& tabu_set) const {
+    raise_uninitialized();
+
+    if (max_indegree > 0)
+        return find_max_indegree<true>(model, &tabu_set);
+    else
+        return find_max_indegree<false>(model, &tabu_set);
+}
+
+void SparseArcOperatorSet::append_legal_operators(const BayesianNetworkBase& model,
+                                                  OperatorTable& table,
+                                                  int top_k) const {
+    raise_uninitialized();
+
+    sort_operators();
+
+    bool limited_indegree = max_indegree > 0;
+    int appended = 0;
+    for (auto it = sorted_idx.begin(), end = sorted_idx.end(); it != end && (top_k < 0 || appended < top_k); ++it) {
+        const auto& arc_delta = delta[it->first][it->second];
+
+        const auto& source = model.collapsed_name(arc_delta.source);
+        const auto& target = model.collapsed_name(it->first);
+        auto d = arc_delta.delta;
+
+        if (model.has_arc(source, target)) {
+            table.add_arc_operator("RemoveArc", source, target, d);
+            ++appended;
+        } else if (limited_indegree && model.num_parents(target) >= max_indegree) {
+            continue;
+        } else if (model.has_arc(target, source)) {
+            if (model.can_flip_arc(target, source)) {
+                table.add_arc_operator("FlipArc", target, source, d);
+                ++appended;
+            }
+        } else if (model.can_add_arc(source, target)) {
+            table.add_arc_operator("AddArc", source, target, d);
+            ++appended;
+        }
+    }
+}
+
 void ChangeNodeTypeSet::cache_scores(const BayesianNetworkBase& model, const Score& score) {
     if (model.type_ref().is_homogeneous()) {
         throw std::invalid_argument("ChangeNodeTypeSet can only be used with non-homogeneous Bayesian networks.");
@@ -556,6 +1123,22 @@ std::shared_ptr<Operator> ChangeNodeTypeSet::find_max(const BayesianNetworkBase&
     }
 }
 
+void ChangeNodeTypeSet::append_legal_operators(const BayesianNetworkBase& model, OperatorTable& table, int) const {
+    raise_uninitialized();
+
+    for (auto i = 0, i_end = static_cast<int>(delta.size()); i < i_end; ++i) {
+        if (!m_is_whitelisted(i) && delta[i].rows() > 0) {
+            const auto& collapsed_name = model.collapsed_name(i);
+            auto alt_node_types = model.type()->alternative_node_type(model, collapsed_name);
+            for (auto k = 0; k < delta[i].rows(); ++k) {
+                if (delta[i](k) > std::numeric_limits<double>::lowest()) {
+                    table.add_change_node_type(collapsed_name, alt_node_types[k]->ToString(), delta[i](k));
+                }
+            }
+        }
+    }
+}
+
 void ChangeNodeTypeSet::update_scores(const BayesianNetworkBase& model,
                                       const Score& score,
                                       const std::vector<std::string>& variables) {
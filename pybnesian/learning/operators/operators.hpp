@@ -13,7 +13,7 @@ using MatrixXb = Matrix<bool, Dynamic, Dynamic>;
 using VectorXb = Matrix<bool, Dynamic, 1>;
 
 using factors::FactorType;
-using learning::scores::Score, learning::scores::ValidatedScore;
+using learning::scores::Score, learning::scores::ValidatedScore, learning::scores::NodeColumns;
 using models::BayesianNetwork, models::BayesianNetworkBase;
 using models::ConditionalBayesianNetworkBase;
 using util::ArcStringVector, util::FactorTypeVector;
@@ -335,6 +335,8 @@ public:
         return m_local_score(model.collapsed_index(name));
     }
 
+    double collapsed_local_score(int collapsed_index) const { return m_local_score(collapsed_index); }
+
     void set_m_local_score(VectorXd& m_local_score) {
         m_local_score = m_local_score;
     }
@@ -348,6 +350,43 @@ private:
     VectorXd m_local_score;
 };
 
+// Columnar list of operators. Each row is an operator: its type ("AddArc", "RemoveArc", "FlipArc" or
+// "ChangeNodeType"), its source and target nodes, its new node type and its delta score. The arc operators do not have
+// a node type, and the ChangeNodeType operators only have a source (the node whose type is changed).
+class OperatorTable {
+public:
+    void add_arc_operator(const char* type, const std::string& source, const std::string& target, double delta) {
+        m_type.push_back(type);
+        m_source.push_back(source);
+        m_target.push_back(target);
+        m_node_type.emplace_back();
+        m_delta.push_back(delta);
+    }
+
+    void add_change_node_type(const std::string& node, const std::string& node_type, double delta) {
+        m_type.push_back("ChangeNodeType");
+        m_source.push_back(node);
+        m_target.emplace_back();
+        m_node_type.push_back(node_type);
+        m_delta.push_back(delta);
+    }
+
+    size_t size() const { return m_delta.size(); }
+
+    // Sorts the operators by decreasing delta. If k >= 0, only the first k operators are kept.
+    void sort_by_delta(int k = -1);
+
+    // Columns "type", "source", "target", "node_type" (utf8) and "delta" (float64).
+    DataFrame to_dataframe() const;
+
+private:
+    std::vector<const char*> m_type;
+    std::vector<std::string> m_source;
+    std::vector<std::string> m_target;
+    std::vector<std::string> m_node_type;
+    std::vector<double> m_delta;
+};
+
 class OperatorSet {
 public:
     OperatorSet() : m_local_cache(nullptr), m_owns_local_cache(false) {}
@@ -372,6 +411,26 @@ public:
 
     std::shared_ptr<LocalScoreCache> local_score_cache() { return m_local_cache; }
 
+    // Returns all the operators of the set that can be applied to the model, sorted by decreasing delta. They are
+    // filtered with the same rules as find_max(). If top_k >= 0, only the top_k operators with largest delta are
+    // returned.
+    template <typename M>
+    OperatorTable legal_operators(const M& model, int top_k = -1) const {
+        OperatorTable table;
+        append_legal_operators(model, table, top_k);
+        table.sort_by_delta(top_k);
+        return table;
+    }
+
+    // Appends the legal operators to the table. If top_k >= 0, at least the top_k operators with largest delta must be
+    // appended.
+    virtual void append_legal_operators(const BayesianNetworkBase&, OperatorTable&, int) const {
+        throw std::invalid_argument("This OperatorSet does not implement legal_operators().");
+    }
+    virtual void append_legal_operators(const ConditionalBayesianNetworkBase&, OperatorTable&, int) const {
+        throw std::invalid_argument("This OperatorSet does not implement legal_operators().");
+    }
+
     virtual void set_arc_blacklist(const ArcStringVector&){};
     virtual void set_arc_whitelist(const ArcStringVector&){};
     virtual void set_max_indegree(int){};
@@ -448,7 +507,13 @@ public:
     ArcOperatorSet(ArcStringVector blacklist = ArcStringVector(),
                    ArcStringVector whitelist = ArcStringVector(),
                    int indegree = 0)
-        : delta(), valid_op(), sorted_idx(), m_blacklist(blacklist), m_whitelist(whitelist), max_indegree(indegree) {}
+        : delta(),
+          valid_op(),
+          sorted_idx(),
+          m_blacklist(blacklist),
+          m_whitelist(whitelist),
+          max_indegree(indegree),
+          m_node_columns() {}
 
     void cache_scores(const BayesianNetworkBase& model, const Score& score) override;
     std::shared_ptr<Operator> find_max(const BayesianNetworkBase& model) const override;
@@ -482,6 +547,11 @@ public:
     void update_valid_ops(const BayesianNetworkBase& bn);
     void update_valid_ops(const ConditionalBayesianNetworkBase& bn);
 
+    void append_legal_operators(const BayesianNetworkBase& model, OperatorTable& table, int top_k) const override;
+    void append_legal_operators(const ConditionalBayesianNetworkBase& model,
+                                OperatorTable& table,
+                                int top_k) const override;
+
     void set_arc_blacklist(const ArcStringVector& blacklist) override { m_blacklist = blacklist; }
 
     void set_arc_whitelist(const ArcStringVector& whitelist) override { m_whitelist = whitelist; }
@@ -520,6 +590,8 @@ private:
     ArcStringVector m_blacklist;
     ArcStringVector m_whitelist;
     int max_indegree;
+    // Data columns and node types of the nodes of the unconditional model, computed in cache_scores().
+    NodeColumns m_node_columns;
 };
 
 
@@ -723,6 +795,106 @@ std::shared_ptr<Operator> ArcOperatorSet::find_max_indegree(const ConditionalBay
     return nullptr;
 }
 
+// Candidate parents of each node. A node missing from the map has no candidate parents.
+using CandidateParents = std::unordered_map<std::string, std::vector<std::string>>;
+
+// Version of ArcOperatorSet restricted to per-node candidate parent lists, as in the Sparse Candidate algorithm
+// (Friedman et al., 1999). An arc source -> target can only be added (or created with a flip) if source is a candidate
+// parent of target, while every arc of the model can be removed. The delta scores are stored sparsely per target
+// node, so cache_scores() evaluates O(n*k) operators for n nodes and k candidates per node, instead of the O(n^2)
+// operators of ArcOperatorSet.
+//
+// If reselect_every > 0, the candidates are re-selected with reselect_candidates() every reselect_every calls to
+// update_scores(). Only the unconditional Bayesian networks are supported.
+class SparseArcOperatorSet : public OperatorSet {
+public:
+    SparseArcOperatorSet(CandidateParents candidates,
+                         ArcStringVector blacklist = ArcStringVector(),
+                         ArcStringVector whitelist = ArcStringVector(),
+                         int indegree = 0,
+                         int max_candidates = 0,
+                         int reselect_every = 0);
+
+    void cache_scores(const BayesianNetworkBase& model, const Score& score) override;
+    std::shared_ptr<Operator> find_max(const BayesianNetworkBase& model) const override;
+    std::shared_ptr<Operator> find_max(const BayesianNetworkBase& model,
+                                       const OperatorTabuSet& tabu_set) const override;
+    void update_scores(const BayesianNetworkBase&, const Score&, const std::vector<std::string>&) override;
+
+    void cache_scores(const ConditionalBayesianNetworkBase&, const Score&) override { raise_conditional(); }
+    std::shared_ptr<Operator> find_max(const ConditionalBayesianNetworkBase&) const override {
+        raise_conditional();
+        return nullptr;
+    }
+    std::shared_ptr<Operator> find_max(const ConditionalBayesianNetworkBase&, const OperatorTabuSet&) const override {
+        raise_conditional();
+        return nullptr;
+    }
+    void update_scores(const ConditionalBayesianNetworkBase&, const Score&, const std::vector<std::string>&) override {
+        raise_conditional();
+    }
+
+    void append_legal_operators(const BayesianNetworkBase& model, OperatorTable& table, int top_k) const override;
+
+    // Re-selects the candidate parents of each node (the Restrict step of the Sparse Candidate algorithm). The current
+    // parents of a node are always kept, and the rest of its candidates are the nodes with the largest score gain when
+    // added to the current parents. To keep the cost at O(n*k^2) score evaluations, the new candidates of a node are
+    // chosen among its current candidates, the candidates of its candidates, the nodes that have it as candidate and
+    // its children. Each node keeps max_candidates candidates, or the size of its initial candidate list if
+    // max_candidates is 0.
+    void reselect_candidates(const BayesianNetworkBase& model, const Score& score);
+
+    const CandidateParents& candidates() const { return m_candidates; }
+    // Number of operators with a cached delta score.
+    int num_operators() const;
+
+    void set_arc_blacklist(const ArcStringVector& blacklist) override { m_blacklist = blacklist; }
+    void set_arc_whitelist(const ArcStringVector& whitelist) override { m_whitelist = whitelist; }
+    void set_max_indegree(int indegree) override { max_indegree = indegree; }
+
+private:
+    struct ArcDelta {
+        int source;
+        double delta;
+    };
+
+    void raise_conditional() const {
+        throw std::invalid_argument("SparseArcOperatorSet does not support conditional Bayesian networks.");
+    }
+
+    void update_valid_ops(const BayesianNetworkBase& model);
+    void update_candidate_indices(const BayesianNetworkBase& model);
+    bool valid_arc(const BayesianNetworkBase& model, int source, int target) const;
+    bool is_candidate(int source, int target) const;
+    void update_target_scores(const BayesianNetworkBase& model, const Score& score, int target);
+    void update_arc_score(const BayesianNetworkBase& model, const Score& score, int source, int target);
+    void sort_operators() const;
+    template <bool limited_indegree>
+    std::shared_ptr<Operator> find_max_indegree(const BayesianNetworkBase& model,
+                                                const OperatorTabuSet* tabu_set) const;
+
+    CandidateParents m_candidates;
+    std::unordered_map<std::string, int> m_num_candidates;
+    // Collapsed indices of the candidates of each node, and of the nodes that have each node as candidate.
+    std::vector<std::vector<int>> m_candidate_idx;
+    std::vector<std::vector<int>> m_candidate_of;
+    // Blacklisted parents of each node. A whitelisted arc cannot be removed or flipped, so it is blacklisted in both
+    // directions.
+    std::vector<std::unordered_set<int>> m_invalid_parents;
+    // Delta scores of the operators with target in each node.
+    std::vector<std::vector<ArcDelta>> delta;
+    // (target, position in delta[target]) of each operator.
+    mutable std::vector<std::pair<int, int>> sorted_idx;
+    ArcStringVector m_blacklist;
+    ArcStringVector m_whitelist;
+    int max_indegree;
+    int m_max_candidates;
+    int m_reselect_every;
+    int m_num_updates;
+    // Data columns and node types of the nodes of the model, computed in cache_scores().
+    NodeColumns m_node_columns;
+};
+
 class ChangeNodeTypeSet : public OperatorSet {
 public:
     ChangeNodeTypeSet(FactorTypeVector blacklist = FactorTypeVector(), FactorTypeVector whitelist = FactorTypeVector())
@@ -756,6 +928,13 @@ public:
         update_scores(static_cast<const BayesianNetworkBase&>(model), score, variables);
     }
 
+    void append_legal_operators(const BayesianNetworkBase& model, OperatorTable& table, int top_k) const override;
+    void append_legal_operators(const ConditionalBayesianNetworkBase& model,
+                                OperatorTable& table,
+                                int top_k) const override {
+        append_legal_operators(static_cast<const BayesianNetworkBase&>(model), table, top_k);
+    }
+
     void update_whitelisted(const BayesianNetworkBase& model) {
         if (m_is_whitelisted.rows() != model.num_nodes()) {
             m_is_whitelisted = VectorXb(model.num_nodes());
@@ -836,6 +1015,19 @@ public:
     template <typename M>
     void update_scores(const M& model, const Score& score, const std::vector<std::string>& variables);
 
+    void append_legal_operators(const BayesianNetworkBase& model, OperatorTable& table, int top_k) const override {
+        for (const auto& op_set : m_op_sets) {
+            op_set->append_legal_operators(model, table, top_k);
+        }
+    }
+    void append_legal_operators(const ConditionalBayesianNetworkBase& model,
+                                OperatorTable& table,
+                                int top_k) const override {
+        for (const auto& op_set : m_op_sets) {
+            op_set->append_legal_operators(model, table, top_k);
+        }
+    }
+
     void set_arc_blacklist(const ArcStringVector& blacklist) override {
         for (auto& opset : m_op_sets) {
             opset->set_arc_blacklist(blacklist);
@@ -9,7 +9,7 @@ typename DiscreteFactor::ParamsClass _fit(const DataFrame& df,
 
     auto [cardinality, strides] = factors::discrete::create_cardinality_strides(df, variable, evidence);
 
-    auto joint_counts = factors::discrete::joint_counts(df, variable, evidence, cardinality, strides);
+    auto joint_counts = factors::discrete::weighted_joint_counts(df, variable, evidence, cardinality, strides);
 
     // Normalize the CPD.
     auto parent_configurations = cardinality.bottomRows(num_variables - 1).prod();
@@ -19,7 +19,7 @@ typename DiscreteFactor::ParamsClass _fit(const DataFrame& df,
     for (auto k = 0; k < parent_configurations; ++k) {
         auto offset = k * cardinality(0);
 
-        int sum_configuration = 0;
+        double sum_configuration = 0;
         for (auto i = 0; i < cardinality(0); ++i) {
             sum_configuration += joint_counts(offset + i);
         }
@@ -32,9 +32,9 @@ typename DiscreteFactor::ParamsClass _fit(const DataFrame& df,
         } else {
             // Schurmann-Grassberger smoothing, lambda = 1 (uniform prior)
             double lambda = 1/cardinality(0);
-            double logsum_configuration = std::log(static_cast<double>(sum_configuration + lambda * cardinality(0)));
+            double logsum_configuration = std::log(sum_configuration + lambda * cardinality(0));
             for (auto i = 0; i < cardinality(0); ++i) {
-                logprob(offset + i) = std::log(static_cast<double>(joint_counts(offset + i) + lambda)) - logsum_configuration;
+                logprob(offset + i) = std::log(joint_counts(offset + i) + lambda) - logsum_configuration;
             }
         }
     }
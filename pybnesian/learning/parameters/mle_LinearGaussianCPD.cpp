@@ -1,14 +1,57 @@
+#include <algorithm>
 #include <learning/parameters/mle_LinearGaussianCPD.hpp>
 
 namespace learning::parameters {
 
-template <>
-typename LinearGaussianCPD::ParamsClass MLE<LinearGaussianCPD>::estimate(const DataFrame& df,
-                                                                         const std::string& variable,
-                                                                         const std::vector<std::string>& evidence) {
+typename LinearGaussianCPD::ParamsClass fit_from_moments(const dataset::WeightedMoments& moments) {
+    int num_evidence = moments.means.rows() - 1;
+
+    VectorXd beta(num_evidence + 1);
+    double rss;
+
+    if (num_evidence == 0) {
+        beta(0) = moments.means(0);
+        rss = moments.sse(0, 0);
+    } else {
+        MatrixXd sxx = moments.sse.bottomRightCorner(num_evidence, num_evidence);
+        VectorXd sxy = moments.sse.col(0).tail(num_evidence);
+
+        VectorXd b = sxx.completeOrthogonalDecomposition().solve(sxy);
+        beta(0) = moments.means(0) - moments.means.tail(num_evidence).dot(b);
+        beta.tail(num_evidence) = b;
+        rss = moments.sse(0, 0) - sxy.dot(b);
+    }
+
+    if (moments.total_weight <= num_evidence + 1) {
+        return typename LinearGaussianCPD::ParamsClass{/*.beta = */ beta,
+                                                       /*.variance = */ std::numeric_limits<double>::infinity()};
+    }
+
+    return typename LinearGaussianCPD::ParamsClass{
+        /*.beta = */ beta,
+        /*.variance = */ std::max(rss, 0.) / (moments.total_weight - num_evidence - 1)};
+}
+
+template <typename Variable, typename Evidence>
+typename LinearGaussianCPD::ParamsClass _fit_weighted(const DataFrame& df,
+                                                      const Variable& variable,
+                                                      const Evidence& evidence) {
+    std::vector<Variable> columns{variable};
+    columns.insert(columns.end(), evidence.begin(), evidence.end());
+
+    return fit_from_moments(dataset::weighted_moments(df, columns));
+}
+
+template <typename Variable, typename Evidence>
+typename LinearGaussianCPD::ParamsClass _estimate(const DataFrame& df,
+                                                  const Variable& variable,
+                                                  const Evidence& evidence) {
     auto type_id = df.same_type(variable, evidence);
     bool contains_null = df.null_count(variable, evidence) > 0;
 
+    if (df.has_weights() && (type_id->id() == Type::DOUBLE || type_id->id() == Type::FLOAT))
+        return _fit_weighted(df, variable, evidence);
+
     switch (type_id->id()) {
         case Type::DOUBLE: {
             if (contains_null)
@@ -26,14 +69,14 @@ typename LinearGaussianCPD::ParamsClass MLE<LinearGaussianCPD>::estimate(const D
         }
         default: {
             std::stringstream ss;
-            ss << "Wrong data type (" << type_id->ToString() << ") to fit the linear regression: " << variable;
+            ss << "Wrong data type (" << type_id->ToString() << ") to fit the linear regression: " << df.name(variable);
 
             if (evidence.empty()) {
                 ss << " | [].";
             } else {
-                ss << " | [" << evidence[0];
+                ss << " | [" << df.name(evidence[0]);
                 for (size_t i = 1; i < evidence.size(); ++i) {
-                    ss << ", " << evidence[i] << std::endl;
+                    ss << ", " << df.name(evidence[i]) << std::endl;
                 }
                 ss << "].";
             }
@@ -44,4 +87,18 @@ typename LinearGaussianCPD::ParamsClass MLE<LinearGaussianCPD>::estimate(const D
     }
 }
 
+template <>
+typename LinearGaussianCPD::ParamsClass MLE<LinearGaussianCPD>::estimate(const DataFrame& df,
+                                                                         const std::string& variable,
+                                                                         const std::vector<std::string>& evidence) {
+    return _estimate(df, variable, evidence);
+}
+
+template <>
+typename LinearGaussianCPD::ParamsClass MLE<LinearGaussianCPD>::estimate(const DataFrame& df,
+                                                                         int variable,
+                                                                         const util::ParentSet& evidence) {
+    return _estimate(df, variable, evidence);
+}
+
 }  // namespace learning::parameters
\ No newline at end of file
@@ -8,10 +8,12 @@ using factors::continuous::LinearGaussianCPD;
 
 namespace learning::parameters {
 
-template <typename ArrowType, bool contains_null>
+// The fit functions accept the columns as names or as column indices of the DataFrame (Variable and Evidence types), so
+// the scores can fit the regressions without creating the names of the columns.
+template <typename ArrowType, bool contains_null, typename Variable>
 typename LinearGaussianCPD::ParamsClass _fit_1parent(const DataFrame& df,
-                                                     const std::string& variable,
-                                                     const std::string& evidence) {
+                                                     const Variable& variable,
+                                                     const Variable& evidence) {
     auto [y, x] = [&df, &variable, &evidence]() {
         if constexpr (contains_null) {
             auto combined_bitmap = df.combined_bitmap(variable, evidence);
@@ -67,10 +69,10 @@ typename LinearGaussianCPD::ParamsClass _fit_1parent(const DataFrame& df,
                                                    /*.variance = */ v};
 }
 
-template <typename ArrowType, bool contains_null>
+template <typename ArrowType, bool contains_null, typename Variable, typename Evidence>
 typename LinearGaussianCPD::ParamsClass _fit_2parent(const DataFrame& df,
-                                                     const std::string& variable,
-                                                     const std::vector<std::string>& evidence) {
+                                                     const Variable& variable,
+                                                     const Evidence& evidence) {
     auto [y, x1, x2] = [&df, &variable, &evidence]() {
         if constexpr (contains_null) {
             auto combined_bitmap = df.combined_bitmap(variable, evidence);
@@ -149,10 +151,10 @@ typename LinearGaussianCPD::ParamsClass _fit_2parent(const DataFrame& df,
     }
 }
 
-template <typename ArrowType, bool contains_null>
+template <typename ArrowType, bool contains_null, typename Variable, typename Evidence>
 typename LinearGaussianCPD::ParamsClass _fit_nparent(const DataFrame& df,
-                                                     const std::string& variable,
-                                                     const std::vector<std::string>& evidence) {
+                                                     const Variable& variable,
+                                                     const Evidence& evidence) {
     auto [y, X] = [&df, &variable, &evidence]() {
         if constexpr (contains_null) {
             auto combined_bitmap = df.combined_bitmap(variable, evidence);
@@ -192,10 +194,8 @@ typename LinearGaussianCPD::ParamsClass _fit_nparent(const DataFrame& df,
     }
 }
 
-template <typename ArrowType, bool contains_null>
-typename LinearGaussianCPD::ParamsClass _fit(const DataFrame& df,
-                                             const std::string& variable,
-                                             const std::vector<std::string>& evidence) {
+template <typename ArrowType, bool contains_null, typename Variable, typename Evidence>
+typename LinearGaussianCPD::ParamsClass _fit(const DataFrame& df, const Variable& variable, const Evidence& evidence) {
     if (evidence.size() == 0) {
         auto v = df.to_eigen<false, ArrowType, contains_null>(variable);
 
@@ -220,6 +220,11 @@ typename LinearGaussianCPD::ParamsClass _fit(const DataFrame& df,
     }
 }
 
+// Weighted least squares of the first column of the moments on the other columns. A row with weight w counts as w
+// repetitions of the row, so the variance is the weighted residual sum of squares divided by (total weight - number of
+// coefficients).
+typename LinearGaussianCPD::ParamsClass fit_from_moments(const dataset::WeightedMoments& moments);
+
 }  // namespace learning::parameters
 
 #endif  // PYBNESIAN_LEARNING_PARAMETERS_MLE_LINEARGAUSSIANCPD_HPP
\ No newline at end of file
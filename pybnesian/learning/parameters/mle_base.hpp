@@ -2,6 +2,7 @@
 #define PYBNESIAN_LEARNING_PARAMETERS_MLE_BASE_HPP
 
 #include <dataset/dataset.hpp>
+#include <util/small_vector.hpp>
 
 using namespace dataset;
 
@@ -13,6 +14,8 @@ public:
     typename CPD::ParamsClass estimate(const DataFrame& df,
                                        const std::string& variable,
                                        const std::vector<std::string>& evidence);
+    // Version with column indices of the DataFrame. It is only implemented by some CPDs.
+    typename CPD::ParamsClass estimate(const DataFrame& df, int variable, const util::ParentSet& evidence);
 };
 
 }  // namespace learning::parameters
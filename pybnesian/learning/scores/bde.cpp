@@ -4,11 +4,11 @@ namespace learning::scores {
 
 double BDe::bde_impl_noparents(const std::string& variable) const {
     auto [cardinality, strides] = factors::discrete::create_cardinality_strides(m_df, variable, {});
-    auto joint_counts = factors::discrete::joint_counts(m_df, variable, {}, cardinality, strides);
+    auto joint_counts = factors::discrete::weighted_joint_counts(m_chunks, variable, {}, cardinality, strides);
 
     double alpha = m_iss / cardinality(0);
 
-    auto num_rows = 0;
+    double num_rows = 0;
     auto res = -cardinality(0) * std::lgamma(alpha);
     for (auto i = 0; i < joint_counts.rows(); ++i) {
         num_rows += joint_counts(i);
@@ -22,7 +22,7 @@ double BDe::bde_impl_noparents(const std::string& variable) const {
 
 double BDe::bde_impl_parents(const std::string& variable, const std::vector<std::string>& parents) const {
     auto [cardinality, strides] = factors::discrete::create_cardinality_strides(m_df, variable, parents);
-    auto joint_counts = factors::discrete::joint_counts(m_df, variable, parents, cardinality, strides);
+    auto joint_counts = factors::discrete::weighted_joint_counts(m_chunks, variable, parents, cardinality, strides);
 
     auto cardinality_prod = cardinality.prod();
     double alpha = m_iss / cardinality_prod;
@@ -31,7 +31,7 @@ double BDe::bde_impl_parents(const std::string& variable, const std::vector<std:
     auto res = -cardinality_prod * std::lgamma(alpha);
     for (auto k = 0; k < parent_configurations; ++k) {
         auto offset = k * cardinality(0);
-        auto sum = 0;
+        double sum = 0;
 
         for (auto i = 0; i < cardinality(0); ++i) {
             auto m = joint_counts(offset + i);
@@ -49,7 +49,10 @@ double BDe::bde_impl_parents(const std::string& variable, const std::vector<std:
 double BDe::local_score(const BayesianNetworkBase& model,
                         const std::string& variable,
                         const std::vector<std::string>& parents) const {
-    if (*model.node_type(variable) == DiscreteFactorType::get_ref()) {
+    auto node_type = model.node_type(variable);
+    auto timer = local_score_timer(*node_type);
+
+    if (*node_type == DiscreteFactorType::get_ref()) {
         if (parents.empty())
             return bde_impl_noparents(variable);
         else
@@ -64,6 +67,8 @@ double BDe::local_score(const BayesianNetworkBase&,
                         const std::shared_ptr<FactorType>& node_type,
                         const std::string& variable,
                         const std::vector<std::string>& parents) const {
+    auto timer = local_score_timer(*node_type);
+
     if (*node_type != DiscreteFactorType::get_ref()) {
         if (parents.empty())
             return bde_impl_noparents(variable);
@@ -1,16 +1,20 @@
 #ifndef PYBNESIAN_LEARNING_SCORES_BDE_HPP
 #define PYBNESIAN_LEARNING_SCORES_BDE_HPP
 
+#include <dataset/chunked_dataframe.hpp>
 #include <factors/discrete/DiscreteFactor.hpp>
 #include <learning/scores/scores.hpp>
 
+using dataset::ChunkedDataFrame;
 using factors::discrete::DiscreteFactorType;
 
 namespace learning::scores {
 
 class BDe : public Score {
 public:
-    BDe(const DataFrame& df, double iss = 1) : m_df(df), m_iss(iss) {}
+    BDe(const DataFrame& df, double iss = 1) : BDe(ChunkedDataFrame(df), iss) {}
+    // The counts are summed over the chunks. With more than one chunk, data() only contains the schema of the data.
+    BDe(const ChunkedDataFrame& df, double iss = 1) : m_df(df.schema_df()), m_chunks(df), m_iss(iss) {}
 
     double local_score(const BayesianNetworkBase& model,
                        const std::string& variable,
@@ -46,6 +50,7 @@ private:
     double bde_impl_parents(const std::string& variable, const std::vector<std::string>& parents) const;
 
     const DataFrame m_df;
+    const ChunkedDataFrame m_chunks;
     double m_iss;
 };
 
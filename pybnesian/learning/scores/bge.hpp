@@ -2,10 +2,11 @@
 #define PYBNESIAN_LEARNING_SCORES_BGE_HPP
 
 #include <dataset/dataset.hpp>
+#include <dataset/chunked_dataframe.hpp>
 #include <models/BayesianNetwork.hpp>
 #include <learning/scores/scores.hpp>
 
-using dataset::DataFrame;
+using dataset::DataFrame, dataset::ChunkedDataFrame;
 using learning::scores::Score;
 using models::BayesianNetworkBase, models::BayesianNetworkType, models::GaussianNetworkType;
 
@@ -17,44 +18,68 @@ public:
         double iss_mu = 1,
         std::optional<double> iss_w = std::nullopt,
         std::optional<VectorXd> nu = std::nullopt)
-        : m_df(df),
+        : BGe(ChunkedDataFrame(df), iss_mu, iss_w, nu) {}
+
+    // The moments are merged over the chunks. With more than one chunk, data() only contains the schema of the data.
+    BGe(const ChunkedDataFrame& df,
+        double iss_mu = 1,
+        std::optional<double> iss_w = std::nullopt,
+        std::optional<VectorXd> nu = std::nullopt)
+        : m_df(df.schema_df()),
+          m_chunks(df),
           m_iss_mu(iss_mu),
           m_iss_w(),
           m_nu(),
           m_cached_sse(),
           m_cached_means(),
           m_is_cached(false),
-          m_cached_indices() {
+          m_cached_indices(),
+          m_cached_columns() {
+        // The weights column is not a variable.
+        auto num_columns = m_df.num_variables();
+
         if (iss_w) {
-            if (*iss_w <= df->num_columns() - 1) {
+            if (*iss_w <= num_columns - 1) {
                 throw std::invalid_argument(
                     "Imaginary sample size for Wishart prior must be greater than "
                     " num_columns - 1 (" +
-                    std::to_string(df->num_columns() - 1) + ").");
+                    std::to_string(num_columns - 1) + ").");
             }
 
             m_iss_w = *iss_w;
         } else {
-            m_iss_w = df->num_columns() + 2;
+            m_iss_w = num_columns + 2;
         }
 
         if (nu) {
-            if (nu->rows() != df->num_columns()) {
+            if (nu->rows() != num_columns) {
                 throw std::invalid_argument("\"nu\" argument contains " + std::to_string(nu->rows()) +
                                             " elements, "
                                             "but DataFrame \"df\" contains " +
-                                            std::to_string(df->num_columns()) + " columns.");
+                                            std::to_string(num_columns) + " columns.");
             }
         }
 
         m_nu = nu;
 
-        auto continuous_indices = df.continuous_columns();
+        auto continuous_indices = m_df.continuous_columns();
 
-        if (m_df.null_count(continuous_indices) == 0) {
+        if (m_chunks.null_count(continuous_indices) == 0) {
             m_is_cached = true;
+            m_cached_columns.resize(m_df->num_columns(), -1);
             for (int i = 0, size = continuous_indices.size(); i < size; ++i) {
                 m_cached_indices.insert(std::make_pair(m_df->column_name(continuous_indices[i]), i));
+                m_cached_columns[continuous_indices[i]] = i;
+            }
+
+            if (m_chunks.requires_moments()) {
+                std::vector<std::string> continuous_names;
+                for (auto i : continuous_indices) continuous_names.push_back(m_df.name(i));
+
+                auto moments = m_chunks.moments(continuous_names);
+                m_cached_means = std::move(moments.means);
+                m_cached_sse = std::move(moments.sse);
+                return;
             }
 
             switch (m_df.same_type(continuous_indices)->id()) {
@@ -81,6 +106,12 @@ public:
                        const std::string& variable,
                        const std::vector<std::string>& parents) const override;
 
+    // The local scores are computed with the column indices of columns, without looking up any name.
+    double local_score(const BayesianNetworkBase& model,
+                       const NodeColumns& columns,
+                       int variable,
+                       const util::ParentSet& parents) const override;
+
     std::string ToString() const override { return "BGe"; }
 
     bool has_variables(const std::string& name) const override { return m_df.has_columns(name); }
@@ -102,11 +133,18 @@ public:
     DataFrame data() const override { return m_df; }
 
 private:
+    // Index of the variable in nu. The weights column does not have an element in nu.
+    template <typename Index>
+    int nu_index(const Index& variable) const {
+        auto index = m_df.index(variable);
+        return (m_df.has_weights() && index > m_df.weights_index()) ? index - 1 : index;
+    }
+
     int cached_index(int v) const {
-        auto it = m_cached_indices.find(m_df->column_name(v));
-        if (it == m_cached_indices.end())
+        auto index = (v >= 0 && v < static_cast<int>(m_cached_columns.size())) ? m_cached_columns[v] : -1;
+        if (index == -1)
             throw std::invalid_argument("Continuous variable " + std::to_string(v) + " not present in BGe.");
-        return it->second;
+        return index;
     }
     int cached_index(const std::string& name) const {
         auto it = m_cached_indices.find(name);
@@ -115,33 +153,33 @@ private:
         return it->second;
     }
 
-    double bge_impl(const BayesianNetworkBase& model,
-                    const std::string& variable,
-                    const std::vector<std::string>& parents) const;
+    // The variables are column names (std::string and std::vector<std::string>) or column indices (int and
+    // util::ParentSet).
+    template <typename Variable, typename Evidence>
+    double bge_impl(int total_nodes, const Variable& variable, const Evidence& parents) const;
 
-    template <typename ArrowType>
-    double bge_no_parents(const std::string& variable, int total_nodes, double nu) const;
-    double bge_no_parents(const std::string& variable, int total_nodes, double nu) const;
+    template <typename ArrowType, typename Variable>
+    double bge_no_parents(const Variable& variable, int total_nodes, double nu) const;
+    template <typename Variable>
+    double bge_no_parents_dispatch(const Variable& variable, int total_nodes, double nu) const;
 
-    template <typename ArrowType>
-    double bge_parents(const std::string& variable,
-                       const std::vector<std::string>& parents,
-                       int total_nodes,
-                       VectorXd& nu) const;
-    double bge_parents(const std::string& variable,
-                       const std::vector<std::string>& parents,
-                       int total_nodes,
-                       VectorXd& nu) const;
+    template <typename ArrowType, typename Variable, typename Evidence>
+    double bge_parents(const Variable& variable, const Evidence& parents, int total_nodes, VectorXd& nu) const;
+    template <typename Variable, typename Evidence>
+    double bge_parents_dispatch(const Variable& variable, const Evidence& parents, int total_nodes, VectorXd& nu) const;
 
-    void generate_cached_r(MatrixXd& r, const std::string& variable, const std::vector<std::string>& parents) const;
-    void generate_r(MatrixXd& r, const std::string& variable, const std::vector<std::string>& parents) const;
+    template <typename Variable, typename Evidence>
+    void generate_cached_r(MatrixXd& r, const Variable& variable, const Evidence& parents) const;
+    template <typename Variable, typename Evidence>
+    void generate_r(MatrixXd& r, const Variable& variable, const Evidence& parents) const;
 
-    void generate_cached_means(VectorXd& means,
-                               const std::string& variable,
-                               const std::vector<std::string>& parents) const;
-    void generate_means(VectorXd& means, const std::string& variable, const std::vector<std::string>& parents) const;
+    template <typename Variable, typename Evidence>
+    void generate_cached_means(VectorXd& means, const Variable& variable, const Evidence& parents) const;
+    template <typename Variable, typename Evidence>
+    void generate_means(VectorXd& means, const Variable& variable, const Evidence& parents) const;
 
     const DataFrame m_df;
+    const ChunkedDataFrame m_chunks;
     double m_iss_mu;
     double m_iss_w;
     std::optional<VectorXd> m_nu;
@@ -149,11 +187,159 @@ private:
     VectorXd m_cached_means;
     bool m_is_cached;
     std::unordered_map<std::string, int> m_cached_indices;
+    // Cached index of each column, or -1 if the column is not cached.
+    std::vector<int> m_cached_columns;
 };
 
-template <typename ArrowType>
-double BGe::bge_no_parents(const std::string& variable, int total_nodes, double nu) const {
-    double N = m_df.valid_rows(variable);
+template <typename Variable>
+double BGe::bge_no_parents_dispatch(const Variable& variable, int total_nodes, double nu) const {
+    auto type = m_df.same_type(variable);
+    switch (type->id()) {
+        case Type::DOUBLE:
+            return bge_no_parents<arrow::DoubleType>(variable, total_nodes, nu);
+        case Type::FLOAT:
+            return bge_no_parents<arrow::FloatType>(variable, total_nodes, nu);
+        default:
+            throw std::invalid_argument("Variable " + dataset::index_to_string(variable) +
+                                        " has data type "
+                                        "\"" +
+                                        type->ToString() +
+                                        "\" but BGe"
+                                        " requires \"double\" or \"float\" data type.");
+    }
+}
+
+template <typename Variable, typename Evidence>
+double BGe::bge_parents_dispatch(const Variable& variable,
+                                 const Evidence& parents,
+                                 int total_nodes,
+                                 VectorXd& nu) const {
+    auto type = m_df.same_type(variable);
+    switch (type->id()) {
+        case Type::DOUBLE:
+            return bge_parents<arrow::DoubleType>(variable, parents, total_nodes, nu);
+        case Type::FLOAT:
+            return bge_parents<arrow::FloatType>(variable, parents, total_nodes, nu);
+        default:
+            throw std::invalid_argument("Variables has data type \"" + type->ToString() +
+                                        "\" but BGe"
+                                        " requires \"double\" or \"float\" data type.");
+    }
+}
+
+template <typename Variable, typename Evidence>
+void BGe::generate_cached_r(MatrixXd& r, const Variable& variable, const Evidence& parents) const {
+    int var_index = cached_index(variable);
+    r(0, 0) = m_cached_sse(var_index, var_index);
+
+    for (size_t i = 0, end = parents.size(); i < end; ++i) {
+        int ei_index = cached_index(parents[i]);
+        r(i + 1, i + 1) = m_cached_sse(ei_index, ei_index);
+
+        r(0, i + 1) = r(i + 1, 0) = m_cached_sse(var_index, ei_index);
+
+        for (size_t j = i + 1; j < end; ++j) {
+            int ej_index = cached_index(parents[j]);
+            r(i + 1, j + 1) = r(j + 1, i + 1) = m_cached_sse(ei_index, ej_index);
+        }
+    }
+}
+
+template <typename Variable, typename Evidence>
+void BGe::generate_r(MatrixXd& r, const Variable& variable, const Evidence& parents) const {
+    auto type = m_df.same_type(variable, parents);
+    switch (type->id()) {
+        case Type::DOUBLE: {
+            r = *m_df.sse<arrow::DoubleType>(variable, parents);
+            break;
+        }
+        case Type::FLOAT: {
+            r = m_df.sse<arrow::FloatType>(variable, parents)->template cast<double>();
+            break;
+        }
+        default:
+            throw std::invalid_argument("Variables has data type \"" + type->ToString() +
+                                        "\" but BGe"
+                                        " requires \"double\" or \"float\" data type.");
+    }
+}
+
+template <typename Variable, typename Evidence>
+void BGe::generate_cached_means(VectorXd& means, const Variable& variable, const Evidence& parents) const {
+    int var_index = cached_index(variable);
+    means(0) = m_cached_means(var_index);
+
+    for (size_t i = 0, end = parents.size(); i < end; ++i) {
+        int ei_index = cached_index(parents[i]);
+        means(i + 1) = m_cached_means(ei_index);
+    }
+}
+
+template <typename Variable, typename Evidence>
+void BGe::generate_means(VectorXd& means, const Variable& variable, const Evidence& parents) const {
+    auto type = m_df.same_type(variable, parents);
+    switch (type->id()) {
+        case Type::DOUBLE: {
+            means = m_df.means<arrow::DoubleType>(variable, parents);
+            break;
+        }
+        case Type::FLOAT: {
+            means = m_df.means<arrow::FloatType>(variable, parents).template cast<double>();
+            break;
+        }
+        default:
+            throw std::invalid_argument("Variables has data type \"" + type->ToString() +
+                                        "\" but BGe"
+                                        " requires \"double\" or \"float\" data type.");
+    }
+}
+
+template <typename Variable, typename Evidence>
+double BGe::bge_impl(int total_nodes, const Variable& variable, const Evidence& parents) const {
+    if (parents.empty()) {
+        double nu = [this, &variable]() {
+            if (m_nu) {
+                return (*m_nu)(nu_index(variable));
+            } else if (m_chunks.requires_moments()) {
+                return m_chunks.moments(std::vector<Variable>{variable}).means(0);
+            } else {
+                return m_df.mean(variable);
+            }
+        }();
+
+        return bge_no_parents_dispatch(variable, total_nodes, nu);
+    } else {
+        VectorXd nu = [this, &variable, &parents]() {
+            if (m_nu) {
+                VectorXd res(parents.size() + 1);
+                res(0) = (*m_nu)(nu_index(variable));
+                int i = 0;
+                for (const auto& e : parents) {
+                    res(++i) = (*m_nu)(nu_index(e));
+                }
+
+                return res;
+            } else if (m_chunks.requires_moments()) {
+                std::vector<Variable> columns{variable};
+                columns.insert(columns.end(), parents.begin(), parents.end());
+                return m_chunks.moments(columns).means;
+            } else {
+                auto combined_bitmap = m_df.combined_bitmap(variable, parents);
+                if (combined_bitmap) {
+                    return m_df.means(combined_bitmap, variable, parents);
+                } else {
+                    return m_df.means(variable, parents);
+                }
+            }
+        }();
+
+        return bge_parents_dispatch(variable, parents, total_nodes, nu);
+    }
+}
+
+template <typename ArrowType, typename Variable>
+double BGe::bge_no_parents(const Variable& variable, int total_nodes, double nu) const {
+    double N = m_chunks.total_weight(variable);
 
     double logprob = 0.5 * (log(m_iss_mu) - log(N + m_iss_mu));
     logprob += lgamma(0.5 * (N + m_iss_w - total_nodes + 1)) - lgamma(0.5 * (m_iss_w - total_nodes + 1));
@@ -162,18 +348,25 @@ double BGe::bge_no_parents(const std::string& variable, int total_nodes, double
     double t = m_iss_mu * (m_iss_w - total_nodes - 1) / (m_iss_mu + 1);
     logprob += 0.5 * (m_iss_w - total_nodes + 1) * log(t);
 
-    double mean = m_df.mean(variable);
-    double nu_diff = mean - nu;
+    double mean, sse;
+    if (m_chunks.requires_moments()) {
+        auto moments = m_chunks.moments(std::vector<Variable>{variable});
+        mean = moments.means(0);
+        sse = moments.sse(0, 0);
+    } else {
+        mean = m_df.mean(variable);
+        sse = [this, &variable, mean]() {
+            if (m_df.null_count(variable) == 0) {
+                auto column = m_df.to_eigen<false, ArrowType, false>(variable);
+                return (column->array() - mean).matrix().squaredNorm();
+            } else {
+                auto column = m_df.to_eigen<false, ArrowType, true>(variable);
+                return (column->array() - mean).matrix().squaredNorm();
+            }
+        }();
+    }
 
-    double sse = [this, &variable, mean]() {
-        if (m_df.null_count(variable) == 0) {
-            auto column = m_df.to_eigen<false, ArrowType, false>(variable);
-            return (column->array() - mean).matrix().squaredNorm();
-        } else {
-            auto column = m_df.to_eigen<false, ArrowType, true>(variable);
-            return (column->array() - mean).matrix().squaredNorm();
-        }
-    }();
+    double nu_diff = mean - nu;
 
     double r = t + sse + ((N * m_iss_mu) / (N + m_iss_mu) * nu_diff * nu_diff);
 
@@ -181,12 +374,9 @@ double BGe::bge_no_parents(const std::string& variable, int total_nodes, double
     return logprob;
 }
 
-template <typename ArrowType>
-double BGe::bge_parents(const std::string& variable,
-                        const std::vector<std::string>& evidence,
-                        int total_nodes,
-                        VectorXd& nu) const {
-    double N = m_df.valid_rows(variable, evidence);
+template <typename ArrowType, typename Variable, typename Evidence>
+double BGe::bge_parents(const Variable& variable, const Evidence& evidence, int total_nodes, VectorXd& nu) const {
+    double N = m_chunks.total_weight(variable, evidence);
     double p = evidence.size();
 
     double logprob = 0.5 * (log(m_iss_mu) - log(N + m_iss_mu));
@@ -203,6 +393,13 @@ double BGe::bge_parents(const std::string& variable,
     if (m_is_cached) {
         generate_cached_means(means_full, variable, evidence);
         generate_cached_r(r_full, variable, evidence);
+    } else if (m_chunks.requires_moments()) {
+        std::vector<Variable> columns{variable};
+        columns.insert(columns.end(), evidence.begin(), evidence.end());
+
+        auto moments = m_chunks.moments(columns);
+        means_full = std::move(moments.means);
+        r_full = std::move(moments.sse);
     } else {
         generate_means(means_full, variable, evidence);
         generate_r(r_full, variable, evidence);
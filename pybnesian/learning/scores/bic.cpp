@@ -9,16 +9,25 @@ using models::GaussianNetworkType;
 
 namespace learning::scores {
 
-double BIC::bic_lineargaussian(const std::string& variable, const std::vector<std::string>& parents) const {
-    MLE<LinearGaussianCPD> mle;
+template <typename Variable, typename Evidence>
+double BIC::bic_lineargaussian(const Variable& variable, const Evidence& parents) const {
+    auto [mle_params, rows] = [this, &variable, &parents]() {
+        if (m_chunks.num_chunks() > 1) {
+            std::vector<Variable> columns{variable};
+            columns.insert(columns.end(), parents.begin(), parents.end());
+
+            auto moments = m_chunks.moments(columns);
+            return std::make_pair(learning::parameters::fit_from_moments(moments), moments.total_weight);
+        }
 
-    auto mle_params = mle.estimate(m_df, variable, parents);
+        MLE<LinearGaussianCPD> mle;
+        return std::make_pair(mle.estimate(m_df, variable, parents), m_df.total_weight(variable, parents));
+    }();
 
     if (mle_params.variance < util::machine_tol || std::isinf(mle_params.variance)) {
         return -std::numeric_limits<double>::infinity();
     }
 
-    auto rows = m_df.valid_rows(variable, parents);
     auto num_parents = parents.size();
     auto loglik = 0.5 * (1 + static_cast<double>(num_parents) - static_cast<double>(rows)) -
                   0.5 * rows * std::log(2 * util::pi<double>) - rows * 0.5 * std::log(mle_params.variance);
@@ -32,7 +41,6 @@ double BIC::bic_clg(const std::string& variable,
     auto [cardinality, strides] = factors::discrete::create_cardinality_strides(m_df, discrete_parents);
 
     auto num_configs = cardinality.prod();
-    auto slices = factors::discrete::discrete_slice_indices(m_df, discrete_parents, strides, num_configs);
 
     MLE<LinearGaussianCPD> mle;
 
@@ -40,32 +48,75 @@ double BIC::bic_clg(const std::string& variable,
 
     auto num_continuous_parents = continuous_parents.size();
 
-    for (auto i = 0; i < num_configs; ++i) {
-        if (slices[i]) {
-            // Calling take() can be slower than fitting all the linear regressions at the same time (as bnlearn)
-            auto df_filtered = m_df.loc(variable, continuous_parents).take(slices[i]);
+    std::vector<std::string> columns{variable};
+    columns.insert(columns.end(), continuous_parents.begin(), continuous_parents.end());
+
+    auto config_loglik = [num_continuous_parents](const auto& mle_params, double num_valid_config) {
+        return 0.5 * (1 + static_cast<double>(num_continuous_parents) - num_valid_config) -
+               0.5 * num_valid_config * std::log(2 * util::pi<double>) -
+               num_valid_config * 0.5 * std::log(mle_params.variance);
+    };
+
+    if (m_chunks.num_chunks() > 1) {
+        // The moments of each configuration are merged across the chunks.
+        std::vector<WeightedMoments> config_moments(
+            num_configs,
+            WeightedMoments{0, VectorXd::Zero(columns.size()), MatrixXd::Zero(columns.size(), columns.size())});
+        std::vector<bool> has_rows(num_configs, false);
+
+        for (const auto& chunk : m_chunks.chunks()) {
+            auto slices = factors::discrete::discrete_slice_indices(chunk, discrete_parents, strides, num_configs);
+            auto df_columns = chunk.loc_weighted(columns);
+
+            for (auto i = 0; i < num_configs; ++i) {
+                if (slices[i]) {
+                    config_moments[i] =
+                        merge_moments(config_moments[i], weighted_moments(df_columns.take(slices[i]), columns));
+                    has_rows[i] = true;
+                }
+            }
+        }
+
+        for (auto i = 0; i < num_configs; ++i) {
+            if (has_rows[i]) {
+                auto mle_params = learning::parameters::fit_from_moments(config_moments[i]);
 
-            auto num_valid_config = df_filtered.valid_rows(variable, continuous_parents);
-            auto mle_params = mle.estimate(df_filtered, variable, continuous_parents);
+                if (mle_params.variance < util::machine_tol || std::isinf(mle_params.variance)) {
+                    return -std::numeric_limits<double>::infinity();
+                }
 
-            if (mle_params.variance < util::machine_tol || std::isinf(mle_params.variance)) {
-                return -std::numeric_limits<double>::infinity();
+                loglik += config_loglik(mle_params, config_moments[i].total_weight);
             }
+        }
+    } else {
+        auto slices = factors::discrete::discrete_slice_indices(m_df, discrete_parents, strides, num_configs);
+        auto df_columns = m_df.loc_weighted(columns);
+
+        for (auto i = 0; i < num_configs; ++i) {
+            if (slices[i]) {
+                // Calling take() can be slower than fitting all the linear regressions at the same time (as bnlearn)
+                auto df_filtered = df_columns.take(slices[i]);
+
+                auto num_valid_config = df_filtered.total_weight(variable, continuous_parents);
+                auto mle_params = mle.estimate(df_filtered, variable, continuous_parents);
 
-            loglik += 0.5 * (1 + static_cast<double>(num_continuous_parents) - static_cast<double>(num_valid_config)) -
-                      0.5 * num_valid_config * std::log(2 * util::pi<double>) -
-                      num_valid_config * 0.5 * std::log(mle_params.variance);
+                if (mle_params.variance < util::machine_tol || std::isinf(mle_params.variance)) {
+                    return -std::numeric_limits<double>::infinity();
+                }
+
+                loglik += config_loglik(mle_params, num_valid_config);
+            }
         }
     }
 
-    auto valid_rows = m_df.valid_rows(variable, discrete_parents, continuous_parents);
+    auto valid_rows = m_chunks.total_weight(variable, discrete_parents, continuous_parents);
 
     return loglik - std::log(valid_rows) * 0.5 * num_configs * (num_continuous_parents + 2);
 }
 
 double BIC::bic_discrete(const std::string& variable, const std::vector<std::string>& parents) const {
     auto [cardinality, strides] = factors::discrete::create_cardinality_strides(m_df, variable, parents);
-    auto joint_counts = factors::discrete::joint_counts(m_df, variable, parents, cardinality, strides);
+    auto joint_counts = factors::discrete::weighted_joint_counts(m_chunks, variable, parents, cardinality, strides);
 
     auto parent_configurations = cardinality.tail(parents.size()).prod();
 
@@ -74,24 +125,24 @@ double BIC::bic_discrete(const std::string& variable, const std::vector<std::str
     for (auto k = 0; k < parent_configurations; ++k) {
         auto offset = k * cardinality(0);
 
-        int sum_configuration = 0;
+        double sum_configuration = 0;
         for (auto i = 0; i < cardinality(0); ++i) {
             sum_configuration += joint_counts(offset + i);
         }
 
         if (sum_configuration > 0) {
-            auto inv_dbl_sum = static_cast<double>(1. / sum_configuration);
+            auto inv_dbl_sum = 1. / sum_configuration;
 
             for (auto i = 0; i < cardinality(0); ++i) {
                 if (joint_counts(offset + i) > 0) {
-                    auto dbl_count = static_cast<double>(joint_counts(offset + i));
+                    auto dbl_count = joint_counts(offset + i);
                     ll += dbl_count * std::log(dbl_count * inv_dbl_sum);
                 }
             }
         }
     }
 
-    double sum_count = static_cast<double>(joint_counts.sum());
+    double sum_count = joint_counts.sum();
     return ll - std::log(sum_count) * 0.5 * (cardinality(0) - 1) * parent_configurations;
 }
 
@@ -109,6 +160,8 @@ double BIC::local_score(const BayesianNetworkBase& model,
                         const std::string& variable,
                         const std::vector<std::string>& parents) const {
     const auto& node_type = *model.underlying_node_type(m_df, variable);
+    auto timer = local_score_timer(node_type);
+
     if (node_type == LinearGaussianCPDType::get_ref()) {
         std::vector<std::string> discrete_parents;
         std::vector<std::string> continuous_parents;
@@ -141,10 +194,35 @@ double BIC::local_score(const BayesianNetworkBase& model,
                                 "\" not valid for score BIC");
 }
 
+double BIC::local_score(const BayesianNetworkBase& model,
+                        const NodeColumns& columns,
+                        int variable,
+                        const util::ParentSet& parents) const {
+    // Without the table of columns, the string version is used. It also raises the errors for missing columns.
+    auto column = columns.empty() ? -1 : columns.column(variable);
+    if (column == -1 || columns.underlying_node_type(variable) != LinearGaussianCPDType::get_ref())
+        return Score::local_score(model, columns, variable, parents);
+
+    util::ParentSet parent_columns;
+    for (auto p : parents) {
+        auto parent_column = columns.column(p);
+        // A discrete parent needs a CLG local score.
+        if (parent_column == -1 || columns.underlying_node_type(p) == DiscreteFactorType::get_ref())
+            return Score::local_score(model, columns, variable, parents);
+
+        parent_columns.push_back(parent_column);
+    }
+
+    auto timer = local_score_timer(columns.underlying_node_type(variable));
+    return bic_lineargaussian(column, parent_columns);
+}
+
 double BIC::local_score(const BayesianNetworkBase& model,
                         const std::shared_ptr<FactorType>& node_type,
                         const std::string& variable,
                         const std::vector<std::string>& parents) const {
+    auto timer = local_score_timer(*node_type);
+
     if (*node_type == LinearGaussianCPDType::get_ref()) {
         return bic_lineargaussian(variable, parents);
     }
@@ -1,6 +1,7 @@
 #ifndef PYBNESIAN_LEARNING_SCORES_BIC_HPP
 #define PYBNESIAN_LEARNING_SCORES_BIC_HPP
 
+#include <dataset/chunked_dataframe.hpp>
 #include <learning/scores/scores.hpp>
 #include <learning/parameters/mle_LinearGaussianCPD.hpp>
 
@@ -13,7 +14,10 @@ namespace learning::scores {
 
 class BIC : public Score {
 public:
-    BIC(const DataFrame& df) : m_df(df) {}
+    BIC(const DataFrame& df) : BIC(ChunkedDataFrame(df)) {}
+    // The local scores are computed from the moments and counts of each chunk, so the chunks are never concatenated.
+    // With more than one chunk, data() only contains the schema of the data (it has no rows).
+    BIC(const ChunkedDataFrame& df) : m_df(df.schema_df()), m_chunks(df) {}
 
     double local_score(const BayesianNetworkBase& model,
                        const std::string& variable,
@@ -24,6 +28,13 @@ public:
                        const std::string& variable,
                        const std::vector<std::string>& parents) const override;
 
+    // The Gaussian local scores are computed with the column indices of columns, without looking up any name. The
+    // other node types use the names of the variables.
+    double local_score(const BayesianNetworkBase& model,
+                       const NodeColumns& columns,
+                       int variable,
+                       const util::ParentSet& parents) const override;
+
     std::string ToString() const override { return "BIC"; }
 
     bool has_variables(const std::string& name) const override { return m_df.has_columns(name); }
@@ -39,7 +50,8 @@ public:
     DataFrame data() const override { return m_df; }
 
 private:
-    double bic_lineargaussian(const std::string& variable, const std::vector<std::string>& parents) const;
+    template <typename Variable, typename Evidence>
+    double bic_lineargaussian(const Variable& variable, const Evidence& parents) const;
     double bic_discrete(const std::string& variable, const std::vector<std::string>& parents) const;
     double bic_clg(const std::string& variable,
                    const std::vector<std::string>& discrete_parents,
@@ -48,6 +60,7 @@ private:
     bool are_all_discrete(const BayesianNetworkBase& model, const std::vector<std::string>& vars) const;
 
     const DataFrame m_df;
+    const ChunkedDataFrame m_chunks;
 };
 
 using DynamicBIC = DynamicScoreAdaptator<BIC>;
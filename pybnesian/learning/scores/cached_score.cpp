@@ -0,0 +1,58 @@
+#include <algorithm>
+#include <learning/scores/cached_score.hpp>
+
+namespace learning::scores {
+
+LocalScoreKey local_score_key(const BayesianNetworkBase& model,
+                              const FactorType& node_type,
+                              const std::string& variable,
+                              const std::vector<std::string>& parents) {
+    std::vector<std::string> sorted_parents(parents);
+    std::sort(sorted_parents.begin(), sorted_parents.end());
+
+    LocalScoreKey key;
+    key.reserve(2 * (parents.size() + 1));
+    key.push_back(variable);
+    key.push_back(node_type.ToString());
+
+    for (const auto& parent : sorted_parents) {
+        key.push_back(parent);
+        key.push_back(model.node_type(parent)->ToString());
+    }
+
+    return key;
+}
+
+bool column_score_key(const NodeColumns& columns, int variable, const util::ParentSet& parents, ColumnScoreKey& key) {
+    if (columns.empty() || columns.column(variable) == -1) return false;
+
+    std::vector<std::pair<std::size_t, std::size_t>> sorted_parents;
+    sorted_parents.reserve(parents.size());
+    for (auto p : parents) {
+        if (columns.column(p) == -1) return false;
+        sorted_parents.push_back({columns.column(p), columns.node_type(p)->hash()});
+    }
+
+    std::sort(sorted_parents.begin(), sorted_parents.end());
+
+    key.reserve(2 * (parents.size() + 1));
+    key.push_back(columns.column(variable));
+    key.push_back(columns.node_type(variable)->hash());
+
+    for (const auto& parent : sorted_parents) {
+        key.push_back(parent.first);
+        key.push_back(parent.second);
+    }
+
+    return true;
+}
+
+std::shared_ptr<Score> cached_score(std::shared_ptr<const Score> score) {
+    if (auto validated = std::dynamic_pointer_cast<const ValidatedScore>(score)) {
+        return std::make_shared<CachedValidatedScore>(validated);
+    }
+
+    return std::make_shared<CachedScore>(score);
+}
+
+}  // namespace learning::scores
@@ -0,0 +1,228 @@
+#ifndef PYBNESIAN_LEARNING_SCORES_CACHED_SCORE_HPP
+#define PYBNESIAN_LEARNING_SCORES_CACHED_SCORE_HPP
+
+#include <array>
+#include <mutex>
+#include <learning/scores/scores.hpp>
+#include <util/hash_utils.hpp>
+
+namespace learning::scores {
+
+// Key of a local score: the variable and its node type, followed by the sorted parents and their node types. The local
+// scores of the hybrid models depend on the node types of the parents (e.g. discrete or continuous parents).
+using LocalScoreKey = std::vector<std::string>;
+
+struct LocalScoreKeyHash {
+    std::size_t operator()(const LocalScoreKey& key) const {
+        std::size_t seed = key.size();
+        for (const auto& s : key) util::hash_combine(seed, s);
+        return seed;
+    }
+};
+
+LocalScoreKey local_score_key(const BayesianNetworkBase& model,
+                              const FactorType& node_type,
+                              const std::string& variable,
+                              const std::vector<std::string>& parents);
+
+// Key of a local score computed from node indices: the data column of the variable and the hash of its node type,
+// followed by the sorted data columns of the parents and the hashes of their node types. The data columns, unlike the
+// node indices, do not depend on the model.
+using ColumnScoreKey = std::vector<std::size_t>;
+
+struct ColumnScoreKeyHash {
+    std::size_t operator()(const ColumnScoreKey& key) const {
+        std::size_t seed = key.size();
+        for (auto v : key) util::hash_combine(seed, v);
+        return seed;
+    }
+};
+
+// Returns false if a node is not in the data, so the local score has no ColumnScoreKey.
+bool column_score_key(const NodeColumns& columns, int variable, const util::ParentSet& parents, ColumnScoreKey& key);
+
+// Lock-striped table of local scores, so it can be used concurrently.
+template <typename Key, typename KeyHash>
+class LocalScoreMemo {
+public:
+    template <typename Compute>
+    double get(Key&& key, Compute compute) const {
+        auto& stripe = m_stripes[KeyHash{}(key) % num_stripes];
+
+        {
+            std::lock_guard<std::mutex> lock(stripe.mutex);
+            auto it = stripe.scores.find(key);
+            if (it != stripe.scores.end()) {
+                util::profiling::count("score_cache/hits");
+                return it->second;
+            }
+        }
+
+        util::profiling::count("score_cache/misses");
+
+        // The score is computed without holding the lock, so the rest of the threads can use the stripe.
+        auto score = compute();
+
+        std::lock_guard<std::mutex> lock(stripe.mutex);
+        stripe.scores.insert({std::move(key), score});
+        return score;
+    }
+
+    int num_cached() const {
+        int total = 0;
+        for (auto& stripe : m_stripes) {
+            std::lock_guard<std::mutex> lock(stripe.mutex);
+            total += static_cast<int>(stripe.scores.size());
+        }
+
+        return total;
+    }
+
+private:
+    static constexpr int num_stripes = 64;
+
+    struct Stripe {
+        std::mutex mutex;
+        std::unordered_map<Key, double, KeyHash> scores;
+    };
+
+    mutable std::array<Stripe, num_stripes> m_stripes;
+};
+
+// Local scores memoized by the names of the nodes.
+using NameScoreMemo = LocalScoreMemo<LocalScoreKey, LocalScoreKeyHash>;
+// Local scores memoized by the data columns of the nodes.
+using ColumnScoreMemo = LocalScoreMemo<ColumnScoreKey, ColumnScoreKeyHash>;
+
+// Memoizes the local scores of a Score, so a local score is computed only once even if it is requested by different
+// models, e.g. the restarts of a multi-start hill-climbing (see hc_restarts()). The cache can be used concurrently if
+// the wrapped score can be used concurrently.
+class CachedScore : public Score {
+public:
+    CachedScore(std::shared_ptr<const Score> score) : m_score(score), m_memo(), m_column_memo() {
+        if (!m_score) throw std::invalid_argument("Score is null.");
+    }
+
+    using Score::local_score;
+
+    double local_score(const BayesianNetworkBase& model,
+                       const std::string& variable,
+                       const std::vector<std::string>& parents) const override {
+        return local_score(model, model.node_type(variable), variable, parents);
+    }
+
+    double local_score(const BayesianNetworkBase& model,
+                       const std::shared_ptr<FactorType>& node_type,
+                       const std::string& variable,
+                       const std::vector<std::string>& parents) const override {
+        return m_memo.get(local_score_key(model, *node_type, variable, parents),
+                          [&]() { return m_score->local_score(model, node_type, variable, parents); });
+    }
+
+    double local_score(const BayesianNetworkBase& model,
+                       const NodeColumns& columns,
+                       int variable,
+                       const util::ParentSet& parents) const override {
+        ColumnScoreKey key;
+        if (!column_score_key(columns, variable, parents, key))
+            return Score::local_score(model, columns, variable, parents);
+
+        return m_column_memo.get(std::move(key),
+                                 [&]() { return m_score->local_score(model, columns, variable, parents); });
+    }
+
+    std::string ToString() const override { return "CachedScore(" + m_score->ToString() + ")"; }
+    bool has_variables(const std::string& name) const override { return m_score->has_variables(name); }
+    bool has_variables(const std::vector<std::string>& cols) const override { return m_score->has_variables(cols); }
+    bool compatible_bn(const BayesianNetworkBase& model) const override { return m_score->compatible_bn(model); }
+    bool compatible_bn(const ConditionalBayesianNetworkBase& model) const override {
+        return m_score->compatible_bn(model);
+    }
+    DataFrame data() const override { return m_score->data(); }
+
+    const Score& score() const { return *m_score; }
+    int num_cached() const { return m_memo.num_cached() + m_column_memo.num_cached(); }
+
+private:
+    std::shared_ptr<const Score> m_score;
+    NameScoreMemo m_memo;
+    // The local scores of the structure learning operators, computed from node indices (see NodeColumns).
+    ColumnScoreMemo m_column_memo;
+};
+
+// Version of CachedScore for a ValidatedScore. The validation local scores are memoized in a separate table.
+class CachedValidatedScore : public ValidatedScore {
+public:
+    CachedValidatedScore(std::shared_ptr<const ValidatedScore> score)
+        : m_score(score), m_memo(), m_column_memo(), m_vmemo() {
+        if (!m_score) throw std::invalid_argument("Score is null.");
+    }
+
+    using ValidatedScore::local_score;
+    using ValidatedScore::vlocal_score;
+
+    double local_score(const BayesianNetworkBase& model,
+                       const std::string& variable,
+                       const std::vector<std::string>& parents) const override {
+        return local_score(model, model.node_type(variable), variable, parents);
+    }
+
+    double local_score(const BayesianNetworkBase& model,
+                       const std::shared_ptr<FactorType>& node_type,
+                       const std::string& variable,
+                       const std::vector<std::string>& parents) const override {
+        return m_memo.get(local_score_key(model, *node_type, variable, parents),
+                          [&]() { return m_score->local_score(model, node_type, variable, parents); });
+    }
+
+    double local_score(const BayesianNetworkBase& model,
+                       const NodeColumns& columns,
+                       int variable,
+                       const util::ParentSet& parents) const override {
+        ColumnScoreKey key;
+        if (!column_score_key(columns, variable, parents, key))
+            return ValidatedScore::local_score(model, columns, variable, parents);
+
+        return m_column_memo.get(std::move(key),
+                                 [&]() { return m_score->local_score(model, columns, variable, parents); });
+    }
+
+    double vlocal_score(const BayesianNetworkBase& model,
+                        const std::string& variable,
+                        const std::vector<std::string>& parents) const override {
+        return vlocal_score(model, model.node_type(variable), variable, parents);
+    }
+
+    double vlocal_score(const BayesianNetworkBase& model,
+                        const std::shared_ptr<FactorType>& node_type,
+                        const std::string& variable,
+                        const std::vector<std::string>& parents) const override {
+        return m_vmemo.get(local_score_key(model, *node_type, variable, parents),
+                           [&]() { return m_score->vlocal_score(model, node_type, variable, parents); });
+    }
+
+    std::string ToString() const override { return "CachedScore(" + m_score->ToString() + ")"; }
+    bool has_variables(const std::string& name) const override { return m_score->has_variables(name); }
+    bool has_variables(const std::vector<std::string>& cols) const override { return m_score->has_variables(cols); }
+    bool compatible_bn(const BayesianNetworkBase& model) const override { return m_score->compatible_bn(model); }
+    bool compatible_bn(const ConditionalBayesianNetworkBase& model) const override {
+        return m_score->compatible_bn(model);
+    }
+    DataFrame data() const override { return m_score->data(); }
+
+    const ValidatedScore& score() const { return *m_score; }
+    int num_cached() const { return m_memo.num_cached() + m_column_memo.num_cached() + m_vmemo.num_cached(); }
+
+private:
+    std::shared_ptr<const ValidatedScore> m_score;
+    NameScoreMemo m_memo;
+    ColumnScoreMemo m_column_memo;
+    NameScoreMemo m_vmemo;
+};
+
+// Wraps the score in a CachedValidatedScore if it is a ValidatedScore, or in a CachedScore otherwise.
+std::shared_ptr<Score> cached_score(std::shared_ptr<const Score> score);
+
+}  // namespace learning::scores
+
+#endif  // PYBNESIAN_LEARNING_SCORES_CACHED_SCORE_HPP
@@ -14,15 +14,25 @@ double CVLikelihood::local_score(const BayesianNetworkBase& model,
                                  const std::shared_ptr<FactorType>& variable_type,
                                  const std::string& variable,
                                  const std::vector<std::string>& evidence) const {
+    auto timer = local_score_timer(*variable_type);
+
     auto [args, kwargs] = m_arguments.args(variable, variable_type);
     auto cpd = variable_type->new_factor(model, variable, evidence, args, kwargs);
 
     double loglik = 0;
 
-    for (auto [train_df, test_df] : m_cv.loc(variable, evidence)) {
-        cpd->fit(train_df);
-        loglik += cpd->slogl(test_df);
+    std::vector<std::string> columns{variable};
+    columns.insert(columns.end(), evidence.begin(), evidence.end());
+
+    // The training folds are fitted with the weights, and the log-likelihood of the test folds is weighted.
+    for (auto [train_df, test_df] : m_cv.loc_weighted(columns)) {
+        {
+            auto fit_timer = factor_fit_timer(*variable_type);
+            cpd->fit(train_df);
+        }
 
+        auto logl_timer = factor_logl_timer(*variable_type);
+        loglik += factors::weighted_slogl(*cpd, test_df);
     }
     return loglik;
 }
@@ -15,11 +15,18 @@ double HoldoutLikelihood::local_score(const BayesianNetworkBase& model,
                                       const std::shared_ptr<FactorType>& variable_type,
                                       const std::string& variable,
                                       const std::vector<std::string>& evidence) const {
+    auto timer = local_score_timer(*variable_type);
+
     auto [args, kwargs] = m_arguments.args(variable, variable_type);
 
     auto cpd = variable_type->new_factor(model, variable, evidence, args, kwargs);
-    cpd->fit(training_data());
-    return cpd->slogl(test_data());
+    {
+        auto fit_timer = factor_fit_timer(*variable_type);
+        cpd->fit(training_data());
+    }
+
+    auto logl_timer = factor_logl_timer(*variable_type);
+    return factors::weighted_slogl(*cpd, test_data());
 }
 
 }  // namespace learning::scores
\ No newline at end of file
@@ -1,22 +1,87 @@
 #ifndef PYBNESIAN_LEARNING_SCORES_SCORES_HPP
 #define PYBNESIAN_LEARNING_SCORES_SCORES_HPP
 
+#include <algorithm>
+#include <atomic>
 #include <models/GaussianNetwork.hpp>
 #include <models/SemiparametricBN.hpp>
 #include <dataset/dynamic_dataset.hpp>
+#include <util/profiling.hpp>
 using dataset::DynamicDataFrame, dataset::DynamicAdaptator;
 using models::BayesianNetworkBase, models::GaussianNetwork, models::SemiparametricBN;
 using models::ConditionalBayesianNetworkBase;
 
 namespace learning::scores {
 
+// Times a local score computation. The measurements are grouped by the node type.
+inline util::profiling::ScopedTimer local_score_timer(const FactorType& node_type) {
+    return util::profiling::ScopedTimer([&node_type]() { return "local_score/" + node_type.ToString(); });
+}
+
+// Data columns and node types of the nodes of a model, indexed by node index. The operator sets compute it once per
+// (model, score) pair (see Score::node_columns()), so the local scores computed from node indices do not look up the
+// names of the nodes.
+class NodeColumns {
+public:
+    NodeColumns() = default;
+    NodeColumns(const BayesianNetworkBase& model, const DataFrame& df) : m_df(df) {
+        int size = 0;
+        for (const auto& p : model.indices()) size = std::max(size, p.second + 1);
+
+        m_columns.resize(size, -1);
+        m_node_types.resize(size);
+        m_underlying_types.resize(size);
+
+        for (const auto& p : model.indices()) {
+            m_columns[p.second] = m_df.index(p.first);
+            update(model, p.second);
+        }
+    }
+
+    // Updates the node types of a node, e.g. after a change of its node type.
+    void update(const BayesianNetworkBase& model, int node) {
+        const auto& name = model.name(node);
+        m_node_types[node] = model.node_type(name);
+        if (m_columns[node] != -1) m_underlying_types[node] = model.underlying_node_type(m_df, name);
+    }
+
+    bool empty() const { return m_columns.empty(); }
+    // Column of the node in the data of the score, or -1 if the data does not contain the node.
+    int column(int node) const { return m_columns[node]; }
+    const std::shared_ptr<FactorType>& node_type(int node) const { return m_node_types[node]; }
+    // Node type of the node, with the unknown node types replaced by the default node type for its column. It is only
+    // defined if column(node) != -1.
+    const FactorType& underlying_node_type(int node) const { return *m_underlying_types[node]; }
+
+private:
+    DataFrame m_df;
+    std::vector<int> m_columns;
+    std::vector<std::shared_ptr<FactorType>> m_node_types;
+    std::vector<std::shared_ptr<FactorType>> m_underlying_types;
+};
+
 class Score {
 public:
+    Score() : m_score_id(new_score_id()) {}
     virtual ~Score() {}
+    virtual bool is_python_derived() const { return false; }
+
+    // The local scores are cached in the model (see BayesianNetworkBase::cached_local_score()), so after a local change
+    // of the structure only the modified nodes are scored again. The local scores of the scores implemented in Python
+    // are not cached, because they can depend on some Python state.
     virtual double score(const BayesianNetworkBase& model) const {
         double s = 0;
         for (const auto& node : model.nodes()) {
-            s += local_score(model, node);
+            if (is_python_derived()) {
+                s += local_score(model, node);
+            } else if (auto cached = model.cached_local_score(node, m_score_id)) {
+                s += *cached;
+                util::profiling::count("score/cache_hits");
+            } else {
+                auto ls = local_score(model, node);
+                model.cache_local_score(node, m_score_id, ls);
+                s += ls;
+            }
         }
 
         return s;
@@ -30,6 +95,29 @@ public:
     virtual double local_score(const BayesianNetworkBase& model,
                                const std::string& variable,
                                const std::vector<std::string>& parents) const = 0;
+    // Table of the nodes of model in the data of the score, for the local scores computed from node indices. It is
+    // empty for the scores implemented in Python.
+    NodeColumns node_columns(const BayesianNetworkBase& model) const {
+        if (is_python_derived()) return NodeColumns();
+        return NodeColumns(model, data());
+    }
+
+    // Local score with the variable and parents given as node indices of the model. columns must be the node_columns()
+    // of model. The default implementation converts the indices to names. The scores can override it to avoid the
+    // string lookups in the structure learning: BIC (Gaussian nodes without discrete parents), BGe and the cached
+    // scores do. The discrete and CLG local scores of BIC, BDe and the likelihood scores still use the names.
+    virtual double local_score(const BayesianNetworkBase& model,
+                               const NodeColumns&,
+                               int variable,
+                               const util::ParentSet& parents) const {
+        std::vector<std::string> parent_names;
+        parent_names.reserve(parents.size());
+        for (auto p : parents) {
+            parent_names.push_back(model.name(p));
+        }
+
+        return local_score(model, model.name(variable), parent_names);
+    }
     virtual double local_score(const BayesianNetworkBase& model,
                                const std::shared_ptr<FactorType>& node_type,
                                const std::string& variable,
@@ -41,6 +129,16 @@ public:
     virtual bool compatible_bn(const BayesianNetworkBase& model) const = 0;
     virtual bool compatible_bn(const ConditionalBayesianNetworkBase& model) const = 0;
     virtual DataFrame data() const = 0;
+
+private:
+    static uint64_t new_score_id() {
+        static std::atomic<uint64_t> next_id{1};
+        return next_id++;
+    }
+
+    // Identifies the score in the cache of local scores of the models. The data of a score does not change, so a copy
+    // of the score can share the identifier.
+    uint64_t m_score_id;
 };
 
 class ValidatedScore : public Score {
@@ -3,6 +3,9 @@
 #include <arrow/python/platform.h>
 #include <arrow/api.h>
 #include <util/pickle.hpp>
+#include <util/parallel.hpp>
+#include <util/binary_serialization.hpp>
+#include <util/profiling.hpp>
 
 #define STRINGIFY(x)       #x
 #define MACRO_STRINGIFY(x) STRINGIFY(x)
@@ -16,6 +19,7 @@ void pybindings_factors(py::module& root);
 void pybindings_graph(py::module& root);
 void pybindings_models(py::module& root);
 void pybindings_learning(py::module& root);
+void pybindings_inference(py::module& root);
 
 /*This module is needed to trick the MSVC linker, so a PyInit___init__() method exists.*/
 #ifdef _MSC_VER
@@ -63,6 +67,114 @@ Load the saved object (a :class:`Factor <pybnesian.Factor>`, a graph, a :class:`
 
 :param filename: File name.
 :returns: The object saved in the file.
+)doc");
+
+    m.def("save_binary", &util::save_binary, py::arg("obj"), py::arg("filename"), R"doc(
+Saves an object (a :class:`Factor <pybnesian.Factor>`, a :class:`BayesianNetworkBase <pybnesian.BayesianNetworkBase>`,
+etc...) in the PyBNesian binary format. The numeric arrays of the object (e.g. the training data of the KDEs) are stored
+as raw sections, so they can be memory-mapped by :func:`load_binary`. If ``filename`` does not end in ``.pbn``, the
+extension is added.
+
+:param obj: Object to save. It must be pickleable.
+:param filename: File name.
+)doc");
+
+    m.def("load_binary", &util::load_binary, py::arg("filename"), R"doc(
+Loads an object saved with :func:`save_binary`. The file is memory-mapped and the numeric arrays of the object reference
+the file, so the data is not copied. Loading a model with large KDEs is fast, and all the processes that load the same
+file share its memory.
+
+:param filename: File name.
+:returns: The object saved in the file.
+:raises ValueError: If the file is not a valid PyBNesian binary file.
+)doc");
+
+    m.def("num_threads", &util::num_threads, R"doc(
+Returns the number of threads used by the parallel algorithms of PyBNesian.
+
+:returns: The number of threads.
+)doc");
+
+    m.def("set_num_threads", &util::set_num_threads, py::arg("n"), R"doc(
+Sets the number of threads used by the parallel algorithms of PyBNesian. By default, all the available cores are used
+(or the value of the ``OMP_NUM_THREADS`` environment variable). The setting is global: it also applies to the
+algorithms called from other Python threads.
+
+The threads are kept alive between calls, and small problems are solved in the calling thread. When a parallel
+algorithm runs inside another one (e.g. the KDE of each CPD in :func:`BayesianNetworkBase.logl
+<pybnesian.BayesianNetworkBase.logl>`), the work is shared among the threads that are already running, so the number
+of threads is never exceeded.
+
+:param n: Number of threads. It must be a positive number.
+)doc");
+
+    m.def("enable_profiling", &util::profiling::enable, py::arg("trace") = false, R"doc(
+Enables the profiling counters and timers of PyBNesian. While profiling is enabled, the structure learning algorithms
+measure their hot paths: the local scores (grouped by node type), the fit and log-likelihood of the factors, the
+independence tests (grouped by test and size of the conditioning set), the hits of
+:class:`CachedIndependenceTest <pybnesian.CachedIndependenceTest>`, the DAG cycle checks and the operator updates of
+hill-climbing. The measurements of all the threads are accumulated until :func:`reset_profiling` is called.
+
+Profiling is disabled by default, and its cost is negligible while disabled.
+
+:param trace: If True, each timed section is also recorded as an event of a Chrome trace, that can be saved with
+    :func:`save_profiling_trace`.
+)doc");
+
+    m.def("disable_profiling", &util::profiling::disable, R"doc(
+Disables the profiling counters and timers. The measurements taken are kept.
+)doc");
+
+    m.def("reset_profiling", &util::profiling::reset, R"doc(
+Removes all the profiling measurements and trace events.
+)doc");
+
+    m.def(
+        "profiling_stats",
+        []() {
+            auto stats = util::profiling::stats();
+
+            py::dict timers;
+            for (const auto& [name, t] : stats.timers) {
+                py::dict timer;
+                timer["count"] = t.count;
+                timer["total_time"] = t.total_seconds;
+                timer["min_time"] = t.min_seconds;
+                timer["max_time"] = t.max_seconds;
+                timers[py::str(name)] = timer;
+            }
+
+            py::dict counters;
+            for (const auto& [name, c] : stats.counters) {
+                counters[py::str(name)] = c;
+            }
+
+            py::dict res;
+            res["timers"] = timers;
+            res["counters"] = counters;
+            res["dropped_trace_events"] = stats.dropped_trace_events;
+            return res;
+        },
+        R"doc(
+Returns the profiling measurements taken since the last :func:`reset_profiling`. It can be called after a run or during
+a run (e.g. from a :class:`Callback <pybnesian.Callback>` of :func:`hc`). The returned dict has the keys:
+
+- ``"timers"``: a dict from the name of each timed section to a dict with the ``"count"``, ``"total_time"``,
+  ``"min_time"`` and ``"max_time"`` (in seconds) of the section.
+- ``"counters"``: a dict from the name of each counter to its value.
+- ``"dropped_trace_events"``: number of trace events not recorded because the trace buffer was full.
+
+The names are hierarchical, e.g. ``"local_score/LinearGaussianFactor"``, ``"ci_test/LinearCorrelation/2"`` (a
+:class:`LinearCorrelation <pybnesian.LinearCorrelation>` test with a conditioning set of size 2) or ``"hc/find_max"``.
+
+:returns: A dict with the profiling measurements.
+)doc");
+
+    m.def("save_profiling_trace", &util::profiling::save_trace, py::arg("filename"), R"doc(
+Saves the trace events recorded while profiling was enabled with ``trace=True`` in the Chrome trace event format (JSON).
+The file can be opened with ``chrome://tracing`` or `Perfetto <https://ui.perfetto.dev>`_.
+
+:param filename: File name.
 )doc");
 
     pybindings_dataset(m);
@@ -71,4 +183,5 @@ Load the saved object (a :class:`Factor <pybnesian.Factor>`, a graph, a :class:`
     pybindings_graph(m);
     pybindings_models(m);
     pybindings_learning(m);
+    pybindings_inference(m);
 }
\ No newline at end of file
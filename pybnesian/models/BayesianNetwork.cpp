@@ -1,4 +1,8 @@
+#include <arrow/array/concatenate.h>
 #include <models/BayesianNetwork.hpp>
+#include <util/arrow_macros.hpp>
+#include <util/parallel.hpp>
+#include <util/random.hpp>
 
 namespace models {
 
@@ -48,6 +52,131 @@ void requires_discrete_data(const DataFrame& df) {
     }
 }
 
+void for_each_factor(const std::vector<int>& sequential,
+                     const std::vector<int>& concurrent,
+                     const std::function<void(int)>& func,
+                     int num_threads) {
+    std::exception_ptr eptr = nullptr;
+
+#pragma omp parallel if (concurrent.size() > 1) num_threads(num_threads)
+    {
+        // The calling thread is the master thread, so it holds the GIL.
+#pragma omp master
+        {
+            for (auto i : sequential) {
+                try {
+                    func(i);
+                } catch (...) {
+#pragma omp critical
+                    {
+                        if (!eptr) eptr = std::current_exception();
+                    }
+                }
+            }
+        }
+
+#pragma omp for schedule(dynamic) nowait
+        for (size_t k = 0; k < concurrent.size(); ++k) {
+            try {
+                func(concurrent[k]);
+            } catch (...) {
+#pragma omp critical
+                {
+                    if (!eptr) eptr = std::current_exception();
+                }
+            }
+        }
+    }
+
+    if (eptr) std::rethrow_exception(eptr);
+}
+
+std::vector<Array_ptr> forward_sample(const std::vector<std::string>& top_sort,
+                                      const std::vector<std::shared_ptr<Factor>>& cpds,
+                                      const DataFrame& evidence,
+                                      int n,
+                                      unsigned int seed) {
+    auto num_nodes = top_sort.size();
+
+    std::unordered_map<std::string, int> position;
+    for (size_t i = 0; i < num_nodes; ++i) {
+        position.insert({top_sort[i], i});
+    }
+
+    // The nodes of the same depth do not depend on each other.
+    std::vector<int> depth(num_nodes, 0);
+    std::vector<std::vector<int>> levels;
+    // Python factors need the GIL, so they are sampled sequentially.
+    bool parallel = true;
+    for (size_t i = 0; i < num_nodes; ++i) {
+        for (const auto& p : cpds[i]->evidence()) {
+            auto it = position.find(p);
+            if (it != position.end()) depth[i] = std::max(depth[i], depth[it->second] + 1);
+        }
+
+        if (static_cast<size_t>(depth[i]) >= levels.size()) levels.resize(depth[i] + 1);
+        levels[depth[i]].push_back(i);
+
+        if (cpds[i]->is_python_derived()) parallel = false;
+    }
+
+    auto num_chunks = static_cast<int>((static_cast<int64_t>(n) + sample_chunk_size - 1) / sample_chunk_size);
+    num_chunks = std::max(1, num_chunks);
+    std::vector<std::vector<Array_ptr>> chunks(num_nodes, std::vector<Array_ptr>(num_chunks));
+
+    std::exception_ptr exception;
+    for (const auto& level : levels) {
+        int num_tasks = level.size() * num_chunks;
+
+#pragma omp parallel for schedule(dynamic) if (parallel) num_threads(util::num_threads())
+        for (int t = 0; t < num_tasks; ++t) {
+            auto i = level[t / num_chunks];
+            auto c = t % num_chunks;
+            auto offset = static_cast<int64_t>(c) * sample_chunk_size;
+            auto length = static_cast<int>(std::min(static_cast<int64_t>(sample_chunk_size), n - offset));
+
+            try {
+                std::vector<Field_ptr> fields;
+                std::vector<Array_ptr> columns;
+                for (const auto& p : cpds[i]->evidence()) {
+                    auto it = position.find(p);
+                    auto column =
+                        (it != position.end()) ? chunks[it->second][c] : evidence.col(p)->Slice(offset, length);
+                    fields.push_back(arrow::field(p, column->type()));
+                    columns.push_back(column);
+                }
+
+                DataFrame parents(arrow::RecordBatch::Make(arrow::schema(fields), length, columns));
+
+                // The first chunk uses the same seed as sampling the node alone, so the samples with less than
+                // sample_chunk_size rows do not depend on the chunking.
+                auto chunk_seed = (c == 0) ? seed + i : util::substream_seed(seed + i, c);
+                chunks[i][c] = cpds[i]->sample(length, parents, chunk_seed);
+            } catch (...) {
+#pragma omp critical
+                {
+                    if (!exception) exception = std::current_exception();
+                }
+            }
+        }
+
+        if (exception) std::rethrow_exception(exception);
+    }
+
+    std::vector<Array_ptr> res;
+    res.reserve(num_nodes);
+    for (auto& node_chunks : chunks) {
+        if (num_chunks == 1) {
+            res.push_back(node_chunks[0]);
+        } else {
+            RAISE_RESULT_ERROR(auto concatenated, arrow::Concatenate(node_chunks))
+            res.push_back(concatenated);
+        }
+    }
+
+    return res;
+}
+
 DataFrame ConditionalBayesianNetwork::sample(const DataFrame& evidence,
                                              unsigned int seed,
                                              bool concat_evidence,
@@ -55,30 +184,38 @@ DataFrame ConditionalBayesianNetwork::sample(const DataFrame& evidence,
     this->check_fitted();
     evidence.raise_has_columns(interface_nodes());
 
-    DataFrame parents(evidence);
-
     auto top_sort = this->g.topological_sort();
-    for (size_t i = 0; i < top_sort.size(); ++i) {
-        auto idx = this->index(top_sort[i]);
-        auto array = this->m_cpds[idx]->sample(evidence->num_rows(), parents, seed + i);
-
-        auto res = parents->AddColumn(evidence->num_columns() + i, top_sort[i], array);
-        parents = DataFrame(std::move(res).ValueOrDie());
+    std::vector<std::shared_ptr<Factor>> cpds;
+    cpds.reserve(top_sort.size());
+    for (const auto& node : top_sort) {
+        cpds.push_back(this->m_cpds[this->index(node)]);
     }
 
+    auto sampled = forward_sample(top_sort, cpds, evidence, evidence->num_rows(), seed);
+
     std::vector<Field_ptr> fields;
     std::vector<Array_ptr> columns;
 
-    auto schema = parents->schema();
     if (ordered) {
+        std::unordered_map<std::string, int> position;
+        for (size_t i = 0; i < top_sort.size(); ++i) {
+            position.insert({top_sort[i], i});
+        }
+
         for (const auto& name : this->nodes()) {
-            fields.push_back(schema->GetFieldByName(name));
-            columns.push_back(parents.col(name));
+            auto it = position.find(name);
+            if (it != position.end()) {
+                fields.push_back(arrow::field(name, sampled[it->second]->type()));
+                columns.push_back(sampled[it->second]);
+            } else {
+                fields.push_back(evidence->schema()->GetFieldByName(name));
+                columns.push_back(evidence.col(name));
+            }
         }
     } else {
-        for (auto i = evidence->num_columns(); i < parents->num_columns(); ++i) {
-            fields.push_back(schema->field(i));
-            columns.push_back(parents.col(i));
+        for (size_t i = 0; i < top_sort.size(); ++i) {
+            fields.push_back(arrow::field(top_sort[i], sampled[i]->type()));
+            columns.push_back(sampled[i]);
         }
     }
 
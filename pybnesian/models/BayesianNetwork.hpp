@@ -1,13 +1,19 @@
 #ifndef PYBNESIAN_MODELS_BAYESIANNETWORK_HPP
 #define PYBNESIAN_MODELS_BAYESIANNETWORK_HPP
 
+#include <functional>
+#include <mutex>
+#include <optional>
 #include <random>
 #include <dataset/dataset.hpp>
 #include <factors/factors.hpp>
 #include <factors/arguments.hpp>
 #include <factors/unknown_factor.hpp>
 #include <graph/generic_graph.hpp>
+#include <util/hash_utils.hpp>
+#include <util/parallel.hpp>
 #include <util/parameter_traits.hpp>
+#include <util/small_vector.hpp>
 #include <util/virtual_clone.hpp>
 #include <omp.h>
 
@@ -52,6 +58,14 @@ public:
     virtual int num_parents(const std::string& node) const = 0;
     virtual int num_children(const std::string& node) const = 0;
     virtual std::vector<std::string> parents(const std::string& node) const = 0;
+    // Indices of the parents of a node. It avoids creating the parent names in the hot loops of structure learning.
+    virtual util::ParentSet parent_indices(int node_index) const {
+        util::ParentSet res;
+        for (const auto& p : parents(name(node_index))) {
+            res.push_back(index(p));
+        }
+        return res;
+    }
     virtual std::vector<std::string> children(const std::string& node) const = 0;
     virtual bool has_arc(const std::string& source, const std::string& target) const = 0;
     virtual bool has_path(const std::string& source, const std::string& target) const = 0;
@@ -81,6 +95,14 @@ public:
     virtual void fit(const DataFrame& df, const Arguments& construction_args = Arguments()) = 0;
     virtual VectorXd logl(const DataFrame& df) const = 0;
     virtual double slogl(const DataFrame& df) const = 0;
+
+    // Cache of the local score of each node, used by Score::score(). score_id identifies the score that computed the
+    // value. The cached value of a node is dropped when its parents or its node type change.
+    virtual std::optional<double> cached_local_score(const std::string&, uint64_t) const { return std::nullopt; }
+    virtual void cache_local_score(const std::string&, uint64_t, double) const {}
+    // Drops the cached slogl() contribution of a node. It must be called if its CPD is modified in place.
+    virtual void invalidate_cpd(const std::string&) {}
+
     virtual std::shared_ptr<BayesianNetworkType> type() const = 0;
     virtual BayesianNetworkType& type_ref() const = 0;
     virtual DataFrame sample(int n, unsigned int seed = std::random_device{}(), bool ordered = false) const = 0;
@@ -304,6 +326,27 @@ protected:
 void requires_continuous_data(const DataFrame& df);
 void requires_discrete_data(const DataFrame& df);
 
+// Number of rows of each chunk in forward sampling. It is fixed (instead of depending on the number of threads), so the
+// samples are reproducible for a given seed.
+constexpr int sample_chunk_size = 65536;
+
+// Forward sampling of the nodes in top_sort (in topological order) using their cpds. evidence contains the values of
+// the parents that are not sampled (e.g. interface nodes). The rows are split in chunks of sample_chunk_size rows, and
+// the nodes of the same depth are sampled concurrently. Returns the sampled arrays in the order of top_sort.
+std::vector<Array_ptr> forward_sample(const std::vector<std::string>& top_sort,
+                                      const std::vector<std::shared_ptr<Factor>>& cpds,
+                                      const DataFrame& evidence,
+                                      int n,
+                                      unsigned int seed);
+
+// Calls func(i) for each index in sequential and concurrent. The indices in sequential (e.g. the Python factors, which
+// need the GIL) are processed by the calling thread, while the indices in concurrent are processed by all the threads in
+// the given order, using at most num_threads threads. The first exception is rethrown in the calling thread.
+void for_each_factor(const std::vector<int>& sequential,
+                     const std::vector<int>& concurrent,
+                     const std::function<void(int)>& func,
+                     int num_threads = util::num_threads());
+
 template <typename DagType>
 class BNGeneric;
 
@@ -503,6 +546,8 @@ public:
 
     int add_node(const std::string& node) override {
         int idx = g.add_node(node);
+        // The index of a removed node can be reused.
+        clear_node_cache(idx);
 
         if (idx == (g.num_raw_nodes() - 1)) {
             if (!m_cpds.empty()) m_cpds.resize(idx + 1);
@@ -516,6 +561,9 @@ public:
     }
 
     void remove_node(const std::string& node) override {
+        clear_node_cache(g.index(node));
+        clear_children_cache(node);
+
         if (!m_cpds.empty()) {
             m_cpds[g.index(node)] = nullptr;
         }
@@ -537,6 +585,11 @@ public:
 
     std::vector<std::string> parents(const std::string& node) const override { return g.parents(node); }
 
+    util::ParentSet parent_indices(int node_index) const override {
+        const auto& ps = g.parent_set(node_index);
+        return util::ParentSet(ps.begin(), ps.end());
+    }
+
     std::vector<std::string> children(const std::string& node) const override { return g.children(node); }
 
     bool has_arc(const std::string& source, const std::string& target) const override {
@@ -555,9 +608,15 @@ public:
         }
     }
 
-    void add_arc_unsafe(const std::string& source, const std::string& target) override { g.add_arc(source, target); }
+    void add_arc_unsafe(const std::string& source, const std::string& target) override {
+        g.add_arc(source, target);
+        clear_node_cache(index(target));
+    }
 
-    void remove_arc(const std::string& source, const std::string& target) override { g.remove_arc(source, target); }
+    void remove_arc(const std::string& source, const std::string& target) override {
+        g.remove_arc(source, target);
+        clear_node_cache(index(target));
+    }
 
     void flip_arc(const std::string& source, const std::string& target) override {
         if (can_flip_arc(source, target)) {
@@ -567,7 +626,11 @@ public:
         }
     }
 
-    void flip_arc_unsafe(const std::string& source, const std::string& target) override { g.flip_arc(source, target); }
+    void flip_arc_unsafe(const std::string& source, const std::string& target) override {
+        g.flip_arc(source, target);
+        clear_node_cache(index(source));
+        clear_node_cache(index(target));
+    }
 
     bool can_add_arc(const std::string& source, const std::string& target) const override {
         return g.can_add_arc(source, target) && m_type->can_have_arc(*this, source, target);
@@ -627,6 +690,29 @@ public:
                                     const std::vector<std::string>& model_parents) const;
     void add_cpds(const std::vector<std::shared_ptr<Factor>>& cpds) override;
     void fit(const DataFrame& df, const Arguments& construction_args = Arguments()) override;
+
+    std::optional<double> cached_local_score(const std::string& node, uint64_t score_id) const override {
+        auto idx = check_index(node);
+        std::lock_guard<std::mutex> lock(m_node_cache.mutex);
+        const auto& entries = m_node_cache.entries;
+        if (idx < static_cast<int>(entries.size()) && entries[idx].has_local_score && entries[idx].score_id == score_id)
+            return entries[idx].local_score;
+        return std::nullopt;
+    }
+
+    void cache_local_score(const std::string& node, uint64_t score_id, double value) const override {
+        auto idx = check_index(node);
+        std::lock_guard<std::mutex> lock(m_node_cache.mutex);
+        m_node_cache.reserve(num_raw_nodes());
+
+        auto& cache = m_node_cache.entries[idx];
+        cache.has_local_score = true;
+        cache.score_id = score_id;
+        cache.local_score = value;
+    }
+
+    void invalidate_cpd(const std::string& node) override { clear_slogl_cache(check_index(node)); }
+
     VectorXd logl(const DataFrame& df) const override;
     double slogl(const DataFrame& df) const override;
 
@@ -712,6 +798,7 @@ public:
 
             auto node_index = check_index(node);
             m_node_types[node_index] = new_type;
+            clear_node_cache(node_index);
 
             if (!m_cpds.empty() && m_cpds[node_index] && *m_node_types[node_index] != m_cpds[node_index]->type_ref())
                 m_cpds[node_index] = nullptr;
@@ -790,6 +877,10 @@ public:
                 }
             }
 
+            for (const auto& p : type_whitelist) {
+                clear_node_cache(index(p.first));
+            }
+
             if (!m_cpds.empty()) {
                 for (const auto& p : type_whitelist) {
                     auto node_index = index(p.first);
@@ -812,12 +903,79 @@ public:
 
 protected:
     void check_fitted() const;
+
+    void clear_node_cache(int idx) {
+        std::lock_guard<std::mutex> lock(m_node_cache.mutex);
+        if (idx < static_cast<int>(m_node_cache.entries.size())) m_node_cache.entries[idx] = NodeCache{};
+    }
+
+    void clear_slogl_cache(int idx) {
+        std::lock_guard<std::mutex> lock(m_node_cache.mutex);
+        if (idx < static_cast<int>(m_node_cache.entries.size())) m_node_cache.entries[idx].has_slogl = false;
+    }
+
+    // The CPDs implemented in Python, or referenced outside of this model (e.g. a CPD passed to add_cpds() and kept in a
+    // Python variable), can be modified without notice, so their slogl() contributions are not cached.
+    bool cacheable_cpd(int idx) const { return !m_cpds[idx]->is_python_derived() && m_cpds[idx].use_count() == 1; }
+
+    // Removing a node or an interface node also removes it from the parents of its children.
+    void clear_children_cache(const std::string& node) {
+        for (const auto& child : g.children(node)) {
+            clear_node_cache(index(child));
+        }
+    }
+
     DagType g;
     std::shared_ptr<BayesianNetworkType> m_type;
     std::vector<std::shared_ptr<Factor>> m_cpds;
     std::vector<std::shared_ptr<FactorType>> m_node_types;
     // This is necessary because __getstate__() do not admit parameters.
     mutable bool m_include_cpd;
+
+    // Contribution of a node to slogl() and Score::score(). The slogl() value is valid for the data with hash
+    // slogl_data_hash (see dataset::array_hash()), and the local score for the score with identifier score_id.
+    struct NodeCache {
+        bool has_slogl = false;
+        uint64_t slogl_data_hash = 0;
+        double slogl = 0;
+        bool has_local_score = false;
+        uint64_t score_id = 0;
+        double local_score = 0;
+    };
+
+    // The const methods slogl(), cached_local_score() and cache_local_score() can be called concurrently on the same
+    // model (e.g. by the hill-climbing restarts or the bootstrap replicas), so the entries are guarded by a mutex. The
+    // mutex is held only to read or write the entries, never while a contribution is computed. Each copy of the model
+    // has its own mutex.
+    struct NodeCacheTable {
+        NodeCacheTable() = default;
+        NodeCacheTable(const NodeCacheTable& other) : entries(other.copy_entries()) {}
+        NodeCacheTable& operator=(const NodeCacheTable& other) {
+            if (this != &other) {
+                auto copied = other.copy_entries();
+                std::lock_guard<std::mutex> lock(mutex);
+                entries = std::move(copied);
+            }
+            return *this;
+        }
+
+        std::vector<NodeCache> copy_entries() const {
+            std::lock_guard<std::mutex> lock(mutex);
+            return entries;
+        }
+
+        // The mutex must be held.
+        void reserve(int num_raw_nodes) {
+            if (entries.size() < static_cast<size_t>(num_raw_nodes)) entries.resize(num_raw_nodes);
+        }
+
+        std::vector<NodeCache> entries;
+        mutable std::mutex mutex;
+    };
+
+    // Indexed by the raw node index. The entries of a node are cleared when its CPD, its parents or its node type change,
+    // so after a local change of the structure only the modified nodes are recomputed.
+    mutable NodeCacheTable m_node_cache;
 };
 
 template <typename DagType>
@@ -934,6 +1092,7 @@ void BNGeneric<DagType>::add_cpds(const std::vector<std::shared_ptr<Factor>>& cp
         if (can_have_cpd(cpd->variable())) {
             auto idx = index(cpd->variable());
             m_cpds[idx] = cpd;
+            clear_slogl_cache(idx);
         } else {
             throw std::invalid_argument("CPD for node " + cpd->variable() + " not valid for Bayesian network.");
         }
@@ -976,6 +1135,8 @@ void BNGeneric<DagType>::fit(const DataFrame& df, const Arguments& construction_
 
     force_type_whitelist(new_factor_types);
 
+    // The CPDs are created sequentially, because the node types can be implemented in Python.
+    std::vector<int> to_fit;
     for (const auto& nn : nodes()) {
         auto i = check_index(nn);
 
@@ -987,11 +1148,35 @@ void BNGeneric<DagType>::fit(const DataFrame& df, const Arguments& construction_
         if (!m_cpds[i] || must_construct_cpd(*m_cpds[i], *node_type_, p)) {
             auto [args, kwargs] = construction_args.args(nn, node_type_);
             m_cpds[i] = node_type_->new_factor(*this, nn, p, args, kwargs);
-            m_cpds[i]->fit(df);
+            to_fit.push_back(i);
         } else if (!m_cpds[i]->fitted()) {
-            m_cpds[i]->fit(df);
+            to_fit.push_back(i);
         }
     }
+
+    for (auto i : to_fit) {
+        clear_slogl_cache(i);
+    }
+
+    // The most expensive CPDs (e.g. CKDE) are fitted first, so the threads are not left waiting for a long fit at the
+    // end of the loop.
+    std::vector<int> sequential, concurrent;
+    std::vector<double> cost(m_cpds.size());
+    for (auto i : to_fit) {
+        if (m_cpds[i]->thread_safe_fit()) {
+            cost[i] = m_cpds[i]->fit_cost(df);
+            concurrent.push_back(i);
+        } else {
+            sequential.push_back(i);
+        }
+    }
+
+    std::stable_sort(concurrent.begin(), concurrent.end(), [&cost](int a, int b) { return cost[a] > cost[b]; });
+
+    for_each_factor(sequential, concurrent, [this, &df](int i) {
+        auto timer = factor_fit_timer(*m_cpds[i]);
+        m_cpds[i]->fit(df);
+    });
 }
 
 template <typename DagType>
@@ -999,39 +1184,140 @@ VectorXd BNGeneric<DagType>::logl(const DataFrame& df) const {
     check_fitted();
 
     const auto& nn = nodes();
-    VectorXd accum;
-    bool init = false;
-    #pragma omp parallel
-    #pragma omp single
+    std::vector<int> sequential, concurrent;
+    for (int k = 0, k_end = nn.size(); k < k_end; ++k) {
+        if (m_cpds[index(nn[k])]->is_python_derived())
+            sequential.push_back(k);
+        else
+            concurrent.push_back(k);
+    }
+
+    // Each thread accumulates the log-likelihood of its CPDs in its own vector, so the memory does not grow with the
+    // number of nodes. The vectors are summed once at the end.
+    auto num_threads = util::num_threads();
+    std::vector<VectorXd> thread_logl(num_threads);
+    for_each_factor(
+        sequential,
+        concurrent,
+        [this, &df, &nn, &thread_logl](int k) {
+            const auto& cpd = m_cpds[index(nn[k])];
+            auto timer = factor_logl_timer(*cpd);
+
+            auto& accum = thread_logl[omp_get_thread_num()];
+            if (accum.rows() == 0)
+                accum = cpd->logl(df);
+            else
+                accum += cpd->logl(df);
+        },
+        num_threads);
+
+    VectorXd logl = VectorXd::Zero(df->num_rows());
+    for (const auto& accum : thread_logl) {
+        if (accum.rows() > 0) logl += accum;
+    }
+
+    return logl;
+}
+
+template <typename DagType>
+double BNGeneric<DagType>::slogl(const DataFrame& df) const {
+    check_fitted();
+
+    const auto& nn = nodes();
+
+    // The contribution of a node only depends on its CPD and on the columns of the node and its parents. Each column is
+    // hashed once, and the cached contribution is reused if the hash of these columns did not change.
+    std::unordered_map<std::string, int> column_position;
+    std::vector<Array_ptr> columns;
+    for (const auto& node : nn) {
+        auto add_column = [&df, &column_position, &columns](const std::string& name) {
+            auto field_index = df->schema()->GetFieldIndex(name);
+            if (field_index != -1 && column_position.count(name) == 0) {
+                column_position.insert({name, static_cast<int>(columns.size())});
+                columns.push_back(df->column(field_index));
+            }
+        };
+
+        add_column(node);
+        for (const auto& p : parents(node)) add_column(p);
+    }
+
+    std::vector<uint64_t> column_hash(columns.size());
+    util::parallel_for(columns.size(), df->num_rows(), [&columns, &column_hash](int64_t i) {
+        column_hash[i] = dataset::array_hash(columns[i]);
+    });
+    // The weights change the contribution of every node.
+    auto weights_hash = df.has_weights() ? dataset::array_hash(df.weights()) : 0;
+
+    std::vector<std::optional<uint64_t>> data_hash(nn.size());
+    for (int k = 0, k_end = nn.size(); k < k_end; ++k) {
+        if (!cacheable_cpd(index(nn[k]))) continue;
+
+        auto it = column_position.find(nn[k]);
+        if (it == column_position.end()) continue;
+
+        std::size_t h = column_hash[it->second];
+        util::hash_combine(h, weights_hash);
+        bool complete = true;
+        for (const auto& p : parents(nn[k])) {
+            auto pit = column_position.find(p);
+            if (pit == column_position.end()) {
+                complete = false;
+                break;
+            }
+            util::hash_combine(h, column_hash[pit->second]);
+        }
+
+        // If a column is missing, the CPD raises the error.
+        if (complete) data_hash[k] = h;
+    }
+
+    VectorXd node_slogl(nn.size());
+    std::vector<int> sequential, concurrent;
     {
-    for (uint i = 0; i < nn.size(); ++i) {
-        #pragma omp task
-        {
-        VectorXd aux = m_cpds[index(nn[i])]->logl(df);
-        #pragma omp critical
-        {
-            if (!init) {
-                accum = aux;
-                init = true;
+        std::lock_guard<std::mutex> lock(m_node_cache.mutex);
+        m_node_cache.reserve(num_raw_nodes());
+        for (int k = 0, k_end = nn.size(); k < k_end; ++k) {
+            const auto& cache = m_node_cache.entries[index(nn[k])];
+            if (data_hash[k] && cache.has_slogl && cache.slogl_data_hash == *data_hash[k]) {
+                node_slogl(k) = cache.slogl;
+                util::profiling::count("bn/slogl_cache_hits");
+            } else if (m_cpds[index(nn[k])]->is_python_derived()) {
+                sequential.push_back(k);
             } else {
-                accum += aux;
+                concurrent.push_back(k);
             }
         }
-        }
-    }
     }
-    return accum;
-}
 
-template <typename DagType>
-double BNGeneric<DagType>::slogl(const DataFrame& df) const {
-    check_fitted();
+    // The terms are summed sequentially in the order of the nodes, so the result does not depend on the scheduling of the
+    // threads.
+    for_each_factor(sequential, concurrent, [this, &df, &nn, &node_slogl](int k) {
+        const auto& cpd = m_cpds[index(nn[k])];
+        auto timer = factor_logl_timer(*cpd);
+        node_slogl(k) = factors::weighted_slogl(*cpd, df);
+    });
+
+    auto store_cache = [this, &nn, &data_hash, &node_slogl](const std::vector<int>& computed) {
+        for (auto k : computed) {
+            if (data_hash[k]) {
+                auto& cache = m_node_cache.entries[index(nn[k])];
+                cache.has_slogl = true;
+                cache.slogl_data_hash = *data_hash[k];
+                cache.slogl = node_slogl(k);
+            }
+        }
+    };
 
-    double accum = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_node_cache.mutex);
+        store_cache(sequential);
+        store_cache(concurrent);
+    }
 
-    for (const auto& nn : nodes()) {
-        auto i = index(nn);
-        accum += m_cpds[i]->slogl(df);
+    double accum = 0;
+    for (auto k = 0; k < node_slogl.rows(); ++k) {
+        accum += node_slogl(k);
     }
 
     return accum;
@@ -1052,32 +1338,43 @@ DataFrame BNGeneric<DagType>::sample(int n, unsigned int seed, bool ordered) con
 
     check_fitted();
 
-    DataFrame parents(n);
-
     auto top_sort = g.topological_sort();
-    for (size_t i = 0; i < top_sort.size(); ++i) {
-        auto idx = index(top_sort[i]);
-        auto array = m_cpds[idx]->sample(n, parents, seed + i);
+    std::vector<std::shared_ptr<Factor>> cpds;
+    cpds.reserve(top_sort.size());
+    for (const auto& node : top_sort) {
+        cpds.push_back(m_cpds[index(node)]);
+    }
+
+    auto columns = forward_sample(top_sort, cpds, DataFrame(n), n, seed);
 
-        auto res = parents->AddColumn(i, top_sort[i], array);
-        parents = DataFrame(std::move(res).ValueOrDie());
+    std::vector<Field_ptr> fields;
+    fields.reserve(top_sort.size());
+    for (size_t i = 0; i < top_sort.size(); ++i) {
+        fields.push_back(arrow::field(top_sort[i], columns[i]->type()));
     }
 
     if (ordered) {
-        std::vector<Field_ptr> fields;
-        std::vector<Array_ptr> columns;
+        std::vector<Field_ptr> ordered_fields;
+        std::vector<Array_ptr> ordered_columns;
+
+        std::unordered_map<std::string, int> position;
+        for (size_t i = 0; i < top_sort.size(); ++i) {
+            position.insert({top_sort[i], i});
+        }
 
-        auto schema = parents->schema();
         for (auto& name : nodes()) {
-            fields.push_back(schema->GetFieldByName(name));
-            columns.push_back(parents->GetColumnByName(name));
+            auto i = position.at(name);
+            ordered_fields.push_back(fields[i]);
+            ordered_columns.push_back(columns[i]);
         }
 
+        auto new_schema = std::make_shared<arrow::Schema>(ordered_fields);
+        auto new_rb = arrow::RecordBatch::Make(new_schema, n, ordered_columns);
+        return DataFrame(new_rb);
+    } else {
         auto new_schema = std::make_shared<arrow::Schema>(fields);
         auto new_rb = arrow::RecordBatch::Make(new_schema, n, columns);
         return DataFrame(new_rb);
-    } else {
-        return parents;
     }
 }
 
@@ -1306,14 +1603,23 @@ public:
 
     bool contains_joint_node(const std::string& name) const override { return this->g.contains_joint_node(name); }
 
-    int add_interface_node(const std::string& node) override { return this->g.add_interface_node(node); }
+    int add_interface_node(const std::string& node) override {
+        int idx = this->g.add_interface_node(node);
+        this->clear_node_cache(idx);
+        return idx;
+    }
 
-    void remove_interface_node(const std::string& node) override { this->g.remove_interface_node(node); }
+    void remove_interface_node(const std::string& node) override {
+        this->clear_node_cache(this->index(node));
+        this->clear_children_cache(node);
+        this->g.remove_interface_node(node);
+    }
 
     bool is_interface(const std::string& name) const override { return this->g.is_interface(name); }
 
     void set_interface(const std::string& name) override {
         this->g.set_interface(name);
+        this->clear_node_cache(this->index(name));
         if (!this->m_cpds.empty()) {
             this->m_cpds[this->index(name)] = nullptr;
         }
@@ -1321,6 +1627,7 @@ public:
 
     void set_node(const std::string& name) override {
         this->g.set_node(name);
+        this->clear_node_cache(this->index(name));
         if (!this->m_cpds.empty()) this->m_cpds[this->index(name)] = nullptr;
     }
 
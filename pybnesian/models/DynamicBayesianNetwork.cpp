@@ -1,4 +1,7 @@
+#include <arrow/array/concatenate.h>
 #include <models/DynamicBayesianNetwork.hpp>
+#include <util/parallel.hpp>
+#include <util/random.hpp>
 
 namespace models {
 
@@ -463,6 +466,128 @@ DataFrame DynamicBayesianNetwork::sample(int n, unsigned int seed) const {
     return sampled;
 }
 
+std::vector<DataFrame> DynamicBayesianNetwork::sample_trajectories(int num_trajectories,
+                                                                   int n,
+                                                                   unsigned int seed) const {
+    if (num_trajectories < 0) {
+        throw std::invalid_argument("num_trajectories should be a non-negative number");
+    }
+
+    check_fitted();
+    check_same_datatypes();
+
+    // Python models and factors need the GIL, so they are sampled sequentially.
+    bool parallel = !m_static->is_python_derived() && !m_transition->is_python_derived();
+    for (const auto& node : m_static->nodes()) {
+        if (m_static->cpd(node)->is_python_derived()) parallel = false;
+    }
+    for (const auto& node : m_transition->nodes()) {
+        if (m_transition->cpd(node)->is_python_derived()) parallel = false;
+    }
+
+    std::vector<DataFrame> trajectories(num_trajectories);
+    std::exception_ptr exception;
+
+#pragma omp parallel for schedule(dynamic) if (parallel) num_threads(util::num_threads())
+    for (int t = 0; t < num_trajectories; ++t) {
+        try {
+            // Each trajectory has its own substream, so the result does not depend on the number of threads.
+            trajectories[t] = DynamicBayesianNetwork::sample(n, util::substream_seed(seed, t));
+        } catch (...) {
+#pragma omp critical
+            {
+                if (!exception) exception = std::current_exception();
+            }
+        }
+    }
+
+    if (exception) std::rethrow_exception(exception);
+
+    return trajectories;
+}
+
+DataFrame concat_rows(const DataFrame& top, const DataFrame& bottom) {
+    Array_vector columns;
+    columns.reserve(bottom->num_columns());
+
+    for (auto i = 0; i < bottom->num_columns(); ++i) {
+        RAISE_RESULT_ERROR(auto concatenated, arrow::Concatenate({top.col(bottom.name(i)), bottom.col(i)}))
+        columns.push_back(concatenated);
+    }
+
+    return DataFrame(arrow::RecordBatch::Make(bottom->schema(), top->num_rows() + bottom->num_rows(), columns));
+}
+
+StreamingLogLikelihood::StreamingLogLikelihood(std::shared_ptr<DynamicBayesianNetworkBase> dbn)
+    : m_dbn(dbn), m_history(), m_num_rows(0), m_variable_logl() {
+    if (m_dbn == nullptr) throw std::runtime_error("Dynamic Bayesian network must be non-null.");
+
+    if (!m_dbn->fitted())
+        throw std::invalid_argument(
+            "DynamicBayesianNetwork currently not fitted. "
+            "Call fit() method, or add_cpds() for static_bn() and transition_bn()");
+
+    m_variable_logl = VectorXd::Zero(m_dbn->num_variables());
+}
+
+VectorXd StreamingLogLikelihood::update(const DataFrame& df) {
+    const auto& variables = m_dbn->variables();
+    auto markovian_order = m_dbn->markovian_order();
+    auto window = df.loc(variables);
+
+    if (m_num_rows == 0 && window->num_rows() < markovian_order)
+        throw std::invalid_argument(
+            "Not enough information. There are less rows in "
+            "the first window (" +
+            std::to_string(window->num_rows()) +
+            ")"
+            " than the markovian order of the "
+            "DynamicBayesianNetwork (" +
+            std::to_string(markovian_order) + ")");
+
+    VectorXd ll = VectorXd::Zero(window->num_rows());
+    DataFrame series;
+    int first_transition_row;
+
+    if (m_num_rows == 0) {
+        auto dstatic_df = create_static_df(window.slice(0, markovian_order), markovian_order);
+
+        for (int i = 0; i < markovian_order; ++i) {
+            for (size_t j = 0; j < variables.size(); ++j) {
+                const auto& cpd = m_dbn->static_bn().cpd(util::temporal_name(variables[j], markovian_order - i));
+                auto sll = cpd->slogl(dstatic_df);
+                ll(i) += sll;
+                m_variable_logl(j) += sll;
+            }
+        }
+
+        series = window;
+        first_transition_row = markovian_order;
+    } else {
+        // Only the last markovian_order rows of the previous windows are concatenated.
+        series = concat_rows(m_history, window);
+        first_transition_row = 0;
+    }
+
+    if (series->num_rows() > markovian_order) {
+        auto temporal_slices = create_temporal_slices(series, markovian_order);
+        auto dtransition_df = create_transition_df(temporal_slices, markovian_order);
+
+        for (size_t j = 0; j < variables.size(); ++j) {
+            const auto& cpd = m_dbn->transition_bn().cpd(util::temporal_name(variables[j], 0));
+            auto vll = cpd->logl(dtransition_df);
+
+            ll.segment(first_transition_row, vll.rows()) += vll;
+            m_variable_logl(j) += vll.sum();
+        }
+    }
+
+    m_history = series.slice(series->num_rows() - markovian_order);
+    m_num_rows += window->num_rows();
+
+    return ll;
+}
+
 py::tuple DynamicBayesianNetwork::__getstate__() const {
     m_static->set_include_cpd(m_include_cpd);
     m_transition->set_include_cpd(m_include_cpd);
@@ -134,6 +134,7 @@ public:
     BayesianNetworkType& type_ref() const override { return m_transition->type_ref(); }
 
     DataFrame sample(int n, unsigned int seed) const override;
+    std::vector<DataFrame> sample_trajectories(int num_trajectories, int n, unsigned int seed) const;
 
     std::string ToString() const override { return "Dynamic" + type_ref().ToString(); }
 
@@ -155,6 +156,35 @@ private:
     mutable bool m_include_cpd;
 };
 
+// Computes the log-likelihood of a time series that is received in consecutive windows. Only the last markovian_order
+// rows are kept between windows, so the log-likelihood of each new row is computed as if the whole series was passed
+// to DynamicBayesianNetworkBase::logl().
+class StreamingLogLikelihood {
+public:
+    StreamingLogLikelihood(std::shared_ptr<DynamicBayesianNetworkBase> dbn);
+
+    VectorXd update(const DataFrame& df);
+
+    int64_t num_rows() const { return m_num_rows; }
+    double total() const { return m_variable_logl.sum(); }
+    // Accumulated log-likelihood of the CPDs of each variable.
+    const VectorXd& variable_logl() const { return m_variable_logl; }
+
+    void reset() {
+        m_history = DataFrame();
+        m_num_rows = 0;
+        m_variable_logl.setZero();
+    }
+
+    std::string ToString() const { return "StreamingLogLikelihood(" + std::to_string(m_num_rows) + " rows)"; }
+
+private:
+    std::shared_ptr<DynamicBayesianNetworkBase> m_dbn;
+    DataFrame m_history;
+    int64_t m_num_rows;
+    VectorXd m_variable_logl;
+};
+
 void __nonderived_dbn_setstate__(py::object& self, py::tuple& t);
 
 template <typename DerivedBN>
@@ -1,15 +1,168 @@
 #include <pybind11/stl.h>
+#include <pybind11/eigen.h>
+#include <dataset/chunked_dataframe.hpp>
 #include <dataset/crossvalidation_adaptator.hpp>
 #include <dataset/holdout_adaptator.hpp>
 #include <dataset/dynamic_dataset.hpp>
 #include <util/util_types.hpp>
 
-using dataset::DataFrame, dataset::CrossValidation, dataset::HoldOut, dataset::DynamicDataFrame,
-    dataset::DynamicVariable;
+using dataset::DataFrame, dataset::ChunkedDataFrame, dataset::CrossValidation, dataset::HoldOut,
+    dataset::DynamicDataFrame, dataset::DynamicVariable;
 
 using util::random_seed_arg;
 
 void pybindings_dataset(py::module& root) {
+    root.def(
+        "read_ipc",
+        [](const std::string& path, std::optional<std::vector<std::string>> columns, bool memory_map) {
+            return dataset::read_ipc(path, columns ? *columns : std::vector<std::string>{}, memory_map);
+        },
+        py::arg("path"),
+        py::arg("columns") = std::nullopt,
+        py::arg("memory_map") = true,
+        R"doc(
+Reads an Arrow IPC file (also known as Feather V2), as written by :func:`pyarrow.feather.write_feather` or
+:class:`pyarrow.ipc.RecordBatchFileWriter`.
+
+If ``memory_map`` is ``True``, the data is not loaded in memory: the returned :class:`DataFrame` is backed by the
+memory-mapped file, so the operating system reads the pages of the file when they are accessed and can evict them
+later. This makes possible to learn from datasets that do not fit in memory. The record batches of the file are
+concatenated into a single :class:`DataFrame`, so the file should be written with a single record batch (and without
+compression) to avoid copies. Use :func:`read_chunked_ipc` to keep the record batches separated.
+
+:param path: Path of the file.
+:param columns: Names of the columns to read. If ``None``, all the columns are read.
+:param memory_map: Whether to memory-map the file.
+:returns: A :class:`DataFrame` with the data of the file.
+:raises ValueError: If a column is not present in the file.
+)doc");
+
+    py::class_<ChunkedDataFrame>(root, "ChunkedDataFrame", R"doc(
+Data split in chunks (record batches) with the same schema, such as the chunks of a :class:`pyarrow.Table` or the
+record batches of an Arrow IPC file. The chunks are never concatenated: the :class:`BIC`, :class:`BGe` and
+:class:`BDe` scores and the :class:`LinearCorrelation` and :class:`ChiSquare` independence tests compute their
+sufficient statistics (moments and counts) on each chunk and merge them, so the extra memory does not depend on the
+number of rows.
+
+The categorical columns must have the same categories in every chunk. Use
+:func:`pyarrow.Table.unify_dictionaries` if they do not.
+)doc")
+        .def(py::init<std::vector<DataFrame>>(), py::arg("chunks"), R"doc(
+Initializes a :class:`ChunkedDataFrame` from a list of chunks, or from a :class:`pyarrow.Table` (without copying its
+chunks).
+
+:param chunks: A list of DataFrames with the same schema, or a :class:`pyarrow.Table`.
+:raises ValueError: If the chunks have different schemas or categories.
+)doc")
+        .def(py::init([](py::handle data) {
+                 if (pyarrow::is_table(data.ptr())) {
+                     auto result = pyarrow::unwrap_table(data.ptr());
+                     if (!result.ok()) throw std::runtime_error("pyarrow's Table could not be converted.");
+                     return ChunkedDataFrame(result.ValueOrDie());
+                 }
+
+                 return ChunkedDataFrame(DataFrame(dataset::to_record_batch(data)));
+             }),
+             py::arg("chunks"))
+        .def("num_rows", &ChunkedDataFrame::num_rows, R"doc(
+Gets the number of rows of all the chunks.
+
+:returns: Number of rows.
+)doc")
+        .def("num_chunks", &ChunkedDataFrame::num_chunks, R"doc(
+Gets the number of chunks.
+
+:returns: Number of chunks.
+)doc")
+        .def(
+            "chunk",
+            [](const ChunkedDataFrame& self, int i) {
+                if (i < 0 || i >= self.num_chunks())
+                    throw std::invalid_argument("Chunk " + std::to_string(i) + " does not exist.");
+                return self.chunk(i);
+            },
+            py::arg("index"),
+            R"doc(
+Gets a chunk.
+
+:param index: Index of the chunk.
+:returns: The chunk as a DataFrame.
+)doc")
+        .def("means", &ChunkedDataFrame::means, py::arg("columns"), R"doc(
+Computes the means of the continuous ``columns``, using the rows that are valid in all the ``columns``.
+
+:param columns: Names of the columns.
+:returns: Vector of means.
+)doc")
+        .def("cov", &ChunkedDataFrame::cov, py::arg("columns"), R"doc(
+Computes the sample covariance of the continuous ``columns``, using the rows that are valid in all the ``columns``.
+
+:param columns: Names of the columns.
+:returns: Covariance matrix.
+)doc")
+        .def("take", &ChunkedDataFrame::take, py::arg("indices"), R"doc(
+Selects the rows at the positions ``indices`` of the whole data (as if the chunks were concatenated).
+
+:param indices: Positions of the rows.
+:returns: A DataFrame with the selected rows.
+:raises ValueError: If an index is out of bounds.
+)doc");
+
+    root.def(
+        "read_chunked_ipc",
+        [](const std::string& path, std::optional<std::vector<std::string>> columns, bool memory_map) {
+            return dataset::read_chunked_ipc(path, columns ? *columns : std::vector<std::string>{}, memory_map);
+        },
+        py::arg("path"),
+        py::arg("columns") = std::nullopt,
+        py::arg("memory_map") = true,
+        R"doc(
+Reads an Arrow IPC file as :func:`read_ipc`, but each record batch of the file is a chunk of the returned
+:class:`ChunkedDataFrame`. The record batches are not concatenated, so a file with several record batches can be
+memory-mapped without copies.
+
+:param path: Path of the file.
+:param columns: Names of the columns to read. If ``None``, all the columns are read.
+:param memory_map: Whether to memory-map the file.
+:returns: A :class:`ChunkedDataFrame` with the record batches of the file.
+:raises ValueError: If a column is not present in the file, or the record batches have different categories.
+)doc");
+
+    root.def("with_weights", &dataset::with_weights, py::arg("df"), py::arg("column"), R"doc(
+Marks a column of the data as the frequency weights of the rows: a row with weight ``w`` counts as ``w`` repetitions of
+the row. The weights are honoured when the parameters of the :class:`LinearGaussianCPD`, :class:`CLinearGaussianCPD`
+and :class:`DiscreteFactor` are estimated, by the :class:`BIC`, :class:`BDe` and :class:`BGe` scores, and by the
+:class:`LinearCorrelation` and :class:`ChiSquare` independence tests. The :class:`KDE` and :class:`CKDE` factors repeat
+each row as many times as its weight, so the weights must be integers to fit them.
+
+The weights column is not a variable of the data. The mark is stored in the schema metadata of the returned
+:class:`DataFrame`, so it is kept when the :class:`DataFrame` is passed to other PyBNesian functions.
+
+:param df: A :class:`DataFrame`.
+:param column: Name of the weights column. The weights must be finite, non-negative and not null.
+:returns: A :class:`DataFrame` with the column (converted to ``double``) as weights.
+:raises ValueError: If the column is not present, is not numeric, or contains invalid weights.
+)doc");
+
+    root.def("without_weights", &dataset::without_weights, py::arg("df"), R"doc(
+Removes the weights mark of the data (see :func:`with_weights`). The weights column is kept as a normal column.
+
+:param df: A :class:`DataFrame`.
+:returns: A :class:`DataFrame` without weights.
+)doc");
+
+    root.def("deduplicate", &dataset::deduplicate, py::arg("df"), py::arg("weights_name") = "weights", R"doc(
+Collapses the repeated rows of discrete data into its unique rows, weighted by the number of repetitions of each row.
+If ``df`` already has weights (see :func:`with_weights`), the weights of the repeated rows are summed. The learning
+algorithms are faster with the deduplicated data, and they return the same results because the weights are honoured by
+the discrete factors, scores and independence tests.
+
+:param df: A :class:`DataFrame` with categorical columns.
+:param weights_name: Name of the weights column of the returned :class:`DataFrame`.
+:returns: A :class:`DataFrame` with the unique rows (in order of first occurrence) and their weights.
+:raises ValueError: If a column is not categorical, or a column is named ``weights_name``.
+)doc");
+
     py::class_<CrossValidation> cv(root, "CrossValidation", R"doc(
 This class implements k-fold cross-validation, i.e. it splits the data into k disjoint sets of train and test data.
 )doc");
@@ -628,6 +628,19 @@ Gets the joint :math:`\hat{f}_{K}(\text{variable}, \text{evidence})` :class:`KDE
 Gets the marginalized :math:`\hat{f}_{K}(\text{evidence})` :class:`KDE` model.
 
 :returns: Marginalized KDE model.
+)doc")
+        .def_property("precision", &CKDE::precision, &CKDE::set_precision, R"doc(
+:class:`KDEPrecision <pybnesian.KDEPrecision>` used to evaluate the log-likelihood. It is also set in the joint and
+marginal :class:`KDE` models.
+)doc")
+        .def_property("univariate_method", &CKDE::univariate_method, &CKDE::set_univariate_method, R"doc(
+:class:`UnivariateKDEMethod <pybnesian.UnivariateKDEMethod>` used by the joint :class:`KDE` if the CKDE has no
+evidence, and by the marginal :class:`KDE` if it has one evidence variable. It is also set in the joint and marginal
+:class:`KDE` models.
+)doc")
+        .def_property("univariate_tolerance", &CKDE::univariate_tolerance, &CKDE::set_univariate_tolerance, R"doc(
+Tolerance of the log-likelihood of ``UnivariateKDEMethod.SortedWindow`` and ``UnivariateKDEMethod.Binned``. It is
+also set in the joint and marginal :class:`KDE` models.
 )doc")
         .def("cdf", &CKDE::cdf, py::return_value_policy::take_ownership, py::arg("df"), R"doc(
 Returns the cumulative distribution function values of each instance in the DataFrame ``df``.
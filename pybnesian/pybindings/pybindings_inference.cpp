@@ -0,0 +1,293 @@
+#include <pybind11/pybind11.h>
+#include <pybind11/stl.h>
+#include <pybind11/eigen.h>
+#include <inference/GaussianInference.hpp>
+#include <inference/JunctionTree.hpp>
+
+namespace py = pybind11;
+
+using inference::GaussianInference, inference::ConditionalGaussian, inference::JunctionTree;
+
+void pybindings_inference(py::module& root) {
+    py::class_<ConditionalGaussian, std::shared_ptr<ConditionalGaussian>>(root, "ConditionalGaussian", R"doc(
+This class represents the conditional distribution of a set of ``query`` variables given a set of ``evidence`` variables
+in a Gaussian Bayesian network:
+
+.. math::
+
+    \mathbf{Q} \mid \mathbf{E} = \mathbf{e} \sim \mathcal{N}(\boldsymbol{\mu}_{\mathbf{Q}} +
+    \mathbf{K}(\mathbf{e} - \boldsymbol{\mu}_{\mathbf{E}}), \Sigma_{\mathbf{Q}\mathbf{Q}} -
+    \mathbf{K}\Sigma_{\mathbf{E}\mathbf{Q}}),\quad \mathbf{K} = \Sigma_{\mathbf{Q}\mathbf{E}}
+    \Sigma_{\mathbf{E}\mathbf{E}}^{-1}
+
+It is created with :func:`GaussianInference.conditional <pybnesian.GaussianInference.conditional>`.
+)doc")
+        .def("query", &ConditionalGaussian::query, py::return_value_policy::reference_internal, R"doc(
+Gets the query variables.
+
+:returns: List of query variable names.
+)doc")
+        .def("evidence", &ConditionalGaussian::evidence, py::return_value_policy::reference_internal, R"doc(
+Gets the evidence variables.
+
+:returns: List of evidence variable names.
+)doc")
+        .def("gain", &ConditionalGaussian::gain, R"doc(
+Gets the gain matrix :math:`\mathbf{K} = \Sigma_{\mathbf{Q}\mathbf{E}}\Sigma_{\mathbf{E}\mathbf{E}}^{-1}`.
+
+:returns: A :class:`numpy.ndarray` matrix with shape (number of query variables, number of evidence variables).
+)doc")
+        .def("offset", &ConditionalGaussian::offset, R"doc(
+Gets the offset vector :math:`\boldsymbol{\mu}_{\mathbf{Q}} - \mathbf{K}\boldsymbol{\mu}_{\mathbf{E}}`.
+
+:returns: A :class:`numpy.ndarray` vector.
+)doc")
+        .def("covariance", &ConditionalGaussian::covariance, R"doc(
+Gets the conditional covariance :math:`\Sigma_{\mathbf{Q}\mathbf{Q}} - \mathbf{K}\Sigma_{\mathbf{E}\mathbf{Q}}`. It
+does not depend on the evidence values.
+
+:returns: A :class:`numpy.ndarray` matrix.
+)doc")
+        .def("mean", &ConditionalGaussian::mean, py::arg("df"), R"doc(
+Returns the conditional mean of the query variables for each row of evidence values in ``df``.
+
+:param df: DataFrame containing the evidence variables.
+:returns: A :class:`numpy.ndarray` matrix where the i-th row is the conditional mean of the i-th instance of ``df``.
+          If some evidence value is null, the row is filled with NaN.
+)doc")
+        .def("logl", &ConditionalGaussian::logl, py::arg("df"), R"doc(
+Returns the conditional log-likelihood of the query variables given the evidence variables for each instance in
+``df``.
+
+:param df: DataFrame containing the query and evidence variables.
+:returns: A :class:`numpy.ndarray` vector with dtype :class:`numpy.float64`, where the i-th value is the conditional
+          log-likelihood of the i-th instance of ``df``.
+)doc")
+        .def("__str__", &ConditionalGaussian::ToString)
+        .def("__repr__", &ConditionalGaussian::ToString);
+
+    py::class_<GaussianInference, std::shared_ptr<GaussianInference>>(root, "GaussianInference", R"doc(
+This class implements exact inference for Bayesian networks where every CPD is a
+:class:`LinearGaussianCPD <pybnesian.LinearGaussianCPD>` (e.g., a fitted
+:class:`GaussianNetwork <pybnesian.GaussianNetwork>`).
+
+The network is compiled once into the joint multivariate normal distribution (mean vector, covariance matrix and
+precision matrix in canonical form), following the topological order of the graph. Conditional distributions are
+cached by (query, evidence) pattern, so repeated queries with the same variables only need a matrix product.
+
+The compiled distribution is a snapshot of the model parameters. If the model is refitted, a new
+:class:`GaussianInference` must be created.
+)doc")
+        .def(py::init<const BayesianNetworkBase&>(), py::arg("model"), R"doc(
+Compiles the fitted ``model`` into its joint Gaussian distribution.
+
+:param model: A fitted :class:`BayesianNetworkBase <pybnesian.BayesianNetworkBase>` with
+              :class:`LinearGaussianCPD <pybnesian.LinearGaussianCPD>` factors.
+)doc")
+        .def("nodes", &GaussianInference::nodes, py::return_value_policy::reference_internal, R"doc(
+Gets the nodes of the joint distribution, in the order of :func:`GaussianInference.mean` and
+:func:`GaussianInference.covariance` (a topological order of the network).
+
+:returns: List of node names.
+)doc")
+        .def("mean", &GaussianInference::mean, R"doc(
+Gets the mean vector of the joint distribution.
+
+:returns: A :class:`numpy.ndarray` vector.
+)doc")
+        .def("covariance", &GaussianInference::covariance, R"doc(
+Gets the covariance matrix of the joint distribution.
+
+:returns: A :class:`numpy.ndarray` matrix.
+)doc")
+        .def("precision", &GaussianInference::precision, R"doc(
+Gets the precision matrix of the joint distribution, :math:`\mathbf{K} = (\mathbf{I} - \mathbf{B})^{T}\mathbf{D}^{-1}
+(\mathbf{I} - \mathbf{B})`, where :math:`\mathbf{B}` contains the regression coefficients of each node and
+:math:`\mathbf{D}` is the diagonal matrix of the CPD variances.
+
+:returns: A :class:`numpy.ndarray` matrix.
+)doc")
+        .def("potential", &GaussianInference::potential, R"doc(
+Gets the potential vector :math:`\mathbf{h} = \mathbf{K}\boldsymbol{\mu}` of the canonical form.
+
+:returns: A :class:`numpy.ndarray` vector.
+)doc")
+        .def("conditional",
+             &GaussianInference::conditional,
+             py::arg("query"),
+             py::arg("evidence") = std::vector<std::string>(),
+             R"doc(
+Returns the conditional distribution of the ``query`` variables given the ``evidence`` variables. The result is
+cached, so calling this method again with the same variables returns the same object.
+
+:param query: List of query variables.
+:param evidence: List of evidence variables. If empty, the marginal distribution of ``query`` is returned.
+:returns: A :class:`ConditionalGaussian <pybnesian.ConditionalGaussian>`.
+)doc")
+        .def("conditional_mean",
+             &GaussianInference::conditional_mean,
+             py::arg("query"),
+             py::arg("evidence"),
+             py::arg("df"),
+             R"doc(
+Returns the conditional mean of the ``query`` variables for each row of ``evidence`` values in ``df``. Equivalent to
+``self.conditional(query, evidence).mean(df)``.
+
+:param query: List of query variables.
+:param evidence: List of evidence variables.
+:param df: DataFrame containing the evidence variables.
+:returns: A :class:`numpy.ndarray` matrix with a row for each instance in ``df``.
+)doc")
+        .def("conditional_covariance",
+             &GaussianInference::conditional_covariance,
+             py::arg("query"),
+             py::arg("evidence"),
+             R"doc(
+Returns the conditional covariance of the ``query`` variables given the ``evidence`` variables. Equivalent to
+``self.conditional(query, evidence).covariance()``.
+
+:param query: List of query variables.
+:param evidence: List of evidence variables.
+:returns: A :class:`numpy.ndarray` matrix.
+)doc")
+        .def("logl",
+             &GaussianInference::logl,
+             py::arg("query"),
+             py::arg("evidence"),
+             py::arg("df"),
+             R"doc(
+Returns the conditional log-likelihood of the ``query`` variables given the ``evidence`` variables for each instance
+in ``df``. Equivalent to ``self.conditional(query, evidence).logl(df)``.
+
+:param query: List of query variables.
+:param evidence: List of evidence variables.
+:param df: DataFrame containing the query and evidence variables.
+:returns: A :class:`numpy.ndarray` vector with dtype :class:`numpy.float64`.
+)doc")
+        .def("num_cached", &GaussianInference::num_cached, R"doc(
+Gets the number of cached conditional distributions.
+
+:returns: Number of cached (query, evidence) patterns.
+)doc")
+        .def("clear_cache", &GaussianInference::clear_cache, R"doc(
+Removes all the cached conditional distributions.
+)doc")
+        .def("__str__", &GaussianInference::ToString)
+        .def("__repr__", &GaussianInference::ToString);
+
+    py::class_<JunctionTree, std::shared_ptr<JunctionTree>>(root, "JunctionTree", R"doc(
+This class implements exact inference for Bayesian networks where every CPD is a
+:class:`DiscreteFactor <pybnesian.DiscreteFactor>` (e.g., a fitted :class:`DiscreteBN <pybnesian.DiscreteBN>`).
+
+The moral graph of the network is triangulated with a greedy elimination heuristic and compiled into a junction tree.
+The clique tables use the same memory layout as :class:`DiscreteFactor <pybnesian.DiscreteFactor>`, and the
+projections between cliques and separators are precomputed, so each message is a single pass over a contiguous table.
+
+The evidence is read from the columns of a DataFrame: the rows are grouped by evidence configuration, the tree is
+calibrated once for each unique configuration (in parallel) and the calibrated trees are cached. The cache keeps the
+most recently used configurations. Null values are treated as unobserved.
+
+The compiled tree is a snapshot of the model parameters. If the model is refitted, a new
+:class:`JunctionTree` must be created.
+)doc")
+        .def(py::init<const BayesianNetworkBase&, const std::string&, int>(),
+             py::arg("model"),
+             py::arg("heuristic") = "min-fill",
+             py::arg("max_cached") = 1024,
+             R"doc(
+Compiles the fitted ``model`` into a junction tree.
+
+:param model: A fitted :class:`BayesianNetworkBase <pybnesian.BayesianNetworkBase>` with
+              :class:`DiscreteFactor <pybnesian.DiscreteFactor>` factors.
+:param heuristic: Triangulation heuristic. The valid heuristics are "min-fill" (eliminate the node that adds the
+                  fewest fill-in edges) and "min-weight" (eliminate the node with the smallest clique table).
+:param max_cached: Maximum number of cached calibrated trees. When the cache is full, the least recently used tree is
+                   removed. If 0, the calibrated trees are not cached.
+:raises ValueError: If the model is not fitted, a CPD is not a :class:`DiscreteFactor <pybnesian.DiscreteFactor>`, the
+                    heuristic is not valid or ``max_cached`` is negative.
+)doc")
+        .def("nodes", &JunctionTree::nodes, py::return_value_policy::reference_internal, R"doc(
+Gets the nodes of the model.
+
+:returns: List of node names.
+)doc")
+        .def("variable_values",
+             &JunctionTree::variable_values,
+             py::arg("variable"),
+             py::return_value_policy::reference_internal,
+             R"doc(
+Gets the categories of a variable, in the order used by the columns of :func:`JunctionTree.query`.
+
+:param variable: Name of the variable.
+:returns: List of categories.
+)doc")
+        .def("cliques", &JunctionTree::cliques, R"doc(
+Gets the cliques of the junction tree.
+
+:returns: A list with the variables of each clique.
+)doc")
+        .def("edges", &JunctionTree::edges, py::return_value_policy::reference_internal, R"doc(
+Gets the edges of the junction tree as pairs of clique indices (see :func:`JunctionTree.cliques`).
+
+:returns: A list of (parent clique, child clique) tuples.
+)doc")
+        .def("separators", &JunctionTree::separators, R"doc(
+Gets the separator of each edge of the junction tree (see :func:`JunctionTree.edges`).
+
+:returns: A list with the variables of each separator.
+)doc")
+        .def("treewidth", &JunctionTree::treewidth, R"doc(
+Gets the width of the triangulation: the size of the largest clique minus one.
+
+:returns: Treewidth of the junction tree.
+)doc")
+        .def("total_table_size", &JunctionTree::total_table_size, R"doc(
+Gets the total number of entries of the clique tables.
+
+:returns: Total size of the clique tables.
+)doc")
+        .def("prior", &JunctionTree::prior, py::arg("variables"), R"doc(
+Returns the prior joint distribution of ``variables`` (without evidence).
+
+:param variables: List of query variables. They must be contained in a clique of the junction tree.
+:returns: A :class:`numpy.ndarray` vector with the joint probabilities. The first variable changes fastest, as in
+          :class:`DiscreteFactor <pybnesian.DiscreteFactor>`.
+)doc")
+        .def("query", &JunctionTree::query, py::arg("variables"), py::arg("df"), R"doc(
+Returns the posterior joint distribution of ``variables`` given the evidence in each row of ``df``. Every column of
+``df`` that is a node of the model (and is not a query variable) is an evidence variable.
+
+:param variables: List of query variables. They must be contained in a clique of the junction tree.
+:param df: DataFrame with the evidence. Null values are treated as unobserved.
+:returns: A :class:`numpy.ndarray` matrix where the i-th row is the posterior distribution given the i-th instance of
+          ``df``. The first variable changes fastest, as in :class:`DiscreteFactor <pybnesian.DiscreteFactor>`. If the
+          evidence of a row has zero probability, the row is filled with NaN.
+)doc")
+        .def("probability_evidence", &JunctionTree::probability_evidence, py::arg("df"), R"doc(
+Returns the probability of the evidence in each row of ``df``.
+
+:param df: DataFrame with the evidence. Null values are treated as unobserved.
+:returns: A :class:`numpy.ndarray` vector with dtype :class:`numpy.float64`.
+)doc")
+        .def("log_probability_evidence", &JunctionTree::log_probability_evidence, py::arg("df"), R"doc(
+Returns the log-probability of the evidence in each row of ``df``. This method does not underflow for unlikely evidence.
+
+:param df: DataFrame with the evidence. Null values are treated as unobserved.
+:returns: A :class:`numpy.ndarray` vector with dtype :class:`numpy.float64`.
+)doc")
+        .def("num_cached", &JunctionTree::num_cached, R"doc(
+Gets the number of cached calibrated trees.
+
+:returns: Number of cached evidence configurations.
+)doc")
+        .def("max_cached", &JunctionTree::max_cached, R"doc(
+Gets the maximum number of cached calibrated trees.
+
+:returns: Maximum number of cached evidence configurations.
+)doc")
+        .def("clear_cache", &JunctionTree::clear_cache, R"doc(
+Removes all the cached calibrated trees.
+)doc")
+        .def("__str__", &JunctionTree::ToString)
+        .def("__repr__", &JunctionTree::ToString);
+}
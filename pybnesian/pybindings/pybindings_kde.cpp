@@ -5,13 +5,16 @@
 #include <pybind11/operators.h>
 #include <kde/KDE.hpp>
 #include <kde/ProductKDE.hpp>
+#include <kde/KDEPrecision.hpp>
+#include <kde/FastUnivariateKDE.hpp>
 #include <kde/BandwidthSelector.hpp>
 #include <kde/ScottsBandwidth.hpp>
 #include <kde/NormalReferenceRule.hpp>
 // #include <kde/UCV.hpp>
 #include <util/exceptions.hpp>
 
-using kde::KDE, kde::ProductKDE, kde::BandwidthSelector, kde::ScottsBandwidth, kde::NormalReferenceRule;
+using kde::KDE, kde::ProductKDE, kde::KDEPrecision, kde::UnivariateKDEMethod, kde::BandwidthSelector, kde::ScottsBandwidth,
+    kde::NormalReferenceRule;
 
 // using kde::KDE, kde::ProductKDE, kde::BandwidthSelector, kde::ScottsBandwidth, kde::NormalReferenceRule, kde::UCV,
 //     kde::UCVScorer;
@@ -211,6 +214,38 @@ Initializes a :class:`NormalReferenceRule <pybnesian.NormalReferenceRule>`.
 //         .def(py::pickle([](const UCV& self) { return self.__getstate__(); },
 //                         [](py::tuple&) { return std::make_shared<UCV>(); }));
 
+    py::enum_<KDEPrecision>(root, "KDEPrecision", R"doc(
+Precision policy used to evaluate the log-likelihood of :class:`KDE <pybnesian.KDE>`,
+:class:`ProductKDE <pybnesian.ProductKDE>` and :class:`CKDE <pybnesian.CKDE>` models:
+
+- ``KDEPrecision.Native``: all the computations use the data type of the training data. This is the default.
+- ``KDEPrecision.Mixed``: the kernels are evaluated in the data type of the training data, but the log-sum-exp over the
+  training instances and the sum of the log-likelihoods are accumulated in double precision with compensated
+  summation. Fitting the model with ``float32`` data halves the memory used by the training data, and the
+  log-likelihood keeps the accuracy of the reductions.
+)doc")
+        .value("Native", KDEPrecision::Native)
+        .value("Mixed", KDEPrecision::Mixed);
+
+    py::enum_<UnivariateKDEMethod>(root, "UnivariateKDEMethod", R"doc(
+Method used to evaluate the log-likelihood of a :class:`KDE <pybnesian.KDE>` with one variable. It is also used in the
+joint KDE of a :class:`CKDE <pybnesian.CKDE>` without evidence, and in the marginal KDE of a
+:class:`CKDE <pybnesian.CKDE>` with one evidence variable:
+
+- ``UnivariateKDEMethod.Exact``: each test instance is compared with every training instance. The cost is
+  :math:`O(NM)`. This is the default.
+- ``UnivariateKDEMethod.SortedWindow``: the training data is sorted, and only the training instances close enough to
+  contribute to the density of a test instance are visited. The absolute error of each log-likelihood value is at most
+  the tolerance.
+- ``UnivariateKDEMethod.Binned``: the density is precomputed on a grid with an FFT convolution when the model is
+  fitted, and each test instance is evaluated with a linear interpolation in :math:`O(1)`. The error of each
+  log-likelihood value is of the order of the tolerance. The test instances outside the grid, or in regions of very
+  low density, are evaluated with ``UnivariateKDEMethod.SortedWindow``.
+)doc")
+        .value("Exact", UnivariateKDEMethod::Exact)
+        .value("SortedWindow", UnivariateKDEMethod::SortedWindow)
+        .value("Binned", UnivariateKDEMethod::Binned);
+
     py::class_<KDE>(root, "KDE", R"doc(
 This class implements Kernel Density Estimation (KDE) for a set of variables:
 
@@ -262,6 +297,17 @@ Bandwidth matrix (:math:`\mathbf{H}`)
 Gets the training dataset for this KDE (the :math:`\mathbf{t}_{i}` instances).
 
 :returns: Training instance.
+)doc")
+        .def_property("precision", &KDE::precision, &KDE::set_precision, R"doc(
+:class:`KDEPrecision <pybnesian.KDEPrecision>` used to evaluate the log-likelihood.
+)doc")
+        .def_property("univariate_method", &KDE::univariate_method, &KDE::set_univariate_method, R"doc(
+:class:`UnivariateKDEMethod <pybnesian.UnivariateKDEMethod>` used to evaluate the log-likelihood if the KDE has one
+variable.
+)doc")
+        .def_property("univariate_tolerance", &KDE::univariate_tolerance, &KDE::set_univariate_tolerance, R"doc(
+Tolerance of the log-likelihood of ``UnivariateKDEMethod.SortedWindow`` and ``UnivariateKDEMethod.Binned``. It must be
+in the range (0, 1). The default is 1e-6.
 )doc")
         .def("fitted", &KDE::fitted, R"doc(
 Checks whether the model is fitted.
@@ -279,6 +325,9 @@ It can return :func:`pyarrow.float64 <pyarrow.float64>` or :func:`pyarrow.float3
 Fits the :class:`KDE <pybnesian.KDE>` with the data in ``df``. It estimates the bandwidth :math:`\mathbf{H}` automatically using the
 provided bandwidth selector.
 
+If ``df`` has weights (see :func:`with_weights <pybnesian.with_weights>`), each training instance is kept once and its
+kernel is weighted by its normalized weight, instead of :math:`1/N`. The instances with weight 0 are not kept.
+
 :param df: DataFrame to fit the :class:`KDE <pybnesian.KDE>`.
 )doc")
         .def("logl", &KDE::logl, py::return_value_policy::take_ownership, py::arg("df"), R"doc(
@@ -353,6 +402,9 @@ Vector of bandwidth values (:math:`h_{j}^{2}`).
 Gets the training dataset for this ProductKDE (the :math:`\mathbf{t}_{i}` instances).
 
 :returns: Training instance.
+)doc")
+        .def_property("precision", &ProductKDE::precision, &ProductKDE::set_precision, R"doc(
+:class:`KDEPrecision <pybnesian.KDEPrecision>` used to evaluate the log-likelihood.
 )doc")
         .def("fitted", &ProductKDE::fitted, R"doc(
 Checks whether the model is fitted.
@@ -370,6 +422,9 @@ It can return :func:`pyarrow.float64 <pyarrow.float64>` or :func:`pyarrow.float3
 Fits the :class:`ProductKDE <pybnesian.ProductKDE>` with the data in ``df``. It estimates the bandwidth vector :math:`h_{j}` automatically
 using the provided bandwidth selector.
 
+If ``df`` has weights (see :func:`with_weights <pybnesian.with_weights>`), each training instance is kept once and its
+kernel is weighted by its normalized weight, instead of :math:`1/N`. The instances with weight 0 are not kept.
+
 :param df: DataFrame to fit the :class:`ProductKDE <pybnesian.ProductKDE>`.
 )doc")
         .def("logl", &ProductKDE::logl, py::return_value_policy::take_ownership, py::arg("df"), R"doc(
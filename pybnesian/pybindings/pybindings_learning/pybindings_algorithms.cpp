@@ -1,5 +1,6 @@
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
+#include <pybind11/numpy.h>
 #include <learning/operators/operators.hpp>
 #include <learning/algorithms/callbacks/callback.hpp>
 #include <learning/algorithms/callbacks/save_model.hpp>
@@ -9,6 +10,8 @@
 #include <learning/algorithms/mmpc.hpp>
 #include <learning/algorithms/mmhc.hpp>
 #include <learning/algorithms/dmmhc.hpp>
+#include <learning/algorithms/bootstrap.hpp>
+#include <learning/algorithms/sparse_candidate.hpp>
 
 namespace py = pybind11;
 
@@ -20,8 +23,9 @@ using learning::algorithms::callbacks::Callback, learning::algorithms::callbacks
 using learning::operators::OperatorPool;
 
 using learning::algorithms::DMMHC;
+using learning::algorithms::BootstrapFrequencies;
 
-using learning::algorithms::SepList;
+using learning::algorithms::SepList, learning::algorithms::SepsetResults, learning::algorithms::SepsetJob;
 
 using learning::algorithms::vstructure;
 
@@ -128,6 +132,378 @@ Executes a greedy hill-climbing algorithm. This calls :func:`GreedyHillClimbing.
                            and :class:`ValidatedLikelihood <pybnesian.ValidatedLikelihood>` scores.
 :param verbose: If True the progress will be displayed, otherwise nothing will be displayed.
 :returns: The estimated Bayesian network structure.
+)doc");
+
+    root.def(
+        "hc_restarts",
+        [](const DataFrame& df,
+           const std::shared_ptr<BayesianNetworkType> bn_type,
+           const std::shared_ptr<BayesianNetworkBase> start,
+           const std::optional<std::string>& score,
+           const std::optional<std::vector<std::string>>& operators,
+           const ArcStringVector& arc_blacklist,
+           const ArcStringVector& arc_whitelist,
+           const FactorTypeVector& type_blacklist,
+           const FactorTypeVector& type_whitelist,
+           int max_indegree,
+           int max_iters,
+           double epsilon,
+           int patience,
+           int num_restarts,
+           const std::string& perturbation,
+           int num_perturbations,
+           std::optional<unsigned int> seed,
+           int num_folds,
+           double test_holdout_ratio,
+           int num_threads,
+           bool return_all) -> py::object {
+            std::vector<learning::algorithms::RestartResult> results;
+            {
+                py::gil_scoped_release release;
+                results = learning::algorithms::hc_restarts(df,
+                                                            bn_type,
+                                                            start,
+                                                            score,
+                                                            operators,
+                                                            arc_blacklist,
+                                                            arc_whitelist,
+                                                            type_blacklist,
+                                                            type_whitelist,
+                                                            max_indegree,
+                                                            max_iters,
+                                                            epsilon,
+                                                            patience,
+                                                            num_restarts,
+                                                            perturbation,
+                                                            num_perturbations,
+                                                            seed,
+                                                            num_folds,
+                                                            test_holdout_ratio,
+                                                            num_threads);
+            }
+
+            if (!return_all) return py::cast(results[0].model);
+
+            py::list ranking;
+            for (const auto& r : results) {
+                ranking.append(py::make_tuple(r.model, r.score));
+            }
+
+            return std::move(ranking);
+        },
+        py::arg("df"),
+        py::arg("bn_type") = nullptr,
+        py::arg("start") = nullptr,
+        py::arg("score") = std::nullopt,
+        py::arg("operators") = std::nullopt,
+        py::arg("arc_blacklist") = ArcStringVector(),
+        py::arg("arc_whitelist") = ArcStringVector(),
+        py::arg("type_blacklist") = FactorTypeVector(),
+        py::arg("type_whitelist") = FactorTypeVector(),
+        py::arg("max_indegree") = 0,
+        py::arg("max_iters") = std::numeric_limits<int>::max(),
+        py::arg("epsilon") = 0,
+        py::arg("patience") = 0,
+        py::arg("num_restarts") = 10,
+        py::arg("perturbation") = "arcs",
+        py::arg("num_perturbations") = 10,
+        py::arg("seed") = std::nullopt,
+        py::arg("num_folds") = 10,
+        py::arg("test_holdout_ratio") = 0.2,
+        py::arg("num_threads") = 0,
+        py::arg("return_all") = false,
+        R"doc(
+Executes ``num_restarts`` greedy hill-climbing algorithms (see :func:`hc`) from different initial structures, and
+returns the best learned model. The restarts are executed in parallel, and they share the local scores already
+computed, so a local score is computed only once even if it is needed by many restarts.
+
+The first restart starts from ``start`` (or an empty model). The rest of restarts start from a perturbation of it,
+chosen with ``perturbation``:
+
+- ``"arcs"``: ``num_perturbations`` random arc additions, removals and flips. The perturbations respect the
+  blacklist, the whitelist and ``max_indegree``.
+- ``"bootstrap"``: the model learned by a hill-climbing on a bootstrap sample of ``df``.
+
+The models with KDE factors (e.g. :class:`SemiparametricBN <pybnesian.SemiparametricBN>` or
+:class:`KDENetwork <pybnesian.KDENetwork>`) are learned sequentially. The Bayesian network types implemented in Python
+are not supported.
+
+:param df: DataFrame used to learn a Bayesian network model.
+:param bn_type: :class:`BayesianNetworkType` of the returned model. If ``start`` is given, ``bn_type`` is ignored.
+:param start: Initial structure of the first restart. If ``None``, a new Bayesian network model is created.
+:param score: A string representing the score used to drive the search. See :func:`hc`.
+:param operators: Set of operators in the search process.
+:param arc_blacklist: List of arcs blacklist (forbidden arcs).
+:param arc_whitelist: List of arcs whitelist (forced arcs).
+:param type_blacklist: List of type blacklist (forbidden :class:`FactorType <pybnesian.FactorType>`).
+:param type_whitelist: List of type whitelist (forced :class:`FactorType <pybnesian.FactorType>`).
+:param max_indegree: Maximum indegree allowed in the graph.
+:param max_iters: Maximum number of search iterations of each restart.
+:param epsilon: Minimum delta score allowed for each operator. If the new operator is less than epsilon, the search
+                process is stopped.
+:param patience: The patience parameter (only used with
+                :class:`ValidatedScore <pybnesian.ValidatedScore>`). See `patience`_.
+:param num_restarts: Number of restarts.
+:param perturbation: Perturbation of the initial structures: ``"arcs"`` or ``"bootstrap"``.
+:param num_perturbations: Number of random arc changes of the ``"arcs"`` perturbation.
+:param seed: Seed of the score and the perturbations. With the same seed, the result does not depend on the number of
+             threads.
+:param num_folds: Number of folds for the :class:`CVLikelihood <pybnesian.CVLikelihood>` and
+                  :class:`ValidatedLikelihood <pybnesian.ValidatedLikelihood>` scores.
+:param test_holdout_ratio: Parameter for the :class:`HoldoutLikelihood <pybnesian.HoldoutLikelihood>`
+                           and :class:`ValidatedLikelihood <pybnesian.ValidatedLikelihood>` scores.
+:param num_threads: Number of threads. If 0, the number of threads of the OpenMP runtime is used.
+:param return_all: If True, returns the learned models of all the restarts.
+:returns: The learned model with the best score. If ``return_all`` is True, a list of tuples (model, score) sorted by
+          descending score. The score is the validation score for the
+          :class:`ValidatedScore <pybnesian.ValidatedScore>`.
+)doc");
+
+    py::class_<BootstrapFrequencies>(root, "BootstrapFrequencies", R"doc(
+Frequencies of the arcs and edges learned in the bootstrap replicates of a structure learning algorithm. It is returned
+by :func:`bootstrap_hc`, :func:`bootstrap_pc` and :func:`bootstrap_mmhc`.
+)doc")
+        .def("nodes", &BootstrapFrequencies::nodes, R"doc(
+Gets the nodes of the learned structures.
+
+:returns: Nodes of the learned structures.
+)doc")
+        .def("num_replicates", &BootstrapFrequencies::num_replicates, R"doc(
+Gets the number of bootstrap replicates.
+
+:returns: Number of bootstrap replicates.
+)doc")
+        .def("arc_frequency", &BootstrapFrequencies::arc_frequency, py::arg("source"), py::arg("target"), R"doc(
+Gets the fraction of replicates that learned the arc ``source`` -> ``target``.
+
+:param source: Source node.
+:param target: Target node.
+:returns: Frequency of the arc.
+)doc")
+        .def("edge_frequency", &BootstrapFrequencies::edge_frequency, py::arg("n1"), py::arg("n2"), R"doc(
+Gets the fraction of replicates where ``n1`` and ``n2`` are adjacent (an arc in any direction or an undirected edge).
+
+:param n1: A node.
+:param n2: The other node.
+:returns: Frequency of the edge.
+)doc")
+        .def("arcs", &BootstrapFrequencies::arcs, R"doc(
+Gets the arcs learned in some replicate.
+
+:returns: List of tuples (source, target, frequency).
+)doc")
+        .def("edges", &BootstrapFrequencies::edges, R"doc(
+Gets the pairs of nodes adjacent in some replicate.
+
+:returns: List of tuples (n1, n2, frequency).
+)doc")
+        .def("averaged_dag", &BootstrapFrequencies::averaged_dag, py::arg("threshold") = 0.5, R"doc(
+Builds the averaged :class:`Dag <pybnesian.Dag>` with the edges whose frequency is greater or equal than
+``threshold``. Each edge is oriented in its most frequent direction. The edges are added by descending frequency, and
+an edge is reversed if it would create a cycle.
+
+:param threshold: Minimum edge frequency in (0, 1].
+:returns: The averaged :class:`Dag <pybnesian.Dag>`.
+)doc")
+        .def("averaged_pdag", &BootstrapFrequencies::averaged_pdag, py::arg("threshold") = 0.5, R"doc(
+Builds the averaged :class:`PartiallyDirectedGraph <pybnesian.PartiallyDirectedGraph>` with the edges whose frequency
+is greater or equal than ``threshold``. An edge is an arc if the frequency of the arc is greater or equal than
+``threshold`` and greater than the frequency of the opposite arc. Otherwise, it is an undirected edge.
+
+:param threshold: Minimum edge frequency in (0, 1].
+:returns: The averaged :class:`PartiallyDirectedGraph <pybnesian.PartiallyDirectedGraph>`.
+)doc");
+
+    root.def("bootstrap_hc",
+             &learning::algorithms::bootstrap_hc,
+             py::arg("df"),
+             py::arg("bn_type") = nullptr,
+             py::arg("start") = nullptr,
+             py::arg("score") = std::nullopt,
+             py::arg("operators") = std::nullopt,
+             py::arg("arc_blacklist") = ArcStringVector(),
+             py::arg("arc_whitelist") = ArcStringVector(),
+             py::arg("type_blacklist") = FactorTypeVector(),
+             py::arg("type_whitelist") = FactorTypeVector(),
+             py::arg("max_indegree") = 0,
+             py::arg("max_iters") = std::numeric_limits<int>::max(),
+             py::arg("epsilon") = 0,
+             py::arg("patience") = 0,
+             py::arg("num_replicates") = 100,
+             py::arg("seed") = std::nullopt,
+             py::arg("num_folds") = 10,
+             py::arg("test_holdout_ratio") = 0.2,
+             py::arg("num_threads") = 0,
+             py::call_guard<py::gil_scoped_release>(),
+             R"doc(
+Executes a greedy hill-climbing (see :func:`hc`) on ``num_replicates`` bootstrap resamples of ``df``, and returns the
+frequencies of the learned arcs. The replicates are executed in parallel. The models with KDE factors (e.g.
+:class:`SemiparametricBN <pybnesian.SemiparametricBN>` or :class:`KDENetwork <pybnesian.KDENetwork>`) are learned
+sequentially.
+
+:param df: DataFrame used to learn a Bayesian network model.
+:param bn_type: :class:`BayesianNetworkType` of the learned models. If ``start`` is given, ``bn_type`` is ignored.
+:param start: Initial structure of each replicate. If ``None``, a new Bayesian network model is created.
+:param score: A string representing the score used to drive the search. See :func:`hc`.
+:param operators: Set of operators in the search process.
+:param arc_blacklist: List of arcs blacklist (forbidden arcs).
+:param arc_whitelist: List of arcs whitelist (forced arcs).
+:param type_blacklist: List of type blacklist (forbidden :class:`FactorType <pybnesian.FactorType>`).
+:param type_whitelist: List of type whitelist (forced :class:`FactorType <pybnesian.FactorType>`).
+:param max_indegree: Maximum indegree allowed in the graph.
+:param max_iters: Maximum number of search iterations of each replicate.
+:param epsilon: Minimum delta score allowed for each operator. If the new operator is less than epsilon, the search
+                process is stopped.
+:param patience: The patience parameter (only used with
+                :class:`ValidatedScore <pybnesian.ValidatedScore>`). See `patience`_.
+:param num_replicates: Number of bootstrap replicates.
+:param seed: Seed of the resamples and the scores. With the same seed, the result does not depend on the number of
+             threads.
+:param num_folds: Number of folds for the :class:`CVLikelihood <pybnesian.CVLikelihood>` and
+                  :class:`ValidatedLikelihood <pybnesian.ValidatedLikelihood>` scores.
+:param test_holdout_ratio: Parameter for the :class:`HoldoutLikelihood <pybnesian.HoldoutLikelihood>`
+                           and :class:`ValidatedLikelihood <pybnesian.ValidatedLikelihood>` scores.
+:param num_threads: Number of threads. If 0, the number of threads of the OpenMP runtime is used.
+:returns: A :class:`BootstrapFrequencies` with the frequencies of the learned arcs.
+)doc");
+
+    root.def("bootstrap_pc",
+             &learning::algorithms::bootstrap_pc,
+             py::arg("df"),
+             py::arg("test") = "linear-correlation",
+             py::arg("nodes") = std::vector<std::string>(),
+             py::arg("arc_blacklist") = ArcStringVector(),
+             py::arg("arc_whitelist") = ArcStringVector(),
+             py::arg("edge_blacklist") = EdgeStringVector(),
+             py::arg("edge_whitelist") = EdgeStringVector(),
+             py::arg("alpha") = 0.05,
+             py::arg("use_sepsets") = false,
+             py::arg("ambiguous_threshold") = 0.5,
+             py::arg("allow_bidirected") = true,
+             py::arg("num_replicates") = 100,
+             py::arg("seed") = std::nullopt,
+             py::arg("num_threads") = 0,
+             py::call_guard<py::gil_scoped_release>(),
+             R"doc(
+Executes the PC algorithm (see :func:`PC.estimate`) on ``num_replicates`` bootstrap resamples of ``df``, and returns
+the frequencies of the learned arcs and edges. The replicates are executed in parallel.
+
+:param df: DataFrame used to learn the graphs.
+:param test: A string representing the conditional independence test: "linear-correlation" for
+             :class:`LinearCorrelation <pybnesian.LinearCorrelation>`, "chi-square" for
+             :class:`ChiSquare <pybnesian.ChiSquare>` or "mutual-info" for
+             :class:`MutualInformation <pybnesian.MutualInformation>`.
+:param nodes: The list of nodes of the graphs. If empty, all the columns of ``df`` are used.
+:param arc_blacklist: List of arcs blacklist (forbidden arcs).
+:param arc_whitelist: List of arcs whitelist (forced arcs).
+:param edge_blacklist: List of edge blacklist (forbidden edges).
+:param edge_whitelist: List of edge whitelist (forced edges).
+:param alpha: The type I error of each independence test.
+:param use_sepsets: If True, the detection of v-structures is done using the separating sets. See
+                    :func:`PC.estimate`.
+:param ambiguous_threshold: If ``use_sepsets`` is False, the ``ambiguous_threshold`` sets the threshold on the ratio
+                            of separating sets needed to reject a v-structure.
+:param allow_bidirected: If True, it allows bi-directed arcs.
+:param num_replicates: Number of bootstrap replicates.
+:param seed: Seed of the resamples.
+:param num_threads: Number of threads. If 0, the number of threads of the OpenMP runtime is used.
+:returns: A :class:`BootstrapFrequencies` with the frequencies of the learned arcs and edges.
+)doc");
+
+    root.def("bootstrap_mmhc",
+             &learning::algorithms::bootstrap_mmhc,
+             py::arg("df"),
+             py::arg("bn_type") = GaussianNetworkType::get(),
+             py::arg("test") = "linear-correlation",
+             py::arg("score") = std::nullopt,
+             py::arg("operators") = std::nullopt,
+             py::arg("nodes") = std::vector<std::string>(),
+             py::arg("arc_blacklist") = ArcStringVector(),
+             py::arg("arc_whitelist") = ArcStringVector(),
+             py::arg("edge_blacklist") = EdgeStringVector(),
+             py::arg("edge_whitelist") = EdgeStringVector(),
+             py::arg("type_blacklist") = FactorTypeVector(),
+             py::arg("type_whitelist") = FactorTypeVector(),
+             py::arg("max_indegree") = 0,
+             py::arg("max_iters") = std::numeric_limits<int>::max(),
+             py::arg("epsilon") = 0,
+             py::arg("patience") = 0,
+             py::arg("alpha") = 0.05,
+             py::arg("num_replicates") = 100,
+             py::arg("seed") = std::nullopt,
+             py::arg("num_folds") = 10,
+             py::arg("test_holdout_ratio") = 0.2,
+             py::arg("num_threads") = 0,
+             py::call_guard<py::gil_scoped_release>(),
+             R"doc(
+Executes the MMHC algorithm (see :func:`MMHC.estimate`) on ``num_replicates`` bootstrap resamples of ``df``, and
+returns the frequencies of the learned arcs. The replicates are executed in parallel. The models with KDE factors are
+learned sequentially.
+
+:param df: DataFrame used to learn a Bayesian network model.
+:param bn_type: :class:`BayesianNetworkType` of the learned models.
+:param test: A string representing the conditional independence test. See :func:`bootstrap_pc`.
+:param score: A string representing the score used to drive the search. See :func:`hc`.
+:param operators: Set of operators in the search process.
+:param nodes: The list of nodes of the models. If empty, all the columns of ``df`` are used.
+:param arc_blacklist: List of arcs blacklist (forbidden arcs).
+:param arc_whitelist: List of arcs whitelist (forced arcs).
+:param edge_blacklist: List of edge blacklist (forbidden edges).
+:param edge_whitelist: List of edge whitelist (forced edges).
+:param type_blacklist: List of type blacklist (forbidden :class:`FactorType <pybnesian.FactorType>`).
+:param type_whitelist: List of type whitelist (forced :class:`FactorType <pybnesian.FactorType>`).
+:param max_indegree: Maximum indegree allowed in the graph.
+:param max_iters: Maximum number of search iterations of each replicate.
+:param epsilon: Minimum delta score allowed for each operator. If the new operator is less than epsilon, the search
+                process is stopped.
+:param patience: The patience parameter (only used with
+                :class:`ValidatedScore <pybnesian.ValidatedScore>`). See `patience`_.
+:param alpha: The type I error of each independence test.
+:param num_replicates: Number of bootstrap replicates.
+:param seed: Seed of the resamples and the scores.
+:param num_folds: Number of folds for the :class:`CVLikelihood <pybnesian.CVLikelihood>` and
+                  :class:`ValidatedLikelihood <pybnesian.ValidatedLikelihood>` scores.
+:param test_holdout_ratio: Parameter for the :class:`HoldoutLikelihood <pybnesian.HoldoutLikelihood>`
+                           and :class:`ValidatedLikelihood <pybnesian.ValidatedLikelihood>` scores.
+:param num_threads: Number of threads. If 0, the number of threads of the OpenMP runtime is used.
+:returns: A :class:`BootstrapFrequencies` with the frequencies of the learned arcs.
+)doc");
+
+    root.def("association_candidates",
+             &learning::algorithms::association_candidates,
+             py::arg("test"),
+             py::arg("nodes") = std::vector<std::string>(),
+             py::arg("k") = 10,
+             py::call_guard<py::gil_scoped_release>(),
+             R"doc(
+Selects the candidate parents of each node for a :class:`SparseArcOperatorSet <pybnesian.SparseArcOperatorSet>`: the
+``k`` nodes with the smallest marginal p-value (the strongest marginal association) with the node.
+
+:param test: The :class:`IndependenceTest <pybnesian.IndependenceTest>` used to measure the associations.
+:param nodes: The list of nodes. If empty, all the variables of ``test`` are used.
+:param k: Number of candidate parents of each node.
+:returns: A dict with the list of candidate parents of each node.
+)doc");
+
+    root.def("mmpc_candidates",
+             &learning::algorithms::mmpc_candidates,
+             py::arg("test"),
+             py::arg("nodes") = std::vector<std::string>(),
+             py::arg("alpha") = 0.05,
+             py::arg("max_candidates") = 0,
+             py::arg("verbose") = 0,
+             R"doc(
+Selects the candidate parents of each node for a :class:`SparseArcOperatorSet <pybnesian.SparseArcOperatorSet>`: the
+candidate parents and children (CPC) estimated by :class:`MMPC`, after removing the asymmetries as in
+:class:`MMHC`.
+
+:param test: The :class:`IndependenceTest <pybnesian.IndependenceTest>` used by :class:`MMPC`.
+:param nodes: The list of nodes. If empty, all the variables of ``test`` are used.
+:param alpha: The type I error of each independence test.
+:param max_candidates: If greater than 0, only the ``max_candidates`` nodes of each CPC with the smallest marginal
+                       p-value are kept.
+:param verbose: If True the progress will be displayed, otherwise nothing will be displayed.
+:returns: A dict with the list of candidate parents of each node.
 )doc");
 
     py::class_<GreedyHillClimbing> hc(root, "GreedyHillClimbing", R"doc(
@@ -244,6 +620,118 @@ py::class_<SepList>(root, "SepList")
         .def_property_readonly("l_sep", &SepList::get_l_sep,
      "The internal list holding edges and their separation sets");
 
+py::class_<SepsetResults>(root, "SepsetResults", R"doc(
+The results of the independence tests of a :class:`SepsetJob` in columnar form. Row ``i`` is the test of the edge
+``(node1[i], node2[i])`` given the sepset ``sepsets[i]``, which returned the p-value ``pvalues[i]``. The nodes are
+the indices of the :class:`PartiallyDirectedGraph`.
+)doc")
+        .def_property_readonly("sepset_size", [](const SepsetResults& self) { return self.sepset_size; }, R"doc(
+Size of the sepsets.
+)doc")
+        .def_property_readonly("node1", [](const SepsetResults& self) {
+                return py::array_t<int>(self.node1.size(), self.node1.data());
+            }, R"doc(
+Array with the first node of each tested edge.
+)doc")
+        .def_property_readonly("node2", [](const SepsetResults& self) {
+                return py::array_t<int>(self.node2.size(), self.node2.data());
+            }, R"doc(
+Array with the second node of each tested edge.
+)doc")
+        .def_property_readonly("sepsets", [](const SepsetResults& self) {
+                return py::array_t<int>(std::vector<size_t>{self.size(), static_cast<size_t>(self.sepset_size)},
+                                        self.sepsets.data());
+            }, R"doc(
+Array of shape ``(len(self), sepset_size)`` with the (sorted) sepset of each test.
+)doc")
+        .def_property_readonly("pvalues", [](const SepsetResults& self) {
+                return py::array_t<double>(self.pvalues.size(), self.pvalues.data());
+            }, R"doc(
+Array with the p-value of each test.
+)doc")
+        .def("__len__", &SepsetResults::size)
+        .def("to_seplist", &SepsetResults::to_seplist, R"doc(
+Converts the results to a :class:`SepList`.
+
+:returns: A :class:`SepList` with the same tests.
+)doc");
+
+py::class_<SepsetJob, std::shared_ptr<SepsetJob>>(root, "SepsetJob", R"doc(
+Computes the independence tests of :func:`PC.compute_sepsets_of_size` in a pool of background threads. It is created
+with :func:`PC.start_sepsets_of_size`.
+
+The results can be read while the job runs with :func:`SepsetJob.poll`. If the user modifies the partially directed
+graph, the pending tests can be reordered (:func:`SepsetJob.prioritize`) or dropped (:func:`SepsetJob.remove_edges`)
+without restarting the job.
+
+The job is cancelled when it is destroyed.
+)doc")
+        .def_property_readonly("sepset_size", &SepsetJob::sepset_size, R"doc(
+Size of the sepsets tested by the job.
+)doc")
+        .def("num_edges", &SepsetJob::num_edges, R"doc(
+Gets the number of edges to test (the removed edges are not counted).
+
+:returns: Number of edges to test.
+)doc")
+        .def("num_threads", &SepsetJob::num_threads, R"doc(
+Gets the number of background threads of the job.
+
+:returns: Number of threads.
+)doc")
+        .def("num_finished_edges", &SepsetJob::num_finished_edges, R"doc(
+Gets the number of edges whose tests are finished.
+
+:returns: Number of tested edges.
+)doc")
+        .def("done", &SepsetJob::done, R"doc(
+Checks whether all the edges were tested or the job was cancelled.
+
+:returns: True if the job is done, False otherwise.
+)doc")
+        .def("cancelled", &SepsetJob::cancelled, R"doc(
+Checks whether the job was cancelled.
+
+:returns: True if the job was cancelled, False otherwise.
+)doc")
+        .def("poll", &SepsetJob::poll, R"doc(
+Gets the results computed since the last call to :func:`SepsetJob.poll`. If a test raised an exception, it is
+raised again.
+
+:returns: A :class:`SepsetResults` with the new results.
+)doc")
+        .def("results", &SepsetJob::results, R"doc(
+Gets all the results computed so far.
+
+:returns: A :class:`SepsetResults` with all the results.
+)doc")
+        .def("prioritize", &SepsetJob::prioritize, py::arg("edges"), R"doc(
+Moves the pending tests of the edges to the front of the queue, in the same order.
+
+:param edges: List of edges (pairs of node indices).
+)doc")
+        .def("remove_edges", &SepsetJob::remove_edges, py::arg("edges"), R"doc(
+Drops the pending tests of the edges, because they were removed from the partially directed graph. The speculative
+tests of the next sepset size are computed without these edges.
+
+:param edges: List of edges (pairs of node indices).
+)doc")
+        .def("cancel", &SepsetJob::cancel, R"doc(
+Stops the job as soon as possible. The results computed before cancelling are kept.
+)doc")
+        .def("wait",
+             &SepsetJob::wait,
+             py::arg("timeout") = -1,
+             py::arg("speculative") = false,
+             py::call_guard<py::gil_scoped_release>(),
+             R"doc(
+Waits until the job is done. If a test raised an exception, it is raised again.
+
+:param timeout: Maximum time to wait in seconds. If negative, it waits until the job is done.
+:param speculative: If True, it also waits for the speculative tests of the next sepset size.
+:returns: True if the job is done, False if the timeout expired.
+)doc");
+
 py::class_<vstructure>(root, "VStructure")
         .def(pybind11::init<>())
         .def_readwrite("p1", &vstructure::p1)  // Expose as read/write
@@ -361,6 +849,68 @@ Estimates the conditional skeleton (the conditional partially directed graph) us
              py::arg("edge_whitelist") = EdgeStringVector(),
              py::arg("sepset_size") = 0,
              R"doc()doc")
+        .def(
+            "start_sepsets_of_size",
+            [](const PC& self,
+               const PartiallyDirectedGraph& pdag,
+               std::shared_ptr<IndependenceTest> hypot_test,
+               const ArcStringVector& arc_blacklist,
+               const ArcStringVector& arc_whitelist,
+               const EdgeStringVector& edge_blacklist,
+               const EdgeStringVector& edge_whitelist,
+               int sepset_size,
+               bool speculate,
+               int num_threads,
+               const EdgeStringVector& priority_edges) {
+                auto job = self.start_sepsets_of_size(pdag,
+                                                      hypot_test,
+                                                      arc_blacklist,
+                                                      arc_whitelist,
+                                                      edge_blacklist,
+                                                      edge_whitelist,
+                                                      sepset_size,
+                                                      speculate,
+                                                      num_threads,
+                                                      priority_edges);
+
+                // The threads may be running a Python independence test, so the GIL is released while they are
+                // joined.
+                return std::shared_ptr<SepsetJob>(job.release(), [](SepsetJob* j) {
+                    py::gil_scoped_release release;
+                    delete j;
+                });
+            },
+            py::arg("pdag"),
+            py::arg("hypot_test"),
+            py::arg("arc_blacklist") = ArcStringVector(),
+            py::arg("arc_whitelist") = ArcStringVector(),
+            py::arg("edge_blacklist") = EdgeStringVector(),
+            py::arg("edge_whitelist") = EdgeStringVector(),
+            py::arg("sepset_size") = 0,
+            py::arg("speculate") = false,
+            py::arg("num_threads") = 0,
+            py::arg("priority_edges") = EdgeStringVector(),
+            py::keep_alive<0, 3>(),
+            R"doc(
+Starts the computation of :func:`PC.compute_sepsets_of_size` in the background, and returns immediately. The tests
+are computed on a copy of ``pdag``.
+
+:param pdag: The :class:`PartiallyDirectedGraph` whose edges are tested.
+:param hypot_test: The :class:`IndependenceTest <pybnesian.IndependenceTest>` object used to
+                   execute the conditional independence tests.
+:param arc_blacklist: List of arcs blacklist (forbidden arcs).
+:param arc_whitelist: List of arcs whitelist (forced arcs).
+:param edge_blacklist: List of edge blacklist (forbidden edges).
+:param edge_whitelist: List of edge whitelist (forced edges). These edges are not tested.
+:param sepset_size: Size of the sepsets.
+:param speculate: If True, the tests of size ``sepset_size + 1`` are computed when the job is done, so the next job
+                  finds them in the cache. ``hypot_test`` must be a
+                  :class:`CachedIndependenceTest <pybnesian.CachedIndependenceTest>`.
+:param num_threads: Number of background threads. If 0, the number of threads of :func:`set_num_threads` is used.
+:param priority_edges: List of edges that are tested first, in the same order. Unlike
+                       :func:`SepsetJob.prioritize`, the order is set before any test starts.
+:returns: A :class:`SepsetJob`.
+)doc")
              .def("apply_adjacency_search",
              &PC::apply_adjacency_search,
              py::arg("pdag"),
@@ -2,6 +2,7 @@
 #include <pybind11/stl.h>
 #include <pybind11/eigen.h>
 #include <learning/independences/independence.hpp>
+#include <learning/independences/cached_independence.hpp>
 #include <learning/independences/continuous/linearcorrelation.hpp>
 #include <learning/independences/continuous/mutual_information.hpp>
 #include <learning/independences/continuous/RCoT.hpp>
@@ -21,6 +22,8 @@ using learning::independences::DynamicIndependenceTest, learning::independences:
     learning::independences::continuous::DynamicKMutualInformation, learning::independences::continuous::DynamicRCoT,
     learning::independences::discrete::DynamicChiSquare, learning::independences::hybrid::DynamicMutualInformation;
 
+using learning::independences::CachedIndependenceTest, learning::independences::CachedDynamicIndependenceTest;
+
 using util::random_seed_arg;
 
 class PyIndependenceTest : public IndependenceTest {
@@ -94,6 +97,14 @@ public:
                                cols              /* Argument(s) */
         );
     }
+
+    std::string ToString() const override {
+        PYBIND11_OVERRIDE_NAME(std::string,      /* Return type */
+                               IndependenceTest, /* Parent class */
+                               "__str__",
+                               ToString, /* Name of function in C++ (must match Python name) */
+        );
+    }
 };
 
 void pybindings_independence_tests(py::module& root) {
@@ -167,7 +178,8 @@ Gets the variable name of the index-th variable.
 
 :param index: Index of the variable.
 :returns: Variable name at the ``index`` position.
-)doc");
+)doc")
+        .def("__str__", &IndependenceTest::ToString);
 
     {
         py::options options;
@@ -199,6 +211,12 @@ data.
 Initializes a :class:`LinearCorrelation` for the continuous variables in the DataFrame ``df``.
 
 :param df: DataFrame on which to calculate the independence tests.
+)doc")
+        .def(py::init<const ChunkedDataFrame&>(), py::arg("df"), R"doc(
+Initializes a :class:`LinearCorrelation` for the continuous variables in the :class:`ChunkedDataFrame` ``df``. The
+chunks are not concatenated: the covariances are computed from the moments of each chunk.
+
+:param df: :class:`ChunkedDataFrame` on which to calculate the independence tests.
 )doc");
 
     py::class_<MutualInformation, IndependenceTest, std::shared_ptr<MutualInformation>>(root,
@@ -350,11 +368,20 @@ This class implements a non-parametric independence test called Randomized Condi
 method is described in [RCoT]_. This independence is only implemented for continuous data.
 
 This method uses random fourier features and is designed to be a fast non-parametric independence test.
+
+The random fourier features of each variable (and each conditioning set) are computed once and cached, so the
+:class:`RCoT` can be used concurrently by the constraint-based learning algorithms.
 )doc")
-        .def(py::init<const DataFrame&, int, int>(),
+        .def(py::init([](const DataFrame& df,
+                         int random_fourier_xy,
+                         int random_fourier_z,
+                         std::optional<unsigned int> seed) {
+                 return std::make_shared<RCoT>(df, random_fourier_xy, random_fourier_z, random_seed_arg(seed));
+             }),
              py::arg("df"),
              py::arg("random_fourier_xy") = 5,
              py::arg("random_fourier_z") = 100,
+             py::arg("seed") = std::nullopt,
              R"doc(
 Initializes a :class:`RCoT` for data ``df``. The number of random fourier features used for the ``x`` and ``y`` variables
 in :class:`IndependenceTest.pvalue` is ``random_fourier_xy``. The number of random features used for ``z`` is equal
@@ -363,6 +390,15 @@ to ``random_fourier_z``.
 :param df: DataFrame on which to calculate the independence tests.
 :param random_fourier_xy: Number of random fourier features for the variables of the independence test.
 :param randoum_fourier_z: Number of random fourier features for the conditioning variables of the independence test.
+:param seed: A random seed number. If not specified or ``None``, a random seed is generated.
+)doc")
+        .def("num_cached_features", &RCoT::num_cached_features, R"doc(
+Gets the number of random fourier feature matrices stored in the cache.
+
+:returns: Number of cached random fourier feature matrices.
+)doc")
+        .def("clear_cache", &RCoT::clear_cache, R"doc(
+Removes all the cached random fourier features.
 )doc");
 
     py::class_<ChiSquare, IndependenceTest, std::shared_ptr<ChiSquare>>(root, "ChiSquare", R"doc(
@@ -372,7 +408,13 @@ It implements the Pearson's X^2 test.
 
 :param df: DataFrame on which to calculate the independence tests.
 )doc")
-        .def(py::init<const DataFrame&>(), py::arg("df"));
+        .def(py::init<const DataFrame&>(), py::arg("df"))
+        .def(py::init<const ChunkedDataFrame&>(), py::arg("df"), R"doc(
+Initializes a :class:`ChiSquare` for the :class:`ChunkedDataFrame` ``df``. The chunks are not concatenated: the
+contingency tables are summed over the chunks.
+
+:param df: :class:`ChunkedDataFrame` on which to calculate the independence tests.
+)doc");
 
     py::class_<DynamicIndependenceTest, std::shared_ptr<DynamicIndependenceTest>> dynamic_indep_test(
         root, "DynamicIndependenceTest", R"doc(
@@ -502,18 +544,26 @@ Initializes a :class:`DynamicKMutualInformation` with the given :class:`DynamicD
         root, "DynamicRCoT", py::multiple_inheritance(), R"doc(
 The dynamic adaptation of the :class:`RCoT` independence test.
 )doc")
-        .def(py::init<const DynamicDataFrame&, int, int>(),
+        .def(py::init([](const DynamicDataFrame& df,
+                         int random_fourier_xy,
+                         int random_fourier_z,
+                         std::optional<unsigned int> seed) {
+                 return std::make_shared<DynamicRCoT>(
+                     df, random_fourier_xy, random_fourier_z, static_cast<unsigned int>(random_seed_arg(seed)));
+             }),
              py::arg("ddf"),
              py::arg("random_fourier_xy") = 5,
              py::arg("random_fourier_z") = 100,
+             py::arg("seed") = std::nullopt,
              R"doc(
-Initializes a :class:`DynamicRCoT` with the given :class:`DynamicDataFrame` ``df``. The ``random_fourier_xy`` and
-``random_fourier_z`` parameters are passed to the static and transition components of
+Initializes a :class:`DynamicRCoT` with the given :class:`DynamicDataFrame` ``df``. The ``random_fourier_xy``,
+``random_fourier_z`` and ``seed`` parameters are passed to the static and transition components of
 :class:`RCoT`.
 
 :param ddf: :class:`DynamicDataFrame` to create the :class:`DynamicRCoT`.
 :param random_fourier_xy: Number of random fourier features for the variables of the independence test.
 :param randoum_fourier_z: Number of random fourier features for the conditioning variables of the independence test.
+:param seed: A random seed number. If not specified or ``None``, a random seed is generated.
 )doc");
 
     py::class_<DynamicChiSquare, DynamicIndependenceTest, std::shared_ptr<DynamicChiSquare>>(
@@ -631,5 +681,96 @@ Estimates the multivariate conditional mutual information :math:`\text{MI}(x, y
 :param y: A variable name.
 :param z: A list of variable names.
 :returns: The multivariate conditional mutual information :math:`\text{MI}(x, y \mid \mathbf{z})`.
+)doc");
+
+    py::class_<CachedIndependenceTest, IndependenceTest, std::shared_ptr<CachedIndependenceTest>>(
+        root, "CachedIndependenceTest", R"doc(
+This class memoizes the p-values of any :class:`IndependenceTest`. The independence tests are identified by the
+unordered pair ``(x, y)`` and the (unordered) conditioning set, so each test is computed only once. The cache can be
+used concurrently by the constraint-based learning algorithms.
+
+The cached results can be saved to disk with :func:`CachedIndependenceTest.save` and loaded in a later session with
+:func:`CachedIndependenceTest.load`. The results are only loaded if they were computed on the same data (checked with
+a fingerprint of the :class:`DataFrame`) and with the same test and parameters, including the ``seed`` (checked with
+``str(test)``). This makes it cheap to re-run a learning algorithm with a different significance level.
+
+An :class:`IndependenceTest` implemented in Python should define ``__str__`` to describe its parameters.
+)doc")
+        .def(py::init([](std::shared_ptr<IndependenceTest> test, const DataFrame& df) {
+                 return std::make_shared<CachedIndependenceTest>(test, df);
+             }),
+             py::arg("test"),
+             py::arg("df"),
+             py::keep_alive<1, 2>(),
+             R"doc(
+Initializes a :class:`CachedIndependenceTest` that memoizes the p-values of ``test``.
+
+:param test: :class:`IndependenceTest` to cache.
+:param df: DataFrame used to create ``test``. It is used to compute the fingerprint of the data.
+)doc")
+        .def("test", &CachedIndependenceTest::test, py::return_value_policy::reference_internal, R"doc(
+Gets the cached :class:`IndependenceTest`.
+
+:returns: The cached :class:`IndependenceTest`.
+)doc")
+        .def("fingerprint", &CachedIndependenceTest::fingerprint, R"doc(
+Gets the fingerprint of the data used by the independence test.
+
+:returns: Fingerprint of the data.
+)doc")
+        .def("num_cached", &CachedIndependenceTest::num_cached, R"doc(
+Gets the number of cached independence tests.
+
+:returns: Number of cached independence tests.
+)doc")
+        .def("clear_cache", &CachedIndependenceTest::clear_cache, R"doc(
+Removes all the cached independence tests.
+)doc")
+        .def("results", &CachedIndependenceTest::results, R"doc(
+Gets the cached independence tests.
+
+:returns: A list of tuples ``(x, y, z, pvalue)``.
+)doc")
+        .def("save", &CachedIndependenceTest::save, py::arg("filename"), R"doc(
+Saves the cached independence tests in a file with the pickle format. If ``filename`` does not end in ``.pickle``, the
+extension is added.
+
+:param filename: File name of the saved results.
+)doc")
+        .def("load", &CachedIndependenceTest::load, py::arg("filename"), R"doc(
+Loads the independence tests saved with :func:`CachedIndependenceTest.save` into the cache.
+
+:param filename: File name of the saved results.
+:raises ValueError: If the results were computed on a different dataset or with a different independence test.
+)doc");
+
+    py::class_<CachedDynamicIndependenceTest, DynamicIndependenceTest, std::shared_ptr<CachedDynamicIndependenceTest>>(
+        root, "CachedDynamicIndependenceTest", R"doc(
+The dynamic adaptation of :class:`CachedIndependenceTest`. The static and transition tests are cached with
+:class:`CachedIndependenceTest`.
+)doc")
+        .def(py::init([](std::shared_ptr<DynamicIndependenceTest> test, const DynamicDataFrame& ddf) {
+                 return std::make_shared<CachedDynamicIndependenceTest>(test, ddf);
+             }),
+             py::arg("test"),
+             py::arg("ddf"),
+             py::keep_alive<1, 2>(),
+             R"doc(
+Initializes a :class:`CachedDynamicIndependenceTest` that memoizes the p-values of ``test``.
+
+:param test: :class:`DynamicIndependenceTest` to cache.
+:param ddf: :class:`DynamicDataFrame` used to create ``test``. It is used to compute the fingerprint of the data.
+)doc")
+        .def("save", &CachedDynamicIndependenceTest::save, py::arg("filename"), R"doc(
+Saves the cached static and transition independence tests in a file with the pickle format. If ``filename`` does not
+end in ``.pickle``, the extension is added.
+
+:param filename: File name of the saved results.
+)doc")
+        .def("load", &CachedDynamicIndependenceTest::load, py::arg("filename"), R"doc(
+Loads the independence tests saved with :func:`CachedDynamicIndependenceTest.save` into the cache.
+
+:param filename: File name of the saved results.
+:raises ValueError: If the results were computed on a different dataset or with a different independence test.
 )doc");
 }
@@ -7,7 +7,8 @@ namespace py = pybind11;
 using learning::operators::Operator, learning::operators::ArcOperator, learning::operators::AddArc,
     learning::operators::RemoveArc, learning::operators::FlipArc, learning::operators::ChangeNodeType,
     learning::operators::OperatorTabuSet, learning::operators::LocalScoreCache, learning::operators::OperatorSet,
-    learning::operators::ArcOperatorSet, learning::operators::ChangeNodeTypeSet, learning::operators::OperatorPool;
+    learning::operators::ArcOperatorSet, learning::operators::ChangeNodeTypeSet, learning::operators::OperatorPool,
+    learning::operators::SparseArcOperatorSet, learning::operators::CandidateParents;
 
 void register_ArcOperators(py::module& m) {
     py::class_<AddArc, ArcOperator, std::shared_ptr<AddArc>>(m, "AddArc", R"doc(
@@ -808,6 +809,41 @@ Updates the delta score values of the operators in the set after applying an ope
 :param model: Bayesian network model.
 :param score: The :class:`Score <pybnesian.Score>` object to cache the scores.
 :param changed_nodes: The nodes whose local score has changed.
+)doc")
+        .def(
+            "legal_operators",
+            [](const OperatorSet& self, const ConditionalBayesianNetworkBase& model, std::optional<int> top_k) {
+                return self.legal_operators(model, top_k.value_or(-1)).to_dataframe();
+            },
+            py::arg("model"),
+            py::arg("top_k") = std::nullopt)
+        .def(
+            "legal_operators",
+            [](const OperatorSet& self, const BayesianNetworkBase& model, std::optional<int> top_k) {
+                return self.legal_operators(model, top_k.value_or(-1)).to_dataframe();
+            },
+            py::arg("model"),
+            py::arg("top_k") = std::nullopt,
+            R"doc(
+Returns all the operators in the set that can be applied to the ``model``, sorted by decreasing delta score. The
+operators are filtered with the same rules as :func:`OperatorSet.find_max` (blacklists, whitelists, max indegree and
+cycles), so this is much faster than checking each element of the delta matrix in Python.
+:func:`OperatorSet.cache_scores` must be called before this method.
+
+The operators are returned as a ``pyarrow.RecordBatch`` with the following columns:
+
+- ``type``: the operator type (``"AddArc"``, ``"RemoveArc"``, ``"FlipArc"`` or ``"ChangeNodeType"``).
+- ``source``: the source node of the arc, or the node of a :class:`ChangeNodeType`.
+- ``target``: the target node of the arc (null for :class:`ChangeNodeType`).
+- ``node_type``: the string representation of the new :class:`FactorType` of a :class:`ChangeNodeType` (null for
+  the arc operators).
+- ``delta``: the delta score of the operator.
+
+It can be converted to a ``pandas.DataFrame`` with ``to_pandas()``.
+
+:param model: Bayesian network model.
+:param top_k: If not None, only the ``top_k`` operators with the largest delta are returned.
+:returns: A ``pyarrow.RecordBatch`` with the legal operators.
 )doc")
         .def("set_arc_blacklist",
              py::overload_cast<const ArcStringVector&>(&OperatorSet::set_arc_blacklist),
@@ -888,6 +924,63 @@ Initializes an :class:`ArcOperatorSet` with optional sets of arc blacklists/whit
     ;
 
 
+    py::class_<SparseArcOperatorSet, OperatorSet, std::shared_ptr<SparseArcOperatorSet>>(root,
+                                                                                       "SparseArcOperatorSet",
+                                                                                       R"doc(
+This set of operators contains the arc operators (:class:`AddArc`, :class:`RemoveArc`, :class:`FlipArc`) restricted to
+a list of candidate parents for each node, as in the Sparse Candidate algorithm. An arc ``source -> target`` can only be
+added (or created with a flip) if ``source`` is a candidate parent of ``target``, while every arc of the model can be
+removed. The delta scores are stored sparsely, so the memory and the number of score evaluations of
+:func:`OperatorSet.cache_scores` grow with the number of candidates instead of quadratically with the number of nodes.
+
+The candidates can be given by the user, or selected with :func:`association_candidates` or :func:`mmpc_candidates`.
+Only the non-conditional Bayesian networks are supported.
+)doc")
+        .def(py::init<CandidateParents, ArcStringVector, ArcStringVector, int, int, int>(),
+             py::arg("candidates"),
+             py::arg("blacklist") = ArcStringVector(),
+             py::arg("whitelist") = ArcStringVector(),
+             py::arg("max_indegree") = 0,
+             py::arg("max_candidates") = 0,
+             py::arg("reselect_every") = 0,
+             R"doc(
+Initializes a :class:`SparseArcOperatorSet` with the candidate parents of each node, optional sets of arc
+blacklists/whitelists and maximum indegree.
+
+:param candidates: A dict with the list of candidate parents of each node. The nodes that are not in the dict do not
+                   have candidate parents.
+:param blacklist: List of blacklisted arcs.
+:param whitelist: List of whitelisted arcs.
+:param max_indegree: Max indegree allowed.
+:param max_candidates: Number of candidates of each node kept by :func:`SparseArcOperatorSet.reselect_candidates`.
+                       If 0, each node keeps the size of its initial candidate list.
+:param reselect_every: If greater than 0, the candidates are re-selected every ``reselect_every`` calls to
+                       :func:`OperatorSet.update_scores` (i.e., every ``reselect_every`` hill-climbing iterations).
+)doc")
+        .def("candidates", &SparseArcOperatorSet::candidates, R"doc(
+Gets the current candidate parents of each node.
+
+:returns: A dict with the list of candidate parents of each node.
+)doc")
+        .def("reselect_candidates",
+             &SparseArcOperatorSet::reselect_candidates,
+             py::arg("model"),
+             py::arg("score"),
+             R"doc(
+Re-selects the candidate parents of each node (the Restrict step of the Sparse Candidate algorithm) and updates the
+delta scores. The current parents of a node are always kept, and the rest of its candidates are the nodes with the
+largest score gain when added to the current parents. These nodes are chosen among the current candidates, the
+candidates of the candidates, the nodes that have the node as candidate and the children of the node.
+
+:param model: The current model.
+:param score: The :class:`Score <pybnesian.Score>` used in :func:`OperatorSet.cache_scores`.
+)doc")
+        .def("num_operators", &SparseArcOperatorSet::num_operators, R"doc(
+Gets the number of operators with a cached delta score.
+
+:returns: Number of operators with a cached delta score.
+)doc");
+
     py::class_<ChangeNodeTypeSet, OperatorSet, std::shared_ptr<ChangeNodeTypeSet>>(root, "ChangeNodeTypeSet", R"doc(
 This set of operators contains all the possible operators of type :class:`ChangeNodeType`.
 )doc")
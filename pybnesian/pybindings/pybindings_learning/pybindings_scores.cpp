@@ -146,6 +146,9 @@ score(self: pybnesian.Score, model: BayesianNetworkBase or ConditionalBayesianNe
 
 Returns the score value of the ``model``.
 
+The local score of each node is cached in the ``model``, so after a local change of the structure only the modified
+nodes are scored again. The local scores of the scores implemented in Python are not cached.
+
 :param model: Bayesian network model.
 :returns: Score value of ``model``.
 )doc");
@@ -284,6 +287,8 @@ public:
     using ScoreBase::local_score;
     using ScoreBase::ScoreBase;
 
+    bool is_python_derived() const override { return true; }
+
     double score(const BayesianNetworkBase& model) const override {
         {
             py::gil_scoped_acquire gil;
@@ -520,6 +525,13 @@ This class implements the Bayesian Information Criterion (BIC).
 Initializes a :class:`BIC` with the given DataFrame ``df``.
 
 :param df: DataFrame to compute the BIC score.
+)doc")
+        .def(py::init<const ChunkedDataFrame&>(), py::arg("df"), R"doc(
+Initializes a :class:`BIC` with the given :class:`ChunkedDataFrame` ``df``. The chunks are not concatenated: the
+local scores are computed from the sufficient statistics of each chunk. :func:`Score.data` only contains the schema
+of the data if ``df`` has more than one chunk.
+
+:param df: :class:`ChunkedDataFrame` to compute the BIC score.
 )doc");
 
     py::class_<BGe, Score, std::shared_ptr<BGe>>(root, "BGe", R"doc(
@@ -537,6 +549,21 @@ Initializes a :class:`BGe` with the given DataFrame ``df``.
 :param iss_mu: Imaginary sample size for the normal component of the normal-Wishart prior.
 :param iss_w: Imaginary sample size for the Wishart component of the normal-Wishart prior.
 :param nu: Mean vector of the normal-Wishart prior.
+)doc")
+        .def(py::init<const ChunkedDataFrame&, double, std::optional<double>, std::optional<VectorXd>>(),
+             py::arg("df"),
+             py::arg("iss_mu") = 1,
+             py::arg("iss_w") = std::nullopt,
+             py::arg("nu") = std::nullopt,
+             R"doc(
+Initializes a :class:`BGe` with the given :class:`ChunkedDataFrame` ``df``. The chunks are not concatenated: the
+moments of the data are merged over the chunks. :func:`Score.data` only contains the schema of the data if ``df`` has
+more than one chunk.
+
+:param df: :class:`ChunkedDataFrame` to compute the BGe score.
+:param iss_mu: Imaginary sample size for the normal component of the normal-Wishart prior.
+:param iss_w: Imaginary sample size for the Wishart component of the normal-Wishart prior.
+:param nu: Mean vector of the normal-Wishart prior.
 )doc");
 
     py::class_<BDe, Score, std::shared_ptr<BDe>>(root, "BDe", R"doc(
@@ -550,6 +577,17 @@ Initializes a :class:`BDe` with the given DataFrame ``df``.
 
 :param df: DataFrame to compute the BDe score.
 :param iss: Imaginary sample size of the Dirichlet prior.
+)doc")
+        .def(py::init<const ChunkedDataFrame&, double>(),
+             py::arg("df"),
+             py::arg("iss") = 1,
+             R"doc(
+Initializes a :class:`BDe` with the given :class:`ChunkedDataFrame` ``df``. The chunks are not concatenated: the
+counts are summed over the chunks. :func:`Score.data` only contains the schema of the data if ``df`` has more than
+one chunk.
+
+:param df: :class:`ChunkedDataFrame` to compute the BDe score.
+:param iss: Imaginary sample size of the Dirichlet prior.
 )doc");
 
     py::class_<CVLikelihood, Score, std::shared_ptr<CVLikelihood>>(root, "CVLikelihood", R"doc(
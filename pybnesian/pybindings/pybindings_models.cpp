@@ -26,7 +26,7 @@ using models::ConditionalBayesianNetworkBase, models::ConditionalBayesianNetwork
 
 using models::DynamicBayesianNetworkBase, models::DynamicBayesianNetwork, models::DynamicGaussianNetwork,
     models::DynamicSemiparametricBN, models::DynamicKDENetwork, models::DynamicDiscreteBN, models::DynamicHomogeneousBN,
-    models::DynamicHeterogeneousBN, models::DynamicCLGNetwork;
+    models::DynamicHeterogeneousBN, models::DynamicCLGNetwork, models::StreamingLogLikelihood;
 
 using util::random_seed_arg;
 
@@ -1303,7 +1303,16 @@ Include the given blacklisted arcs. It checks the validity of the graph after re
 
 :param arc_blacklist: List of arcs tuples (``source``, ``target``) that must be removed from the graph.
 )doc")
-        .def("cpd", py::overload_cast<const std::string&>(&CppClass::cpd), py::arg("node"), R"doc(
+        .def(
+            "cpd",
+            [](CppClass& self, const std::string& node) {
+                auto cpd = self.cpd(node);
+                // The returned CPD can be modified in place, so its cached contribution to slogl() is dropped.
+                self.invalidate_cpd(node);
+                return cpd;
+            },
+            py::arg("node"),
+            R"doc(
 Returns the conditional probability distribution (CPD) associated to ``node``. This is a
 :class:`Factor <pybnesian.Factor>` type.
 
@@ -1324,7 +1333,8 @@ partial (just some a subset of the nodes).
 :param cpds: List of :class:`Factor <pybnesian.Factor>`.
 )doc")
         .def("fit", &CppClass::fit, py::arg("df"), py::arg("construction_args") = Arguments(), R"doc(
-Fit all the unfitted :class:`Factor <pybnesian.Factor>` with the data ``df``.
+Fit all the unfitted :class:`Factor <pybnesian.Factor>` with the data ``df``. The factors are fitted in parallel, starting
+with the most expensive ones. The factors implemented in Python are fitted sequentially.
 
 :param df: DataFrame to fit the Bayesian network.
 :param construction_args: Additional arguments provided to construct the :class:`Factor <pybnesian.Factor>`.
@@ -1343,7 +1353,13 @@ the factors in the Bayesian network.
 )doc")
         .def("slogl", &CppClass::slogl, py::arg("df"), R"doc(
 Returns the sum of the log-likelihood of each instance in the DataFrame ``df``. That is, the sum of the result of
-:func:`BayesianNetworkBase.logl`.
+:func:`BayesianNetworkBase.logl`. If ``df`` has frequency weights (see :func:`with_weights`), the log-likelihood of each
+instance is multiplied by its weight. :func:`BayesianNetworkBase.logl` returns the unweighted log-likelihood of each
+instance.
+
+The contribution of each node is cached with a hash of its columns in ``df``. After a local change of the structure, or
+of the CPDs, only the modified nodes are evaluated again. Getting a CPD with :func:`BayesianNetworkBase.cpd` drops its
+cached contribution, because the CPD can be modified in place.
 
 :param df: DataFrame to compute the sum of the log-likelihood.
 :returns: The sum of log-likelihood for DataFrame ``df``.
@@ -2663,6 +2679,24 @@ The static and transition networks must have the same :class:`BayesianNetworkTyp
 :param markovian_order: Markovian order of the dynamic Bayesian network.
 :param static_bn: Static Bayesian network.
 :param transition_bn: Transition Bayesian network.
+)doc")
+        .def(
+            "sample_trajectories",
+            [](const DynamicBayesianNetwork& self, int num_trajectories, int n, std::optional<unsigned int> seed) {
+                return self.sample_trajectories(num_trajectories, n, random_seed_arg(seed));
+            },
+            py::arg("num_trajectories"),
+            py::arg("n"),
+            py::arg("seed") = std::nullopt,
+            R"doc(
+Samples ``num_trajectories`` independent trajectories of ``n`` instances each. The trajectories are sampled in
+parallel, and each trajectory uses its own random stream derived from ``seed``, so the result does not depend on the
+number of threads.
+
+:param num_trajectories: Number of trajectories to sample.
+:param n: Number of instances of each trajectory.
+:param seed: A random seed number. If not specified or ``None``, a random seed is generated.
+:returns: A list of :class:`pyarrow.RecordBatch`, one for each trajectory.
 )doc")
         .def_property("include_cpd", &DynamicBayesianNetwork::include_cpd, &DynamicBayesianNetwork::set_include_cpd)
         .def("__getstate__", [](const DynamicBayesianNetwork& self) { return self.__getstate__(); })
@@ -3622,4 +3656,44 @@ The type of ``static_bn`` and ``transition_bn`` must be :class:`HeterogeneousBNT
     register_DerivedDynamicBayesianNetwork<DynamicCLGNetwork>(root, "DynamicCLGNetwork", R"doc(
 This class implements a :class:`DynamicBayesianNetwork` with the type :class:`CLGNetworkType`.
 )doc");
+
+    py::class_<StreamingLogLikelihood, std::shared_ptr<StreamingLogLikelihood>>(root, "StreamingLogLikelihood", R"doc(
+Computes the log-likelihood of a time series that is received in consecutive windows (e.g., for online monitoring).
+Only the last ``markovian_order`` rows are kept between windows, so the log-likelihood of each row is the same as if
+the whole time series was passed to :func:`DynamicBayesianNetworkBase.logl`.
+)doc")
+        .def(py::init<std::shared_ptr<DynamicBayesianNetworkBase>>(), py::arg("model"), py::keep_alive<1, 2>(), R"doc(
+Initializes a :class:`StreamingLogLikelihood` for a fitted dynamic Bayesian network.
+
+:param model: A fitted :class:`DynamicBayesianNetworkBase`.
+)doc")
+        .def("update", &StreamingLogLikelihood::update, py::arg("df"), R"doc(
+Consumes the next window of the time series.
+
+:param df: DataFrame with the next rows of the time series. The first window must contain at least
+           ``markovian_order`` rows.
+:returns: A :class:`numpy.ndarray` vector with dtype :class:`numpy.float64`, where the i-th value is the
+          log-likelihood of the i-th instance of ``df``.
+)doc")
+        .def("num_rows", &StreamingLogLikelihood::num_rows, R"doc(
+Gets the number of rows consumed.
+
+:returns: Number of rows consumed.
+)doc")
+        .def("total", &StreamingLogLikelihood::total, R"doc(
+Gets the sum of the log-likelihood of all the consumed rows.
+
+:returns: Sum of the log-likelihood.
+)doc")
+        .def("variable_logl", &StreamingLogLikelihood::variable_logl, R"doc(
+Gets the accumulated log-likelihood of the CPDs of each variable, in the order of
+:func:`DynamicBayesianNetworkBase.variables`.
+
+:returns: A :class:`numpy.ndarray` vector with dtype :class:`numpy.float64`.
+)doc")
+        .def("reset", &StreamingLogLikelihood::reset, R"doc(
+Removes the consumed rows, so the next window is treated as the start of a new time series.
+)doc")
+        .def("__str__", &StreamingLogLikelihood::ToString)
+        .def("__repr__", &StreamingLogLikelihood::ToString);
 }
@@ -0,0 +1,232 @@
+#include <fstream>
+#include <arrow/io/file.h>
+#include <util/binary_serialization.hpp>
+
+namespace util {
+
+const char binary_magic[8] = {'P', 'Y', 'B', 'N', 'B', 'I', 'N', '\0'};
+// Name of the capsules that keep alive the buffers referenced by numpy arrays.
+const char* const buffer_capsule_name = "pybnesian.buffer";
+
+constexpr int64_t binary_header_size = 32;
+constexpr int64_t binary_table_entry_size = 16;
+
+int64_t align_section(int64_t offset) {
+    return (offset + binary_section_alignment - 1) / binary_section_alignment * binary_section_alignment;
+}
+
+void delete_buffer_capsule(PyObject* capsule) {
+    delete static_cast<std::shared_ptr<arrow::Buffer>*>(PyCapsule_GetPointer(capsule, buffer_capsule_name));
+}
+
+py::array make_array(const std::shared_ptr<arrow::Buffer>& buffer,
+                     const py::dtype& dtype,
+                     const std::vector<Py_ssize_t>& shape,
+                     bool c_order) {
+    std::vector<Py_ssize_t> strides(shape.size());
+    Py_ssize_t stride = dtype.itemsize();
+    if (c_order) {
+        for (int i = static_cast<int>(shape.size()) - 1; i >= 0; --i) {
+            strides[i] = stride;
+            stride *= shape[i];
+        }
+    } else {
+        for (size_t i = 0; i < shape.size(); ++i) {
+            strides[i] = stride;
+            stride *= shape[i];
+        }
+    }
+
+    if (stride > buffer->size()) throw std::runtime_error("The buffer is smaller than the array.");
+
+    py::capsule base(new std::shared_ptr<arrow::Buffer>(buffer), buffer_capsule_name, &delete_buffer_capsule);
+    py::array a(dtype, shape, strides, buffer->data(), base);
+    // The buffers can be memory-mapped in read-only mode.
+    a.attr("setflags")(py::arg("write") = false);
+    return a;
+}
+
+py::array buffer_to_array(const std::shared_ptr<arrow::Buffer>& buffer, const py::dtype& dtype, int64_t length) {
+    return make_array(buffer, dtype, {static_cast<Py_ssize_t>(length)}, true);
+}
+
+std::shared_ptr<arrow::Buffer> array_to_buffer(const py::array& a, const py::dtype& dtype) {
+    if (a.ndim() != 1) throw std::invalid_argument("A 1-dimensional array was expected.");
+
+    if (a.dtype().equal(dtype) && (a.shape(0) <= 1 || a.strides(0) == dtype.itemsize())) {
+        py::object base = a.attr("base");
+        while (py::isinstance<py::array>(base)) {
+            base = base.attr("base");
+        }
+
+        if (PyCapsule_CheckExact(base.ptr())) {
+            auto name = PyCapsule_GetName(base.ptr());
+
+            if (name && std::strcmp(name, buffer_capsule_name) == 0) {
+                const auto& buffer =
+                    *static_cast<std::shared_ptr<arrow::Buffer>*>(PyCapsule_GetPointer(base.ptr(), buffer_capsule_name));
+                auto offset = static_cast<const uint8_t*>(a.data()) - buffer->data();
+
+                if (offset >= 0 && offset + a.nbytes() <= buffer->size()) {
+                    return arrow::SliceBuffer(buffer, offset, a.nbytes());
+                }
+            }
+        }
+    }
+
+    py::array contiguous = py::module_::import("numpy").attr("ascontiguousarray")(a, dtype);
+    return copy_to_buffer(static_cast<const uint8_t*>(contiguous.data()), contiguous.nbytes());
+}
+
+template <typename T>
+void write_value(std::ofstream& out, T value) {
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template <typename T>
+T read_value(const uint8_t* data) {
+    T value;
+    std::memcpy(&value, data, sizeof(T));
+    return value;
+}
+
+void write_padding(std::ofstream& out, int64_t position) {
+    static const char zeros[binary_section_alignment] = {};
+    auto current = static_cast<int64_t>(out.tellp());
+    out.write(zeros, position - current);
+}
+
+void save_binary(py::handle obj, std::string name) {
+    if (name.size() < 4 || name.substr(name.size() - 4) != ".pbn") name += ".pbn";
+
+    // The numeric arrays are replaced by a persistent id (index, dtype, shape, order), and their content is stored in
+    // a section.
+    std::vector<py::array> sections;
+    auto stream = py::module_::import("io").attr("BytesIO")();
+    auto pickler = py::module_::import("pickle").attr("Pickler")(stream, 4);
+
+    pickler.attr("persistent_id") = py::cpp_function([&sections](py::handle o) -> py::object {
+        if (!py::isinstance<py::array>(o)) return py::none();
+
+        auto a = py::reinterpret_borrow<py::array>(o);
+        if (a.dtype().attr("hasobject").cast<bool>()) return py::none();
+
+        auto flags = a.attr("flags");
+        bool c_order = flags.attr("c_contiguous").cast<bool>();
+        bool f_order = flags.attr("f_contiguous").cast<bool>();
+        if (!c_order && !f_order) return py::none();
+
+        sections.push_back(a);
+        return py::make_tuple(sections.size() - 1, a.dtype().attr("str"), a.attr("shape"), c_order ? "C" : "F");
+    });
+
+    pickler.attr("dump")(obj);
+    auto metadata = stream.attr("getvalue")().cast<std::string>();
+
+    std::vector<int64_t> offsets;
+    offsets.reserve(sections.size());
+    int64_t offset = align_section(binary_header_size + binary_table_entry_size * sections.size());
+    for (const auto& s : sections) {
+        offsets.push_back(offset);
+        offset = align_section(offset + s.nbytes());
+    }
+
+    std::ofstream out(name, std::ios::binary | std::ios::trunc);
+    if (!out) throw std::invalid_argument("Could not open file " + name + ".");
+
+    out.write(binary_magic, sizeof(binary_magic));
+    write_value<uint32_t>(out, binary_format_version);
+    write_value<uint32_t>(out, sections.size());
+    write_value<uint64_t>(out, offset);
+    write_value<uint64_t>(out, metadata.size());
+
+    for (size_t i = 0; i < sections.size(); ++i) {
+        write_value<uint64_t>(out, offsets[i]);
+        write_value<uint64_t>(out, sections[i].nbytes());
+    }
+
+    for (size_t i = 0; i < sections.size(); ++i) {
+        write_padding(out, offsets[i]);
+        out.write(static_cast<const char*>(sections[i].data()), sections[i].nbytes());
+    }
+
+    write_padding(out, offset);
+    out.write(metadata.data(), metadata.size());
+
+    if (!out) throw std::runtime_error("Error writing file " + name + ".");
+}
+
+std::shared_ptr<arrow::Buffer> map_file(const std::string& name) {
+    std::shared_ptr<arrow::io::MemoryMappedFile> file;
+    {
+        RAISE_RESULT_ERROR(file, arrow::io::MemoryMappedFile::Open(name, arrow::io::FileMode::READ))
+    }
+
+    int64_t size;
+    {
+        RAISE_RESULT_ERROR(size, file->GetSize())
+    }
+
+    // The returned buffer keeps the memory map alive after the file is closed.
+    std::shared_ptr<arrow::Buffer> data;
+    {
+        RAISE_RESULT_ERROR(data, file->ReadAt(0, size))
+    }
+
+    return data;
+}
+
+py::object load_binary(const std::string& name) {
+    auto data = map_file(name);
+    auto raw = data->data();
+
+    if (data->size() < binary_header_size || std::memcmp(raw, binary_magic, sizeof(binary_magic)) != 0) {
+        throw std::invalid_argument("File " + name + " is not a PyBNesian binary file.");
+    }
+
+    auto version = read_value<uint32_t>(raw + 8);
+    if (version != binary_format_version) {
+        throw std::invalid_argument("File " + name + " has binary format version " + std::to_string(version) +
+                                    ", but only version " + std::to_string(binary_format_version) +
+                                    " is supported.");
+    }
+
+    auto num_sections = static_cast<int64_t>(read_value<uint32_t>(raw + 12));
+    auto metadata_offset = static_cast<int64_t>(read_value<uint64_t>(raw + 16));
+    auto metadata_length = static_cast<int64_t>(read_value<uint64_t>(raw + 24));
+
+    if (binary_header_size + binary_table_entry_size * num_sections > data->size() ||
+        metadata_offset + metadata_length > data->size()) {
+        throw std::invalid_argument("File " + name + " is truncated.");
+    }
+
+    std::vector<std::shared_ptr<arrow::Buffer>> sections;
+    sections.reserve(num_sections);
+    for (int64_t i = 0; i < num_sections; ++i) {
+        auto entry = raw + binary_header_size + binary_table_entry_size * i;
+        auto offset = static_cast<int64_t>(read_value<uint64_t>(entry));
+        auto length = static_cast<int64_t>(read_value<uint64_t>(entry + 8));
+
+        if (offset + length > data->size()) throw std::invalid_argument("File " + name + " is truncated.");
+
+        sections.push_back(arrow::SliceBuffer(data, offset, length));
+    }
+
+    auto metadata = py::bytes(reinterpret_cast<const char*>(raw + metadata_offset), metadata_length);
+    auto unpickler = py::module_::import("pickle").attr("Unpickler")(py::module_::import("io").attr("BytesIO")(metadata));
+
+    unpickler.attr("persistent_load") = py::cpp_function([&sections](py::tuple pid) -> py::object {
+        auto index = pid[0].cast<size_t>();
+        if (index >= sections.size()) throw std::runtime_error("Not valid section in PyBNesian binary file.");
+
+        auto dtype = py::dtype::from_args(pid[1]);
+        auto shape = pid[2].cast<std::vector<Py_ssize_t>>();
+        auto c_order = pid[3].cast<std::string>() == "C";
+
+        return make_array(sections[index], dtype, shape, c_order);
+    });
+
+    return unpickler.attr("load")();
+}
+
+}  // namespace util
@@ -0,0 +1,59 @@
+#ifndef PYBNESIAN_UTIL_BINARY_SERIALIZATION_HPP
+#define PYBNESIAN_UTIL_BINARY_SERIALIZATION_HPP
+
+#include <cstring>
+#include <arrow/api.h>
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+#include <util/arrow_macros.hpp>
+
+namespace py = pybind11;
+
+namespace util {
+
+// Binary container format of PyBNesian. The numeric arrays of the pickled state of an object (training data,
+// bandwidths, parameters, etc.) are stored as raw sections, and the rest of the state is pickled:
+//
+//     magic "PYBNBIN\0" (8 bytes) | version (uint32) | number of sections (uint32)
+//     metadata offset (uint64) | metadata length (uint64)
+//     section table: offset (uint64) and length (uint64) of each section
+//     sections, each one aligned to binary_section_alignment bytes
+//     metadata: pickle of the object, where each section is referenced by a persistent id.
+//
+// All the values are stored in the native byte order (little-endian in all the supported platforms). When a file is
+// loaded, it is memory-mapped and the arrays of the objects reference the sections, so the data is not copied and the
+// pages of the file are shared by all the processes that load it.
+constexpr uint32_t binary_format_version = 1;
+constexpr int64_t binary_section_alignment = 64;
+
+void save_binary(py::handle obj, std::string name);
+py::object load_binary(const std::string& name);
+
+// Returns a read-only 1-d numpy array that references (does not copy) the first length values of buffer.
+py::array buffer_to_array(const std::shared_ptr<arrow::Buffer>& buffer, const py::dtype& dtype, int64_t length);
+
+template <typename CType>
+py::array buffer_to_array(const std::shared_ptr<arrow::Buffer>& buffer, int64_t length) {
+    return buffer_to_array(buffer, py::dtype::of<CType>(), length);
+}
+
+// Returns a buffer with the values of the 1-d array a. If a references a buffer (it was created with buffer_to_array()
+// or it was loaded with load_binary()), the values are not copied.
+std::shared_ptr<arrow::Buffer> array_to_buffer(const py::array& a, const py::dtype& dtype);
+
+template <typename CType>
+std::shared_ptr<arrow::Buffer> array_to_buffer(const py::array& a) {
+    return array_to_buffer(a, py::dtype::of<CType>());
+}
+
+// Returns a new buffer with a copy of the first length values of data.
+template <typename CType>
+std::shared_ptr<arrow::Buffer> copy_to_buffer(const CType* data, int64_t length) {
+    RAISE_RESULT_ERROR(std::shared_ptr<arrow::Buffer> buffer, arrow::AllocateBuffer(length * sizeof(CType)))
+    if (length > 0) std::memcpy(buffer->mutable_data(), data, length * sizeof(CType));
+    return buffer;
+}
+
+}  // namespace util
+
+#endif  // PYBNESIAN_UTIL_BINARY_SERIALIZATION_HPP
@@ -1,5 +1,11 @@
+#include <algorithm>
+#include <cstring>
 #include <arrow/util/bitmap_ops.h>
 #include <arrow/api.h>
+#include <util/bit_util.hpp>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
 
 namespace util::bit_util {
 
@@ -77,6 +83,47 @@ uint64_t non_null_count(Buffer_ptr bitmap, uint64_t length) {
     return arrow::internal::CountSetBits(bitmap->data(), 0, length);
 }
 
+inline int popcount64(uint64_t word) {
+#ifdef _MSC_VER
+    return static_cast<int>(__popcnt64(word));
+#else
+    return __builtin_popcountll(word);
+#endif
+}
+
+int64_t bitmap_and_count(const std::vector<const uint8_t*>& bitmaps, int64_t length, uint8_t* out) {
+    auto num_bytes = (length + 7) / 8;
+    auto words = bitmap_words<64>(length);
+    int64_t count = 0;
+
+    // The words are loaded with memcpy, so the bitmaps do not need to be aligned.
+    for (uint64_t w = 0; w < words.words; ++w) {
+        uint64_t word;
+        std::memcpy(&word, bitmaps[0] + 8 * w, 8);
+        for (size_t b = 1, num_bitmaps = bitmaps.size(); b < num_bitmaps; ++b) {
+            uint64_t other;
+            std::memcpy(&other, bitmaps[b] + 8 * w, 8);
+            word &= other;
+        }
+
+        std::memcpy(out + 8 * w, &word, 8);
+        count += popcount64(word);
+    }
+
+    for (auto byte = static_cast<int64_t>(8 * words.words); byte < num_bytes; ++byte) {
+        uint8_t value = bitmaps[0][byte];
+        for (size_t b = 1, num_bitmaps = bitmaps.size(); b < num_bitmaps; ++b) {
+            value &= bitmaps[b][byte];
+        }
+
+        out[byte] = value;
+        auto valid_bits = std::min<int64_t>(8, length - 8 * byte);
+        count += popcount64(value & ((1u << valid_bits) - 1));
+    }
+
+    return count;
+}
+
 // Extracted from arrow/util/bit_util.h
 int next_power2(int value) {
     value--;
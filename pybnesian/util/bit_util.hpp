@@ -31,6 +31,10 @@ Buffer_ptr combined_bitmap(std::vector<Array_ptr> columns);
 Buffer_ptr combined_bitmap(Buffer_ptr bitmap1, Buffer_ptr bitmap2, uint64_t length);
 Buffer_ptr combined_bitmap_with_null(std::vector<Array_ptr> columns);
 
+// Writes the AND of the bitmaps (all starting at bit 0) in out, and returns the number of set bits in the first length
+// bits of the result. The bitmaps are combined and counted in a single pass over 64-bit words.
+int64_t bitmap_and_count(const std::vector<const uint8_t*>& bitmaps, int64_t length, uint8_t* out);
+
 // Extracted from arrow/util/bit_util.h
 int next_power2(int value);
 int previous_power2(int value);
@@ -0,0 +1,24 @@
+#include <atomic>
+#include <stdexcept>
+#include <util/parallel.hpp>
+
+namespace util {
+
+namespace {
+
+// The OpenMP setting (omp_set_num_threads) only applies to the thread that changes it, so the number of threads is
+// stored globally and every parallel region requests it explicitly.
+std::atomic<int> global_num_threads(omp_get_max_threads());
+
+}  // namespace
+
+int num_threads() { return global_num_threads.load(std::memory_order_relaxed); }
+
+void set_num_threads(int n) {
+    if (n < 1) throw std::invalid_argument("The number of threads must be a positive number.");
+    global_num_threads.store(n, std::memory_order_relaxed);
+    // The libraries that use the OpenMP setting (e.g. Eigen) follow the calling thread.
+    omp_set_num_threads(n);
+}
+
+}  // namespace util
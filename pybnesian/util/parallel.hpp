@@ -0,0 +1,61 @@
+#ifndef PYBNESIAN_UTIL_PARALLEL_HPP
+#define PYBNESIAN_UTIL_PARALLEL_HPP
+
+#include <algorithm>
+#include <cstdint>
+#include <omp.h>
+
+namespace util {
+
+// Number of threads used by the parallel regions. It is shared by all the threads (including the threads not created by
+// OpenMP), so every parallel region must request it with a num_threads(util::num_threads()) clause. The OpenMP runtime
+// keeps the threads alive between regions, so the same team is reused by every parallel algorithm.
+int num_threads();
+void set_num_threads(int n);
+
+// Minimum amount of work (approximately, the number of floating point operations) needed to run a loop in parallel.
+// Smaller loops are run inline, because starting a parallel region costs more than the loop itself.
+constexpr int64_t parallel_grain_size = 32768;
+
+// Number of tasks created per thread, so the work can be stolen by the threads that finish first.
+constexpr int tasks_per_thread = 4;
+
+// Calls func(i) for i in [0, n). iteration_cost is the approximate work of each iteration:
+//  - If the total work is smaller than parallel_grain_size, or only one thread is available, the loop is run inline.
+//  - If the caller is already inside a parallel region (e.g. the CPDs of a model evaluated in parallel), the iterations
+//    are split in tasks that are executed by the threads of the enclosing team, instead of opening a nested region.
+//  - Otherwise, a new parallel region is started.
+// func must not throw.
+template <typename Func>
+void parallel_for(int64_t n, int64_t iteration_cost, Func func) {
+    if (n <= 0) return;
+
+    if (n == 1 || n * std::max<int64_t>(iteration_cost, 1) < parallel_grain_size) {
+        for (int64_t i = 0; i < n; ++i) func(i);
+        return;
+    }
+
+    if (omp_in_parallel()) {
+        int64_t num_tasks = std::min<int64_t>(n, static_cast<int64_t>(omp_get_num_threads()) * tasks_per_thread);
+
+        if (num_tasks <= 1) {
+            for (int64_t i = 0; i < n; ++i) func(i);
+        } else {
+#pragma omp taskloop num_tasks(num_tasks)
+            for (int64_t i = 0; i < n; ++i) func(i);
+        }
+    } else {
+        int threads = static_cast<int>(std::min<int64_t>(n, num_threads()));
+
+        if (threads <= 1) {
+            for (int64_t i = 0; i < n; ++i) func(i);
+        } else {
+#pragma omp parallel for schedule(static) num_threads(threads)
+            for (int64_t i = 0; i < n; ++i) func(i);
+        }
+    }
+}
+
+}  // namespace util
+
+#endif  // PYBNESIAN_UTIL_PARALLEL_HPP
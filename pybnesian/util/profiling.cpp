@@ -0,0 +1,206 @@
+#include <algorithm>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <util/profiling.hpp>
+
+namespace util::profiling {
+
+namespace detail {
+std::atomic<bool> enabled{false};
+}
+
+namespace {
+
+// Maximum number of trace events kept in memory. A long run would otherwise grow the trace without bound.
+constexpr int64_t max_trace_events = 1 << 22;
+
+struct TraceEvent {
+    std::string name;
+    int64_t start_us;
+    int64_t duration_us;
+};
+
+struct ThreadStorage {
+    std::mutex mutex;
+    int tid;
+    std::unordered_map<std::string, TimerStats> timers;
+    std::unordered_map<std::string, int64_t> counters;
+    std::vector<TraceEvent> events;
+};
+
+std::atomic<bool> trace_enabled{false};
+std::atomic<int64_t> num_trace_events{0};
+std::atomic<int64_t> dropped_trace_events{0};
+// Origin of the timestamps of the trace, in nanoseconds of the steady clock.
+std::atomic<int64_t> trace_origin{0};
+
+// The storage of the threads is kept alive after the threads finish, so their measurements are not lost.
+std::mutex registry_mutex;
+std::vector<std::shared_ptr<ThreadStorage>> registry;
+
+ThreadStorage& thread_storage() {
+    thread_local std::shared_ptr<ThreadStorage> storage = []() {
+        auto s = std::make_shared<ThreadStorage>();
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        s->tid = static_cast<int>(registry.size());
+        registry.push_back(s);
+        return s;
+    }();
+
+    return *storage;
+}
+
+int64_t nanoseconds(std::chrono::steady_clock::time_point t) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+}
+
+std::string escape_json(const std::string& s) {
+    std::string res;
+    res.reserve(s.size());
+
+    for (auto c : s) {
+        switch (c) {
+            case '"':
+                res += "\\\"";
+                break;
+            case '\\':
+                res += "\\\\";
+                break;
+            case '\n':
+                res += "\\n";
+                break;
+            case '\t':
+                res += "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    res += ' ';
+                } else {
+                    res += c;
+                }
+        }
+    }
+
+    return res;
+}
+
+}  // namespace
+
+void enable(bool trace) {
+    if (!detail::enabled.load()) trace_origin = nanoseconds(std::chrono::steady_clock::now());
+
+    trace_enabled = trace;
+    detail::enabled = true;
+}
+
+void disable() {
+    detail::enabled = false;
+    trace_enabled = false;
+}
+
+void reset() {
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    for (auto& storage : registry) {
+        std::lock_guard<std::mutex> storage_lock(storage->mutex);
+        storage->timers.clear();
+        storage->counters.clear();
+        storage->events.clear();
+    }
+
+    num_trace_events = 0;
+    dropped_trace_events = 0;
+    trace_origin = nanoseconds(std::chrono::steady_clock::now());
+}
+
+void add_count(const std::string& name, int64_t n) {
+    auto& storage = thread_storage();
+    std::lock_guard<std::mutex> lock(storage.mutex);
+    storage.counters[name] += n;
+}
+
+void add_time(const std::string& name,
+              std::chrono::steady_clock::time_point start,
+              std::chrono::steady_clock::time_point end) {
+    auto seconds = std::chrono::duration<double>(end - start).count();
+
+    auto& storage = thread_storage();
+    std::lock_guard<std::mutex> lock(storage.mutex);
+
+    auto it = storage.timers.find(name);
+    if (it == storage.timers.end()) {
+        storage.timers.insert({name, TimerStats{1, seconds, seconds, seconds}});
+    } else {
+        auto& t = it->second;
+        ++t.count;
+        t.total_seconds += seconds;
+        t.min_seconds = std::min(t.min_seconds, seconds);
+        t.max_seconds = std::max(t.max_seconds, seconds);
+    }
+
+    if (trace_enabled.load(std::memory_order_relaxed)) {
+        if (num_trace_events.fetch_add(1, std::memory_order_relaxed) < max_trace_events) {
+            auto start_ns = nanoseconds(start) - trace_origin.load(std::memory_order_relaxed);
+            auto duration_ns = nanoseconds(end) - nanoseconds(start);
+            storage.events.push_back(TraceEvent{name, start_ns / 1000, duration_ns / 1000});
+        } else {
+            dropped_trace_events.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+}
+
+ProfilingStats stats() {
+    ProfilingStats res{{}, {}, dropped_trace_events.load()};
+
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    for (auto& storage : registry) {
+        std::lock_guard<std::mutex> storage_lock(storage->mutex);
+
+        for (const auto& [name, t] : storage->timers) {
+            auto it = res.timers.find(name);
+            if (it == res.timers.end()) {
+                res.timers.insert({name, t});
+            } else {
+                auto& acc = it->second;
+                acc.count += t.count;
+                acc.total_seconds += t.total_seconds;
+                acc.min_seconds = std::min(acc.min_seconds, t.min_seconds);
+                acc.max_seconds = std::max(acc.max_seconds, t.max_seconds);
+            }
+        }
+
+        for (const auto& [name, c] : storage->counters) {
+            res.counters[name] += c;
+        }
+    }
+
+    return res;
+}
+
+void save_trace(const std::string& filename) {
+    std::ofstream file(filename);
+    if (!file) throw std::invalid_argument("Could not open file " + filename + " to save the profiling trace.");
+
+    file << "{\"traceEvents\":[";
+
+    bool first = true;
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    for (auto& storage : registry) {
+        std::lock_guard<std::mutex> storage_lock(storage->mutex);
+
+        for (const auto& e : storage->events) {
+            if (!first) file << ",";
+            first = false;
+
+            file << "\n{\"name\":\"" << escape_json(e.name) << "\",\"ph\":\"X\",\"ts\":" << e.start_us
+                 << ",\"dur\":" << e.duration_us << ",\"pid\":0,\"tid\":" << storage->tid << "}";
+        }
+    }
+
+    file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+    if (!file) throw std::runtime_error("Error writing the profiling trace to " + filename + ".");
+}
+
+}  // namespace util::profiling
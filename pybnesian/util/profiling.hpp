@@ -0,0 +1,107 @@
+#ifndef PYBNESIAN_UTIL_PROFILING_HPP
+#define PYBNESIAN_UTIL_PROFILING_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+// Profiling counters and timers of the structure learning algorithms. Profiling is disabled by default: then, a timer or
+// a counter only reads an atomic flag, so the instrumentation can be left in the hot paths.
+//
+// Each thread accumulates its measurements in its own storage, so the timers can be used inside the parallel loops
+// without contention. The measurements of all the threads are merged when they are queried.
+namespace util::profiling {
+
+namespace detail {
+extern std::atomic<bool> enabled;
+}
+
+inline bool enabled() { return detail::enabled.load(std::memory_order_relaxed); }
+
+// Enables the profiling. If trace is true, each timed section is also recorded as an event of a Chrome trace (see
+// save_trace()).
+void enable(bool trace = false);
+void disable();
+// Removes all the measurements and trace events.
+void reset();
+
+struct TimerStats {
+    int64_t count;
+    double total_seconds;
+    double min_seconds;
+    double max_seconds;
+};
+
+struct ProfilingStats {
+    std::unordered_map<std::string, TimerStats> timers;
+    std::unordered_map<std::string, int64_t> counters;
+    // Number of trace events that were not recorded because the trace buffer was full.
+    int64_t dropped_trace_events;
+};
+
+ProfilingStats stats();
+
+// Saves the recorded trace events in the Chrome trace event format. The file can be opened with chrome://tracing or
+// https://ui.perfetto.dev.
+void save_trace(const std::string& filename);
+
+void add_count(const std::string& name, int64_t n);
+void add_time(const std::string& name,
+              std::chrono::steady_clock::time_point start,
+              std::chrono::steady_clock::time_point end);
+
+inline void count(const char* name, int64_t n = 1) {
+    if (enabled()) add_count(name, n);
+}
+
+// Overload for names that are expensive to build: name is a callable that returns the name, and it is only called if
+// profiling is enabled.
+template <typename NameFunc, std::enable_if_t<std::is_invocable_r_v<std::string, NameFunc>, int> = 0>
+void count(NameFunc name, int64_t n = 1) {
+    if (enabled()) add_count(name(), n);
+}
+
+// Measures the time from its construction to its destruction.
+class ScopedTimer {
+public:
+    explicit ScopedTimer(const char* name) : m_active(enabled()), m_name(), m_start() {
+        if (m_active) {
+            m_name = name;
+            m_start = std::chrono::steady_clock::now();
+        }
+    }
+
+    template <typename NameFunc, std::enable_if_t<std::is_invocable_r_v<std::string, NameFunc>, int> = 0>
+    explicit ScopedTimer(NameFunc name) : m_active(enabled()), m_name(), m_start() {
+        if (m_active) {
+            m_name = name();
+            m_start = std::chrono::steady_clock::now();
+        }
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+    ~ScopedTimer() { stop(); }
+
+    // Stops the timer before the end of the scope.
+    void stop() {
+        if (m_active) {
+            add_time(m_name, m_start, std::chrono::steady_clock::now());
+            m_active = false;
+        }
+    }
+
+private:
+    bool m_active;
+    std::string m_name;
+    std::chrono::steady_clock::time_point m_start;
+};
+
+}  // namespace util::profiling
+
+#endif  // PYBNESIAN_UTIL_PROFILING_HPP
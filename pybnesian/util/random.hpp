@@ -0,0 +1,44 @@
+#ifndef PYBNESIAN_UTIL_RANDOM_HPP
+#define PYBNESIAN_UTIL_RANDOM_HPP
+
+#include <array>
+#include <cstdint>
+
+namespace util {
+
+// Philox4x32-10 counter-based generator (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3", 2011). The
+// output is a pure function of (counter, key), so independent streams can be generated in any order and by any thread.
+inline std::array<uint32_t, 4> philox4x32(std::array<uint32_t, 4> ctr, std::array<uint32_t, 2> key) {
+    constexpr uint32_t M0 = 0xD2511F53;
+    constexpr uint32_t M1 = 0xCD9E8D57;
+    constexpr uint32_t W0 = 0x9E3779B9;
+    constexpr uint32_t W1 = 0xBB67AE85;
+
+    for (int round = 0; round < 10; ++round) {
+        uint64_t p0 = static_cast<uint64_t>(M0) * ctr[0];
+        uint64_t p1 = static_cast<uint64_t>(M1) * ctr[2];
+
+        auto hi0 = static_cast<uint32_t>(p0 >> 32);
+        auto lo0 = static_cast<uint32_t>(p0);
+        auto hi1 = static_cast<uint32_t>(p1 >> 32);
+        auto lo1 = static_cast<uint32_t>(p1);
+
+        ctr = {hi1 ^ ctr[1] ^ key[0], lo1, hi0 ^ ctr[3] ^ key[1], lo0};
+
+        key[0] += W0;
+        key[1] += W1;
+    }
+
+    return ctr;
+}
+
+// Returns the seed of the substream number "counter" of the stream identified by "seed".
+inline unsigned int substream_seed(unsigned int seed, uint64_t counter) {
+    auto r = philox4x32({static_cast<uint32_t>(counter), static_cast<uint32_t>(counter >> 32), 0, 0},
+                        {static_cast<uint32_t>(seed), 0});
+    return r[0];
+}
+
+}  // namespace util
+
+#endif  // PYBNESIAN_UTIL_RANDOM_HPP
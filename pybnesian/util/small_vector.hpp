@@ -0,0 +1,142 @@
+#ifndef PYBNESIAN_UTIL_SMALL_VECTOR_HPP
+#define PYBNESIAN_UTIL_SMALL_VECTOR_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <type_traits>
+
+namespace util {
+
+// Vector with inline storage for N elements. It only allocates memory if it contains more than N elements. Only
+// trivially copyable types are supported, so the elements are copied with std::copy.
+template <typename T, int N>
+class SmallVector {
+public:
+    static_assert(std::is_trivially_copyable_v<T>, "SmallVector only supports trivially copyable types.");
+
+    using value_type = T;
+    using size_type = std::size_t;
+    using iterator = T*;
+    using const_iterator = const T*;
+    using reference = T&;
+    using const_reference = const T&;
+
+    SmallVector() : m_heap(), m_data(m_inline), m_size(0), m_capacity(N) {}
+
+    SmallVector(std::initializer_list<T> list) : SmallVector(list.begin(), list.end()) {}
+
+    template <typename Iter>
+    SmallVector(Iter begin, Iter end) : SmallVector() {
+        reserve(std::distance(begin, end));
+        for (; begin != end; ++begin) push_back(*begin);
+    }
+
+    SmallVector(const SmallVector& other) : SmallVector(other.begin(), other.end()) {}
+
+    // The moves are noexcept, so a std::vector of SmallVector moves its elements when it grows.
+    SmallVector(SmallVector&& other) noexcept : SmallVector() { *this = std::move(other); }
+
+    SmallVector& operator=(const SmallVector& other) {
+        if (this != &other) {
+            clear();
+            reserve(other.size());
+            std::copy(other.begin(), other.end(), m_data);
+            m_size = other.m_size;
+        }
+
+        return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& other) noexcept {
+        if (this == &other) return *this;
+
+        if (other.is_inline()) {
+            m_heap.reset();
+            m_data = m_inline;
+            m_capacity = N;
+            std::copy(other.begin(), other.end(), m_data);
+        } else {
+            m_heap = std::move(other.m_heap);
+            m_data = m_heap.get();
+            m_capacity = other.m_capacity;
+
+            other.m_data = other.m_inline;
+            other.m_capacity = N;
+        }
+
+        m_size = other.m_size;
+        other.m_size = 0;
+        return *this;
+    }
+
+    size_type size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+    size_type capacity() const { return m_capacity; }
+    // True if the elements are stored in the inline buffer.
+    bool is_inline() const { return m_data == m_inline; }
+
+    T* data() { return m_data; }
+    const T* data() const { return m_data; }
+
+    iterator begin() { return m_data; }
+    iterator end() { return m_data + m_size; }
+    const_iterator begin() const { return m_data; }
+    const_iterator end() const { return m_data + m_size; }
+
+    T& operator[](size_type i) { return m_data[i]; }
+    const T& operator[](size_type i) const { return m_data[i]; }
+    T& back() { return m_data[m_size - 1]; }
+    const T& back() const { return m_data[m_size - 1]; }
+
+    void reserve(size_type capacity) {
+        if (capacity <= m_capacity) return;
+
+        auto new_capacity = std::max(capacity, 2 * m_capacity);
+        auto new_heap = std::make_unique<T[]>(new_capacity);
+        std::copy(begin(), end(), new_heap.get());
+
+        m_heap = std::move(new_heap);
+        m_data = m_heap.get();
+        m_capacity = new_capacity;
+    }
+
+    void push_back(const T& value) {
+        if (m_size == m_capacity) reserve(m_size + 1);
+        m_data[m_size++] = value;
+    }
+
+    void pop_back() { --m_size; }
+    void clear() { m_size = 0; }
+
+    bool operator==(const SmallVector& other) const {
+        return m_size == other.m_size && std::equal(begin(), end(), other.begin());
+    }
+    bool operator!=(const SmallVector& other) const { return !(*this == other); }
+
+private:
+    T m_inline[N];
+    std::unique_ptr<T[]> m_heap;
+    T* m_data;
+    size_type m_size;
+    size_type m_capacity;
+};
+
+// Removes the first element equal to value, replacing it with the last element.
+template <typename T, int N>
+void swap_remove_v(SmallVector<T, N>& v, T value) {
+    auto it = std::find(v.begin(), v.end(), value);
+    if (it == v.end()) return;
+
+    *it = v.back();
+    v.pop_back();
+}
+
+// Indices of the parents of a node. Most nodes have a few parents, so a ParentSet usually does not allocate memory.
+using ParentSet = SmallVector<int, 8>;
+static_assert(std::is_nothrow_move_constructible_v<ParentSet>, "ParentSet must be moved by std::vector.");
+
+}  // namespace util
+
+#endif  // PYBNESIAN_UTIL_SMALL_VECTOR_HPP
@@ -6,9 +6,14 @@
 #include <learning/scores/bic.hpp>
 #include <learning/scores/bge.hpp>
 #include <learning/scores/validated_likelihood.hpp>
+#include <learning/independences/continuous/linearcorrelation.hpp>
+#include <learning/independences/discrete/chi_square.hpp>
+#include <learning/independences/hybrid/mutual_information.hpp>
 
 using learning::operators::ArcOperatorSet, learning::operators::ChangeNodeTypeSet, learning::operators::OperatorPool;
 using learning::scores::BIC, learning::scores::BGe, learning::scores::ValidatedLikelihood;
+using learning::independences::continuous::LinearCorrelation, learning::independences::discrete::ChiSquare,
+    learning::independences::hybrid::MutualInformation;
 using models::GaussianNetworkType, models::KDENetworkType, models::SemiparametricBNType, models::DiscreteBNType;
 
 namespace util {
@@ -90,4 +95,16 @@ std::shared_ptr<OperatorSet> check_valid_operators(const BayesianNetworkType& bn
     }
 }
 
-}  // namespace util
\ No newline at end of file
+std::unique_ptr<IndependenceTest> check_valid_independence_test(const DataFrame& df, const std::string& test) {
+    if (test == "linear-correlation") return std::make_unique<LinearCorrelation>(df);
+    if (test == "chi-square") return std::make_unique<ChiSquare>(df);
+    if (test == "mutual-info")
+        return std::make_unique<MutualInformation>(df);
+    else
+        throw std::invalid_argument("Wrong independence test \"" + test +
+                                    "\" specified. The possible alternatives are "
+                                    "\"linear-correlation\" (LinearCorrelation), \"chi-square\" (ChiSquare) "
+                                    "or \"mutual-info\" (MutualInformation).");
+}
+
+}  // namespace util
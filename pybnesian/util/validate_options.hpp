@@ -2,8 +2,10 @@
 #define PYBNESIAN_UTIL_VALIDATE_OPTIONS_HPP
 
 #include <learning/operators/operators.hpp>
+#include <learning/independences/independence.hpp>
 #include <models/BayesianNetwork.hpp>
 
+using learning::independences::IndependenceTest;
 using learning::operators::OperatorSet;
 using models::BayesianNetworkType;
 
@@ -23,6 +25,8 @@ std::shared_ptr<OperatorSet> check_valid_operators(const BayesianNetworkType& bn
                                                    int max_indegree,
                                                    const FactorTypeVector& type_whitelist);
 
+std::unique_ptr<IndependenceTest> check_valid_independence_test(const DataFrame& df, const std::string& test);
+
 }  // namespace util
 
 #endif  // PYBNESIAN_UTIL_VALIDATE_OPTIONS_HPP
\ No newline at end of file
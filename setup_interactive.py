@@ -125,13 +125,16 @@ ext_modules = [
          'pybnesian/pybindings/pybindings_learning/pybindings_mle.cpp',
          'pybnesian/pybindings/pybindings_learning/pybindings_operators.cpp',
          'pybnesian/pybindings/pybindings_learning/pybindings_algorithms.cpp',
+         'pybnesian/pybindings/pybindings_inference.cpp',
          'pybnesian/kde/KDE.cpp',
          'pybnesian/kde/ProductKDE.cpp',
+         'pybnesian/kde/FastUnivariateKDE.cpp',
          'pybnesian/factors/continuous/LinearGaussianCPD.cpp',
          'pybnesian/factors/continuous/CKDE.cpp',
          'pybnesian/factors/discrete/DiscreteFactor.cpp',
          'pybnesian/factors/discrete/discrete_indices.cpp',
          'pybnesian/dataset/dataset.cpp',
+         'pybnesian/dataset/chunked_dataframe.cpp',
          'pybnesian/dataset/dynamic_dataset.cpp',
          'pybnesian/dataset/crossvalidation_adaptator.cpp',
          'pybnesian/dataset/holdout_adaptator.cpp',
@@ -142,14 +145,21 @@ ext_modules = [
          'pybnesian/util/rpoly.cpp',
          'pybnesian/util/vech_ops.cpp',
          'pybnesian/util/pickle.cpp',
+         'pybnesian/util/parallel.cpp',
+         'pybnesian/util/profiling.cpp',
+         'pybnesian/util/binary_serialization.cpp',
          'pybnesian/util/util_types.cpp',
          'pybnesian/kdtree/kdtree.cpp',
          'pybnesian/learning/operators/operators.cpp',
          'pybnesian/learning/algorithms/hillclimbing.cpp',
          'pybnesian/learning/algorithms/pc.cpp',
+         'pybnesian/learning/algorithms/sepset_job.cpp',
          'pybnesian/learning/algorithms/mmpc.cpp',
          'pybnesian/learning/algorithms/mmhc.cpp',
+         'pybnesian/learning/algorithms/bootstrap.cpp',
+         'pybnesian/learning/algorithms/sparse_candidate.cpp',
          'pybnesian/learning/algorithms/dmmhc.cpp',
+         'pybnesian/learning/independences/cached_independence.cpp',
          'pybnesian/learning/independences/continuous/linearcorrelation.cpp',
          'pybnesian/learning/independences/continuous/mutual_information.cpp',
          'pybnesian/learning/independences/continuous/RCoT.cpp',
@@ -164,6 +174,7 @@ ext_modules = [
          'pybnesian/learning/scores/bde.cpp',
          'pybnesian/learning/scores/cv_likelihood.cpp',
          'pybnesian/learning/scores/holdout_likelihood.cpp',
+         'pybnesian/learning/scores/cached_score.cpp',
          'pybnesian/graph/generic_graph.cpp',
          'pybnesian/models/BayesianNetwork.cpp',
          'pybnesian/models/GaussianNetwork.cpp',
@@ -174,6 +185,8 @@ ext_modules = [
          'pybnesian/models/HeterogeneousBN.cpp',
          'pybnesian/models/CLGNetwork.cpp',
          'pybnesian/models/DynamicBayesianNetwork.cpp',
+         'pybnesian/inference/GaussianInference.cpp',
+         'pybnesian/inference/JunctionTree.cpp',
          'pybnesian/kernels/kernel.cpp'
          ],
         language='c++',
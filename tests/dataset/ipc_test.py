@@ -0,0 +1,148 @@
+import numpy as np
+import pyarrow as pa
+import pyarrow.feather as feather
+import pytest
+import pybnesian as pbn
+import util_test
+
+SIZE = 1000
+
+df = util_test.generate_normal_data(SIZE)
+
+
+def test_read_ipc(tmp_path):
+    path = str(tmp_path / "data.arrow")
+    feather.write_feather(df, path, compression="uncompressed", chunksize=SIZE)
+
+    for memory_map in [True, False]:
+        data = pbn.read_ipc(path, memory_map=memory_map)
+        assert data.num_rows == SIZE
+        assert data.schema.names == list(df.columns)
+        for name in df.columns:
+            assert np.array_equal(data.column(name).to_numpy(), df[name].to_numpy())
+
+        data = pbn.read_ipc(path, columns=["c", "a"], memory_map=memory_map)
+        assert data.schema.names == ["c", "a"]
+        assert np.array_equal(data.column("c").to_numpy(), df["c"].to_numpy())
+        assert np.array_equal(data.column("a").to_numpy(), df["a"].to_numpy())
+
+    with pytest.raises(ValueError) as ex:
+        pbn.read_ipc(path, columns=["z"])
+    assert "not found" in str(ex.value)
+
+
+def test_read_ipc_chunks(tmp_path):
+    path = str(tmp_path / "data.arrow")
+    feather.write_feather(df, path, chunksize=SIZE // 4)
+
+    data = pbn.read_ipc(path)
+    assert data.num_rows == SIZE
+    for name in df.columns:
+        assert np.array_equal(data.column(name).to_numpy(), df[name].to_numpy())
+
+
+def test_chunked_table():
+    table = pa.Table.from_pandas(df, preserve_index=False)
+    chunked = pa.concat_tables([table.slice(0, 300), table.slice(300, 400), table.slice(700)])
+    assert chunked.column(0).num_chunks == 3
+
+    gbn = pbn.GaussianNetwork(["a", "b", "c", "d"], [("a", "b"), ("a", "c"), ("b", "d")])
+    bic = pbn.BIC(df)
+    bic_table = pbn.BIC(table)
+    bic_chunked = pbn.BIC(chunked)
+
+    for node in gbn.nodes():
+        local_score = bic.local_score(gbn, node)
+        assert np.isclose(bic_table.local_score(gbn, node), local_score)
+        assert np.isclose(bic_chunked.local_score(gbn, node), local_score)
+
+    gbn.fit(chunked)
+    assert np.all(np.isclose(gbn.logl(table), gbn.logl(df)))
+
+
+def chunk_table(table):
+    return pa.concat_tables([table.slice(0, 250), table.slice(250, 1), table.slice(251, 500), table.slice(751)])
+
+
+def test_chunked_dataframe():
+    table = pa.Table.from_pandas(df, preserve_index=False)
+    chunked = pbn.ChunkedDataFrame(chunk_table(table))
+    assert chunked.num_chunks() == 4
+    assert chunked.num_rows() == SIZE
+    assert chunked.chunk(1).num_rows == 1
+
+    assert np.all(np.isclose(chunked.means(["a", "b", "c"]), df[["a", "b", "c"]].mean().to_numpy()))
+    assert np.all(np.isclose(chunked.cov(["a", "b", "c"]), df[["a", "b", "c"]].cov().to_numpy()))
+
+    indices = [0, 249, 250, 251, 999, 3, 500]
+    taken = chunked.take(indices)
+    for name in df.columns:
+        assert np.array_equal(taken.column(name).to_numpy(), df[name].to_numpy()[indices])
+
+    with pytest.raises(ValueError):
+        chunked.take([SIZE])
+
+    with pytest.raises(ValueError) as ex:
+        pbn.ChunkedDataFrame([table, table.select(["a", "b"])])
+    assert "different schema" in str(ex.value)
+
+    discrete_df = util_test.generate_discrete_data_uniform(SIZE)
+    other = discrete_df.copy()
+    other["A"] = other["A"].cat.rename_categories({"a1": "a3"})
+    with pytest.raises(ValueError) as ex:
+        pbn.ChunkedDataFrame([discrete_df, other])
+    assert "unify_dictionaries" in str(ex.value)
+
+
+def test_chunked_scores():
+    chunked = pbn.ChunkedDataFrame(chunk_table(pa.Table.from_pandas(df, preserve_index=False)))
+
+    gbn = pbn.GaussianNetwork(["a", "b", "c", "d"], [("a", "b"), ("a", "c"), ("b", "c"), ("b", "d"), ("c", "d")])
+    for score, chunked_score in [(pbn.BIC(df), pbn.BIC(chunked)), (pbn.BGe(df), pbn.BGe(chunked))]:
+        for node in gbn.nodes():
+            assert np.isclose(chunked_score.local_score(gbn, node), score.local_score(gbn, node))
+
+    lc = pbn.LinearCorrelation(df)
+    chunked_lc = pbn.LinearCorrelation(chunked)
+    assert np.isclose(chunked_lc.pvalue("a", "b"), lc.pvalue("a", "b"))
+    assert np.isclose(chunked_lc.pvalue("a", "c", "b"), lc.pvalue("a", "c", "b"))
+    assert np.isclose(chunked_lc.pvalue("a", "d", ["b", "c"]), lc.pvalue("a", "d", ["b", "c"]))
+
+    discrete_df = util_test.generate_discrete_data_dependent(SIZE)
+    chunked = pbn.ChunkedDataFrame(chunk_table(pa.Table.from_pandas(discrete_df, preserve_index=False)))
+
+    dbn = pbn.DiscreteBN(["A", "B", "C", "D"], [("A", "B"), ("A", "C"), ("B", "C"), ("C", "D")])
+    for score, chunked_score in [(pbn.BIC(discrete_df), pbn.BIC(chunked)), (pbn.BDe(discrete_df), pbn.BDe(chunked))]:
+        for node in dbn.nodes():
+            assert np.isclose(chunked_score.local_score(dbn, node), score.local_score(dbn, node))
+
+    chi = pbn.ChiSquare(discrete_df)
+    chunked_chi = pbn.ChiSquare(chunked)
+    assert np.isclose(chunked_chi.pvalue("A", "B"), chi.pvalue("A", "B"))
+    assert np.isclose(chunked_chi.pvalue("A", "C", "B"), chi.pvalue("A", "C", "B"))
+    assert np.isclose(chunked_chi.pvalue("A", "D", ["B", "C"]), chi.pvalue("A", "D", ["B", "C"]))
+
+    hybrid_df = util_test.generate_hybrid_data(SIZE)
+    chunked = pbn.ChunkedDataFrame(chunk_table(pa.Table.from_pandas(hybrid_df, preserve_index=False)))
+
+    clg = pbn.CLGNetwork(["A", "B", "C", "D"], [("A", "D"), ("B", "D"), ("C", "D")])
+    bic = pbn.BIC(hybrid_df)
+    chunked_bic = pbn.BIC(chunked)
+    for node in clg.nodes():
+        assert np.isclose(chunked_bic.local_score(clg, node), bic.local_score(clg, node))
+
+
+def test_read_chunked_ipc(tmp_path):
+    path = str(tmp_path / "data.arrow")
+    feather.write_feather(df, path, compression="uncompressed", chunksize=SIZE // 4)
+
+    data = pbn.read_chunked_ipc(path, columns=["b", "a"])
+    assert data.num_chunks() == 4
+    assert data.num_rows() == SIZE
+    assert data.chunk(0).schema.names == ["b", "a"]
+
+    gbn = pbn.GaussianNetwork(["a", "b"], [("a", "b")])
+    bic = pbn.BIC(df)
+    chunked_bic = pbn.BIC(data)
+    for node in gbn.nodes():
+        assert np.isclose(chunked_bic.local_score(gbn, node), bic.local_score(gbn, node))
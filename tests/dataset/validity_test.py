@@ -0,0 +1,66 @@
+import numpy as np
+import pybnesian as pbn
+import util_test
+
+SIZE = 1000
+
+df = util_test.generate_normal_data(SIZE)
+
+np.random.seed(0)
+df_null = df.copy()
+for col in ["a", "b", "c"]:
+    df_null.loc[df_null.index[np.random.randint(0, SIZE, size=100)], col] = np.nan
+
+
+def test_validity_no_nulls():
+    pbn.reset_profiling()
+    pbn.enable_profiling()
+    try:
+        lc = pbn.LinearCorrelation(df)
+        lc.pvalue("a", "b")
+        lc.pvalue("a", "b", ["c", "d"])
+    finally:
+        pbn.disable_profiling()
+
+    # The DataFrame has no nulls, so the validity bitmaps are never computed.
+    counters = pbn.profiling_stats()["counters"]
+    assert "validity_cache/hits" not in counters
+    assert "validity_cache/misses" not in counters
+
+    pbn.reset_profiling()
+
+
+def test_validity_cache():
+    pbn.reset_profiling()
+    pbn.enable_profiling()
+    try:
+        lc = pbn.LinearCorrelation(df_null)
+        pvalue_ab = lc.pvalue("a", "b")
+        assert lc.pvalue("b", "a") == pvalue_ab
+        pvalue_abc = lc.pvalue("a", "b", "c")
+        assert lc.pvalue("a", "b", "c") == pvalue_abc
+    finally:
+        pbn.disable_profiling()
+
+    counters = pbn.profiling_stats()["counters"]
+    # The sets {a, b} and {a, b, c} are combined once. The order of the columns does not change the key.
+    assert counters["validity_cache/misses"] == 2
+    assert counters["validity_cache/hits"] >= 2
+
+    pbn.reset_profiling()
+    pbn.enable_profiling()
+    try:
+        # The column "d" has no nulls, so {a, b, d} shares the bitmap of {a, b}.
+        lc.pvalue("a", "b", "d")
+    finally:
+        pbn.disable_profiling()
+
+    counters = pbn.profiling_stats()["counters"]
+    assert "validity_cache/misses" not in counters
+
+    lc_dropna = pbn.LinearCorrelation(df_null[["a", "b"]].dropna())
+    assert np.isclose(pvalue_ab, lc_dropna.pvalue("a", "b"))
+    lc_dropna = pbn.LinearCorrelation(df_null[["a", "b", "c"]].dropna())
+    assert np.isclose(pvalue_abc, lc_dropna.pvalue("a", "b", "c"))
+
+    pbn.reset_profiling()
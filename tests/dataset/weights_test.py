@@ -0,0 +1,251 @@
+import pickle
+import numpy as np
+import pyarrow as pa
+import pytest
+import pybnesian as pbn
+import util_test
+from scipy.special import logsumexp
+from scipy.stats import norm
+
+SIZE = 1000
+
+df = util_test.generate_normal_data(SIZE)
+discrete_df = util_test.generate_discrete_data_dependent(SIZE)
+
+np.random.seed(0)
+repetitions = np.random.randint(1, 4, size=SIZE)
+
+
+def repeat_rows(data, reps):
+    return data.loc[data.index.repeat(reps)].reset_index(drop=True)
+
+
+def weighted(data, reps):
+    rb = pa.RecordBatch.from_pandas(data.assign(w=reps), preserve_index=False)
+    return pbn.with_weights(rb, "w")
+
+
+repeated_df = repeat_rows(df, repetitions)
+weighted_df = weighted(df, repetitions)
+
+
+def test_with_weights():
+    assert weighted_df.schema.field("w").type == pa.float64()
+
+    unweighted = pbn.without_weights(weighted_df)
+    assert unweighted.schema.names == weighted_df.schema.names
+
+    with pytest.raises(ValueError) as ex:
+        pbn.with_weights(weighted_df, "z")
+    assert "not found" in str(ex.value)
+
+    with pytest.raises(ValueError) as ex:
+        weighted(df, -repetitions)
+    assert "non-negative" in str(ex.value)
+
+    with pytest.raises(ValueError) as ex:
+        weighted(df, np.where(repetitions == 1, np.nan, repetitions))
+    assert "null" in str(ex.value) or "non-negative" in str(ex.value)
+
+
+def test_weighted_lg():
+    for variable, evidence in [("a", []), ("b", ["a"]), ("d", ["a", "b", "c"])]:
+        cpd = pbn.LinearGaussianCPD(variable, evidence)
+        cpd.fit(repeated_df)
+        wcpd = pbn.LinearGaussianCPD(variable, evidence)
+        wcpd.fit(weighted_df)
+
+        assert np.all(np.isclose(cpd.beta, wcpd.beta))
+        assert np.isclose(cpd.variance, wcpd.variance)
+
+
+def test_weighted_gaussian_scores():
+    gbn = pbn.GaussianNetwork(["a", "b", "c", "d"])
+
+    for score in [pbn.BIC, pbn.BGe]:
+        s = score(repeated_df)
+        ws = score(weighted_df)
+
+        assert np.isclose(s.local_score(gbn, "a", []), ws.local_score(gbn, "a", []))
+        assert np.isclose(s.local_score(gbn, "b", ["a"]), ws.local_score(gbn, "b", ["a"]))
+        assert np.isclose(s.local_score(gbn, "d", ["a", "b", "c"]), ws.local_score(gbn, "d", ["a", "b", "c"]))
+
+
+def test_weighted_linear_correlation():
+    lc = pbn.LinearCorrelation(repeated_df)
+    wlc = pbn.LinearCorrelation(weighted_df)
+
+    assert wlc.num_variables() == 4
+    assert np.isclose(lc.pvalue("a", "b"), wlc.pvalue("a", "b"))
+    assert np.isclose(lc.pvalue("a", "c", "b"), wlc.pvalue("a", "c", "b"))
+    assert np.isclose(lc.pvalue("a", "d", ["b", "c"]), wlc.pvalue("a", "d", ["b", "c"]))
+
+
+def test_weighted_kde():
+    for variables in [["a"], ["a", "b"]]:
+        kde = pbn.KDE(variables)
+        kde.fit(repeated_df)
+        wkde = pbn.KDE(variables)
+        wkde.fit(weighted_df)
+
+        # Each row is kept once, and its kernel is weighted.
+        assert wkde.num_instances() == SIZE
+        assert np.all(np.isclose(kde.bandwidth, wkde.bandwidth))
+        assert np.all(np.isclose(kde.logl(df), wkde.logl(df)))
+        assert np.isclose(kde.slogl(df), wkde.slogl(df))
+
+        restored = pickle.loads(pickle.dumps(wkde))
+        assert np.all(np.isclose(restored.logl(df), wkde.logl(df)))
+
+    for method in [pbn.UnivariateKDEMethod.SortedWindow, pbn.UnivariateKDEMethod.Binned]:
+        kde = pbn.KDE(["a"])
+        kde.univariate_method = method
+        kde.fit(repeated_df)
+        wkde = pbn.KDE(["a"])
+        wkde.univariate_method = method
+        wkde.fit(weighted_df)
+
+        assert np.all(np.isclose(kde.logl(df), wkde.logl(df), atol=1e-5))
+
+    pkde = pbn.ProductKDE(["a", "b"])
+    pkde.fit(repeated_df)
+    wpkde = pbn.ProductKDE(["a", "b"])
+    wpkde.fit(weighted_df)
+
+    assert wpkde.num_instances() == SIZE
+    assert np.all(np.isclose(pkde.bandwidth, wpkde.bandwidth))
+    assert np.all(np.isclose(pkde.logl(df), wpkde.logl(df)))
+    restored = pickle.loads(pickle.dumps(wpkde))
+    assert np.all(np.isclose(restored.logl(df), wpkde.logl(df)))
+
+
+def test_weighted_kde_real_weights():
+    # Importance weights do not need to be integers.
+    importance = np.random.uniform(0.1, 2, size=SIZE)
+    wkde = pbn.KDE(["a"])
+    wkde.fit(weighted(df, importance))
+
+    p = importance / importance.sum()
+    h = np.sqrt(wkde.bandwidth[0, 0])
+    test = df["a"].to_numpy()[:50]
+    log_kernels = norm.logpdf(test[:, None], df["a"].to_numpy()[None, :], h) + np.log(p)[None, :]
+    assert np.all(np.isclose(wkde.logl(df.iloc[:50]), logsumexp(log_kernels, axis=1)))
+
+    for method in [pbn.UnivariateKDEMethod.SortedWindow, pbn.UnivariateKDEMethod.Binned]:
+        wkde.univariate_method = method
+        assert np.all(np.isclose(wkde.logl(df.iloc[:50]), logsumexp(log_kernels, axis=1), atol=1e-5))
+
+    # The rows with weight 0 are not in the data.
+    zero_weights = np.where(np.arange(SIZE) % 2 == 0, 0, importance)
+    zkde = pbn.KDE(["a", "b"])
+    zkde.fit(weighted(df, zero_weights))
+    odd_kde = pbn.KDE(["a", "b"])
+    odd_kde.fit(weighted(df.iloc[1::2].reset_index(drop=True), importance[1::2]))
+
+    assert zkde.num_instances() == SIZE // 2
+    assert np.all(np.isclose(zkde.logl(df), odd_kde.logl(df)))
+
+
+def test_weighted_ckde():
+    for variable, evidence in [("a", []), ("b", ["a"]), ("d", ["a", "b", "c"])]:
+        cpd = pbn.CKDE(variable, evidence)
+        cpd.fit(repeated_df)
+        wcpd = pbn.CKDE(variable, evidence)
+        wcpd.fit(weighted_df)
+
+        assert wcpd.num_instances() == SIZE
+        assert np.all(np.isclose(cpd.logl(df), wcpd.logl(df)))
+        assert np.all(np.isclose(cpd.cdf(df), wcpd.cdf(df)))
+
+    # The training instances are drawn proportionally to their weights.
+    wcpd = pbn.CKDE("a", [])
+    wcpd.fit(weighted_df)
+    sampled = wcpd.sample(20000, None, 0).to_numpy()
+    assert np.isclose(sampled.mean(), np.average(df["a"], weights=repetitions), atol=0.02)
+
+
+def test_deduplicate():
+    dedup = pbn.deduplicate(discrete_df)
+
+    assert dedup.schema.names == list(discrete_df.columns) + ["weights"]
+    assert dedup.num_rows == discrete_df.drop_duplicates().shape[0]
+    assert dedup.column("weights").to_numpy().sum() == SIZE
+
+    dedup_pd = dedup.to_pandas()
+    counts = discrete_df.groupby(list(discrete_df.columns), observed=True).size()
+    for _, row in dedup_pd.iterrows():
+        assert counts[tuple(row[list(discrete_df.columns)])] == row["weights"]
+
+    with pytest.raises(ValueError) as ex:
+        pbn.deduplicate(df)
+    assert "not discrete" in str(ex.value)
+
+
+def test_deduplicate_discrete_learning():
+    dedup = pbn.deduplicate(discrete_df)
+    dbn = pbn.DiscreteBN(["A", "B", "C", "D"])
+
+    for score in [pbn.BIC, pbn.BDe]:
+        s = score(discrete_df)
+        ws = score(dedup)
+
+        assert np.isclose(s.local_score(dbn, "A", []), ws.local_score(dbn, "A", []))
+        assert np.isclose(s.local_score(dbn, "C", ["A", "B"]), ws.local_score(dbn, "C", ["A", "B"]))
+
+    chi = pbn.ChiSquare(discrete_df)
+    wchi = pbn.ChiSquare(dedup)
+
+    assert np.isclose(chi.pvalue("A", "B"), wchi.pvalue("A", "B"))
+    assert np.isclose(chi.pvalue("A", "C", "B"), wchi.pvalue("A", "C", "B"))
+    assert np.isclose(chi.pvalue("A", "D", ["B", "C"]), wchi.pvalue("A", "D", ["B", "C"]))
+
+    cpd = pbn.DiscreteFactor("C", ["A", "B"])
+    cpd.fit(discrete_df)
+    wcpd = pbn.DiscreteFactor("C", ["A", "B"])
+    wcpd.fit(dedup)
+
+    assert np.all(np.isclose(cpd.logl(discrete_df), wcpd.logl(discrete_df)))
+
+
+def test_weighted_validation_likelihood():
+    dedup = pbn.deduplicate(discrete_df)
+
+    cv = pbn.CVLikelihood(discrete_df, k=5, seed=0)
+    wcv = pbn.CVLikelihood(dedup, k=5, seed=0)
+    dbn = pbn.DiscreteBN(["A", "B", "C", "D"])
+
+    for variable, evidence in [("A", []), ("B", ["A"]), ("C", ["A", "B"])]:
+        # The test folds are weighted: each unique row contributes its log-likelihood times its weight.
+        expected = 0
+        for train, test in pbn.CrossValidation(dedup, k=5, seed=0):
+            cpd = pbn.DiscreteFactor(variable, evidence)
+            cpd.fit(train)
+            weights = test.column("weights").to_numpy()
+            expected += np.sum(weights * cpd.logl(test))
+
+        assert np.isclose(wcv.local_score(dbn, variable, evidence), expected)
+
+    # The folds of the deduplicated data contain different rows, so the scores are only similar.
+    for variable, evidence in [("A", []), ("B", ["A"])]:
+        assert np.isclose(wcv.local_score(dbn, variable, evidence), cv.local_score(dbn, variable, evidence), rtol=0.05)
+
+    # With unit weights, the folds are the same.
+    unit_cv = pbn.CVLikelihood(weighted(discrete_df, np.ones(SIZE)), k=5, seed=0)
+    assert np.isclose(unit_cv.local_score(dbn, "C", ["A", "B"]), cv.local_score(dbn, "C", ["A", "B"]))
+
+    dbn.fit(discrete_df)
+    assert np.isclose(dbn.slogl(dedup), dbn.slogl(discrete_df))
+
+
+def test_unweighted_tests():
+    with pytest.raises(ValueError) as ex:
+        pbn.KMutualInformation(weighted_df, k=10)
+    assert "weights" in str(ex.value)
+
+    with pytest.raises(ValueError) as ex:
+        pbn.RCoT(weighted_df)
+    assert "weights" in str(ex.value)
+
+    with pytest.raises(ValueError) as ex:
+        pbn.MutualInformation(pbn.deduplicate(discrete_df))
+    assert "weights" in str(ex.value)
@@ -1,5 +1,6 @@
 import pytest
 import numpy as np
+import pickle
 import pyarrow as pa
 import pandas as pd
 import pybnesian as pbn
@@ -551,4 +552,73 @@ def test_ckde_sample():
     sampled = cpd.sample(SAMPLE_SIZE, sampling_df, 0)
 
     assert sampled.type == pa.float32()
-    assert int(sampled.nbytes / (sampled.type.bit_width / 8)) == SAMPLE_SIZE
\ No newline at end of file
+    assert int(sampled.nbytes / (sampled.type.bit_width / 8)) == SAMPLE_SIZE
+
+
+def test_ckde_sample_conditional_mean():
+    SAMPLE_SIZE = 20000
+
+    cpd = pbn.CKDE('b', ['a'])
+    cpd.fit(df)
+
+    sampling_df = pd.DataFrame({'a': np.full((SAMPLE_SIZE,), 3.0)})
+    sampled = cpd.sample(SAMPLE_SIZE, sampling_df, 0).to_numpy()
+
+    # Same seed, same sample.
+    assert np.all(sampled == cpd.sample(SAMPLE_SIZE, sampling_df, 0).to_numpy())
+
+    # Expected conditional mean of the CKDE: mixture of the conditional kernels weighted by the marginal kernel of 'a'.
+    bandwidth = cpd.kde_joint().bandwidth
+    a = df['a'].to_numpy()
+    b = df['b'].to_numpy()
+    logw = -0.5 * (3.0 - a)**2 / bandwidth[1, 1]
+    w = np.exp(logw - logw.max())
+    w /= w.sum()
+    expected = np.sum(w * (b + bandwidth[0, 1] / bandwidth[1, 1] * (3.0 - a)))
+
+    cond_var = bandwidth[0, 0] - bandwidth[0, 1]**2 / bandwidth[1, 1]
+    total_var = np.sum(w * (b + bandwidth[0, 1] / bandwidth[1, 1] * (3.0 - a) - expected)**2) + cond_var
+    assert np.abs(sampled.mean() - expected) < 5 * np.sqrt(total_var / SAMPLE_SIZE)
+
+def test_ckde_mixed_precision():
+    test_df = util_test.generate_normal_data(TEST_SIZE, seed=1)
+    test_df_float = test_df.astype('float32')
+
+    for variable, evidence in [('a', []), ('b', ['a']), ('c', ['a', 'b']), ('d', ['a', 'b', 'c'])]:
+        cpd = pbn.CKDE(variable, evidence)
+        cpd.fit(df)
+
+        cpd_float = pbn.CKDE(variable, evidence)
+        cpd_float.precision = pbn.KDEPrecision.Mixed
+        cpd_float.fit(df_float)
+        assert cpd_float.kde_joint().precision == pbn.KDEPrecision.Mixed
+
+        logl = cpd.logl(test_df)
+        assert np.all(np.isclose(cpd_float.logl(test_df_float), logl, atol=1e-3, rtol=1e-3))
+        assert np.isclose(cpd_float.slogl(test_df_float), logl.sum(), rtol=1e-4)
+
+        loaded = pickle.loads(pickle.dumps(cpd_float))
+        assert loaded.precision == pbn.KDEPrecision.Mixed
+        assert np.all(loaded.logl(test_df_float) == cpd_float.logl(test_df_float))
+
+def test_ckde_univariate_method():
+    test_df = util_test.generate_normal_data(TEST_SIZE, seed=1)
+
+    for variable, evidence in [('a', []), ('b', ['a']), ('c', ['a', 'b'])]:
+        cpd = pbn.CKDE(variable, evidence)
+        cpd.fit(df)
+        exact = cpd.logl(test_df)
+
+        for method in [pbn.UnivariateKDEMethod.SortedWindow, pbn.UnivariateKDEMethod.Binned]:
+            cpd_fast = pbn.CKDE(variable, evidence)
+            cpd_fast.univariate_method = method
+            cpd_fast.fit(df)
+            assert cpd_fast.kde_joint().univariate_method == method
+            assert cpd_fast.univariate_tolerance == 1e-6
+
+            # The error of the joint and the marginal log-likelihoods is of the order of the tolerance.
+            assert np.all(np.isclose(cpd_fast.logl(test_df), exact, atol=1e-4, rtol=0))
+
+            loaded = pickle.loads(pickle.dumps(cpd_fast))
+            assert loaded.univariate_method == method
+            assert np.all(loaded.logl(test_df) == cpd_fast.logl(test_df))
@@ -0,0 +1,32 @@
+import numpy as np
+import pybnesian as pbn
+import util_test
+
+df = util_test.generate_hybrid_data(10000)
+
+def test_clg_logl_configurations():
+    cpd = pbn.CLinearGaussianCPD("D", ["A", "B", "C"])
+    cpd.fit(df)
+
+    test_df = util_test.generate_hybrid_data(2000, seed=1)
+    test_df.loc[test_df.index % 7 == 0, "C"] = np.nan
+    test_df.loc[test_df.index % 11 == 0, "D"] = np.nan
+
+    ll = cpd.logl(test_df)
+    expected = np.full(test_df.shape[0], np.nan)
+
+    for a in ["a1", "a2"]:
+        for b in ["b1", "b2", "b3"]:
+            mask = ((test_df["A"] == a) & (test_df["B"] == b)).to_numpy()
+            f = cpd.conditional_factor(pbn.Assignment({"A": a, "B": b}))
+            expected[mask] = f.logl(test_df[mask])
+
+            # The conditional factors are fitted with the rows of its configuration.
+            train_mask = (df["A"] == a) & (df["B"] == b)
+            lg = pbn.LinearGaussianCPD("D", ["C"])
+            lg.fit(df[train_mask])
+            assert np.all(np.isclose(f.beta, lg.beta))
+
+    assert np.all(np.isnan(ll) == np.isnan(expected))
+    assert np.all(np.isclose(ll[~np.isnan(ll)], expected[~np.isnan(expected)]))
+    assert np.isclose(cpd.slogl(test_df), np.nansum(expected))
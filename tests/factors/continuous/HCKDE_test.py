@@ -0,0 +1,43 @@
+import numpy as np
+import pybnesian as pbn
+import util_test
+
+df = util_test.generate_hybrid_data(2000)
+
+
+class UnitaryBandwidth(pbn.BandwidthSelector):
+    def __init__(self):
+        pbn.BandwidthSelector.__init__(self)
+
+    def bandwidth(self, df, variables):
+        return np.eye(len(variables))
+
+
+def test_hckde_logl_configurations():
+    test_df = util_test.generate_hybrid_data(500, seed=1)
+    test_df.loc[test_df.index % 7 == 0, "C"] = np.nan
+
+    # The configurations of the default bandwidth selector are fitted in parallel. The Python bandwidth selector needs
+    # the GIL, so its configurations are fitted sequentially.
+    for bandwidth_selector in [None, UnitaryBandwidth()]:
+        if bandwidth_selector is None:
+            cpd = pbn.HCKDE("D", ["A", "B", "C"])
+        else:
+            cpd = pbn.HCKDE("D", ["A", "B", "C"], bandwidth_selector)
+        cpd.fit(df)
+
+        ll = cpd.logl(test_df)
+        expected = np.full(test_df.shape[0], np.nan)
+
+        for a in ["a1", "a2"]:
+            for b in ["b1", "b2", "b3"]:
+                mask = ((test_df["A"] == a) & (test_df["B"] == b)).to_numpy()
+                f = cpd.conditional_factor(pbn.Assignment({"A": a, "B": b}))
+                expected[mask] = f.logl(test_df[mask])
+
+                if bandwidth_selector is not None:
+                    assert np.all(f.bandwidth == np.eye(2))
+
+        assert np.all(np.isnan(ll) == np.isnan(expected))
+        assert np.all(np.isclose(ll[~np.isnan(ll)], expected[~np.isnan(expected)]))
+        assert np.isclose(cpd.slogl(test_df), np.nansum(expected))
@@ -1,5 +1,6 @@
 import pytest
 import numpy as np
+import pickle
 import pyarrow as pa
 import pybnesian as pbn
 from pybnesian import BandwidthSelector
@@ -351,3 +352,116 @@ def test_kde_slogl_null():
     cpd2 = pbn.KDE(['a', 'c', 'd', 'b'])
     cpd2.fit(df_float)
     assert np.all(np.isclose(cpd.slogl(df_null_float), cpd2.slogl(df_null_float))), "Order of evidence changes slogl() result."
+
+def test_kde_num_threads():
+    previous = pbn.num_threads()
+    test_df = util_test.generate_normal_data(2000, seed=1)
+
+    for variables in [['a'], ['a', 'b', 'c', 'd']]:
+        kde = pbn.KDE(variables)
+        kde.fit(df)
+
+        pbn.set_num_threads(1)
+        assert pbn.num_threads() == 1
+        sequential = kde.logl(test_df)
+
+        pbn.set_num_threads(4)
+        assert pbn.num_threads() == 4
+        parallel = kde.logl(test_df)
+
+        assert np.all(sequential == parallel)
+        assert np.isclose(kde.slogl(test_df), sequential.sum())
+
+    with pytest.raises(ValueError) as ex:
+        pbn.set_num_threads(0)
+    assert "positive number" in str(ex.value)
+
+    pbn.set_num_threads(previous)
+
+def test_kde_mixed_precision():
+    test_df = util_test.generate_normal_data(1000, seed=1)
+    test_df_float = test_df.astype('float32')
+
+    for variables in [['a'], ['b', 'a'], ['c', 'a', 'b'], ['d', 'a', 'b', 'c']]:
+        kde = pbn.KDE(variables)
+        assert kde.precision == pbn.KDEPrecision.Native
+        kde.fit(df)
+
+        kde_float = pbn.KDE(variables)
+        kde_float.fit(df_float)
+        kde_float.precision = pbn.KDEPrecision.Mixed
+        assert kde_float.precision == pbn.KDEPrecision.Mixed
+
+        # The log-sum-exp is accumulated in double, so the error comes only from the float kernel values.
+        logl = kde.logl(test_df)
+        assert np.all(np.isclose(kde_float.logl(test_df_float), logl, atol=1e-4, rtol=1e-4))
+        assert np.isclose(kde_float.slogl(test_df_float), logl.sum(), rtol=1e-5)
+
+        kde.precision = pbn.KDEPrecision.Mixed
+        assert np.all(np.isclose(kde.logl(test_df), logl))
+        assert np.isclose(kde.slogl(test_df), logl.sum())
+
+        # The precision is saved with the model.
+        loaded = pickle.loads(pickle.dumps(kde_float))
+        assert loaded.precision == pbn.KDEPrecision.Mixed
+        assert np.all(loaded.logl(test_df_float) == kde_float.logl(test_df_float))
+
+def test_kde_univariate_method():
+    test_df = util_test.generate_normal_data(1000, seed=1)
+    # Test instances far from the training data are evaluated outside the grid of the Binned method.
+    test_df.loc[:9, 'a'] = np.linspace(-50, 50, 10)
+
+    kde = pbn.KDE(['a'])
+    assert kde.univariate_method == pbn.UnivariateKDEMethod.Exact
+    kde.fit(df)
+    exact = kde.logl(test_df)
+
+    for method, atol in [(pbn.UnivariateKDEMethod.SortedWindow, 1e-6),
+                         (pbn.UnivariateKDEMethod.Binned, 1e-5)]:
+        kde.univariate_method = method
+        assert kde.univariate_method == method
+        logl = kde.logl(test_df)
+        assert np.all(np.abs(logl - exact) <= atol)
+        assert np.isclose(kde.slogl(test_df), exact.sum())
+
+        kde.univariate_tolerance = 1e-3
+        assert kde.univariate_tolerance == 1e-3
+        assert np.all(np.abs(kde.logl(test_df) - exact) <= 1e3 * atol)
+        kde.univariate_tolerance = 1e-6
+
+        # A new fit keeps the method.
+        kde_float = pbn.KDE(['a'])
+        kde_float.univariate_method = method
+        kde_float.fit(df_float)
+        assert np.all(np.isclose(kde_float.logl(test_df.astype('float32')), exact, atol=1e-4, rtol=1e-4))
+
+        # The method and the tolerance are saved with the model.
+        loaded = pickle.loads(pickle.dumps(kde))
+        assert loaded.univariate_method == method
+        assert loaded.univariate_tolerance == 1e-6
+        assert np.all(loaded.logl(test_df) == logl)
+
+    with pytest.raises(ValueError) as ex:
+        kde.univariate_tolerance = 0
+    assert "range (0, 1)" in str(ex.value)
+
+    # The density of ±inf is 0.
+    inf_df = test_df.iloc[:3].copy()
+    inf_df['a'] = [np.inf, -np.inf, 0.]
+    for method in [pbn.UnivariateKDEMethod.SortedWindow, pbn.UnivariateKDEMethod.Binned]:
+        # The training data is sorted when the KDE is fitted, so it is not copied by the univariate method.
+        kde_sorted = pbn.KDE(['a'])
+        kde_sorted.univariate_method = method
+        kde_sorted.fit(df)
+        assert np.all(np.isclose(kde_sorted.logl(test_df), exact, atol=1e-5))
+
+        ll = kde_sorted.logl(inf_df)
+        assert np.all(ll[:2] == -np.inf)
+        assert np.isfinite(ll[2])
+
+    # The multivariate KDEs ignore the univariate method.
+    kde_multi = pbn.KDE(['a', 'b'])
+    kde_multi.fit(df)
+    logl = kde_multi.logl(test_df)
+    kde_multi.univariate_method = pbn.UnivariateKDEMethod.Binned
+    assert np.all(kde_multi.logl(test_df) == logl)
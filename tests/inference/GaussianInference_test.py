@@ -0,0 +1,122 @@
+import pytest
+import numpy as np
+import pybnesian as pbn
+from scipy.stats import multivariate_normal
+import util_test
+
+df = util_test.generate_normal_data(10000)
+
+def fitted_gbn():
+    gbn = pbn.GaussianNetwork([('a', 'b'), ('a', 'c'), ('b', 'c'), ('a', 'd'), ('b', 'd'), ('c', 'd')])
+    gbn.fit(df)
+    return gbn
+
+def joint_numpy(gbn, nodes):
+    # Joint distribution by ancestral propagation of the linear Gaussian CPDs.
+    index = {n: i for i, n in enumerate(nodes)}
+    n = len(nodes)
+    B = np.zeros((n, n))
+    variances = np.zeros(n)
+    intercepts = np.zeros(n)
+
+    for node in nodes:
+        cpd = gbn.cpd(node)
+        intercepts[index[node]] = cpd.beta[0]
+        variances[index[node]] = cpd.variance
+        for e, b in zip(cpd.evidence(), cpd.beta[1:]):
+            B[index[node], index[e]] = b
+
+    inv = np.linalg.inv(np.eye(n) - B)
+    return inv.dot(intercepts), inv.dot(np.diag(variances)).dot(inv.T)
+
+def test_joint():
+    gbn = fitted_gbn()
+    inference = pbn.GaussianInference(gbn)
+
+    nodes = inference.nodes()
+    assert set(nodes) == set(gbn.nodes())
+
+    mean, cov = joint_numpy(gbn, nodes)
+    assert np.all(np.isclose(inference.mean(), mean))
+    assert np.all(np.isclose(inference.covariance(), cov))
+    assert np.all(np.isclose(inference.precision(), np.linalg.inv(cov)))
+    assert np.all(np.isclose(inference.potential(), np.linalg.inv(cov).dot(mean)))
+
+def test_conditional():
+    gbn = fitted_gbn()
+    inference = pbn.GaussianInference(gbn)
+
+    nodes = inference.nodes()
+    mean, cov = joint_numpy(gbn, nodes)
+    index = {n: i for i, n in enumerate(nodes)}
+
+    for query, evidence in [(['a'], ['d']), (['b', 'c'], ['a', 'd']), (['d', 'a'], ['c']), (['c'], [])]:
+        q = [index[v] for v in query]
+        e = [index[v] for v in evidence]
+
+        cond = inference.conditional(query, evidence)
+        assert cond.query() == query
+        assert cond.evidence() == evidence
+
+        if evidence:
+            gain = cov[np.ix_(q, e)].dot(np.linalg.inv(cov[np.ix_(e, e)]))
+            expected_cov = cov[np.ix_(q, q)] - gain.dot(cov[np.ix_(e, q)])
+            expected_mean = mean[q] + (df.loc[:, evidence].to_numpy() - mean[e]).dot(gain.T)
+        else:
+            expected_cov = cov[np.ix_(q, q)]
+            expected_mean = np.tile(mean[q], (df.shape[0], 1))
+
+        assert np.all(np.isclose(cond.covariance(), expected_cov))
+        assert np.all(np.isclose(cond.mean(df), expected_mean))
+        assert np.all(np.isclose(inference.conditional_mean(query, evidence, df), expected_mean))
+        assert np.all(np.isclose(inference.conditional_covariance(query, evidence), expected_cov))
+
+        logl = inference.logl(query, evidence, df)
+        x = df.loc[:, query].to_numpy()
+        expected_logl = np.asarray([multivariate_normal.logpdf(x[i], expected_mean[i], expected_cov)
+                                    for i in range(10)])
+        assert np.all(np.isclose(logl[:10], expected_logl))
+
+def test_cache():
+    gbn = fitted_gbn()
+    inference = pbn.GaussianInference(gbn)
+
+    assert inference.num_cached() == 0
+    c1 = inference.conditional(['a', 'b'], ['d'])
+    assert inference.num_cached() == 1
+    c2 = inference.conditional(['a', 'b'], ['d'])
+    assert inference.num_cached() == 1
+    assert c1 is c2
+
+    inference.conditional(['b', 'a'], ['d'])
+    assert inference.num_cached() == 2
+
+    inference.clear_cache()
+    assert inference.num_cached() == 0
+
+def test_invalid():
+    gbn = pbn.GaussianNetwork([('a', 'b')])
+    with pytest.raises(ValueError) as ex:
+        pbn.GaussianInference(gbn)
+    assert "not fitted" in str(ex.value)
+
+    gbn = fitted_gbn()
+    inference = pbn.GaussianInference(gbn)
+
+    with pytest.raises(ValueError) as ex:
+        inference.conditional(['a'], ['a'])
+    assert "both a query and an evidence" in str(ex.value)
+
+    with pytest.raises(ValueError) as ex:
+        inference.conditional(['e'], ['a'])
+    assert "not present in the model" in str(ex.value)
+
+    with pytest.raises(ValueError) as ex:
+        inference.conditional([], ['a'])
+    assert "cannot be empty" in str(ex.value)
+
+    spbn = pbn.SemiparametricBN([('a', 'b')], [('a', pbn.CKDEType())])
+    spbn.fit(df)
+    with pytest.raises(ValueError) as ex:
+        pbn.GaussianInference(spbn)
+    assert "requires LinearGaussianCPD" in str(ex.value)
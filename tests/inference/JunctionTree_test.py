@@ -0,0 +1,151 @@
+import itertools
+import pytest
+import numpy as np
+import pandas as pd
+import pybnesian as pbn
+import util_test
+
+df = util_test.generate_discrete_data_dependent(10000)
+
+def fitted_bn():
+    bn = pbn.DiscreteBN(['A', 'B', 'C', 'D'], [('A', 'B'), ('A', 'C'), ('B', 'C'), ('B', 'D'), ('C', 'D')])
+    bn.fit(df)
+    return bn
+
+def joint_brute_force(bn):
+    # Enumerate every configuration of the variables. The first variable changes fastest.
+    variables = ['A', 'B', 'C', 'D']
+    categories = [df[v].cat.categories for v in variables]
+    configurations = [c[::-1] for c in itertools.product(*categories[::-1])]
+    joint_df = pd.DataFrame({v: pd.Categorical([c[i] for c in configurations], categories=categories[i])
+                             for i, v in enumerate(variables)})
+
+    logl = np.zeros(joint_df.shape[0])
+    for v in variables:
+        logl += bn.cpd(v).logl(joint_df)
+
+    return joint_df, np.exp(logl)
+
+def test_structure():
+    bn = fitted_bn()
+
+    for heuristic in ["min-fill", "min-weight"]:
+        jt = pbn.JunctionTree(bn, heuristic)
+        cliques = jt.cliques()
+        assert len(jt.edges()) == len(cliques) - 1
+        assert len(jt.separators()) == len(jt.edges())
+
+        # Each family is contained in a clique.
+        for node in bn.nodes():
+            family = set([node] + bn.parents(node))
+            assert any(family <= set(c) for c in cliques)
+
+        assert jt.treewidth() == max(len(c) for c in cliques) - 1
+
+    with pytest.raises(ValueError) as ex:
+        pbn.JunctionTree(bn, "wrong")
+    assert "Wrong heuristic" in str(ex.value)
+
+def test_prior():
+    bn = fitted_bn()
+    jt = pbn.JunctionTree(bn)
+    joint_df, joint = joint_brute_force(bn)
+
+    for v in ['A', 'B', 'C', 'D']:
+        expected = np.asarray([joint[(joint_df[v] == c).to_numpy()].sum() for c in jt.variable_values(v)])
+        assert np.all(np.isclose(jt.prior([v]), expected))
+
+    # Joint query. 'A' changes fastest.
+    expected = np.asarray([joint[((joint_df['A'] == a) & (joint_df['B'] == b)).to_numpy()].sum()
+                           for b in jt.variable_values('B') for a in jt.variable_values('A')])
+    assert np.all(np.isclose(jt.prior(['A', 'B']), expected))
+
+def test_query():
+    bn = fitted_bn()
+    jt = pbn.JunctionTree(bn)
+    joint_df, joint = joint_brute_force(bn)
+
+    evidence = df[['C', 'D']].iloc[:200].reset_index(drop=True)
+    evidence.loc[evidence.index % 5 == 0, 'D'] = np.nan
+
+    posterior = jt.query(['A'], evidence)
+    assert posterior.shape == (200, 2)
+
+    p_evidence = jt.probability_evidence(evidence)
+
+    for i in range(evidence.shape[0]):
+        mask = (joint_df['C'] == evidence['C'][i]).to_numpy()
+        if not pd.isnull(evidence['D'][i]):
+            mask &= (joint_df['D'] == evidence['D'][i]).to_numpy()
+
+        assert np.isclose(p_evidence[i], joint[mask].sum())
+
+        expected = np.asarray([joint[mask & (joint_df['A'] == a).to_numpy()].sum() for a in jt.variable_values('A')])
+        expected /= expected.sum()
+        assert np.all(np.isclose(posterior[i], expected))
+
+    assert np.all(np.isclose(jt.log_probability_evidence(evidence), np.log(p_evidence)))
+
+def test_cache():
+    bn = fitted_bn()
+    jt = pbn.JunctionTree(bn)
+
+    evidence = df[['C', 'D']].iloc[:1000]
+    unique = evidence.drop_duplicates().shape[0]
+
+    first = jt.query(['A'], evidence)
+    assert jt.num_cached() == unique
+    second = jt.query(['A'], evidence)
+    assert jt.num_cached() == unique
+    assert np.all(first == second)
+
+    jt.clear_cache()
+    assert jt.num_cached() == 0
+
+def test_cache_lru():
+    bn = fitted_bn()
+    jt = pbn.JunctionTree(bn, max_cached=2)
+    assert jt.max_cached() == 2
+
+    evidence = df[['C', 'D']].drop_duplicates().iloc[:3]
+    expected = jt.query(['A'], evidence)
+    assert jt.num_cached() == 2
+
+    # The evicted configurations are calibrated again.
+    for i in range(3):
+        assert np.all(np.isclose(jt.query(['A'], evidence.iloc[i:i+1]), expected[i]))
+        assert jt.num_cached() == 2
+
+    no_cache = pbn.JunctionTree(bn, max_cached=0)
+    assert np.all(np.isclose(no_cache.query(['A'], evidence), expected))
+    assert no_cache.num_cached() == 0
+
+    with pytest.raises(ValueError) as ex:
+        pbn.JunctionTree(bn, max_cached=-1)
+    assert "negative" in str(ex.value)
+
+def test_invalid():
+    bn = fitted_bn()
+    jt = pbn.JunctionTree(bn)
+
+    with pytest.raises(ValueError) as ex:
+        jt.query([], df)
+    assert "cannot be empty" in str(ex.value)
+
+    with pytest.raises(ValueError) as ex:
+        jt.query(['A', 'A'], df)
+    assert "duplicates" in str(ex.value)
+
+    with pytest.raises(ValueError) as ex:
+        jt.query(['E'], df)
+    assert "not present in the model" in str(ex.value)
+
+    gbn = pbn.GaussianNetwork(['a', 'b'])
+    gbn.fit(util_test.generate_normal_data(100))
+    with pytest.raises(ValueError) as ex:
+        pbn.JunctionTree(gbn)
+    assert "requires DiscreteFactor" in str(ex.value)
+
+    with pytest.raises(ValueError) as ex:
+        pbn.JunctionTree(pbn.DiscreteBN(['A', 'B']))
+    assert "not fitted" in str(ex.value)
@@ -0,0 +1,96 @@
+import numpy as np
+import pyarrow as pa
+import pytest
+import pybnesian as pbn
+import util_test
+
+df = util_test.generate_normal_data(1000)
+
+
+def check_frequencies(freqs, num_replicates):
+    assert freqs.num_replicates() == num_replicates
+    assert set(freqs.nodes()) == set(df.columns.values)
+
+    for source, target, f in freqs.arcs():
+        assert 0 < f <= 1
+        assert f == freqs.arc_frequency(source, target)
+        assert freqs.arc_frequency(source, target) <= freqs.edge_frequency(source, target)
+
+    for n1, n2, f in freqs.edges():
+        assert 0 < f <= 1
+        assert f == freqs.edge_frequency(n2, n1)
+
+
+def test_bootstrap_hc():
+    freqs = pbn.bootstrap_hc(df, bn_type=pbn.GaussianNetworkType(), score="bic", num_replicates=20, seed=0)
+    check_frequencies(freqs, 20)
+
+    # Each replicate learns a DAG, so the adjacencies come from the arcs.
+    for n1, n2, f in freqs.edges():
+        assert f == pytest.approx(freqs.arc_frequency(n1, n2) + freqs.arc_frequency(n2, n1))
+
+    # The result only depends on the seed.
+    freqs_sequential = pbn.bootstrap_hc(df, bn_type=pbn.GaussianNetworkType(), score="bic", num_replicates=20,
+                                        seed=0, num_threads=1)
+    assert freqs.arcs() == freqs_sequential.arcs()
+
+    dag = freqs.averaged_dag(0.5)
+    for source, target in dag.arcs():
+        assert freqs.edge_frequency(source, target) >= 0.5
+
+    # A lower threshold does not remove edges.
+    assert dag.num_arcs() <= freqs.averaged_dag(0.1).num_arcs()
+
+
+def test_bootstrap_pc():
+    freqs = pbn.bootstrap_pc(df, test="linear-correlation", num_replicates=20, seed=0)
+    check_frequencies(freqs, 20)
+
+    pdag = freqs.averaged_pdag(0.5)
+    for source, target in pdag.arcs():
+        assert freqs.arc_frequency(source, target) >= 0.5
+        assert freqs.arc_frequency(source, target) > freqs.arc_frequency(target, source)
+    for n1, n2 in pdag.edges():
+        assert freqs.edge_frequency(n1, n2) >= 0.5
+
+
+def test_bootstrap_mmhc():
+    freqs = pbn.bootstrap_mmhc(df, bn_type=pbn.GaussianNetworkType(), score="bic", num_replicates=10, seed=0)
+    check_frequencies(freqs, 10)
+    freqs.averaged_dag(0.5)
+
+
+def test_bootstrap_weighted():
+    # The resamples of a weighted DataFrame draw the rows proportionally to the weights. The weights column is not a
+    # node of the learned models.
+    rb = pa.RecordBatch.from_pandas(df.assign(w=np.full(df.shape[0], 2.)), preserve_index=False)
+    weighted_df = pbn.with_weights(rb, "w")
+
+    freqs = pbn.bootstrap_hc(weighted_df, bn_type=pbn.GaussianNetworkType(), score="bic", num_replicates=10, seed=0)
+    check_frequencies(freqs, 10)
+
+    freqs = pbn.bootstrap_pc(weighted_df, test="linear-correlation", num_replicates=10, seed=0)
+    check_frequencies(freqs, 10)
+
+
+def test_bootstrap_mutual_info():
+    # MutualInformation does not support weights, so the resampled rows are copied.
+    discrete_df = util_test.generate_discrete_data_dependent(500)
+    freqs = pbn.bootstrap_pc(discrete_df, test="mutual-info", num_replicates=4, seed=0)
+    assert freqs.num_replicates() == 4
+    assert set(freqs.nodes()) == set(discrete_df.columns.values)
+
+
+def test_bootstrap_invalid():
+    with pytest.raises(ValueError) as ex:
+        pbn.bootstrap_hc(df, bn_type=pbn.GaussianNetworkType(), num_replicates=0)
+    assert "replicates" in str(ex.value)
+
+    with pytest.raises(ValueError) as ex:
+        pbn.bootstrap_pc(df, test="wrong-test", num_replicates=2)
+    assert "independence test" in str(ex.value)
+
+    freqs = pbn.bootstrap_hc(df, bn_type=pbn.GaussianNetworkType(), num_replicates=2, seed=0)
+    with pytest.raises(ValueError) as ex:
+        freqs.averaged_dag(0)
+    assert "threshold" in str(ex.value)
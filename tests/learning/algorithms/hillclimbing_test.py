@@ -1,3 +1,4 @@
+import pytest
 import numpy as np
 import pybnesian as pbn
 from pybnesian import BayesianNetworkType, BayesianNetwork
@@ -203,4 +204,77 @@ def test_newbn_estimate_validation():
     estimated = hc.estimate(arc, bic, start)
 
     assert type(start) == type(estimated)
-    assert estimated.extra_data == "extra"
\ No newline at end of file
+    assert estimated.extra_data == "extra"
+
+
+def test_hc_restarts():
+    bic = pbn.BIC(df)
+    hc_model = pbn.hc(df, bn_type=pbn.GaussianNetworkType(), score="bic", seed=0)
+
+    ranking = pbn.hc_restarts(df, bn_type=pbn.GaussianNetworkType(), score="bic", num_restarts=6,
+                              num_perturbations=4, seed=0, return_all=True)
+    assert len(ranking) == 6
+
+    scores = [s for _, s in ranking]
+    assert scores == sorted(scores, reverse=True)
+    for model, s in ranking:
+        assert np.isclose(s, bic.score(model))
+
+    # The first restart starts from the same empty model as hc().
+    assert scores[0] >= bic.score(hc_model) or np.isclose(scores[0], bic.score(hc_model))
+
+    # The result only depends on the seed.
+    best = pbn.hc_restarts(df, bn_type=pbn.GaussianNetworkType(), score="bic", num_restarts=6,
+                           num_perturbations=4, seed=0, num_threads=1)
+    assert set(best.arcs()) == set(ranking[0][0].arcs())
+
+    bootstrap = pbn.hc_restarts(df, bn_type=pbn.GaussianNetworkType(), score="bic", num_restarts=3,
+                                perturbation="bootstrap", seed=0, return_all=True)
+    assert len(bootstrap) == 3
+
+
+def test_hc_restarts_semiparametric():
+    # Semiparametric restarts are learned concurrently: the result must not depend on the number of threads.
+    parallel = pbn.hc_restarts(df, bn_type=pbn.SemiparametricBNType(), score="validated-lik", num_restarts=3,
+                               num_perturbations=2, max_iters=5, seed=0, num_threads=2, return_all=True)
+    sequential = pbn.hc_restarts(df, bn_type=pbn.SemiparametricBNType(), score="validated-lik", num_restarts=3,
+                                 num_perturbations=2, max_iters=5, seed=0, num_threads=1, return_all=True)
+
+    assert len(parallel) == len(sequential)
+    for (p, ps), (s, ss) in zip(parallel, sequential):
+        assert set(p.arcs()) == set(s.arcs())
+        assert np.isclose(ps, ss)
+
+
+def test_hc_restarts_whitelists():
+    ranking = pbn.hc_restarts(df, bn_type=pbn.GaussianNetworkType(), score="bic", num_restarts=5,
+                              num_perturbations=10, arc_blacklist=[("a", "b")], arc_whitelist=[("c", "d")],
+                              max_indegree=2, seed=1, return_all=True)
+
+    for model, _ in ranking:
+        assert not model.has_arc("a", "b")
+        assert model.has_arc("c", "d")
+        assert all(model.num_parents(n) <= 2 for n in model.nodes())
+
+
+def test_hc_restarts_shared_cache():
+    pbn.reset_profiling()
+    pbn.enable_profiling()
+    try:
+        pbn.hc_restarts(df, bn_type=pbn.GaussianNetworkType(), score="bic", num_restarts=4, seed=0)
+    finally:
+        pbn.disable_profiling()
+
+    counters = pbn.profiling_stats()["counters"]
+    assert counters["score_cache/hits"] > 0
+    assert counters["score_cache/misses"] > 0
+
+
+def test_hc_restarts_invalid():
+    with pytest.raises(ValueError) as ex:
+        pbn.hc_restarts(df, bn_type=pbn.GaussianNetworkType(), num_restarts=0)
+    assert "restarts" in str(ex.value)
+
+    with pytest.raises(ValueError) as ex:
+        pbn.hc_restarts(df, bn_type=pbn.GaussianNetworkType(), perturbation="random")
+    assert "perturbation" in str(ex.value)
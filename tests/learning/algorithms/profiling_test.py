@@ -0,0 +1,116 @@
+import json
+import pybnesian as pbn
+import util_test
+
+df = util_test.generate_normal_data(1000)
+
+
+def test_profiling_disabled():
+    pbn.disable_profiling()
+    pbn.reset_profiling()
+
+    pbn.hc(df, bn_type=pbn.GaussianNetworkType(), score="bic", seed=0)
+
+    stats = pbn.profiling_stats()
+    assert stats["timers"] == {}
+    assert stats["counters"] == {}
+
+
+def test_profiling_hc(tmp_path):
+    pbn.reset_profiling()
+    pbn.enable_profiling(trace=True)
+    try:
+        pbn.hc(df, bn_type=pbn.GaussianNetworkType(), score="bic", seed=0)
+    finally:
+        pbn.disable_profiling()
+
+    stats = pbn.profiling_stats()
+    timers = stats["timers"]
+    counters = stats["counters"]
+
+    assert timers["hc/total"]["count"] == 1
+    assert timers["hc/cache_scores"]["count"] == 1
+    # The last iteration does not find an improving operator, so the scores are not updated.
+    assert timers["hc/find_max"]["count"] == counters["hc/iterations"]
+    assert timers["hc/update_scores"]["count"] == counters["hc/iterations"] - 1
+
+    local_score = timers["local_score/LinearGaussianFactor"]
+    assert local_score["count"] > 0
+    assert 0 <= local_score["min_time"] <= local_score["max_time"] <= local_score["total_time"]
+
+    trace_file = tmp_path / "trace.json"
+    pbn.save_profiling_trace(str(trace_file))
+    with open(trace_file) as f:
+        trace = json.load(f)
+
+    names = {e["name"] for e in trace["traceEvents"]}
+    assert "hc/total" in names
+    assert "local_score/LinearGaussianFactor" in names
+    assert all(e["ph"] == "X" and e["dur"] >= 0 for e in trace["traceEvents"])
+
+    pbn.reset_profiling()
+    assert pbn.profiling_stats()["timers"] == {}
+
+
+def test_profiling_independence_tests():
+    pbn.reset_profiling()
+    pbn.enable_profiling()
+    try:
+        lc = pbn.LinearCorrelation(df)
+        lc.pvalue("a", "b")
+        lc.pvalue("a", "b", "c")
+        lc.pvalue("a", "b", ["c", "d"])
+
+        cached = pbn.CachedIndependenceTest(lc, df)
+        cached.pvalue("a", "b", ["c", "d"])
+        cached.pvalue("b", "a", ["d", "c"])
+    finally:
+        pbn.disable_profiling()
+
+    stats = pbn.profiling_stats()
+    timers = stats["timers"]
+    counters = stats["counters"]
+
+    assert timers["ci_test/LinearCorrelation/0"]["count"] == 1
+    assert timers["ci_test/LinearCorrelation/1"]["count"] == 1
+    assert timers["ci_test/LinearCorrelation/2"]["count"] == 2
+    assert counters["ci_cache/misses"] == 1
+    assert counters["ci_cache/hits"] == 1
+
+    pbn.reset_profiling()
+
+
+def test_profiling_cycle_checks():
+    dag = pbn.Dag(["a", "b", "c", "d"], [("a", "b"), ("b", "c")])
+
+    pbn.reset_profiling()
+    pbn.enable_profiling()
+    try:
+        # A path must be searched only if the new arc can close a cycle.
+        assert not dag.can_add_arc("c", "a")
+        assert dag.can_add_arc("d", "a")
+        assert dag.can_flip_arc("a", "b")
+    finally:
+        pbn.disable_profiling()
+
+    assert pbn.profiling_stats()["counters"]["dag/cycle_checks"] == 1
+
+    pbn.reset_profiling()
+
+
+def test_profiling_fit_logl():
+    model = pbn.GaussianNetwork(["a", "b", "c", "d"], [("a", "b"), ("b", "c")])
+
+    pbn.reset_profiling()
+    pbn.enable_profiling()
+    try:
+        model.fit(df)
+        model.logl(df)
+    finally:
+        pbn.disable_profiling()
+
+    timers = pbn.profiling_stats()["timers"]
+    assert timers["factor_fit/LinearGaussianFactor"]["count"] == 4
+    assert timers["factor_logl/LinearGaussianFactor"]["count"] == 4
+
+    pbn.reset_profiling()
@@ -0,0 +1,194 @@
+import threading
+import pytest
+import numpy as np
+import pybnesian as pbn
+import util_test
+
+df = util_test.generate_normal_data(1000)
+
+
+def complete_pdag():
+    nodes = list(df.columns.values)
+    return pbn.PartiallyDirectedGraph.CompleteUndirected(nodes)
+
+
+def sorted_rows(results):
+    return sorted(
+        (min(n1, n2), max(n1, n2), tuple(s), p)
+        for n1, n2, s, p in zip(results.node1, results.node2, results.sepsets.tolist(), results.pvalues)
+    )
+
+
+def sorted_seplist(seplist):
+    return sorted((min(e), max(e), tuple(sorted(s)), p) for e, s, p in seplist.l_sep)
+
+
+def test_sepset_job_equals_sync():
+    pc = pbn.PC()
+    lc = pbn.LinearCorrelation(df)
+    pdag = complete_pdag()
+
+    for sepset_size in range(3):
+        job = pc.start_sepsets_of_size(pdag, lc, sepset_size=sepset_size, num_threads=2)
+        assert job.wait()
+        assert job.done()
+        assert not job.cancelled()
+        assert job.num_edges() == job.num_finished_edges() == pdag.num_edges()
+
+        results = job.results()
+        assert results.sepset_size == sepset_size
+        assert results.sepsets.shape == (len(results), sepset_size)
+
+        expected = pc.compute_sepsets_of_size(pdag, lc, sepset_size=sepset_size)
+        assert sorted_rows(results) == sorted_seplist(expected)
+        assert sorted_seplist(results.to_seplist()) == sorted_seplist(expected)
+
+
+def test_sepset_job_poll():
+    pc = pbn.PC()
+    lc = pbn.LinearCorrelation(df)
+    pdag = complete_pdag()
+
+    job = pc.start_sepsets_of_size(pdag, lc, sepset_size=1)
+    polled = []
+    while not job.wait(timeout=0.001):
+        polled.append(job.poll())
+    polled.append(job.poll())
+
+    assert len(job.poll()) == 0
+    assert sum(len(r) for r in polled) == len(job.results())
+    pvalues = np.concatenate([r.pvalues for r in polled])
+    assert np.all(np.sort(pvalues) == np.sort(job.results().pvalues))
+
+
+class BlockingTest(pbn.IndependenceTest):
+    # Independence test that blocks every test until the event is set.
+    def __init__(self, event):
+        pbn.IndependenceTest.__init__(self)
+        self.event = event
+
+    def num_variables(self):
+        return 4
+
+    def variable_names(self):
+        return ["a", "b", "c", "d"]
+
+    def has_variables(self, vars):
+        if isinstance(vars, str):
+            vars = [vars]
+        return set(vars).issubset(set(self.variable_names()))
+
+    def name(self, index):
+        return self.variable_names()[index]
+
+    def pvalue(self, v1, v2, cond):
+        self.event.wait()
+        return 0.5
+
+
+def test_sepset_job_whitelist_remove_edges():
+    pc = pbn.PC()
+    lc = pbn.LinearCorrelation(df)
+    pdag = complete_pdag()
+    a, b = pdag.index("a"), pdag.index("b")
+
+    job = pc.start_sepsets_of_size(pdag, lc, edge_whitelist=[("a", "b")], sepset_size=0)
+    job.wait()
+    assert job.num_edges() == pdag.num_edges() - 1
+    assert all({n1, n2} != {a, b} for n1, n2 in zip(job.results().node1, job.results().node2))
+
+    # No test finishes until the edges are removed, and the priority edges are sorted before the job starts.
+    release = threading.Event()
+    job = pc.start_sepsets_of_size(pdag, BlockingTest(release), sepset_size=0, num_threads=1,
+                                   priority_edges=[("b", "a")])
+    c, d = pdag.index("c"), pdag.index("d")
+    job.remove_edges([(c, d)])
+    release.set()
+    assert job.wait()
+
+    assert job.num_edges() == pdag.num_edges() - 1
+    results = job.results()
+    assert {results.node1[0], results.node2[0]} == {a, b}
+
+    tested = {frozenset(e) for e in zip(results.node1, results.node2)}
+    expected = {frozenset((pdag.index(n1), pdag.index(n2))) for n1, n2 in pdag.edges()} - {frozenset((c, d))}
+    assert tested == expected
+
+
+def test_sepset_job_cancel():
+    pc = pbn.PC()
+    lc = pbn.LinearCorrelation(df)
+    pdag = complete_pdag()
+
+    job = pc.start_sepsets_of_size(pdag, lc, sepset_size=2)
+    job.cancel()
+    assert job.wait()
+    assert job.done()
+    assert job.cancelled()
+    assert job.num_finished_edges() <= job.num_edges()
+
+
+def test_sepset_job_speculate():
+    pc = pbn.PC()
+    lc = pbn.LinearCorrelation(df)
+    pdag = complete_pdag()
+
+    with pytest.raises(ValueError) as ex:
+        pc.start_sepsets_of_size(pdag, lc, sepset_size=0, speculate=True)
+    assert "CachedIndependenceTest" in str(ex.value)
+
+    cached = pbn.CachedIndependenceTest(lc, df)
+    job = pc.start_sepsets_of_size(pdag, cached, sepset_size=0, speculate=True)
+    assert job.wait(speculative=True)
+
+    num_marginal = pdag.num_edges()
+    num_univariate = len(pc.compute_sepsets_of_size(pdag, lc, sepset_size=1).l_sep)
+    assert cached.num_cached() == num_marginal + num_univariate
+
+
+def test_sepset_job_python_test():
+    class MyTest(pbn.IndependenceTest):
+        def __init__(self):
+            pbn.IndependenceTest.__init__(self)
+
+        def num_variables(self):
+            return 4
+
+        def variable_names(self):
+            return ["a", "b", "c", "d"]
+
+        def has_variables(self, vars):
+            if isinstance(vars, str):
+                vars = [vars]
+            return set(vars).issubset(set(self.variable_names()))
+
+        def name(self, index):
+            return self.variable_names()[index]
+
+        def pvalue(self, v1, v2, cond):
+            return 0.5
+
+    pc = pbn.PC()
+    pdag = complete_pdag()
+    job = pc.start_sepsets_of_size(pdag, MyTest(), sepset_size=1)
+    assert job.wait()
+    assert np.all(job.results().pvalues == 0.5)
+
+
+def test_sepset_job_default_threads():
+    previous = pbn.num_threads()
+    pc = pbn.PC()
+    lc = pbn.LinearCorrelation(df)
+
+    try:
+        for n in [1, 3]:
+            pbn.set_num_threads(n)
+            job = pc.start_sepsets_of_size(complete_pdag(), lc, sepset_size=1)
+            assert job.num_threads() == n
+            assert job.wait()
+
+        job = pc.start_sepsets_of_size(complete_pdag(), lc, sepset_size=1, num_threads=2)
+        assert job.num_threads() == 2
+        assert job.wait()
+    finally:
+        pbn.set_num_threads(previous)
@@ -0,0 +1,40 @@
+import pybnesian as pbn
+import util_test
+
+df = util_test.generate_normal_data(1000)
+
+def test_rcot_seed():
+    rcot = pbn.RCoT(df, seed=0)
+    rcot2 = pbn.RCoT(df, seed=0)
+
+    assert rcot.pvalue("a", "b") == rcot2.pvalue("a", "b")
+    assert rcot.pvalue("a", "c", "b") == rcot2.pvalue("a", "c", "b")
+    assert rcot.pvalue("a", "d", ["b", "c"]) == rcot2.pvalue("a", "d", ["b", "c"])
+
+def test_rcot_cache():
+    rcot = pbn.RCoT(df, seed=0)
+    assert rcot.num_cached_features() == 0
+
+    p1 = rcot.pvalue("a", "b")
+    assert rcot.num_cached_features() == 2
+    assert rcot.pvalue("a", "b") == p1
+
+    # The features of a conditioning set do not depend on the order of the variables.
+    p2 = rcot.pvalue("a", "d", ["b", "c"])
+    assert rcot.num_cached_features() == 4
+    assert rcot.pvalue("a", "d", ["c", "b"]) == p2
+    assert rcot.num_cached_features() == 4
+
+    rcot.clear_cache()
+    assert rcot.num_cached_features() == 0
+    assert rcot.pvalue("a", "b") == p1
+
+def test_rcot_pc():
+    rcot = pbn.RCoT(df, seed=0)
+    pc = pbn.PC()
+    graph = pc.estimate(rcot)
+    graph2 = pc.estimate(pbn.RCoT(df, seed=0))
+
+    assert set(graph.nodes()) == set(["a", "b", "c", "d"])
+    assert set(graph.arcs()) == set(graph2.arcs())
+    assert set(graph.edges()) == set(graph2.edges())
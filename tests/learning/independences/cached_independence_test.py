@@ -0,0 +1,92 @@
+import pytest
+import pybnesian as pbn
+import util_test
+
+df = util_test.generate_normal_data(1000)
+
+def test_cached_pvalue():
+    lc = pbn.LinearCorrelation(df)
+    cached = pbn.CachedIndependenceTest(lc, df)
+
+    assert cached.num_cached() == 0
+    assert cached.pvalue("a", "b") == lc.pvalue("a", "b")
+    assert cached.pvalue("b", "a") == lc.pvalue("a", "b")
+    assert cached.num_cached() == 1
+
+    assert cached.pvalue("a", "c", "b") == lc.pvalue("a", "c", "b")
+    assert cached.pvalue("a", "c", ["b"]) == lc.pvalue("a", "c", "b")
+    assert cached.num_cached() == 2
+
+    assert cached.pvalue("a", "d", ["b", "c"]) == lc.pvalue("a", "d", ["b", "c"])
+    assert cached.pvalue("d", "a", ["c", "b"]) == lc.pvalue("a", "d", ["b", "c"])
+    assert cached.num_cached() == 3
+
+    cached.clear_cache()
+    assert cached.num_cached() == 0
+
+def test_cached_pc():
+    lc = pbn.LinearCorrelation(df)
+    cached = pbn.CachedIndependenceTest(lc, df)
+
+    pc = pbn.PC()
+    graph = pc.estimate(lc, alpha=0.05)
+    cached_graph = pc.estimate(cached, alpha=0.05)
+
+    assert set(graph.arcs()) == set(cached_graph.arcs())
+    assert set(graph.edges()) == set(cached_graph.edges())
+
+    num_cached = cached.num_cached()
+    assert num_cached > 0
+    pc.estimate(cached, alpha=0.05)
+    assert cached.num_cached() == num_cached
+
+def test_cached_save_load(tmp_path):
+    lc = pbn.LinearCorrelation(df)
+    cached = pbn.CachedIndependenceTest(lc, df)
+    pbn.PC().estimate(cached)
+
+    filename = str(tmp_path / "cached_tests")
+    cached.save(filename)
+
+    loaded = pbn.CachedIndependenceTest(pbn.LinearCorrelation(df), df)
+    assert loaded.fingerprint() == cached.fingerprint()
+    loaded.load(filename + ".pickle")
+    assert loaded.num_cached() == cached.num_cached()
+    assert sorted(loaded.results()) == sorted(cached.results())
+
+    other_df = util_test.generate_normal_data(1000, seed=1)
+    other = pbn.CachedIndependenceTest(pbn.LinearCorrelation(other_df), other_df)
+    assert other.fingerprint() != cached.fingerprint()
+    with pytest.raises(ValueError) as ex:
+        other.load(filename + ".pickle")
+    assert "different dataset" in str(ex.value)
+
+def test_cached_load_other_test(tmp_path):
+    kmi = pbn.KMutualInformation(df, k=10, seed=0, samples=10)
+    cached = pbn.CachedIndependenceTest(kmi, df)
+    cached.pvalue("a", "b")
+
+    filename = str(tmp_path / "cached_kmi")
+    cached.save(filename)
+
+    loaded = pbn.CachedIndependenceTest(pbn.KMutualInformation(df, k=10, seed=0, samples=10), df)
+    loaded.load(filename + ".pickle")
+    assert loaded.results() == cached.results()
+
+    for other_test in [pbn.KMutualInformation(df, k=10, seed=1, samples=10),
+                       pbn.KMutualInformation(df, k=5, seed=0, samples=10),
+                       pbn.LinearCorrelation(df)]:
+        other = pbn.CachedIndependenceTest(other_test, df)
+        with pytest.raises(ValueError) as ex:
+            other.load(filename + ".pickle")
+        assert "different independence test" in str(ex.value)
+
+def test_discrete_fingerprint():
+    discrete_df = util_test.generate_discrete_data_dependent(1000)
+    chi = pbn.ChiSquare(discrete_df)
+
+    same = pbn.CachedIndependenceTest(chi, util_test.generate_discrete_data_dependent(1000))
+    assert same.fingerprint() == pbn.CachedIndependenceTest(chi, discrete_df).fingerprint()
+
+    other_df = util_test.generate_discrete_data_dependent(1000, seed=1)
+    assert pbn.CachedIndependenceTest(chi, other_df).fingerprint() != same.fingerprint()
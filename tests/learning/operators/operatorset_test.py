@@ -76,3 +76,139 @@ def test_nomax():
 
 
 
+
+def test_legal_operators():
+    gbn = pbn.GaussianNetwork(['a', 'b', 'c', 'd'], [('a', 'b'), ('b', 'c')])
+    bic = pbn.BIC(df)
+    arc_op = pbn.ArcOperatorSet(blacklist=[('d', 'a')], whitelist=[('a', 'b')], max_indegree=2)
+    arc_op.cache_scores(gbn, bic)
+
+    ops = arc_op.legal_operators(gbn)
+    assert ops.schema.names == ["type", "source", "target", "node_type", "delta"]
+    ops = ops.to_pandas()
+
+    deltas = ops["delta"].to_numpy()
+    assert np.all(deltas[:-1] >= deltas[1:])
+    assert ops["node_type"].isnull().all()
+
+    arcs = set(zip(ops["type"], ops["source"], ops["target"]))
+    assert ("RemoveArc", "b", "c") in arcs
+    assert ("FlipArc", "b", "c") in arcs
+    # Whitelisted, blacklisted and cyclic operators are not legal.
+    assert all(set((s, t)) != {"a", "b"} for _, s, t in arcs)
+    assert ("AddArc", "d", "a") not in arcs
+    assert ("AddArc", "c", "a") not in arcs
+
+    # The first operator is the one returned by find_max().
+    best = arc_op.find_max(gbn)
+    assert (type(best).__name__, best.source(), best.target()) == (ops["type"][0], ops["source"][0], ops["target"][0])
+    assert np.isclose(best.delta(), ops["delta"][0])
+
+    top = arc_op.legal_operators(gbn, top_k=3).to_pandas()
+    assert len(top) == 3
+    assert np.all(top["delta"].to_numpy() == deltas[:3])
+
+    arc_op.set_max_indegree(1)
+    limited = arc_op.legal_operators(gbn).to_pandas()
+    assert all(t == "RemoveArc" or gbn.num_parents(s if t == "FlipArc" else t2) < 1
+               for t, s, t2 in zip(limited["type"], limited["source"], limited["target"]))
+
+
+def test_legal_operators_pool():
+    spbn = pbn.SemiparametricBN(['a', 'b', 'c', 'd'])
+    spbn.set_unknown_node_types(df)
+    cv = pbn.CVLikelihood(df, k=2, seed=0)
+    pool = pbn.OperatorPool([pbn.ArcOperatorSet(), pbn.ChangeNodeTypeSet()])
+    pool.cache_scores(spbn, cv)
+
+    ops = pool.legal_operators(spbn).to_pandas()
+    change = ops[ops["type"] == "ChangeNodeType"]
+    assert len(change) == 4
+    assert change["target"].isnull().all()
+    assert set(change["source"]) == {'a', 'b', 'c', 'd'}
+    assert len(ops) == 4 + 12
+
+    best = pool.find_max(spbn)
+    assert np.isclose(best.delta(), ops["delta"][0])
+    assert len(pool.legal_operators(spbn, top_k=5)) == 5
+
+
+def expected_delta(model, score, op_type, source, target):
+    def local(node, parents):
+        return score.local_score(model, node, parents) - score.local_score(model, node)
+
+    target_parents = model.parents(target)
+    if op_type == "AddArc":
+        return local(target, target_parents + [source])
+    elif op_type == "RemoveArc":
+        return local(target, [p for p in target_parents if p != source])
+    else:
+        flip_source = local(source, model.parents(source) + [target])
+        return flip_source + local(target, [p for p in target_parents if p != source])
+
+
+def test_operator_deltas():
+    # The deltas are computed with the node indices. The removed node makes the indices and the collapsed indices
+    # differ.
+    gbn = pbn.GaussianNetwork(['e', 'a', 'b', 'c', 'd'], [('a', 'b'), ('b', 'c')])
+    gbn.remove_node('e')
+
+    null_df = df.copy()
+    null_df.loc[::7, 'c'] = np.nan
+
+    for data in [df, null_df]:
+        bic = pbn.BIC(data)
+        candidates = {n: [o for o in gbn.nodes() if o != n] for n in gbn.nodes()}
+        for op_set in [pbn.ArcOperatorSet(), pbn.SparseArcOperatorSet(candidates)]:
+            op_set.cache_scores(gbn, bic)
+            ops = op_set.legal_operators(gbn).to_pandas()
+            assert len(ops) > 0
+
+            for op_type, source, target, delta in zip(ops["type"], ops["source"], ops["target"], ops["delta"]):
+                assert np.isclose(delta, expected_delta(gbn, bic, op_type, source, target))
+
+
+def test_operator_deltas_hybrid():
+    # The nodes are in a different order than the columns of the data, and the discrete parents use the CLG score.
+    hybrid_df = util_test.generate_hybrid_data(SIZE)
+    clg = pbn.CLGNetwork(['D', 'C', 'B', 'A'], [('A', 'C')])
+    bic = pbn.BIC(hybrid_df)
+
+    op_set = pbn.ArcOperatorSet()
+    op_set.cache_scores(clg, bic)
+
+    for _ in range(2):
+        ops = op_set.legal_operators(clg).to_pandas()
+        assert len(ops) > 0
+
+        for op_type, source, target, delta in zip(ops["type"], ops["source"], ops["target"], ops["delta"]):
+            assert np.isclose(delta, expected_delta(clg, bic, op_type, source, target))
+
+        # The deltas of the updated nodes are computed with the columns computed in cache_scores().
+        op = op_set.find_max(clg)
+        op.apply(clg)
+        op_set.update_scores(clg, bic, op.nodes_changed(clg))
+
+
+def test_operator_deltas_bge():
+    # The BGe deltas are computed with the column indices, also with a missing value (without the cached moments).
+    missing_df = df.copy()
+    missing_df.loc[0, 'a'] = np.nan
+
+    for data in [df, missing_df]:
+        gbn = pbn.GaussianNetwork(['d', 'c', 'b', 'a'], [('a', 'c')])
+        bge = pbn.BGe(data)
+
+        op_set = pbn.ArcOperatorSet()
+        op_set.cache_scores(gbn, bge)
+
+        for _ in range(2):
+            ops = op_set.legal_operators(gbn).to_pandas()
+            assert len(ops) > 0
+
+            for op_type, source, target, delta in zip(ops["type"], ops["source"], ops["target"], ops["delta"]):
+                assert np.isclose(delta, expected_delta(gbn, bge, op_type, source, target))
+
+            op = op_set.find_max(gbn)
+            op.apply(gbn)
+            op_set.update_scores(gbn, bge, op.nodes_changed(gbn))
@@ -0,0 +1,124 @@
+import pytest
+import numpy as np
+import pybnesian as pbn
+import util_test
+
+SIZE = 10000
+df = util_test.generate_normal_data(SIZE)
+
+nodes = ['a', 'b', 'c', 'd']
+all_candidates = {n: [o for o in nodes if o != n] for n in nodes}
+
+
+def test_full_candidates_as_dense():
+    gbn = pbn.GaussianNetwork(nodes, [('a', 'b')])
+    bic = pbn.BIC(df)
+
+    dense = pbn.ArcOperatorSet(blacklist=[('d', 'a')], max_indegree=2)
+    sparse = pbn.SparseArcOperatorSet(all_candidates, blacklist=[('d', 'a')], max_indegree=2)
+    dense.cache_scores(gbn, bic)
+    sparse.cache_scores(gbn, bic)
+
+    # Each ordered pair of nodes has a single operator, except the blacklisted arc.
+    assert sparse.num_operators() == 11
+
+    op = dense.find_max(gbn)
+    sop = sparse.find_max(gbn)
+    assert (type(op), op.source(), op.target()) == (type(sop), sop.source(), sop.target())
+    assert np.isclose(op.delta(), sop.delta())
+
+    hc = pbn.GreedyHillClimbing()
+    start = pbn.GaussianNetwork(nodes)
+    dense_model = hc.estimate(pbn.ArcOperatorSet(), bic, start)
+    sparse_model = hc.estimate(pbn.SparseArcOperatorSet(all_candidates), bic, start)
+
+    assert set(dense_model.arcs()) == set(sparse_model.arcs())
+
+
+def test_restricted_candidates():
+    bic = pbn.BIC(df)
+    candidates = {'b': ['a'], 'c': ['b'], 'd': ['b', 'c']}
+
+    sparse = pbn.SparseArcOperatorSet(candidates)
+    gbn = pbn.GaussianNetwork(nodes, [('a', 'c')])
+    sparse.cache_scores(gbn, bic)
+    # 4 candidate arcs and the removal of the arc a -> c.
+    assert sparse.num_operators() == 5
+
+    legal = sparse.legal_operators(gbn).to_pandas()
+    arcs = set(zip(legal["type"], legal["source"], legal["target"]))
+    assert ("RemoveArc", "a", "c") in arcs
+    assert all(t == "RemoveArc" or s in candidates[t2] for t, s, t2 in arcs if t != "FlipArc")
+
+    hc = pbn.GreedyHillClimbing()
+    model = hc.estimate(pbn.SparseArcOperatorSet(candidates), bic, pbn.GaussianNetwork(nodes))
+
+    for source, target in model.arcs():
+        assert source in candidates.get(target, [])
+
+
+def test_reselect_candidates():
+    bic = pbn.BIC(df)
+    gbn = pbn.GaussianNetwork(nodes, [('a', 'b')])
+    sparse = pbn.SparseArcOperatorSet({'b': ['c'], 'c': ['d'], 'd': ['a']}, max_candidates=2)
+    sparse.cache_scores(gbn, bic)
+    sparse.reselect_candidates(gbn, bic)
+
+    candidates = sparse.candidates()
+    # The current parents are always kept.
+    assert 'a' in candidates['b']
+    assert all(len(c) <= 2 for c in candidates.values())
+
+    hc = pbn.GreedyHillClimbing()
+    op_set = pbn.SparseArcOperatorSet({'b': ['a'], 'c': ['a'], 'd': ['a']}, reselect_every=1)
+    model = hc.estimate(op_set, bic, pbn.GaussianNetwork(nodes))
+    assert model.num_arcs() > 0
+
+    with pytest.raises(ValueError) as ex:
+        pbn.SparseArcOperatorSet(all_candidates, reselect_every=-1)
+    assert "non-negative" in str(ex.value)
+
+
+def test_invalid_candidates():
+    bic = pbn.BIC(df)
+    gbn = pbn.GaussianNetwork(nodes)
+
+    with pytest.raises(ValueError) as ex:
+        pbn.SparseArcOperatorSet({'a': ['e']}).cache_scores(gbn, bic)
+    assert "not present in the graph" in str(ex.value)
+
+    with pytest.raises(ValueError) as ex:
+        pbn.SparseArcOperatorSet({'e': ['a']}).cache_scores(gbn, bic)
+    assert "not present in the graph" in str(ex.value)
+
+    cgbn = pbn.ConditionalGaussianNetwork(['c', 'd'], ['a', 'b'])
+    with pytest.raises(ValueError) as ex:
+        pbn.GreedyHillClimbing().estimate(pbn.SparseArcOperatorSet(all_candidates), bic, cgbn)
+    assert "does not support conditional" in str(ex.value)
+
+
+def test_candidate_selection():
+    lc = pbn.LinearCorrelation(df)
+
+    candidates = pbn.association_candidates(lc, k=2)
+    assert set(candidates.keys()) == set(nodes)
+    for node, c in candidates.items():
+        assert len(c) == 2
+        assert node not in c
+
+    pvalues = {n: sorted(lc.pvalue(n, o) for o in nodes if o != n) for n in nodes}
+    for node, c in candidates.items():
+        assert sorted(lc.pvalue(node, o) for o in c) == pvalues[node][:2]
+
+    cpcs = pbn.mmpc_candidates(lc, alpha=0.05)
+    assert set(cpcs.keys()) == set(nodes)
+    for node, c in cpcs.items():
+        for other in c:
+            assert node in cpcs[other]
+
+    limited = pbn.mmpc_candidates(lc, alpha=0.05, max_candidates=1)
+    assert all(len(c) <= 1 for c in limited.values())
+
+    with pytest.raises(ValueError) as ex:
+        pbn.association_candidates(lc, k=0)
+    assert "must be positive" in str(ex.value)
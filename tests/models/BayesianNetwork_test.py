@@ -346,3 +346,97 @@ def test_bn_sample():
     assert not sample.column(1).equals(other_seed.column(2))
     assert not sample.column(2).equals(other_seed.column(1))
     assert not sample.column(3).equals(other_seed.column(3))
+
+def test_bn_sample_chunks():
+    gbn = GaussianNetwork(['a', 'c', 'b', 'd'], [('a', 'b'), ('a', 'c'), ('a', 'd'), ('b', 'c'), ('b', 'd'), ('c', 'd')])
+    gbn.fit(df)
+
+    # More rows than the size of a sampling chunk.
+    sample = gbn.sample(200000, 0, False)
+    assert sample.num_rows == 200000
+    assert sample.schema.names == ['a', 'b', 'c', 'd']
+
+    same_seed = gbn.sample(200000, 0, False)
+    for i in range(4):
+        assert sample.column(i).equals(same_seed.column(i))
+
+    # The first chunk is sampled as a small sample.
+    small = gbn.sample(1000, 0, False)
+    for i in range(4):
+        assert sample.column(i).slice(0, 1000).equals(small.column(i))
+
+    # The chunks do not repeat the same values.
+    assert not sample.column(0).slice(0, 1000).equals(sample.column(0).slice(65536, 1000))
+
+    discrete_df = util_test.generate_discrete_data_dependent(10000)
+    dbn = pbn.DiscreteBN(['A', 'B', 'C', 'D'], [('A', 'B'), ('A', 'C'), ('B', 'C'), ('C', 'D')])
+    dbn.fit(discrete_df)
+    discrete_sample = dbn.sample(200000, 0, True)
+    assert discrete_sample.num_rows == 200000
+    assert discrete_sample.schema.names == ['A', 'B', 'C', 'D']
+    assert discrete_sample.column(0).null_count == 0
+
+def test_bn_incremental_slogl_score():
+    gbn = GaussianNetwork(['a', 'b', 'c', 'd'], [('a', 'b'), ('a', 'c'), ('b', 'c'), ('c', 'd')])
+    gbn.fit(df)
+    test_df = util_test.generate_normal_data(1000, seed=1)
+    bic = pbn.BIC(df)
+
+    def exact_slogl(model):
+        return sum(model.cpd(n).slogl(test_df) for n in model.nodes())
+
+    def exact_score(model):
+        return sum(bic.local_score(model, n) for n in model.nodes())
+
+    pbn.reset_profiling()
+    pbn.enable_profiling()
+    try:
+        slogl = gbn.slogl(test_df)
+        score = bic.score(gbn)
+        # Nothing changed, so every node is cached.
+        assert gbn.slogl(test_df) == slogl
+        assert bic.score(gbn) == score
+        counters = pbn.profiling_stats()["counters"]
+        assert counters["bn/slogl_cache_hits"] == 4
+        assert counters["score/cache_hits"] == 4
+
+        # Only the node 'd' is recomputed.
+        pbn.reset_profiling()
+        gbn.add_arc('b', 'd')
+        gbn.fit(df)
+        assert np.isclose(gbn.slogl(test_df), exact_slogl(gbn))
+        assert np.isclose(bic.score(gbn), exact_score(gbn))
+        counters = pbn.profiling_stats()["counters"]
+        assert counters["bn/slogl_cache_hits"] == 3
+        assert counters["score/cache_hits"] == 3
+        assert pbn.profiling_stats()["timers"]["factor_fit/LinearGaussianFactor"]["count"] == 1
+
+        # Different data is not taken from the cache.
+        gbn.slogl(test_df)
+        pbn.reset_profiling()
+        other_df = util_test.generate_normal_data(1000, seed=2)
+        other_slogl = gbn.slogl(other_df)
+        assert "bn/slogl_cache_hits" not in pbn.profiling_stats()["counters"]
+        assert np.isclose(other_slogl, sum(gbn.cpd(n).slogl(other_df) for n in gbn.nodes()))
+    finally:
+        pbn.disable_profiling()
+        pbn.reset_profiling()
+
+    # The operators invalidate the nodes they change.
+    for op in [pbn.FlipArc('a', 'b', 0), pbn.RemoveArc('c', 'd', 0), pbn.AddArc('a', 'd', 0)]:
+        op.apply(gbn)
+        gbn.fit(df)
+        assert np.isclose(gbn.slogl(test_df), exact_slogl(gbn))
+        assert np.isclose(bic.score(gbn), exact_score(gbn))
+
+    # A CPD modified in place is evaluated again.
+    gbn.slogl(test_df)
+    cpd = gbn.cpd('d')
+    cpd.variance = 2 * cpd.variance
+    assert np.isclose(gbn.slogl(test_df), exact_slogl(gbn))
+    del cpd
+    assert np.isclose(gbn.slogl(test_df), exact_slogl(gbn))
+
+    # A different score does not use the local scores of BIC.
+    bge = pbn.BGe(df)
+    assert np.isclose(bge.score(gbn), sum(bge.local_score(gbn, n) for n in gbn.nodes()))
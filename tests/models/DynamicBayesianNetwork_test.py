@@ -202,4 +202,56 @@ def test_slogl_dbn():
     gbn.fit(df)
     test_df = util_test.generate_normal_data(100)
     ll = numpy_logl(gbn, test_df)
-    assert np.isclose(gbn.slogl(test_df), ll.sum())
\ No newline at end of file
+    assert np.isclose(gbn.slogl(test_df), ll.sum())
+
+def fitted_dbn():
+    gbn = DynamicGaussianNetwork(["a", "b", "c", "d"], 2)
+
+    static_bn = gbn.static_bn()
+    static_bn.add_arc("a_t_2", "c_t_2")
+    static_bn.add_arc("c_t_2", "d_t_2")
+    static_bn.add_arc("a_t_1", "c_t_1")
+
+    transition_bn = gbn.transition_bn()
+    transition_bn.add_arc("a_t_1", "a_t_0")
+    transition_bn.add_arc("b_t_2", "b_t_0")
+    transition_bn.add_arc("c_t_1", "c_t_0")
+    transition_bn.add_arc("a_t_0", "d_t_0")
+
+    gbn.fit(df)
+    return gbn
+
+def test_streaming_logl_dbn():
+    gbn = fitted_dbn()
+    test_df = util_test.generate_normal_data(100)
+    ll = gbn.logl(test_df)
+
+    streaming = pbn.StreamingLogLikelihood(gbn)
+    windows = [(0, 5), (5, 6), (6, 40), (40, 100)]
+    streaming_ll = np.concatenate([streaming.update(test_df.iloc[b:e]) for b, e in windows])
+
+    assert np.all(np.isclose(ll, streaming_ll))
+    assert streaming.num_rows() == 100
+    assert np.isclose(streaming.total(), gbn.slogl(test_df))
+    assert np.isclose(streaming.variable_logl().sum(), streaming.total())
+
+    streaming.reset()
+    assert streaming.num_rows() == 0
+    with pytest.raises(ValueError) as ex:
+        streaming.update(test_df.iloc[:1])
+    assert "Not enough information" in str(ex.value)
+
+def test_sample_trajectories_dbn():
+    gbn = fitted_dbn()
+
+    trajectories = gbn.sample_trajectories(8, 50, 0)
+    assert len(trajectories) == 8
+    for t in trajectories:
+        assert t.num_rows == 50
+        assert t.schema.names == ["a", "b", "c", "d"]
+
+    same_seed = gbn.sample_trajectories(8, 50, 0)
+    for t1, t2 in zip(trajectories, same_seed):
+        assert t1.equals(t2)
+
+    assert not trajectories[0].equals(trajectories[1])
@@ -224,4 +224,45 @@ def test_logl():
     
     assert np.all(np.isclose(ll, sum_ll))
     assert np.isclose(sll, ll.sum())
-    assert sll == sum_sll
\ No newline at end of file
+    assert sll == sum_sll
+
+class UnitaryBandwidth(pbn.BandwidthSelector):
+    def __init__(self):
+        pbn.BandwidthSelector.__init__(self)
+
+    def bandwidth(self, df, variables):
+        return np.eye(len(variables))
+
+def test_parallel_fit():
+    arcs = [('a', 'b'), ('a', 'c'), ('a', 'd'), ('b', 'c'), ('b', 'd'), ('c', 'd')]
+    node_types = [('b', pbn.CKDEType()), ('d', pbn.CKDEType())]
+
+    spbn = SemiparametricBN(arcs, node_types)
+    # The CKDE of 'c' uses a Python bandwidth selector, so it is fitted in the calling thread.
+    spbn.set_node_type('c', pbn.CKDEType())
+    spbn.fit(df, pbn.Arguments({'c': {'bandwidth_selector': UnitaryBandwidth()}}))
+
+    assert np.all(spbn.cpd('c').bandwidth == np.eye(3))
+
+    test_df = util_test.generate_normal_data(500)
+    for n in spbn.nodes():
+        cpd = spbn.cpd(n)
+        assert cpd.type() == spbn.node_type(n)
+
+        if n == 'c':
+            expected = CKDE(n, spbn.parents(n), UnitaryBandwidth())
+        elif spbn.node_type(n) == pbn.CKDEType():
+            expected = CKDE(n, spbn.parents(n))
+        else:
+            expected = LinearGaussianCPD(n, spbn.parents(n))
+
+        expected.fit(df)
+        assert np.all(np.isclose(cpd.logl(test_df), expected.logl(test_df)))
+
+    spbn2 = SemiparametricBN(arcs, node_types)
+    spbn2.fit(df)
+
+    ll = spbn2.logl(test_df)
+    assert ll.shape == (500,)
+    assert np.all(np.isclose(ll, sum(spbn2.cpd(n).logl(test_df) for n in spbn2.nodes())))
+    assert spbn2.slogl(test_df) == sum(spbn2.cpd(n).slogl(test_df) for n in spbn2.nodes())
@@ -0,0 +1,67 @@
+import numpy as np
+import pytest
+import pybnesian as pbn
+import pickle
+import util_test
+
+df = util_test.generate_normal_data(1000)
+df_float = df.astype('float32')
+
+def test_binary_kde(tmp_path):
+    for data in [df, df_float]:
+        for cls in [pbn.KDE, pbn.ProductKDE]:
+            kde = cls(["a", "b", "c"])
+            kde.fit(data)
+
+            filename = str(tmp_path / "kde")
+            pbn.save_binary(kde, filename)
+            loaded = pbn.load_binary(filename + ".pbn")
+
+            assert loaded.fitted()
+            assert loaded.data_type() == kde.data_type()
+            assert loaded.num_instances() == kde.num_instances()
+            assert np.all(loaded.bandwidth == kde.bandwidth)
+            assert loaded.dataset().equals(kde.dataset())
+            assert np.all(loaded.logl(data) == kde.logl(data))
+            assert loaded.slogl(data) == kde.slogl(data)
+
+def test_pickle_productkde():
+    kde = pbn.ProductKDE(["a", "b", "c"])
+    kde.fit(df)
+
+    loaded = pickle.loads(pickle.dumps(kde))
+    assert loaded.dataset().equals(kde.dataset())
+    assert np.all(np.isclose(loaded.logl(df), kde.logl(df)))
+
+def test_binary_model(tmp_path):
+    spbn = pbn.SemiparametricBN([("a", "b"), ("a", "c"), ("b", "c"), ("c", "d")],
+                                [("a", pbn.CKDEType()), ("c", pbn.CKDEType())])
+    spbn.fit(df)
+
+    filename = str(tmp_path / "model.pbn")
+    pbn.save_binary(spbn, filename)
+    loaded = pbn.load_binary(filename)
+
+    assert loaded.fitted()
+    assert set(loaded.arcs()) == set(spbn.arcs())
+    for n in spbn.nodes():
+        assert loaded.node_type(n) == spbn.node_type(n)
+
+    assert np.all(loaded.logl(df) == spbn.logl(df))
+    assert loaded.slogl(df) == spbn.slogl(df)
+
+    sample = spbn.sample(100, seed=0, ordered=True)
+    loaded_sample = loaded.sample(100, seed=0, ordered=True)
+    assert sample.equals(loaded_sample)
+
+    # The loaded model can be pickled again, so the data can be copied out of the mapped file.
+    copied = pickle.loads(pickle.dumps(loaded))
+    assert np.all(copied.logl(df) == spbn.logl(df))
+
+def test_binary_not_valid(tmp_path):
+    filename = str(tmp_path / "not_valid.pbn")
+    with open(filename, "wb") as f:
+        f.write(b"This is not a PyBNesian file")
+
+    with pytest.raises(ValueError, match="not a PyBNesian binary file"):
+        pbn.load_binary(filename)